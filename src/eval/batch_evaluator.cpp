@@ -0,0 +1,347 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "batch_evaluator.h"
+
+#include "command.h"
+#include "error_handler.h"
+#include "file_manager.h"
+#include "job.h"
+#include "logger.h"
+#include "markov_chain.h"
+#include "memory.h"
+#include "model.h"
+#include "native_engine.h"
+#include "prism_results_parser.h"
+#include "transcriber.h"
+#include "transformer.h"
+#include "transient_simulator.h"
+#include "transient_solver.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTextStream>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+
+namespace eval
+{
+using graph::Model;
+using graphInternal::MarkovChain;
+using graphInternal::Transcriber;
+using graphInternal::Transformer;
+using widgets::ErrorHandler;
+
+BatchEvaluator::BatchEvaluator(const Options& options) : mOptions(options)
+{
+    if (mOptions.experimentDoc.isEmpty())
+    {
+        mOptions.experimentDoc = defaultExperiment();
+    }
+}
+
+BatchEvaluator::~BatchEvaluator() = default;
+
+QString
+BatchEvaluator::defaultExperiment()
+{
+    return "const double T;\n"
+           "P=? [ F[T,T] \"systemfailure\" ]\n"
+           "P=? [ F[T,T] \"defective\" ]\n"
+           "P=? [ F[T,T] \"corrupted\" ]\n";
+}
+
+int
+BatchEvaluator::run(const QStringList& models, QTextStream* out)
+{
+    if (mOptions.format == Format::csv && mOptions.header)
+    {
+        *out << "model,property,T,probability\n";
+        out->flush();
+    }
+    if (mOptions.jobs > 1 && models.size() > 1)
+    {
+        return runConcurrently(models, out);
+    }
+
+    int status = 0;
+    for (const QString& model : models)
+    {
+        Results results;
+        if (evaluate(model, &results))
+        {
+            write(model, results, out);
+        }
+        else
+        {
+            status = 1;
+        }
+    }
+    return status;
+}
+
+int
+BatchEvaluator::runConcurrently(const QStringList& models, QTextStream* out)
+{
+    QStringList arguments;
+    arguments << "--batch"
+              << "--no-header"
+              << "--interval"
+              << QString("%1:%2:%3")
+                         .arg(mOptions.interval.from)
+                         .arg(mOptions.interval.steps)
+                         .arg(mOptions.interval.to)
+              << "--format" << (mOptions.format == Format::json ? "json" : "csv");
+    if (!mOptions.experimentPath.isEmpty())
+    {
+        arguments << "--properties" << mOptions.experimentPath;
+    }
+    if (mOptions.forcePrism)
+    {
+        arguments << "--prism";
+    }
+    if (mOptions.rareEvent)
+    {
+        arguments << "--rare-event";
+    }
+    if (mOptions.truncationTolerance > 0.0)
+    {
+        arguments << "--bounded" << QString::number(mOptions.truncationTolerance);
+    }
+
+    // Every model gets its own process: the model type and the error handler are global
+    int status = 0;
+    int next = 0;
+    std::deque<std::unique_ptr<QProcess>> running;
+    while (next < models.size() || !running.empty())
+    {
+        while (next < models.size() && static_cast<int>(running.size()) < mOptions.jobs)
+        {
+            running.emplace_back(new QProcess());
+            running.back()->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+            running.back()->start(QCoreApplication::applicationFilePath(),
+                                  QStringList(arguments) << models[next++]);
+        }
+        // The output is forwarded in order, hence the oldest job is waited for
+        std::unique_ptr<QProcess> job = std::move(running.front());
+        running.pop_front();
+        if (!job->waitForFinished(-1) || job->exitStatus() != QProcess::NormalExit
+            || job->exitCode() != 0)
+        {
+            status = 1;
+        }
+        *out << job->readAllStandardOutput();
+        out->flush();
+    }
+    return status;
+}
+
+bool
+BatchEvaluator::evaluate(const QString& model, Results* results)
+{
+    ErrorHandler::getInstance().clearCollection();
+    utils::LogicModel logic;
+    if (!utils::FileManager::readLogic(model, &logic))
+    {
+        PRINT_ERROR("Failed to read %s : %s",
+                    model.toStdString().c_str(),
+                    ErrorHandler::getInstance().getLatestError().toStdString().c_str());
+        return false;
+    }
+
+    utils::Job job("batch");
+    if (!job.isValid())
+    {
+        return false;
+    }
+    const QString prismModel = job.filePath("model.pm");
+
+    std::unique_ptr<Transcriber> transcriber;
+    Transformer::prepareTranscriber(logic.envNodes, logic.nodes, logic.redundancy,
+                                    prismModel.toStdString(), mOptions.experimentDoc,
+                                    &transcriber);
+    transcriber->buildModel();
+
+    std::vector<std::string> labels;
+    if (!mOptions.forcePrism && Model::getInstance().getType() == Model::CTMC
+        && NativeEngine::supportedProperties(mOptions.experimentDoc, &labels))
+    {
+        MarkovChain chain(logic.nodes,
+                          transcriber->getOperationalFormula(),
+                          transcriber->getLabelFormulas());
+        std::map<std::string, TransientSolver::Curve> curves;
+        TransientSolver::Curve errors;
+        if (chain.isValid() && !mOptions.rareEvent && mOptions.truncationTolerance > 0.0
+            && TransientSolver::solveBounded(chain, mOptions.interval, labels,
+                                             mOptions.truncationTolerance, &curves, &errors))
+        {  // the upper bounds are written as properties of their own
+            for (const std::string& label : labels)
+            {
+                const QString name = QString::fromStdString(label);
+                QList<QPointF>& points = (*results)[name];
+                QList<QPointF>& upper = (*results)[name + " (upper bound)"];
+                for (size_t i = 0; i < curves[label].size(); ++i)
+                {
+                    const auto& point = curves[label][i];
+                    points.append(QPointF(point.first, point.second));
+                    upper.append(QPointF(point.first,
+                                         std::min(1.0, point.second + errors[i].second)));
+                }
+            }
+            return true;
+        }
+        if (chain.isValid() && !mOptions.rareEvent && mOptions.truncationTolerance <= 0.0
+            && chain.build()
+            && TransientSolver(chain).solve(mOptions.interval, labels, &curves))
+        {
+            for (const std::string& label : labels)
+            {
+                QList<QPointF>& points = (*results)[QString::fromStdString(label)];
+                for (const auto& point : curves[label])
+                {
+                    points.append(QPointF(point.first, point.second));
+                }
+            }
+            return true;
+        }
+        TransientSimulator::Options simulation;
+        simulation.importanceSampling = mOptions.rareEvent;
+        std::map<std::string, TransientSimulator::Estimates> estimates;
+        if (chain.isValid() && chain.getStateCount() == 0
+            && TransientSimulator(chain, simulation)
+                       .simulate(mOptions.interval, labels, &estimates))
+        {  // too large to be built (PRISM would not cope either) or rare events
+            if (!mOptions.rareEvent)
+            {
+                PRINT_WARNING("%s, %s was simulated", chain.getError().c_str(),
+                              model.toStdString().c_str());
+            }
+            for (const std::string& label : labels)
+            {
+                QList<QPointF>& points = (*results)[QString::fromStdString(label)];
+                for (const auto& estimate : estimates[label])
+                {
+                    points.append(QPointF(estimate.time, estimate.probability));
+                }
+            }
+            return true;
+        }
+        PRINT_WARNING("Native evaluation of %s failed (%s), falling back to PRISM",
+                      model.toStdString().c_str(), chain.getError().c_str());
+    }
+    std::vector<NativeEngine::Property> properties;
+    if (!mOptions.forcePrism && !mOptions.rareEvent
+        && Model::getInstance().getType() == Model::CTMC
+        && !NativeEngine::supportedProperties(mOptions.experimentDoc, &labels)
+        && NativeEngine::supportedProperties(mOptions.experimentDoc, &properties))
+    {  // long-run properties are solved on the full state space
+        MarkovChain chain(logic.nodes,
+                          transcriber->getOperationalFormula(),
+                          transcriber->getLabelFormulas());
+        if (chain.isValid() && chain.build()
+            && NativeEngine::solve(chain, properties, mOptions.interval, results))
+        {
+            return true;
+        }
+        PRINT_WARNING("Native evaluation of %s failed (%s), falling back to PRISM",
+                      model.toStdString().c_str(), chain.getError().c_str());
+    }
+    return evaluateWithPrism(prismModel, job, results);
+}
+
+bool
+BatchEvaluator::evaluateWithPrism(const QString& prismModel,
+                                  const utils::Job& job,
+                                  Results* results)
+{
+    const QString experimentPath = job.filePath("experiment.pctl");
+    const QString resultsPath = job.filePath("results.txt");
+    QFile experiment(experimentPath);
+    if (!experiment.open(QFile::WriteOnly | QFile::Text | QFile::Truncate))
+    {
+        PRINT_ERROR("Failed to write %s", experimentPath.toStdString().c_str());
+        return false;
+    }
+    experiment.write(mOptions.experimentDoc.toUtf8());
+    experiment.close();
+
+    auto prism = utils::allocateMemoryBlock<utils::Command>(nullptr, "prism");
+    job.attach(prism.get());
+    prism->setArguments(QStringList() << prismModel << experimentPath << "-const"
+                                      << QString::fromStdString(mOptions.interval.toString())
+                                      << "-exportresults" << resultsPath);
+    if (!prism->run())
+    {
+        PRINT_ERROR("Failed to start prism");
+        return false;
+    }
+    prism->waitForFinished(-1);
+    if (prism->exitCode() != 0)
+    {
+        PRINT_ERROR("Prism exited with a status code  : %d ", prism->exitCode());
+        PRINT_ERROR("%s", prism->readAll().toStdString().c_str());
+        return false;
+    }
+
+    PrismResultsParser::ParseError error;
+    return PrismResultsParser::readResults(resultsPath, results, &error);
+}
+
+void
+BatchEvaluator::write(const QString& model, const Results& results, QTextStream* out) const
+{
+    if (mOptions.format == Format::json)
+    {
+        QJsonObject properties;
+        for (auto it = results.begin(); it != results.end(); ++it)
+        {
+            QJsonArray points;
+            for (const QPointF& point : it.value())
+            {
+                points.append(QJsonArray{point.x(), point.y()});
+            }
+            properties.insert(it.key(), points);
+        }
+        QJsonObject object;
+        object.insert("model", model);
+        object.insert("results", properties);
+        *out << QJsonDocument(object).toJson(QJsonDocument::Compact) << "\n";
+    }
+    else
+    {
+        for (auto it = results.begin(); it != results.end(); ++it)
+        {
+            for (const QPointF& point : it.value())
+            {
+                *out << model << "," << it.key() << "," << point.x() << ","
+                     << QString::number(point.y(), 'g', 12) << "\n";
+            }
+        }
+    }
+    out->flush();
+}
+
+}  // namespace eval
@@ -0,0 +1,140 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_BATCH_EVALUATOR_H
+#define ERIS_EVAL_BATCH_EVALUATOR_H
+
+#include "eris_config.h"
+#include "experiment.h"
+
+#include <QList>
+#include <QMap>
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+
+QT_BEGIN_NAMESPACE
+class QTextStream;
+QT_END_NAMESPACE
+
+namespace utils
+{
+class Job;
+}
+
+namespace eval
+{
+/**
+ * Headless evaluation of model files (eris --batch). The models are read into their logic
+ * representation without a scene, transcribed and evaluated by the native engine if possible
+ * and by the prism command line tool otherwise. Only a QCoreApplication is needed.
+ *
+ * Usage scenario:
+ * BatchEvaluator::Options options;
+ * options.experimentDoc = "const double T;\nP=? [ F[T,T] \"systemfailure\" ]";
+ * options.interval = ExperimentInterval(0, 100, 10);
+ * QTextStream out(stdout);
+ * return BatchEvaluator(options).run(modelPaths, &out);
+ */
+class ERIS_EXPORT BatchEvaluator
+{
+public:
+    using Results = QMap<QString, QList<QPointF>>;
+
+    enum class Format
+    {
+        /** model,property,T,probability */
+        csv,
+        /** One object per model and line: {"model":..., "results":{"property":[[T,P],...]}} */
+        json,
+    };
+
+    struct Options
+    {
+        /** Content of the experiment (.pctl) */
+        QString experimentDoc;
+        /** Path of the experiment file, handed to concurrent jobs, empty for the default */
+        QString experimentPath;
+        ExperimentInterval interval;
+        Format format = Format::csv;
+        /** Number of model files evaluated concurrently (in separate processes) */
+        int jobs = 1;
+        /** Use PRISM even if the native engine could answer the experiment */
+        bool forcePrism = false;
+        /** Estimate CTMC experiments by importance sampling, for very small probabilities */
+        bool rareEvent = false;
+        /** Accepted truncation error of a failure depth bounded exploration, 0 for none */
+        double truncationTolerance = 0.0;
+        /** Write the CSV header line */
+        bool header = true;
+    };
+
+    explicit BatchEvaluator(const Options& options);
+    ~BatchEvaluator();
+
+    /**
+     * Evaluates the given model files and writes the results in the order of the files.
+     * Failures are reported on stderr, the remaining files are evaluated nonetheless.
+     * @param models paths to the model files (.xml)
+     * @param out stream the results are written to
+     * @return 0 if all models were evaluated, 1 otherwise
+     */
+    int
+    run(const QStringList& models, QTextStream* out);
+
+    /**
+     * Evaluates a single model file in-process.
+     * @param model path to the model file (.xml)
+     * @param results map the curves are stored in, keyed by property label
+     * @return true on success, false otherwise
+     */
+    bool
+    evaluate(const QString& model, Results* results);
+
+    /**
+     * The experiment used if none is given: systemfailure, defective and corrupted over T.
+     */
+    static QString
+    defaultExperiment();
+
+private:
+    /**
+     * Runs one child process (eris --batch) per model, at most Options::jobs at a time, and
+     * forwards their output in the order of the models.
+     */
+    int
+    runConcurrently(const QStringList& models, QTextStream* out);
+
+    /**
+     * Runs the prism command line tool on the given (.pm) model within the scratch directory of
+     * the job.
+     */
+    bool
+    evaluateWithPrism(const QString& prismModel, const utils::Job& job, Results* results);
+
+    void
+    write(const QString& model, const Results& results, QTextStream* out) const;
+
+    Options mOptions;
+};
+
+}  // namespace eval
+
+#endif /* ERIS_EVAL_BATCH_EVALUATOR_H */
@@ -0,0 +1,343 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "engine_planner.h"
+
+#include "logger.h"
+#include "markov_chain.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace eval
+{
+using graphInternal::MarkovChain;
+
+namespace
+{
+/** Largest failure depth of the bounded exploration */
+constexpr unsigned int kMaxPlanningDepth = 3;
+
+/** Engine thresholds in states, the explicit engine is fastest for small models */
+constexpr double kExplicitLimit = 2e5;
+constexpr double kSparseLimit = 5e6;
+constexpr double kHybridLimit = 2e8;
+
+/** Nanoseconds per transition and iteration of each engine */
+constexpr double kIterationCost[] = {4e-9, 3e-9, 15e-9, 60e-9};
+
+/** Start of the JVM and parsing of the model */
+constexpr double kStartupSeconds = 2.0;
+
+constexpr double kMegabyte = 1024.0 * 1024.0;
+
+/**
+ * Rounds the given number of bytes up to a power of two in MB, at least 512 MB and at most 3/4
+ * of the physical memory if it is known.
+ */
+unsigned int
+memoryLimit(double bytes)
+{
+    double limit = 512.0;
+    while (limit * kMegabyte < bytes && limit < 1024.0 * 1024.0)
+    {
+        limit *= 2.0;
+    }
+#if defined(_SC_PHYS_PAGES) && defined(_SC_PAGE_SIZE)
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pages > 0 && pageSize > 0)
+    {
+        limit = std::min(limit, std::floor(0.75 * pages * (pageSize / kMegabyte)));
+    }
+#endif
+    return static_cast<unsigned int>(std::max(limit, 256.0));
+}
+
+const char*
+engineName(EnginePlanner::Engine engine)
+{
+    switch (engine)
+    {
+        case EnginePlanner::Engine::explicitEngine:
+            return "explicit";
+        case EnginePlanner::Engine::sparse:
+            return "sparse";
+        case EnginePlanner::Engine::hybrid:
+            return "hybrid";
+        case EnginePlanner::Engine::mtbdd:
+            return "mtbdd";
+    }
+    return "hybrid";
+}
+
+/**
+ * Largest sum of the outgoing rates of a state of the built chain.
+ */
+double
+maxExitRate(const MarkovChain& chain)
+{
+    const std::vector<uint64_t>& rowStarts = chain.getRowStarts();
+    const std::vector<double>& rates = chain.getRates();
+    double maximum = 0.0;
+    for (size_t i = 0; i + 1 < rowStarts.size(); ++i)
+    {
+        double exitRate = 0.0;
+        for (uint64_t j = rowStarts[i]; j < rowStarts[i + 1]; ++j)
+        {
+            exitRate += rates[j];
+        }
+        maximum = std::max(maximum, exitRate);
+    }
+    return maximum;
+}
+}  // namespace
+
+std::vector<std::string>
+EnginePlanner::Plan::arguments() const
+{
+    if (!planned)
+    {
+        return {"-javamaxmem", "4g", "-cuddmaxmem", "4g"};
+    }
+    std::vector<std::string> arguments = {"-" + std::string(engineName(engine)),
+                                          "-javamaxmem", std::to_string(javaMemory) + "m",
+                                          "-cuddmaxmem", std::to_string(cuddMemory) + "m"};
+    if (epsilon > 0.0)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%g", epsilon);
+        arguments.push_back("-epsilon");
+        arguments.push_back(buffer);
+    }
+    return arguments;
+}
+
+std::string
+EnginePlanner::Plan::toString() const
+{
+    if (!planned)
+    {
+        return "Engine: PRISM default, no estimate of the state space";
+    }
+    char buffer[512];
+    char tolerance[32] = "default";
+    if (epsilon > 0.0)
+    {
+        std::snprintf(tolerance, sizeof(tolerance), "%g", epsilon);
+    }
+    std::string source;
+    if (exact)
+    {
+        source = "counted";
+    }
+    else if (depth > 0)
+    {
+        source = "extrapolated from the states with at most " + std::to_string(depth)
+                 + " failed nodes";
+    }
+    else
+    {
+        source = "upper bound by the number of nodes";
+    }
+    std::snprintf(buffer, sizeof(buffer),
+                  "Engine: %s, ~%.3g states and ~%.3g transitions (%s)\n"
+                  "Memory: Java %u MB, CUDD %u MB, epsilon %s\n"
+                  "Estimated runtime: %.0f s",
+                  engineName(engine), states, transitions, source.c_str(), javaMemory, cuddMemory,
+                  tolerance, seconds);
+    return buffer;
+}
+
+double
+EnginePlanner::combinations(const std::vector<size_t>& groupSizes,
+                            unsigned int singles,
+                            unsigned int depth)
+{
+    // coefficient i of the generating polynomial counts the combinations with i failed nodes,
+    // a single node contributes 1 + 2x, a group of m nodes sum_j (j+1) x^j (j failed members
+    // are split into defective and corrupted ones)
+    size_t nodes = singles;
+    for (size_t size : groupSizes)
+    {
+        nodes += size;
+    }
+    const size_t degree = std::min<size_t>(depth, nodes);
+    std::vector<double> polynomial(degree + 1, 0.0);
+    polynomial[0] = 1.0;
+    auto multiply = [&](const std::vector<double>& factor) {
+        std::vector<double> product(degree + 1, 0.0);
+        for (size_t i = 0; i <= degree; ++i)
+        {
+            for (size_t j = 0; j < factor.size() && i + j <= degree; ++j)
+            {
+                product[i + j] += polynomial[i] * factor[j];
+            }
+        }
+        polynomial.swap(product);
+    };
+    for (unsigned int i = 0; i < singles; ++i)
+    {
+        multiply({1.0, 2.0});
+    }
+    for (size_t size : groupSizes)
+    {
+        std::vector<double> factor(size + 1);
+        for (size_t j = 0; j <= size; ++j)
+        {
+            factor[j] = static_cast<double>(j + 1);
+        }
+        multiply(factor);
+    }
+    double count = 0.0;
+    for (double coefficient : polynomial)
+    {
+        count += coefficient;
+    }
+    return count;
+}
+
+EnginePlanner::Plan
+EnginePlanner::choose(double states,
+                      double transitions,
+                      double maxExitRate,
+                      const ExperimentInterval& interval)
+{
+    Plan plan;
+    plan.planned = true;
+    plan.states = states;
+    plan.transitions = transitions;
+
+    // explicit vectors of the solution (transient: current, next and result) in C and Java
+    const double vectors = 4.0 * 8.0 * states;
+    if (states <= kExplicitLimit)
+    {
+        plan.engine = Engine::explicitEngine;
+        // states are stored with their hash, transitions as (column, rate)
+        plan.javaMemory = memoryLimit(1.5 * (states * 96.0 + transitions * 16.0 + vectors));
+        plan.cuddMemory = memoryLimit(0.0);
+        // cheap, the results of reliability models are often tiny probabilities
+        plan.epsilon = 1e-10;
+    }
+    else
+    {
+        if (states <= kSparseLimit)
+        {
+            plan.engine = Engine::sparse;
+        }
+        else if (states <= kHybridLimit)
+        {
+            plan.engine = Engine::hybrid;
+        }
+        else
+        {
+            plan.engine = Engine::mtbdd;
+        }
+        plan.javaMemory = memoryLimit(0.0);
+        // the sparse matrix and the vectors are allocated next to the MTBDDs
+        const double matrix = plan.engine == Engine::sparse ? transitions * 12.0 : 0.0;
+        const double symbolic = plan.engine == Engine::mtbdd ? 0.0 : vectors;
+        plan.cuddMemory = memoryLimit(256.0 * kMegabyte + matrix + symbolic);
+        plan.epsilon = plan.engine == Engine::sparse ? 1e-8 : 0.0;
+    }
+
+    // uniformisation: about q*T iterations per time point, the Fox-Glynn window adds ~sqrt(q*T)
+    double iterations = 0.0;
+    for (int t = std::max(interval.from, 0); t <= interval.to; t += std::max(interval.steps, 1))
+    {
+        const double qt = maxExitRate * 1.02 * t;
+        iterations += qt + 3.0 * std::sqrt(qt) + 10.0;
+        if (interval.steps <= 0)
+        {
+            break;
+        }
+    }
+    const double construction = plan.engine == Engine::explicitEngine ? states * 2e-6
+                                                                       : states * 2e-7;
+    plan.seconds = kStartupSeconds + construction
+                   + iterations * transitions * kIterationCost[static_cast<int>(plan.engine)];
+    return plan;
+}
+
+EnginePlanner::Plan
+EnginePlanner::plan(MarkovChain* chain, const ExperimentInterval& interval)
+{
+    if (chain->getStateCount() > 0 || chain->build(kExactLimit))
+    {
+        Plan plan = choose(static_cast<double>(chain->getStateCount()),
+                           static_cast<double>(chain->getTransitionCount()), maxExitRate(*chain),
+                           interval);
+        plan.exact = true;
+        return plan;
+    }
+
+    // the state space is too large to be counted, extrapolate the deepest bounded exploration
+    MarkovChain bounded(*chain);
+    size_t states = 0;
+    size_t transitions = 0;
+    double exitRate = 0.0;
+    unsigned int depth = 0;
+    std::vector<size_t> groupSizes;
+    for (unsigned int d = 1; d <= std::min(kMaxPlanningDepth, chain->getNodeCount()); ++d)
+    {
+        bounded.setFailureDepth(d);
+        if (!bounded.build(kExactLimit))
+        {
+            break;
+        }
+        const bool truncated = bounded.getTruncationState() != MarkovChain::kNoState;
+        states = bounded.getStateCount() - (truncated ? 1 : 0);
+        transitions = bounded.getTransitionCount();
+        exitRate = maxExitRate(bounded);
+        groupSizes = bounded.getLumpedGroupSizes();
+        depth = d;
+    }
+    if (depth == 0)
+    {
+        PRINT_WARNING("Not even the states with a single failed node can be explored");
+        return plan(chain->getNodeCount(), interval);
+    }
+
+    unsigned int singles = chain->getNodeCount();
+    for (size_t size : groupSizes)
+    {
+        singles -= static_cast<unsigned int>(size);
+    }
+    const double scale = combinations(groupSizes, singles, MarkovChain::kUnbounded)
+                         / combinations(groupSizes, singles, depth);
+    Plan plan = choose(states * scale, transitions * scale, exitRate, interval);
+    plan.depth = depth;
+    return plan;
+}
+
+EnginePlanner::Plan
+EnginePlanner::plan(unsigned int nodeCount, const ExperimentInterval& interval)
+{
+    const double states = combinations({}, nodeCount, MarkovChain::kUnbounded);
+    // every node may fail, be attacked and recover, the rates are unknown
+    return choose(states, states * 3.0 * nodeCount, 1.0, interval);
+}
+
+}  // namespace eval
@@ -0,0 +1,155 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_ENGINE_PLANNER_H
+#define ERIS_EVAL_ENGINE_PLANNER_H
+
+#include "experiment.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace graphInternal
+{
+class MarkovChain;
+}
+
+namespace eval
+{
+/**
+ * Chooses the PRISM engine, the memory limits and the termination epsilon of an evaluation from
+ * an estimate of the state space, before PRISM is started.
+ *
+ * Usage scenario:
+ * EnginePlanner::Plan plan = EnginePlanner::plan(chain.get(), interval);
+ * Prism::getInstance()->setPlan(plan);
+ *
+ * The state count is exact if the chain can be explored up to kExactLimit states. Otherwise the
+ * states with at most d defective or corrupted nodes are explored (see
+ * MarkovChain::setFailureDepth()) and extrapolated: the share of reachable states among all
+ * combinations with at most d failed nodes is assumed for the full state space as well. The
+ * combinations take the redundancy structure into account, a group of m interchangeable nodes
+ * has (m+1)(m+2)/2 instead of 3^m states (see MarkovChain::setSymmetryReduction()). Deep failure
+ * combinations are reachable less often than shallow ones, so the estimate rather errs upwards.
+ *
+ * Small models are solved by the explicit engine, medium ones by the sparse engine and large
+ * ones by the hybrid engine, whose vectors are explicit but matrices symbolic. The mtbdd engine
+ * is only chosen if not even the vectors fit into memory. The runtime is estimated from the
+ * uniformisation iterations of the transient analysis, i.e. the maximal exit rate times T summed
+ * over the time points of the experiment.
+ */
+class EnginePlanner
+{
+public:
+    enum class Engine
+    {
+        explicitEngine,
+        sparse,
+        hybrid,
+        mtbdd
+    };
+
+    struct Plan
+    {
+        /** False if nothing was planned, PRISM is started with the settings of previous versions */
+        bool planned = false;
+        Engine engine = Engine::hybrid;
+        /** Estimated number of states and transitions */
+        double states = 0.0;
+        double transitions = 0.0;
+        /** True if the states were counted by a complete exploration */
+        bool exact = false;
+        /** Failure depth of the bounded exploration the estimate is based on */
+        unsigned int depth = 0;
+        /** Memory limits of the JVM and of the CUDD library in MB */
+        unsigned int javaMemory = 4096;
+        unsigned int cuddMemory = 4096;
+        /** Termination criterion of the iterative methods, 0 for the default of PRISM */
+        double epsilon = 0.0;
+        /** Estimated runtime in seconds */
+        double seconds = 0.0;
+
+        /**
+         * Returns the command line arguments of the plan, e.g. -sparse -javamaxmem 1024m ...
+         */
+        std::vector<std::string>
+        arguments() const;
+
+        /**
+         * Returns a human readable description of the plan and the estimates.
+         */
+        std::string
+        toString() const;
+    };
+
+    /** Largest state space that is counted by a complete exploration */
+    static constexpr size_t kExactLimit = 1 << 20;
+
+    /**
+     * Plans the evaluation of a CTMC. The chain is built up to kExactLimit states if it has not
+     * been built yet, the bounded exploration works on a copy.
+     * @param chain markov chain, isValid() must be true
+     * @param interval experiment interval
+     * @return the plan
+     */
+    static Plan
+    plan(graphInternal::MarkovChain* chain, const ExperimentInterval& interval);
+
+    /**
+     * Plans the evaluation of a model without native chain (MDP) from the number of nodes, i.e.
+     * from an upper bound of the state space.
+     * @param nodeCount number of nodes excluding the environment nodes
+     * @param interval experiment interval
+     * @return the plan
+     */
+    static Plan
+    plan(unsigned int nodeCount, const ExperimentInterval& interval);
+
+    /**
+     * Chooses engine, memory limits and epsilon for the given size of the model and estimates
+     * the runtime.
+     * @param states number of states
+     * @param transitions number of transitions
+     * @param maxExitRate largest sum of the outgoing rates of a state (uniformisation rate)
+     * @param interval experiment interval
+     * @return the plan, states and transitions are set, exact and depth are not
+     */
+    static Plan
+    choose(double states,
+           double transitions,
+           double maxExitRate,
+           const ExperimentInterval& interval);
+
+    /**
+     * Counts the combinations of node values with at most the given number of defective or
+     * corrupted nodes, i.e. the unconstrained state space up to that failure depth.
+     * @param groupSizes sizes of the groups of interchangeable nodes
+     * @param singles number of the other nodes
+     * @param depth maximal number of failed nodes
+     * @return number of combinations
+     */
+    static double
+    combinations(const std::vector<size_t>& groupSizes, unsigned int singles, unsigned int depth);
+};
+
+}  // namespace eval
+
+#endif /* ERIS_EVAL_ENGINE_PLANNER_H */
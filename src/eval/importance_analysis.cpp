@@ -0,0 +1,170 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "importance_analysis.h"
+
+#include "logger.h"
+#include "markov_chain.h"
+
+#include <QThread>
+
+#include <algorithm>
+#include <limits>
+
+namespace eval
+{
+using graphInternal::MarkovChain;
+
+ImportanceAnalysis::ImportanceAnalysis() :
+    QObject(nullptr), mThreadPool(), mPending(0), mFailed(false)
+{
+    mThreadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+}
+
+ImportanceAnalysis*
+ImportanceAnalysis::getInstance()
+{
+    static std::unique_ptr<ImportanceAnalysis> instance(new ImportanceAnalysis());
+    return instance.get();
+}
+
+ImportanceAnalysis::~ImportanceAnalysis()
+{
+    mThreadPool.waitForDone();
+}
+
+void
+ImportanceAnalysis::computeMeasures(double probability,
+                                    double failed,
+                                    double perfect,
+                                    Measures* measures)
+{
+    const double undefined = std::numeric_limits<double>::quiet_NaN();
+    measures->probability = probability;
+    measures->birnbaum = failed - perfect;
+    measures->fussellVesely = probability > 0.0 ? (probability - perfect) / probability : undefined;
+    measures->achievementWorth = probability > 0.0 ? failed / probability : undefined;
+    measures->reductionWorth = perfect > 0.0 ? probability / perfect : undefined;
+}
+
+bool
+ImportanceAnalysis::isRunning() const
+{
+    return mPending.load(std::memory_order_acquire) > 0;
+}
+
+std::vector<ImportanceAnalysis::Measures>
+ImportanceAnalysis::getMeasures() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mMeasures;
+}
+
+bool
+ImportanceAnalysis::execute(std::shared_ptr<const MarkovChain> chain,
+                            const std::vector<std::string>& labels,
+                            ExperimentInterval interval,
+                            int failedValue)
+{
+    if (isRunning())
+    {
+        PRINT_WARNING("Previous importance analysis did not finish yet");
+        return false;
+    }
+    if (chain == nullptr || !chain->isValid() || (failedValue != 1 && failedValue != 2))
+    {
+        return false;
+    }
+    mThreadPool.waitForDone();
+
+    const std::vector<unsigned int> nodes = chain->getNodeNumbers();
+    const size_t conditions = 2 * nodes.size() + 1;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mNodes = nodes;
+        mLabels = labels;
+        mCurves.assign(conditions, {});
+        mMeasures.clear();
+    }
+    mFailed.store(false, std::memory_order_seq_cst);
+    mPending.store(static_cast<int>(conditions), std::memory_order_seq_cst);
+    PRINT_INFO("Starting importance analysis of %zu nodes on %d threads",
+               nodes.size(),
+               mThreadPool.maxThreadCount());
+
+    for (size_t condition = 0; condition < conditions; ++condition)
+    {
+        mThreadPool.start([this, chain, labels, interval, failedValue, nodes, condition] {
+            MarkovChain local(*chain);
+            if (condition > 0)
+            {  // odd conditions fix the node failed, even ones perfect
+                const unsigned int node = nodes[(condition - 1) / 2];
+                local.fixNode(node, condition % 2 == 1 ? failedValue : 0);
+            }
+            // every condition owns its slot, mCurves is not resized while running
+            if (!local.build()
+                || !TransientSolver(local).solve(interval, labels, &mCurves[condition]))
+            {
+                PRINT_ERROR("Importance analysis failed : %s", local.getError().c_str());
+                mFailed.store(true, std::memory_order_seq_cst);
+            }
+            finishCondition();
+        });
+    }
+    return true;
+}
+
+void
+ImportanceAnalysis::finishCondition()
+{
+    if (mPending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+    const bool success = !mFailed.load(std::memory_order_acquire);
+    if (success)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            for (const std::string& label : mLabels)
+            {
+                const TransientSolver::Curve& base = mCurves[0][label];
+                const TransientSolver::Curve& failed = mCurves[2 * i + 1][label];
+                const TransientSolver::Curve& perfect = mCurves[2 * i + 2][label];
+                for (size_t j = 0; j < base.size(); ++j)
+                {
+                    Measures measures;
+                    measures.node = mNodes[i];
+                    measures.label = label;
+                    measures.time = base[j].first;
+                    computeMeasures(base[j].second, failed[j].second, perfect[j].second,
+                                    &measures);
+                    mMeasures.push_back(measures);
+                }
+            }
+        }
+        mCurves.clear();
+    }
+    PRINT_INFO("Importance analysis finished");
+    emit analysisFinished(success);
+}
+
+}  // namespace eval
@@ -0,0 +1,167 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_IMPORTANCE_ANALYSIS_H
+#define ERIS_EVAL_IMPORTANCE_ANALYSIS_H
+
+#include "eris_config.h"
+#include "experiment.h"
+#include "transient_solver.h"
+
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace graphInternal
+{
+class MarkovChain;
+}
+
+namespace eval
+{
+/**
+ * Computes the importance of every node for the probabilities of the experiment labels, to
+ * decide where redundancy or security guarantees pay off most. The model is conditioned on the
+ * state of one node at a time: the node is either fixed to be ok (perfect component) or fixed to
+ * its failed state (defective or corrupted) from the start. All 2n + 1 chains (the unconditioned
+ * one included) are built and solved concurrently in a single run.
+ *
+ * With Q the probability of a label, Q+ its probability given the node failed and Q- given the
+ * node is perfect:
+ * - Birnbaum                   Q+ - Q-
+ * - Fussell-Vesely             (Q - Q-) / Q
+ * - Risk Achievement Worth     Q+ / Q
+ * - Risk Reduction Worth       Q / Q-
+ * Measures whose denominator is zero are NaN.
+ *
+ * Usage scenario:
+ * connect(ImportanceAnalysis::getInstance(), &ImportanceAnalysis::analysisFinished, ...);
+ * ImportanceAnalysis::getInstance()->execute(chain, labels, interval, 2);
+ * ... ImportanceAnalysis::getInstance()->getMeasures();
+ */
+class ERIS_EXPORT ImportanceAnalysis : public QObject
+{
+    Q_OBJECT
+
+public:
+    ERIS_DISALLOW_COPY_AND_ASSIGN(ImportanceAnalysis);
+
+    /** Importance of a node for a label at a time point */
+    struct Measures
+    {
+        unsigned int node;
+        std::string label;
+        double time;
+        /** Probability of the label without conditioning */
+        double probability;
+        double birnbaum;
+        double fussellVesely;
+        double achievementWorth;
+        double reductionWorth;
+    };
+
+    static ImportanceAnalysis*
+    getInstance();
+
+    ~ImportanceAnalysis() override;
+
+    /**
+     * Computes the measures from the conditioned probabilities.
+     * @param probability Q
+     * @param failed Q+
+     * @param perfect Q-
+     * @param measures the node, label and time are not touched
+     */
+    static void
+    computeMeasures(double probability, double failed, double perfect, Measures* measures);
+
+    /**
+     * Starts the analysis of all nodes of the chain in the background.
+     * @param chain compiled (not necessarily built) chain of the model, copied per condition
+     * @param labels labels to compute the importance for
+     * @param interval experiment interval
+     * @param failedValue state of a failed node, 1 defective or 2 corrupted
+     * @return true if the analysis was started, false otherwise
+     */
+    bool
+    execute(std::shared_ptr<const graphInternal::MarkovChain> chain,
+            const std::vector<std::string>& labels,
+            ExperimentInterval interval,
+            int failedValue);
+
+    /**
+     * Returns the measures of the last analysis, for every node, label and time point.
+     */
+    std::vector<Measures>
+    getMeasures() const;
+
+    /**
+     * Checks whether an analysis is currently running.
+     * @return true if running, false otherwise
+     */
+    bool
+    isRunning() const;
+
+signals:
+
+    /**
+     * Emitted from a worker thread once all conditions were solved.
+     * @param success false if a condition could not be solved
+     */
+    void
+    analysisFinished(bool success);
+
+private:
+    ImportanceAnalysis();
+
+    /**
+     * Counts a solved condition, the last one computes the measures.
+     */
+    void
+    finishCondition();
+
+    QThreadPool mThreadPool;
+
+    std::atomic_int mPending;
+
+    std::atomic_bool mFailed;
+
+    mutable std::mutex mMutex;
+
+    /** Node numbers of the running analysis */
+    std::vector<unsigned int> mNodes;
+
+    std::vector<std::string> mLabels;
+
+    /** Curves of the conditions: unconditioned, then failed and perfect per node */
+    std::vector<std::map<std::string, TransientSolver::Curve>> mCurves;
+
+    std::vector<Measures> mMeasures;
+};
+
+}  // namespace eval
+
+#endif /* ERIS_EVAL_IMPORTANCE_ANALYSIS_H */
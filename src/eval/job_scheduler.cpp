@@ -0,0 +1,397 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "job_scheduler.h"
+
+#include "logger.h"
+
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+
+namespace eval
+{
+JobScheduler::Context::Context(JobScheduler* scheduler, Id id, const std::atomic_bool* cancelled) :
+    mScheduler(scheduler), mId(id), mCancelled(cancelled)
+{
+}
+
+bool
+JobScheduler::Context::isCancelled() const
+{
+    return mCancelled->load(std::memory_order_acquire);
+}
+
+const std::atomic_bool*
+JobScheduler::Context::cancelled() const
+{
+    return mCancelled;
+}
+
+void
+JobScheduler::Context::setProgress(int percent)
+{
+    mScheduler->setProgress(mId, percent);
+}
+
+JobScheduler::JobScheduler() :
+    QObject(nullptr), mThreadPool(), mLock(), mJobs(), mNextId(1), mPending(0)
+{
+    qRegisterMetaType<eval::JobScheduler::Info>("eval::JobScheduler::Info");
+    mThreadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+}
+
+JobScheduler*
+JobScheduler::getInstance()
+{
+    static std::unique_ptr<JobScheduler> instance(new JobScheduler());
+    return instance.get();
+}
+
+JobScheduler::~JobScheduler()
+{
+    cancelAll();
+    mThreadPool.waitForDone();
+}
+
+const char*
+JobScheduler::toString(State state)
+{
+    switch (state)
+    {
+        case State::waiting: return "waiting";
+        case State::queued: return "queued";
+        case State::running: return "running";
+        case State::finished: return "finished";
+        case State::failed: return "failed";
+        case State::cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+bool
+JobScheduler::isDone(State state)
+{
+    return state == State::finished || state == State::failed || state == State::cancelled;
+}
+
+JobScheduler::Id
+JobScheduler::submit(const QString& name,
+                     Work work,
+                     int priority,
+                     const std::vector<Id>& dependencies)
+{
+    auto job = std::make_shared<Job>();
+    Id id = 0;
+    std::vector<Info> changed;
+    bool idle = false;
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        id = mNextId++;
+        job->info.id = id;
+        job->info.name = name;
+        job->info.priority = priority;
+        job->work = std::move(work);
+        mJobs[id] = job;
+        ++mPending;
+
+        bool dependencyFailed = false;
+        for (Id dependency : dependencies)
+        {
+            auto it = mJobs.find(dependency);
+            if (it == mJobs.end())
+            {  // its result is not known (any more)
+                PRINT_WARNING("Job %s depends on the unknown job %llu", name.toStdString().c_str(),
+                              static_cast<unsigned long long>(dependency));
+                dependencyFailed = true;
+                continue;
+            }
+            const State state = it->second->info.state;
+            if (state == State::finished)
+            {
+                continue;
+            }
+            if (isDone(state))
+            {
+                dependencyFailed = true;
+                continue;
+            }
+            ++job->pending;
+            it->second->dependents.push_back(id);
+        }
+
+        if (dependencyFailed)
+        {
+            cancelLocked(job, &changed);
+            idle = mPending == 0;
+        }
+        else
+        {
+            if (job->pending == 0)
+            {
+                dispatch(job);
+            }
+            changed.push_back(job->info);
+        }
+        pruneLocked();
+    }
+    notify(changed, idle);
+    return id;
+}
+
+void
+JobScheduler::dispatch(const std::shared_ptr<Job>& job)
+{
+    job->info.state = State::queued;
+    ++job->info.sequence;
+    mThreadPool.start([this, job] { run(job); }, job->info.priority);
+}
+
+void
+JobScheduler::run(const std::shared_ptr<Job>& job)
+{
+    Info snapshot;
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        if (job->info.state != State::queued)
+        {  // cancelled before it was started
+            return;
+        }
+        job->info.state = State::running;
+        ++job->info.sequence;
+        snapshot = job->info;
+    }
+    emit jobChanged(snapshot);
+
+    Context context(this, snapshot.id, &job->cancelled);
+    const bool success = job->work(context);
+
+    std::vector<Info> changed;
+    bool idle = false;
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        job->work = nullptr;
+        job->info.state = job->cancelled.load(std::memory_order_acquire)
+                                  ? State::cancelled
+                                  : (success ? State::finished : State::failed);
+        ++job->info.sequence;
+        --mPending;
+        changed.push_back(job->info);
+        for (Id id : job->dependents)
+        {
+            auto it = mJobs.find(id);
+            if (it == mJobs.end() || isDone(it->second->info.state))
+            {  // cancelled (and possibly forgotten) before
+                continue;
+            }
+            const std::shared_ptr<Job>& dependent = it->second;
+            if (job->info.state != State::finished)
+            {  // its input is missing
+                cancelLocked(dependent, &changed);
+            }
+            else if (--dependent->pending == 0)
+            {
+                dispatch(dependent);
+                changed.push_back(dependent->info);
+            }
+        }
+        job->dependents.clear();
+        idle = mPending == 0;
+        pruneLocked();
+    }
+    mJobDone.notify_all();
+    PRINT_INFO("Job %s %s", snapshot.name.toStdString().c_str(),
+               toString(changed.front().state));
+    notify(changed, idle);
+}
+
+void
+JobScheduler::cancelLocked(const std::shared_ptr<Job>& job, std::vector<Info>* changed)
+{
+    if (isDone(job->info.state) || job->cancelled.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    job->cancelled.store(true, std::memory_order_release);
+    if (job->info.state != State::running)
+    {  // a running job is cancelled once its work returned
+        job->info.state = State::cancelled;
+        ++job->info.sequence;
+        job->work = nullptr;
+        --mPending;
+        changed->push_back(job->info);
+        mJobDone.notify_all();
+    }
+    for (Id id : job->dependents)
+    {
+        auto it = mJobs.find(id);
+        if (it != mJobs.end())
+        {
+            cancelLocked(it->second, changed);
+        }
+    }
+}
+
+void
+JobScheduler::cancel(Id id)
+{
+    std::vector<Info> changed;
+    bool idle = false;
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        auto it = mJobs.find(id);
+        if (it == mJobs.end())
+        {
+            return;
+        }
+        cancelLocked(it->second, &changed);
+        idle = mPending == 0 && !changed.empty();
+        pruneLocked();
+    }
+    notify(changed, idle);
+}
+
+void
+JobScheduler::cancelAll()
+{
+    std::vector<Info> changed;
+    bool idle = false;
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        for (auto& entry : mJobs)
+        {
+            cancelLocked(entry.second, &changed);
+        }
+        idle = mPending == 0 && !changed.empty();
+        pruneLocked();
+    }
+    notify(changed, idle);
+}
+
+void
+JobScheduler::setProgress(Id id, int percent)
+{
+    Info snapshot;
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        auto it = mJobs.find(id);
+        if (it == mJobs.end())
+        {
+            return;
+        }
+        it->second->info.progress = std::min(100, std::max(0, percent));
+        ++it->second->info.sequence;
+        snapshot = it->second->info;
+    }
+    emit jobChanged(snapshot);
+}
+
+void
+JobScheduler::pruneLocked()
+{
+    // mJobs is ordered by id, i.e. the oldest jobs come first
+    auto it = mJobs.begin();
+    while (mJobs.size() - mPending > kKeptJobs && it != mJobs.end())
+    {
+        it = isDone(it->second->info.state) ? mJobs.erase(it) : std::next(it);
+    }
+}
+
+void
+JobScheduler::notify(const std::vector<Info>& changed, bool idle)
+{
+    for (const Info& info : changed)
+    {
+        emit jobChanged(info);
+    }
+    if (idle)
+    {
+        emit allDone();
+    }
+}
+
+JobScheduler::State
+JobScheduler::state(Id id) const
+{
+    std::lock_guard<std::mutex> guard(mLock);
+    auto it = mJobs.find(id);
+    return it == mJobs.end() ? State::cancelled : it->second->info.state;
+}
+
+std::vector<JobScheduler::Info>
+JobScheduler::pendingJobs() const
+{
+    std::lock_guard<std::mutex> guard(mLock);
+    std::vector<Info> jobs;
+    for (const auto& entry : mJobs)
+    {
+        if (!isDone(entry.second->info.state))
+        {
+            jobs.push_back(entry.second->info);
+        }
+    }
+    return jobs;
+}
+
+bool
+JobScheduler::isRunning() const
+{
+    std::lock_guard<std::mutex> guard(mLock);
+    return mPending > 0;
+}
+
+void
+JobScheduler::setMaxThreadCount(int count)
+{
+    mThreadPool.setMaxThreadCount(std::max(1, count));
+}
+
+bool
+JobScheduler::waitForDone(int msecs)
+{
+    // waiting jobs are dispatched by the job they depend on before its worker is released
+    return mThreadPool.waitForDone(msecs);
+}
+
+bool
+JobScheduler::wait(const std::vector<Id>& ids, int msecs)
+{
+    auto done = [this, &ids] {
+        for (Id id : ids)
+        {
+            auto it = mJobs.find(id);
+            if (it != mJobs.end() && !isDone(it->second->info.state))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    std::unique_lock<std::mutex> guard(mLock);
+    if (msecs < 0)
+    {
+        mJobDone.wait(guard, done);
+        return true;
+    }
+    return mJobDone.wait_for(guard, std::chrono::milliseconds(msecs), done);
+}
+
+}  // namespace eval
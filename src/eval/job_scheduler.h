@@ -0,0 +1,298 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_JOB_SCHEDULER_H
+#define ERIS_EVAL_JOB_SCHEDULER_H
+
+#include "eris_config.h"
+
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace eval
+{
+/**
+ * Runs the jobs of an evaluation (submodules, time steps, ...) on a bounded pool of worker
+ * threads. Jobs form a DAG: a job is queued once all its dependencies finished, it is cancelled
+ * if one of them failed or was cancelled. Queued jobs are started in the order of their priority,
+ * jobs of equal priority in the order they were submitted. Every job can be cancelled on its own,
+ * the work of a running job polls its context and stops (e.g. kills its process) once cancelled.
+ * Every change of a job is signalled, e.g. to list the jobs in the widgets::WorkingDialog.
+ *
+ * Usage scenario:
+ * auto scheduler = JobScheduler::getInstance();
+ * JobScheduler::Id sub = scheduler->submit("Submodule a.xml", [](JobScheduler::Context& context) {
+ *     return Prism::getInstance()->extractSubmoduleFailureRates(..., context.cancelled());
+ * }, 1);
+ * scheduler->submit("Parent", [](JobScheduler::Context&) { ... return true; }, 0, {sub});
+ */
+class ERIS_EXPORT JobScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    ERIS_DISALLOW_COPY_AND_ASSIGN(JobScheduler);
+
+    using Id = quint64;
+
+    enum class State
+    {
+        /** Waits for its dependencies */
+        waiting,
+        /** Waits for a worker thread */
+        queued,
+        running,
+        finished,
+        failed,
+        cancelled,
+    };
+
+    /** Snapshot of a job */
+    struct Info
+    {
+        Id id = 0;
+        QString name;
+        int priority = 0;
+        State state = State::waiting;
+        /** Progress in percent, -1 if the job does not report any */
+        int progress = -1;
+        /**
+         * Increases with every change of the job. The changes are signalled by different threads,
+         * a snapshot with a lower sequence than one received before is outdated.
+         */
+        quint64 sequence = 0;
+    };
+
+    /**
+     * Handed to the work of a job, to report progress and to check for cancellation.
+     */
+    class Context
+    {
+    public:
+        /**
+         * @return true once the job was cancelled, the work should return as soon as possible
+         */
+        bool
+        isCancelled() const;
+
+        /**
+         * @return cancellation flag of the job, e.g. for utils::Command::waitUntilFinished()
+         */
+        const std::atomic_bool*
+        cancelled() const;
+
+        /**
+         * Reports the progress of the job.
+         * @param percent progress in [0, 100]
+         */
+        void
+        setProgress(int percent);
+
+    private:
+        friend class JobScheduler;
+        Context(JobScheduler* scheduler, Id id, const std::atomic_bool* cancelled);
+
+        JobScheduler* mScheduler;
+        Id mId;
+        const std::atomic_bool* mCancelled;
+    };
+
+    /** Work of a job, runs on a worker thread and returns false if it failed */
+    using Work = std::function<bool(Context&)>;
+
+    static JobScheduler*
+    getInstance();
+
+    ~JobScheduler() override;
+
+    /**
+     * Submits a job. It is queued at once if it has no pending dependencies.
+     * @param name shown to the user, e.g. in the working dialog
+     * @param work work of the job
+     * @param priority jobs of higher priority are started first
+     * @param dependencies jobs that must finish before this one starts, the job is cancelled
+     * if one of them is unknown
+     * @return id of the job
+     */
+    Id
+    submit(const QString& name,
+           Work work,
+           int priority = 0,
+           const std::vector<Id>& dependencies = {});
+
+    /**
+     * Cancels the job and, transitively, all jobs depending on it. Queued jobs never start,
+     * running jobs are asked to stop.
+     */
+    void
+    cancel(Id id);
+
+    /**
+     * Cancels all jobs that are not done yet.
+     */
+    void
+    cancelAll();
+
+    /**
+     * @return state of the job, cancelled for unknown jobs (done jobs are forgotten once
+     * kKeptJobs newer ones are done)
+     */
+    State
+    state(Id id) const;
+
+    /**
+     * @return snapshots of all jobs that are not done yet, in the order they were submitted
+     */
+    std::vector<Info>
+    pendingJobs() const;
+
+    /**
+     * Checks whether any job is not done yet.
+     * @return true if running, false otherwise
+     */
+    bool
+    isRunning() const;
+
+    /**
+     * Sets the number of worker threads, by default the number of cores.
+     */
+    void
+    setMaxThreadCount(int count);
+
+    /**
+     * Blocks until all jobs are done. Must not be called from within a job.
+     * @param msecs timeout, -1 to wait forever
+     * @return false on a timeout
+     */
+    bool
+    waitForDone(int msecs = -1);
+
+    /**
+     * Blocks until the given jobs are done, e.g. after cancelling the jobs of a closed module.
+     * Must not be called from within a job.
+     * @param ids jobs to wait for
+     * @param msecs timeout, -1 to wait forever
+     * @return false on a timeout
+     */
+    bool
+    wait(const std::vector<Id>& ids, int msecs = -1);
+
+    static const char*
+    toString(State state);
+
+    /**
+     * @return true for finished, failed and cancelled jobs
+     */
+    static bool
+    isDone(State state);
+
+    /** Number of done jobs whose state is kept, see state() */
+    static constexpr size_t kKeptJobs = 256;
+
+signals:
+
+    /**
+     * Emitted from the thread that changed the job (state or progress).
+     */
+    void
+    jobChanged(const eval::JobScheduler::Info& info);
+
+    /**
+     * Emitted once the last pending job is done.
+     */
+    void
+    allDone();
+
+private:
+    struct Job
+    {
+        Info info;
+        Work work;
+        std::atomic_bool cancelled{false};
+        /** Number of dependencies that did not finish yet */
+        size_t pending = 0;
+        std::vector<Id> dependents;
+    };
+
+    JobScheduler();
+
+    /**
+     * Hands the job to the pool, mLock must be held.
+     */
+    void
+    dispatch(const std::shared_ptr<Job>& job);
+
+    /**
+     * Runs the job on a worker thread and releases or cancels its dependents.
+     */
+    void
+    run(const std::shared_ptr<Job>& job);
+
+    /**
+     * Marks the job and its dependents as cancelled, mLock must be held.
+     * @param changed filled with the snapshots to signal once mLock is released
+     */
+    void
+    cancelLocked(const std::shared_ptr<Job>& job, std::vector<Info>* changed);
+
+    /**
+     * Sets the progress of a job, see Context::setProgress().
+     */
+    void
+    setProgress(Id id, int percent);
+
+    /**
+     * Forgets the oldest done jobs beyond kKeptJobs, mLock must be held.
+     */
+    void
+    pruneLocked();
+
+    /**
+     * Signals the changes and allDone(), mLock must not be held.
+     * @param changed snapshots of the changed jobs
+     * @param idle true if the changes completed the last pending job
+     */
+    void
+    notify(const std::vector<Info>& changed, bool idle);
+
+    QThreadPool mThreadPool;
+    mutable std::mutex mLock;
+    /** Notified whenever a job is done, see wait() */
+    std::condition_variable mJobDone;
+    std::map<Id, std::shared_ptr<Job>> mJobs;
+    Id mNextId;
+    size_t mPending;
+};
+
+}  // namespace eval
+
+Q_DECLARE_METATYPE(eval::JobScheduler::Info)
+
+#endif  // ERIS_EVAL_JOB_SCHEDULER_H
@@ -0,0 +1,382 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "native_engine.h"
+
+#include "logger.h"
+#include "markov_chain.h"
+#include "prism_results_parser.h"
+#include "steady_state_solver.h"
+#include "evaluation_tab.h"
+#include "chart_view.h"
+
+#include <QRegularExpression>
+#include <QStringList>
+
+#include <algorithm>
+
+namespace eval
+{
+using graphInternal::MarkovChain;
+using widgets::EvaluationTab;
+
+NativeEngine::NativeEngine() : QObject(nullptr), mThreadPool(), mDone(true)
+{
+}
+
+NativeEngine*
+NativeEngine::getInstance()
+{
+    static std::unique_ptr<NativeEngine> instance(new NativeEngine());
+    return instance.get();
+}
+
+NativeEngine::~NativeEngine()
+{
+    mThreadPool.waitForDone();
+}
+
+bool
+NativeEngine::supportedProperties(const QString& experimentDoc, std::vector<std::string>* labels)
+{
+    static const QRegularExpression property(
+            R"(^P\s*=\s*\?\s*\[\s*F\s*\[\s*T\s*,\s*T\s*\]\s*"(\w+)"\s*\]$)");
+    labels->clear();
+    for (const QString& line : experimentDoc.split("\n"))
+    {
+        QString token = line.simplified();
+        if (token.isEmpty() || token.startsWith("//") || token == "const double T;")
+        {
+            continue;
+        }
+        QRegularExpressionMatch match = property.match(token);
+        if (!match.hasMatch())
+        {
+            PRINT_INFO("Property not supported by the native engine : %s",
+                       token.toStdString().c_str());
+            return false;
+        }
+        labels->push_back(match.captured(1).toStdString());
+    }
+    return !labels->empty();
+}
+
+bool
+NativeEngine::supportedProperties(const QString& experimentDoc, std::vector<Property>* properties)
+{
+    static const QRegularExpression transient(
+            R"(^P\s*=\s*\?\s*\[\s*F\s*\[\s*T\s*,\s*T\s*\]\s*"(\w+)"\s*\]$)");
+    static const QRegularExpression steadyState(R"(^S\s*=\s*\?\s*\[\s*"(\w+)"\s*\]$)");
+    static const QRegularExpression meanTime(
+            R"(^R\s*\{\s*"time"\s*\}\s*=\s*\?\s*\[\s*F\s*"(\w+)"\s*\]$)");
+    properties->clear();
+    for (const QString& line : experimentDoc.split("\n"))
+    {
+        QString token = line.simplified();
+        if (token.isEmpty() || token.startsWith("//") || token == "const double T;")
+        {
+            continue;
+        }
+        QRegularExpressionMatch match;
+        if ((match = transient.match(token)).hasMatch())
+        {
+            properties->push_back({PropertyKind::transient, match.captured(1).toStdString()});
+        }
+        else if ((match = steadyState.match(token)).hasMatch())
+        {
+            properties->push_back({PropertyKind::steadyState, match.captured(1).toStdString()});
+        }
+        else if ((match = meanTime.match(token)).hasMatch())
+        {
+            properties->push_back({PropertyKind::meanTime, match.captured(1).toStdString()});
+        }
+        else
+        {
+            PRINT_INFO("Property not supported by the native engine : %s",
+                       token.toStdString().c_str());
+            return false;
+        }
+    }
+    return !properties->empty();
+}
+
+bool
+NativeEngine::solve(const MarkovChain& chain,
+                    const std::vector<Property>& properties,
+                    ExperimentInterval interval,
+                    QMap<QString, QList<QPointF>>* results)
+{
+    std::vector<std::string> transientLabels;
+    std::vector<std::string> steadyStateLabels;
+    std::vector<std::string> meanTimeLabels;
+    for (const Property& property : properties)
+    {
+        switch (property.kind)
+        {
+            case PropertyKind::transient:
+                transientLabels.push_back(property.label);
+                break;
+            case PropertyKind::steadyState:
+                steadyStateLabels.push_back(property.label);
+                break;
+            case PropertyKind::meanTime:
+                meanTimeLabels.push_back(property.label);
+                break;
+        }
+    }
+
+    std::map<std::string, TransientSolver::Curve> curves;
+    if (!transientLabels.empty()
+        && !TransientSolver(chain).solve(interval, transientLabels, &curves))
+    {
+        return false;
+    }
+    SteadyStateSolver solver(chain);
+    std::map<std::string, double> steadyState;
+    std::map<std::string, double> meanTime;
+    if (!solver.steadyState(steadyStateLabels, &steadyState)
+        || !solver.meanTime(meanTimeLabels, &meanTime))
+    {
+        return false;
+    }
+
+    for (const Property& property : properties)
+    {
+        const QString label = QString::fromStdString(property.label);
+        if (property.kind == PropertyKind::transient)
+        {
+            QList<QPointF>& points = (*results)[label];
+            for (const auto& point : curves[property.label])
+            {
+                points.append(QPointF(point.first, point.second));
+            }
+            continue;
+        }
+        const bool steady = property.kind == PropertyKind::steadyState;
+        const double value = steady ? steadyState[property.label] : meanTime[property.label];
+        PRINT_INFO("%s %s : %g", steady ? "Long-run probability of" : "Mean time to",
+                   property.label.c_str(), value);
+        QList<QPointF>& points = (*results)[(steady ? "S " : "MTTF ") + label];
+        points.append(QPointF(interval.from, value));
+        points.append(QPointF(interval.to, value));
+    }
+    return true;
+}
+
+bool
+NativeEngine::begin()
+{
+    if (!mDone.load(std::memory_order_acquire))
+    {
+        PRINT_WARNING("Previous native evaluation did not finish yet");
+        return false;
+    }
+    mDone.store(false, std::memory_order_seq_cst);
+    mThreadPool.waitForDone();
+
+    // This is needed to clear the plot
+    EvaluationTab::Get()->view()->clear();
+    return true;
+}
+
+void
+NativeEngine::publish(const std::vector<std::string>& labels,
+                      std::map<std::string, TransientSolver::Curve>& curves)
+{
+    QMap<QString, QList<QPointF>> results;
+    for (const std::string& label : labels)
+    {  // keep the order of the experiment
+        QList<QPointF>& points = results[QString::fromStdString(label)];
+        for (const auto& point : curves[label])
+        {
+            points.append(QPointF(point.first, point.second));
+        }
+    }
+    PrismResultsParser::Get()->publish(results);
+}
+
+bool
+NativeEngine::execute(std::shared_ptr<MarkovChain> chain,
+                      const std::vector<std::string>& labels,
+                      ExperimentInterval interval)
+{
+    if (!begin())
+    {
+        return false;
+    }
+
+    mThreadPool.start([=] {
+        TransientSolver solver(*chain);
+        std::map<std::string, TransientSolver::Curve> curves;
+        if (solver.solve(interval, labels, &curves))
+        {
+            publish(labels, curves);
+        }
+        else
+        {
+            PRINT_ERROR("Native evaluation failed");
+        }
+        mDone.store(true, std::memory_order_seq_cst);
+    });
+    return true;
+}
+
+bool
+NativeEngine::execute(std::shared_ptr<MarkovChain> chain,
+                      const std::vector<Property>& properties,
+                      ExperimentInterval interval)
+{
+    if (!begin())
+    {
+        return false;
+    }
+
+    mThreadPool.start([=] {
+        QMap<QString, QList<QPointF>> results;
+        if (solve(*chain, properties, interval, &results))
+        {
+            PrismResultsParser::Get()->publish(results);
+        }
+        else
+        {
+            PRINT_ERROR("Native evaluation failed");
+        }
+        mDone.store(true, std::memory_order_seq_cst);
+    });
+    return true;
+}
+
+bool
+NativeEngine::execute(std::vector<TransientSolver::Segment> segments,
+                      const std::vector<std::string>& labels)
+{
+    if (!begin())
+    {
+        return false;
+    }
+
+    mThreadPool.start([this, segments, labels]() mutable {
+        std::map<std::string, TransientSolver::Curve> curves;
+        if (TransientSolver::solvePiecewise(std::move(segments), labels, &curves))
+        {
+            publish(labels, curves);
+        }
+        else
+        {
+            PRINT_ERROR("Native evaluation failed");
+        }
+        mDone.store(true, std::memory_order_seq_cst);
+    });
+    return true;
+}
+
+bool
+NativeEngine::executeBounded(std::shared_ptr<MarkovChain> chain,
+                             const std::vector<std::string>& labels,
+                             ExperimentInterval interval,
+                             double tolerance)
+{
+    if (!begin())
+    {
+        return false;
+    }
+
+    mThreadPool.start([=] {
+        // the shared chain keeps its full state space
+        MarkovChain bounded(*chain);
+        std::map<std::string, TransientSolver::Curve> curves;
+        TransientSolver::Curve errors;
+        if (TransientSolver::solveBounded(bounded, interval, labels, tolerance, &curves, &errors))
+        {
+            QMap<QString, QList<QPointF>> results;
+            for (const std::string& label : labels)
+            {
+                const QString name = QString::fromStdString(label);
+                QList<QPointF>& points = results[name];
+                QList<QPointF>& upper = results[name + " (upper bound)"];
+                for (size_t i = 0; i < curves[label].size(); ++i)
+                {
+                    const auto& point = curves[label][i];
+                    points.append(QPointF(point.first, point.second));
+                    upper.append(QPointF(point.first,
+                                         std::min(1.0, point.second + errors[i].second)));
+                }
+            }
+            PrismResultsParser::Get()->publish(results);
+        }
+        else
+        {
+            PRINT_ERROR("Native evaluation failed");
+        }
+        mDone.store(true, std::memory_order_seq_cst);
+    });
+    return true;
+}
+
+bool
+NativeEngine::simulate(std::shared_ptr<MarkovChain> chain,
+                       const std::vector<std::string>& labels,
+                       ExperimentInterval interval,
+                       TransientSimulator::Options options)
+{
+    if (!begin())
+    {
+        return false;
+    }
+
+    mThreadPool.start([=] {
+        // the simulation starts threads of its own
+        TransientSimulator simulator(*chain, options);
+        std::map<std::string, TransientSimulator::Estimates> estimates;
+        if (simulator.simulate(interval, labels, &estimates))
+        {
+            const QString level = QString::number(options.confidence * 100) + "%";
+            QMap<QString, QList<QPointF>> results;
+            for (const std::string& label : labels)
+            {
+                const QString name = QString::fromStdString(label);
+                QList<QPointF>& points = results[name];
+                QList<QPointF>& lower = results[name + " (" + level + " lower)"];
+                QList<QPointF>& upper = results[name + " (" + level + " upper)"];
+                for (const auto& estimate : estimates[label])
+                {
+                    points.append(QPointF(estimate.time, estimate.probability));
+                    lower.append(QPointF(estimate.time, estimate.lower));
+                    upper.append(QPointF(estimate.time, estimate.upper));
+                }
+            }
+            PrismResultsParser::Get()->publish(results);
+        }
+        else
+        {
+            PRINT_ERROR("Simulation failed");
+        }
+        mDone.store(true, std::memory_order_seq_cst);
+    });
+    return true;
+}
+
+bool
+NativeEngine::isRunning() const
+{
+    return !mDone.load(std::memory_order_acquire);
+}
+
+}  // namespace eval
@@ -0,0 +1,221 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_NATIVE_ENGINE_H
+#define ERIS_EVAL_NATIVE_ENGINE_H
+
+#include "eris_config.h"
+#include "experiment.h"
+#include "transient_simulator.h"
+#include "transient_solver.h"
+
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QPointF>
+#include <QString>
+#include <QThreadPool>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace graphInternal
+{
+class MarkovChain;
+}
+
+namespace eval
+{
+/**
+ * In-process alternative to the prism command line tool for CTMC experiments.
+ *
+ * Usage scenario:
+ * std::vector<std::string> labels;
+ * if (NativeEngine::supportedProperties(experimentDoc, &labels) && chain->build())
+ *     NativeEngine::getInstance()->execute(chain, labels, interval);
+ *
+ * The transient analysis runs in a background thread, the results are published via the
+ * PrismResultsParser observers just like the results of a PRISM run.
+ */
+class ERIS_EXPORT NativeEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    ERIS_DISALLOW_COPY_AND_ASSIGN(NativeEngine);
+
+    static NativeEngine*
+    getInstance();
+
+    ~NativeEngine() override;
+
+    /**
+     * Checks whether the experiment only consists of properties the native engine can answer,
+     * i.e. P=? [ F[T,T] "label" ], and collects the labels.
+     * @param experimentDoc content of the experiment (.pctl)
+     * @param labels vector the requested labels are stored in
+     * @return true if supported, false otherwise
+     */
+    static bool
+    supportedProperties(const QString& experimentDoc, std::vector<std::string>* labels);
+
+    /** Kinds of properties the native engine can answer */
+    enum class PropertyKind
+    {
+        transient,    // P=? [ F[T,T] "label" ]
+        steadyState,  // S=? [ "label" ]
+        meanTime      // R{"time"}=? [ F "label" ]
+    };
+
+    struct Property
+    {
+        PropertyKind kind;
+        std::string label;
+    };
+
+    /**
+     * Checks whether the experiment only consists of properties the native engine can answer,
+     * including the long-run properties of the SteadyStateSolver, and collects them.
+     * @param experimentDoc content of the experiment (.pctl)
+     * @param properties vector the requested properties are stored in
+     * @return true if supported, false otherwise
+     */
+    static bool
+    supportedProperties(const QString& experimentDoc, std::vector<Property>* properties);
+
+    /**
+     * Solves the given properties on a (built) chain in the calling thread. Transient properties
+     * are named by their label, long-run properties by "S label" and "MTTF label" and plotted as
+     * constant curves over the interval.
+     * @param chain markov chain, build() must have succeeded
+     * @param properties properties to solve
+     * @param interval experiment interval
+     * @param results map the curves are stored in, keyed by property name
+     * @return true on success, false otherwise
+     */
+    static bool
+    solve(const graphInternal::MarkovChain& chain,
+          const std::vector<Property>& properties,
+          ExperimentInterval interval,
+          QMap<QString, QList<QPointF>>* results);
+
+    /**
+     * Starts the transient analysis of the given (built) chain in the background.
+     * @param chain markov chain, build() must have succeeded
+     * @param labels labels to compute the probabilities for
+     * @param interval experiment interval
+     * @return true if the analysis was started, false otherwise
+     */
+    bool
+    execute(std::shared_ptr<graphInternal::MarkovChain> chain,
+            const std::vector<std::string>& labels,
+            ExperimentInterval interval);
+
+    /**
+     * Starts the analysis of transient and long-run properties of the given (built) chain in the
+     * background, see solve().
+     * @param chain markov chain, build() must have succeeded
+     * @param properties properties to solve
+     * @param interval experiment interval
+     * @return true if the analysis was started, false otherwise
+     */
+    bool
+    execute(std::shared_ptr<graphInternal::MarkovChain> chain,
+            const std::vector<Property>& properties,
+            ExperimentInterval interval);
+
+    /**
+     * Starts the transient analysis of a model with time dependent rates in the background,
+     * see TransientSolver::solvePiecewise(). The chains are built by the analysis.
+     * @param segments time points in ascending order and the chains valid up to them
+     * @param labels labels to compute the probabilities for
+     * @return true if the analysis was started, false otherwise
+     */
+    bool
+    execute(std::vector<TransientSolver::Segment> segments,
+            const std::vector<std::string>& labels);
+
+    /**
+     * Starts the transient analysis on failure depth bounded state spaces in the background,
+     * see TransientSolver::solveBounded(). Besides the results, their upper bounds (result plus
+     * truncation error) are published as curves of their own.
+     * @param chain markov chain, isValid() must be true, a copy is built
+     * @param labels labels to compute the probabilities for
+     * @param interval experiment interval
+     * @param tolerance accepted truncation error
+     * @return true if the analysis was started, false otherwise
+     */
+    bool
+    executeBounded(std::shared_ptr<graphInternal::MarkovChain> chain,
+                   const std::vector<std::string>& labels,
+                   ExperimentInterval interval,
+                   double tolerance);
+
+    /**
+     * Starts the statistical model checking of the given (compiled) chain in the background, for
+     * models too large to be built. Besides the estimates, the bounds of their confidence
+     * intervals are published as curves of their own.
+     * @param chain markov chain, isValid() must be true
+     * @param labels labels to estimate the probabilities for
+     * @param interval experiment interval
+     * @param options confidence, precision and threads of the simulation
+     * @return true if the simulation was started, false otherwise
+     */
+    bool
+    simulate(std::shared_ptr<graphInternal::MarkovChain> chain,
+             const std::vector<std::string>& labels,
+             ExperimentInterval interval,
+             TransientSimulator::Options options);
+
+    /**
+     * Checks whether an analysis is currently running.
+     * @return true if running, false otherwise
+     */
+    bool
+    isRunning() const;
+
+private:
+    NativeEngine();
+
+    /**
+     * Marks the engine as busy and clears the plot.
+     * @return false if an analysis is still running
+     */
+    bool
+    begin();
+
+    /**
+     * Publishes the curves in the order of the labels via the PrismResultsParser observers.
+     */
+    static void
+    publish(const std::vector<std::string>& labels,
+            std::map<std::string, TransientSolver::Curve>& curves);
+
+    QThreadPool mThreadPool;
+
+    std::atomic_bool mDone;
+};
+
+}  // namespace eval
+
+#endif /* ERIS_EVAL_NATIVE_ENGINE_H */
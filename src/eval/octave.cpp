@@ -23,22 +23,20 @@
 #include "memory.h"
 #include "tokenizer.h"
 #include "command.h"
+#include "job.h"
 #include "prism_results_parser.h"
 
-#include <QDir>
 #include <QFile>
-
-#define CWD_PATH (QDir::currentPath() + utils::pathSeparator)
-#define SIMULATION_RESULTS_PATH (CWD_PATH + kSimulationResultsFileName)
+#include <QFileInfo>
 
 namespace {
-const char kSimulationResultsFileName[] = ".__octave_results__.txt";
+const char kSimulationResultsFileName[] = "octave_results.txt";
 }
 
 namespace eval
 {
     
-Octave::Octave() : mLock()
+Octave::Octave()
 {
 
 }
@@ -52,28 +50,29 @@ Octave* Octave::getInstance()
 
 Octave::~Octave()
 {
-    QFile simulationResults(SIMULATION_RESULTS_PATH);
-    if(simulationResults.exists())
-    {
-        PRINT_INFO("Destruct Octave");
-        //ERIS_CHECK(simulationResults.remove());
-    }
 }
 
 bool
 Octave::extractSimulationFailureRates(const QString& simulationPath,
                                     ExperimentInterval interval,
                                     std::map<qreal, QString>* safetyFailure,
-                                    std::map<qreal, QString>* securityFailure)
+                                    std::map<qreal, QString>* securityFailure,
+                                    const std::atomic_bool* cancelled)
 {
-    std::lock_guard<std::mutex> guard(mLock);
-    
-    //QFile::remove(SIMULATION_RESULTS_PATH);
+    // Simulations run concurrently, every call is a job with its own scratch directory
+    utils::Job job("octave");
+    if (!job.isValid())
+    {
+        return false;
+    }
+    const QString resultsPath = job.filePath(kSimulationResultsFileName);
+
     auto octave = utils::allocateMemoryBlock<utils::Command>(nullptr, "octave");
+    job.attach(octave.get());
     
     // ignoring the interval for now and write results to correct file
-    octave->setArguments(QStringList() << "-q" << simulationPath);
-    octave->setStandardOutputFile(SIMULATION_RESULTS_PATH, QIODevice::Truncate | QIODevice::WriteOnly);
+    octave->setArguments(QStringList() << "-q" << QFileInfo(simulationPath).absoluteFilePath());
+    octave->setStandardOutputFile(resultsPath, QIODevice::Truncate | QIODevice::WriteOnly);
     
     QStringList args = octave->arguments();
 
@@ -81,7 +80,10 @@ Octave::extractSimulationFailureRates(const QString& simulationPath,
     
     octave->run();
     
-    octave->waitForFinished(-1);
+    if (!octave->waitUntilFinished(cancelled))
+    {
+        return false;
+    }
     
     if (octave->exitCode() != 0)
     {
@@ -94,6 +96,6 @@ Octave::extractSimulationFailureRates(const QString& simulationPath,
     
     // with the presumption that the octave script uses the same output format as Prism
     return eval::PrismResultsParser::Get()->parseForSubmodule(
-            SIMULATION_RESULTS_PATH, safetyFailure, securityFailure);
+            resultsPath, safetyFailure, securityFailure);
 }
 }
\ No newline at end of file
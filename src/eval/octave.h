@@ -26,8 +26,9 @@
 
 #include <QObject>
 
+#include <atomic>
+#include <map>
 #include <memory>
-#include <mutex>
 
 namespace eval
 {
@@ -58,17 +59,17 @@ public:
      * @param interval interval
      * @param safetyFailure module nodes map ptr to store defective rate
      * @param securityFailure module nodes map ptr to store corrupted rate
+     * @param cancelled kills octave once set (see JobScheduler::Context), may be nullptr
      * @return 
      */
     bool extractSimulationFailureRates(const QString& simulationPath,
                                     ExperimentInterval interval,
                                     std::map<qreal, QString>* safetyFailure,
-                                    std::map<qreal, QString>* securityFailure);
+                                    std::map<qreal, QString>* securityFailure,
+                                    const std::atomic_bool* cancelled = nullptr);
     
 private:
     Octave();
-    
-    std::mutex mLock;
 };
 
 }
@@ -0,0 +1,334 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "parameter_sweep.h"
+
+#include "command.h"
+#include "job.h"
+#include "logger.h"
+#include "markov_chain.h"
+#include "memory.h"
+#include "prism_results_parser.h"
+#include "tokenizer.h"
+#include "transient_solver.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QThread>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+
+namespace eval
+{
+using graphInternal::MarkovChain;
+
+ParameterSweep::ParameterSweep() : QObject(nullptr), mThreadPool(), mPending(0), mCancelled(false)
+{
+    mThreadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+}
+
+ParameterSweep*
+ParameterSweep::getInstance()
+{
+    static std::unique_ptr<ParameterSweep> instance(new ParameterSweep());
+    return instance.get();
+}
+
+ParameterSweep::~ParameterSweep()
+{
+    cancel();
+    mThreadPool.waitForDone();
+}
+
+bool
+ParameterSweep::samplePoints(const std::vector<Parameter>& parameters,
+                             Sampling sampling,
+                             size_t samples,
+                             std::vector<Point>* points,
+                             uint32_t seed)
+{
+    points->clear();
+    if (parameters.empty())
+    {
+        return false;
+    }
+
+    if (sampling == Sampling::latinHypercube)
+    {
+        if (samples == 0 || samples > kMaxPoints)
+        {
+            PRINT_ERROR("Invalid number of samples %zu", samples);
+            return false;
+        }
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> offset(0.0, 1.0);
+        points->assign(samples, Point(parameters.size(), 0.0));
+        std::vector<size_t> strata(samples);
+        for (size_t j = 0; j < parameters.size(); ++j)
+        {  // every stratum of every parameter is hit exactly once
+            std::iota(strata.begin(), strata.end(), 0);
+            std::shuffle(strata.begin(), strata.end(), generator);
+            const double width = (parameters[j].to - parameters[j].from) / samples;
+            for (size_t i = 0; i < samples; ++i)
+            {
+                (*points)[i][j] = parameters[j].from + (strata[i] + offset(generator)) * width;
+            }
+        }
+        return true;
+    }
+
+    size_t count = 1;
+    for (const Parameter& parameter : parameters)
+    {
+        if (parameter.steps < 1 || count * parameter.steps > kMaxPoints)
+        {
+            PRINT_ERROR("Invalid grid, at most %zu points are supported", kMaxPoints);
+            return false;
+        }
+        count *= parameter.steps;
+    }
+    points->reserve(count);
+    // the last parameter changes fastest
+    std::vector<int> index(parameters.size(), 0);
+    for (size_t n = 0; n < count; ++n)
+    {
+        Point point(parameters.size());
+        for (size_t j = 0; j < parameters.size(); ++j)
+        {
+            const Parameter& parameter = parameters[j];
+            point[j] = parameter.steps == 1
+                               ? parameter.from
+                               : parameter.from
+                                         + (parameter.to - parameter.from) * index[j]
+                                                   / (parameter.steps - 1);
+        }
+        points->push_back(std::move(point));
+        for (size_t j = parameters.size(); j-- > 0;)
+        {
+            if (++index[j] < parameters[j].steps)
+            {
+                break;
+            }
+            index[j] = 0;
+        }
+    }
+    return true;
+}
+
+QString
+ParameterSweep::describe(const std::vector<Parameter>& parameters, const Point& point)
+{
+    QStringList constants;
+    for (size_t j = 0; j < parameters.size() && j < point.size(); ++j)
+    {
+        constants << QString::fromStdString(parameters[j].constant) + "="
+                             + QString::number(point[j], 'g', 10);
+    }
+    return constants.join(",");
+}
+
+bool
+ParameterSweep::begin(size_t points)
+{
+    if (isRunning())
+    {
+        PRINT_WARNING("Previous parameter sweep did not finish yet");
+        return false;
+    }
+    if (points == 0)
+    {
+        return false;
+    }
+    mThreadPool.waitForDone();
+    mCancelled.store(false, std::memory_order_seq_cst);
+    mPending.store(static_cast<int>(points), std::memory_order_seq_cst);
+    PRINT_INFO("Starting parameter sweep of %zu points on %d threads",
+               points,
+               mThreadPool.maxThreadCount());
+    return true;
+}
+
+void
+ParameterSweep::finishPoint()
+{
+    if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        PRINT_INFO("Parameter sweep finished");
+        emit sweepFinished();
+    }
+}
+
+bool
+ParameterSweep::execute(std::shared_ptr<const MarkovChain> chain,
+                        const std::vector<std::string>& labels,
+                        ExperimentInterval interval,
+                        const std::vector<Parameter>& parameters,
+                        const std::vector<Point>& points)
+{
+    if (chain == nullptr || !chain->isValid() || !begin(points.size()))
+    {
+        return false;
+    }
+
+    for (size_t index = 0; index < points.size(); ++index)
+    {
+        const Point point = points[index];
+        mThreadPool.start([this, chain, labels, interval, parameters, point, index] {
+            if (mCancelled.load(std::memory_order_acquire))
+            {
+                finishPoint();
+                return;
+            }
+            // The copy is compiled already, only the states are explored again
+            MarkovChain local(*chain);
+            for (size_t j = 0; j < parameters.size(); ++j)
+            {
+                local.setConstant(parameters[j].constant, point[j]);
+            }
+            std::map<std::string, TransientSolver::Curve> curves;
+            if (local.build() && TransientSolver(local).solve(interval, labels, &curves))
+            {
+                Results results;
+                for (const std::string& label : labels)
+                {
+                    QList<QPointF>& curve = results[QString::fromStdString(label)];
+                    for (const auto& value : curves[label])
+                    {
+                        curve.append(QPointF(value.first, value.second));
+                    }
+                }
+                emit pointFinished(static_cast<int>(index), results);
+            }
+            else
+            {
+                PRINT_ERROR("Failed to evaluate %s : %s",
+                            describe(parameters, point).toStdString().c_str(),
+                            local.getError().c_str());
+                emit pointFailed(static_cast<int>(index));
+            }
+            finishPoint();
+        });
+    }
+    return true;
+}
+
+bool
+ParameterSweep::execute(const QString& prismModel,
+                        const QString& experimentDoc,
+                        ExperimentInterval interval,
+                        const std::vector<Parameter>& parameters,
+                        const std::vector<Point>& points)
+{
+    if (!begin(points.size()))
+    {
+        return false;
+    }
+
+    // prism runs within the scratch directory of the point
+    const QString model = QFileInfo(prismModel).absoluteFilePath();
+    for (size_t index = 0; index < points.size(); ++index)
+    {
+        const QString constants = describe(parameters, points[index]);
+        mThreadPool.start([this, model, experimentDoc, interval, constants, index] {
+            if (mCancelled.load(std::memory_order_acquire))
+            {
+                finishPoint();
+                return;
+            }
+            Results results;
+            if (evaluateWithPrism(model, experimentDoc, interval, constants, &results))
+            {
+                emit pointFinished(static_cast<int>(index), results);
+            }
+            else
+            {
+                PRINT_ERROR("Failed to evaluate %s", constants.toStdString().c_str());
+                emit pointFailed(static_cast<int>(index));
+            }
+            finishPoint();
+        });
+    }
+    return true;
+}
+
+bool
+ParameterSweep::evaluateWithPrism(const QString& prismModel,
+                                  const QString& experimentDoc,
+                                  const ExperimentInterval& interval,
+                                  const QString& constants,
+                                  Results* results)
+{
+    // every point is a job with its own scratch directory, removed once the point is done
+    utils::Job job("sweep");
+    if (!job.isValid())
+    {
+        return false;
+    }
+    const QString experimentPath = job.filePath("experiment.pctl");
+    const QString resultsPath = job.filePath("results.txt");
+    QFile experiment(experimentPath);
+    if (!experiment.open(QFile::WriteOnly | QFile::Text | QFile::Truncate))
+    {
+        PRINT_ERROR("Failed to write %s", experimentPath.toStdString().c_str());
+        return false;
+    }
+    experiment.write(experimentDoc.toUtf8());
+    experiment.close();
+
+    auto prism = utils::allocateMemoryBlock<utils::Command>(nullptr, "prism");
+    job.attach(prism.get());
+    prism->setArguments(QStringList()
+                        << prismModel << experimentPath << "-const"
+                        << QString::fromStdString(interval.toString()) + "," + constants
+                        << "-exportresults" << resultsPath);
+    if (!prism->run())
+    {
+        PRINT_ERROR("Failed to start prism");
+        return false;
+    }
+    prism->waitForFinished(-1);
+    if (prism->exitCode() != 0)
+    {
+        PRINT_ERROR("Prism exited with a status code  : %d ", prism->exitCode());
+        PRINT_ERROR("%s", prism->readAll().toStdString().c_str());
+        return false;
+    }
+
+    PrismResultsParser::ParseError error;
+    return PrismResultsParser::readResults(resultsPath, results, &error);
+}
+
+void
+ParameterSweep::cancel()
+{
+    mCancelled.store(true, std::memory_order_seq_cst);
+}
+
+bool
+ParameterSweep::isRunning() const
+{
+    return mPending.load(std::memory_order_acquire) > 0;
+}
+
+}  // namespace eval
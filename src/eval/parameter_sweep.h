@@ -0,0 +1,221 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_PARAMETER_SWEEP_H
+#define ERIS_EVAL_PARAMETER_SWEEP_H
+
+#include "eris_config.h"
+#include "experiment.h"
+
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QPointF>
+#include <QString>
+#include <QThreadPool>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace graphInternal
+{
+class MarkovChain;
+}
+
+namespace eval
+{
+/**
+ * Evaluates a model for many values of its rate constants (what-if studies). Every point of
+ * the sweep is evaluated on its own, all points are dispatched to a pool of worker threads, which
+ * either solve a copy of the markov chain natively or run prism on the parametric model within
+ * their own scratch directory.
+ *
+ * Usage scenario:
+ * std::vector<ParameterSweep::Parameter> parameters = {{"rn3SAFE", 0.01, 0.1, 10}};
+ * std::vector<ParameterSweep::Point> points;
+ * ParameterSweep::samplePoints(parameters, ParameterSweep::Sampling::grid, 0, &points);
+ * connect(ParameterSweep::getInstance(), &ParameterSweep::pointFinished, ...);
+ * ParameterSweep::getInstance()->execute(chain, labels, interval, parameters, points);
+ */
+class ERIS_EXPORT ParameterSweep : public QObject
+{
+    Q_OBJECT
+
+public:
+    ERIS_DISALLOW_COPY_AND_ASSIGN(ParameterSweep);
+
+    using Results = QMap<QString, QList<QPointF>>;
+
+    /** Values of the parameters, same order as the parameters */
+    using Point = std::vector<double>;
+
+    enum class Sampling
+    {
+        /** Every combination of the values of all parameters */
+        grid,
+        /** Latin hypercube, every range is split into as many strata as there are samples */
+        latinHypercube,
+    };
+
+    struct Parameter
+    {
+        /** Name of the rate constant, see graphInternal::Transcriber::constantName() */
+        std::string constant;
+        double from = 0.0;
+        double to = 0.0;
+        /** Number of values in the grid, including from and to */
+        int steps = 2;
+    };
+
+    /** Upper bound for the number of points of a sweep */
+    static constexpr size_t kMaxPoints = 100000;
+
+    static ParameterSweep*
+    getInstance();
+
+    ~ParameterSweep() override;
+
+    /**
+     * Generates the points of a sweep.
+     * @param parameters swept parameters
+     * @param sampling grid or latin hypercube
+     * @param samples number of points of a latin hypercube, ignored for grids
+     * @param points vector the points are stored in
+     * @param seed seed of the latin hypercube sampling
+     * @return false if there are no points or more than kMaxPoints
+     */
+    static bool
+    samplePoints(const std::vector<Parameter>& parameters,
+                 Sampling sampling,
+                 size_t samples,
+                 std::vector<Point>* points,
+                 uint32_t seed = 0);
+
+    /**
+     * Returns the constants of a point as given to prism, e.g. rn3SAFE=0.1,rn4SEC=0.2
+     */
+    static QString
+    describe(const std::vector<Parameter>& parameters, const Point& point);
+
+    /**
+     * Starts to evaluate all points natively. Every point solves its own copy of the chain with
+     * the constants set to the values of the point.
+     * @param chain compiled (not necessarily built) chain of the model
+     * @param labels labels to compute the probabilities for
+     * @param interval experiment interval
+     * @param parameters swept parameters
+     * @param points values of the parameters
+     * @return true if the sweep was started, false otherwise
+     */
+    bool
+    execute(std::shared_ptr<const graphInternal::MarkovChain> chain,
+            const std::vector<std::string>& labels,
+            ExperimentInterval interval,
+            const std::vector<Parameter>& parameters,
+            const std::vector<Point>& points);
+
+    /**
+     * Starts to evaluate all points by prism. Every point runs its own prism instance within its
+     * own scratch directory.
+     * @param prismModel path of the parametric model, see graphInternal::Transformer
+     * @param experimentDoc content of the experiment (.pctl)
+     * @param interval experiment interval
+     * @param parameters swept parameters, undefined constants of the model
+     * @param points values of the parameters
+     * @return true if the sweep was started, false otherwise
+     */
+    bool
+    execute(const QString& prismModel,
+            const QString& experimentDoc,
+            ExperimentInterval interval,
+            const std::vector<Parameter>& parameters,
+            const std::vector<Point>& points);
+
+    /**
+     * Skips all points that were not started yet.
+     */
+    void
+    cancel();
+
+    /**
+     * Checks whether a sweep is currently running.
+     * @return true if running, false otherwise
+     */
+    bool
+    isRunning() const;
+
+signals:
+
+    /**
+     * Emitted from the worker thread once a point was evaluated.
+     * @param index of the point
+     * @param results curves of the point, keyed by property label
+     */
+    void
+    pointFinished(int index, const QMap<QString, QList<QPointF>>& results);
+
+    /**
+     * Emitted from the worker thread if a point could not be evaluated.
+     */
+    void
+    pointFailed(int index);
+
+    /**
+     * Emitted once all points are done or skipped.
+     */
+    void
+    sweepFinished();
+
+private:
+    ParameterSweep();
+
+    /**
+     * Marks the sweep as running with the given number of points.
+     * @return false if a sweep is still running
+     */
+    bool
+    begin(size_t points);
+
+    /**
+     * Counts a finished point and signals the end of the sweep.
+     */
+    void
+    finishPoint();
+
+    bool
+    evaluateWithPrism(const QString& prismModel,
+                      const QString& experimentDoc,
+                      const ExperimentInterval& interval,
+                      const QString& constants,
+                      Results* results);
+
+    QThreadPool mThreadPool;
+
+    std::atomic_int mPending;
+
+    std::atomic_bool mCancelled;
+};
+
+}  // namespace eval
+
+#endif /* ERIS_EVAL_PARAMETER_SWEEP_H */
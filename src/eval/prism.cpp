@@ -27,33 +27,33 @@
 #include "tokenizer.h"
 #include "working_dialog.h"
 #include "command.h"
+#include "job.h"
+#include "job_scheduler.h"
 #include "experiment.h"
 #include "prism_results_parser.h"
+#include "results_cache.h"
 #include "evaluation_tab.h"
 #include "chart_view.h"
+#include "model.h"
 
 #include <QDir>
 #include <sstream>
 #include <QFile>
+#include <QFileInfo>
 #include <QWidget>
 #include <QProcess>
 #include <QThreadPool>
 #include <QDateTime>
-
-#define CWD_PATH (QDir::currentPath() + utils::pathSeparator)
-#define EXPERIMENT_PATH (CWD_PATH + kExperimentFileName)
-#define EXPERIMENT_RESULTS_PATH (CWD_PATH + kExperimentResultsFileName)
-#define SUBMODULE_PROPERTIES_PATH (CWD_PATH + kSubmodulePropertiesFileName)
-#define SUBMODULE_PROPERTIES_RESULTS_PATH (CWD_PATH + kSubmodulePropertiesResultsFileName)
+#include <QRegularExpression>
 
 namespace 
 {
-// Those files are created in the working directory where eris was first
-// executed, and they will be removed on a graceful exit.
-const char kExperimentFileName[] = ".__eris_experiment__.pctl";
-const char kExperimentResultsFileName[] = ".__eris_results__.txt";
-const char kSubmodulePropertiesFileName[] = ".__eris_submodule_properties__.txt";
-const char kSubmodulePropertiesResultsFileName[] = ".__eris_submodule_properties_results__.txt";
+// Those files are created in the scratch directory of each job (see utils::Job) and removed
+// together with it.
+const char kExperimentFileName[] = "experiment.pctl";
+const char kExperimentResultsFileName[] = "results.txt";
+const char kSubmodulePropertiesFileName[] = "submodule_properties.txt";
+const char kSubmodulePropertiesResultsFileName[] = "submodule_properties_results.txt";
 
 const char*
 translateQProcessError(QProcess::ProcessError state)
@@ -95,12 +95,10 @@ Prism::Prism(QObject* parent, QWidget* parentWidget) :
     mArgs(),
     mThreadPool(),
     mDone(true),
-    mLock(),
     mCommand(nullptr),
+    mJob(nullptr),
     mWorkingDialog(nullptr),
     mDoEvaluate(false),
-    mLastStep(false),
-    mStepwiseExecution(false),
     mExperimentInterval(new eval::ExperimentInterval()),
     mStartTime(""),
     mEndTime("")
@@ -130,6 +128,7 @@ Prism::Prism(QObject* parent, QWidget* parentWidget) :
             Qt::QueuedConnection);
 
     connect(mWorkingDialog.get(), &WorkingDialog::WasAborted, this, &Prism::terminate);
+    mWorkingDialog->WatchJobs(JobScheduler::getInstance());
 
     eval::PrismResultsParser::Get()->RegisterObserver(this);
 }
@@ -141,62 +140,66 @@ Prism::getInstance()
     return instance.get();
 }
 
-Prism::~Prism()
-{
-    QFile experimentFile(EXPERIMENT_PATH);
-    QFile experimentResults(EXPERIMENT_RESULTS_PATH);
-    if (experimentFile.exists())
-    {
-        ERIS_CHECK(experimentFile.remove());
-    }
-
-    if (experimentResults.exists())
-    {
-        ERIS_CHECK(experimentResults.remove());
-    }
-}
+Prism::~Prism() = default;
 
 void
 Prism::reset()
 {
     mArgs.clear();
+    mPlan = EnginePlanner::Plan();
     mWorkingDialog->Clear();
 }
 
 bool
-Prism::execute(bool with_evaluation, bool stepwise, bool lastStep,
-        const QString& working_directory)
+Prism::execute(bool with_evaluation, const QString& working_directory)
 {
     ERIS_CHECK(!mArgs.isEmpty());
-    mStepwiseExecution = stepwise;
-    mLastStep = lastStep;
 
     if (mCommand->state() == QProcess::Running)
     {
         PRINT_WARNING("Previous call of prism did not finish yet");
         return false;
     }
+    if (PrismResultsParser::Get()->isRunning())
+    {  // the parser reads from the scratch directory of the previous run
+        PRINT_WARNING("Results of the previous call of prism are still being parsed");
+        return false;
+    }
     mDoEvaluate = with_evaluation; // TODO check if this is needed?
-    mCommand->setWorkingDirectory(working_directory);
+
+    // Every run gets its own scratch directory, the one of the previous run is removed once its
+    // results are parsed. PRISM runs within it, hence the model path is made absolute first.
+    mJob = utils::allocateMemoryBlock<utils::Job>("experiment");
+    if (!mJob->isValid())
+    {
+        emit WriteOutput("Failed to create a scratch directory : " + mJob->errorString() + "\n",
+                         Qt::red);
+        return false;
+    }
+    mArgs.first() = QFileInfo(QDir(working_directory), mArgs.first()).absoluteFilePath();
+    mJob->attach(mCommand.get());
 
     // This is needed to clear the plot
     // when executing prism without an experiment.
-    if (!mStepwiseExecution)
+    EvaluationTab::Get()->view()->clear();
+
+    // the options of the plan change the results (precision) and are part of the cache key
+    QStringList options;
+    for (const std::string& arg : mPlan.arguments())
     {
-        EvaluationTab::Get()->view()->clear();
+        options << QString::fromStdString(arg);
     }
-
     if (mDoEvaluate)
     {
-        addArgument(EXPERIMENT_PATH);
+        addArgument(mJob->filePath(kExperimentFileName));
         addArgument("-const");
         addArgument(tr(mExperimentInterval->toString().c_str()));
-        addArgument("-javamaxmem");
-        addArgument("4g");
-        addArgument("-cuddmaxmem");
-        addArgument("4g");
+        for (const QString& option : options)
+        {
+            addArgument(option);
+        }
         addArgument("-exportresults");
-        addArgument(EXPERIMENT_RESULTS_PATH);
+        addArgument(mJob->filePath(kExperimentResultsFileName));
         writeExperimentFile();
     }
     
@@ -212,7 +215,33 @@ Prism::execute(bool with_evaluation, bool stepwise, bool lastStep,
         mStartTime = QDateTime::currentDateTime().toString("dd.MM.yyyy hh:mm:ss");    
     }
     emit WriteOutput("Operation Started \n--------------------- \n", Qt::green);
-    
+    if (mDoEvaluate && mPlan.planned)
+    {
+        PRINT_INFO("%s", mPlan.toString().c_str());
+        emit WriteOutput(QString::fromStdString(mPlan.toString() + "\n"), Qt::green);
+    }
+
+    // Complete evaluations of an unchanged model and experiment are answered by the cache
+    mCacheKey.clear();
+    if (mDoEvaluate)
+    {
+        QFile model(mArgs.first());
+        if (model.open(QFile::ReadOnly))
+        {
+            mCacheKey = ResultsCache::key(model.readAll(), experimentDoc, *mExperimentInterval,
+                                          options);
+        }
+        ResultsCache::Results results;
+        if (!mCacheKey.isEmpty() && ResultsCache::Get()->lookup(mCacheKey, &results))
+        {
+            mCacheKey.clear();
+            emit WriteOutput("Results taken from the cache \n", Qt::green);
+            PrismResultsParser::Get()->publish(results);
+            emit DoneWorking(true);
+            return true;
+        }
+    }
+
     return mCommand->run();
 }
 
@@ -222,6 +251,12 @@ Prism::addArgument(const QString& arg)
     mArgs << arg;
 }
 
+void
+Prism::setPlan(const EnginePlanner::Plan& plan)
+{
+    mPlan = plan;
+}
+
 void
 Prism::errorOccurred(QProcess::ProcessError error)
 {
@@ -235,30 +270,16 @@ Prism::finished(int exitCode, QProcess::ExitStatus /*exitStatus*/ exitStatus)
 {
     PRINT_INFO("Prism Finished with the exit code %d ", exitCode);
 
-    if ((!mStepwiseExecution) || mLastStep)
-    {
-        mWorkingDialog->SetDoneState();
-    }
+    mWorkingDialog->SetDoneState();
 
     if (exitCode == 0)
     { // success, probably
-
-        if (mStepwiseExecution)
-        {// submodule stepwise mode
-            PrismResultsParser::Get()->parseStepResults(EXPERIMENT_RESULTS_PATH, mLastStep);
-            if (!mLastStep)
-            {
-                return; // avoid emitting work done, before it is actually done   
-            }
-        }
-        else
-        {// Normal evaluation mode
-            PrismResultsParser::Get()->parse(EXPERIMENT_RESULTS_PATH);
-        }
-
+        reportModelSize();
+        PrismResultsParser::Get()->parse(mJob->filePath(kExperimentResultsFileName), mJob);
     }
     else
     {
+        mCacheKey.clear();
         emit WriteOutput(mStdoutBuffer.str().c_str(), Qt::GlobalColor::red);
         emit WriteOutput(mStderrBuffer.str().c_str(), Qt::GlobalColor::red);
         std::stringstream ss;
@@ -273,6 +294,37 @@ Prism::finished(int exitCode, QProcess::ExitStatus /*exitStatus*/ exitStatus)
     mWorkingDialog->RaiseIt();
 }
 
+void
+Prism::reportModelSize()
+{
+    // printed by the symbolic engines, e.g.
+    // States:      27 (1 initial)
+    // Rate matrix: 210 nodes (4 terminal), 54 minterms, vars: 6r/6c
+    static const QRegularExpression states(R"(^States:\s+(\d+))",
+                                           QRegularExpression::MultilineOption);
+    static const QRegularExpression matrix(R"(^(?:Rate|Transition) matrix: (\d+) nodes)",
+                                           QRegularExpression::MultilineOption);
+    const QString output = QString::fromStdString(mStdoutBuffer.str());
+    QRegularExpressionMatch nodes = matrix.match(output);
+    if (!nodes.hasMatch())
+    {  // explicit engine
+        return;
+    }
+    QRegularExpressionMatch stateCount = states.match(output);
+    graph::Model& model = graph::Model::getInstance();
+    const QString message =
+            "MTBDD of the " + QString(model.getType() == graph::Model::CTMC ? "rate" : "transition")
+            + " matrix: " + nodes.captured(1) + " nodes"
+            + (stateCount.hasMatch() ? ", " + stateCount.captured(1) + " states" : QString())
+            + " (" + (model.getModuleLayout() == graph::Model::singleModule ? "single module"
+                                                                               : "module per node")
+            + ", " + (model.getVariableOrder() == graph::Model::numberOrder ? "number order"
+                                                                           : "dependency order")
+            + ")\n";
+    PRINT_INFO("%s", message.trimmed().toStdString().c_str());
+    emit WriteOutput(message, Qt::green);
+}
+
 void
 Prism::started()
 {
@@ -336,7 +388,7 @@ Prism::isRunning() const
 void
 Prism::writeExperimentFile()
 {
-    QFile experimentFile(EXPERIMENT_PATH);
+    QFile experimentFile(mJob->filePath(kExperimentFileName));
     ERIS_CHECK(experimentFile.open(QFile::WriteOnly | QFile::Text | QFile::Truncate));
     experimentFile.write(experimentDoc.toStdString().c_str());
     experimentFile.close();
@@ -360,10 +412,11 @@ Prism::failedToParse(eval::PrismResultsParser::ParseError error)
     QString message =
             "Parse error : " + tr(eval::PrismResultsParser::TranslateParseError(error)) + "\n\n";
 
+    mCacheKey.clear();
     emit WriteOutput("Failed to parse the results from prism\n---------------------\n", Qt::red);
 
     emit WriteOutput(message, Qt::red);
-    QFile f(EXPERIMENT_RESULTS_PATH);
+    QFile f(mJob->filePath(kExperimentResultsFileName));
     if (f.open(QFile::ReadOnly))
     {
         emit WriteOutput(f.readAll().toStdString().c_str(), Qt::red);
@@ -372,6 +425,16 @@ Prism::failedToParse(eval::PrismResultsParser::ParseError error)
     emit WriteOutput("", Qt::red);
 }
 
+void
+Prism::propertyResults(const QMap<QString, QList<QPointF>> results)
+{
+    if (!mCacheKey.isEmpty())
+    {  // results of the PRISM run started by execute()
+        ResultsCache::Get()->store(mCacheKey, results);
+        mCacheKey.clear();
+    }
+}
+
 void
 Prism::OperationDone(bool success)
 {
@@ -391,29 +454,37 @@ bool
 Prism::extractSubmoduleFailureRates(const QString& prismModel,
                                     ExperimentInterval interval,
                                     std::map<qreal, QString>* safetyFailure,
-                                    std::map<qreal, QString>* securityFailure)
+                                    std::map<qreal, QString>* securityFailure,
+                                    const std::atomic_bool* cancelled)
 {
-    std::lock_guard<std::mutex> guard(mLock);
+    // Submodules are evaluated concurrently, every call is a job with its own scratch directory
+    utils::Job job("submodule");
+    if (!job.isValid())
+    {
+        return false;
+    }
+    const QString propertiesPath = job.filePath(kSubmodulePropertiesFileName);
+    const QString resultsPath = job.filePath(kSubmodulePropertiesResultsFileName);
 
-    QFile::remove(SUBMODULE_PROPERTIES_RESULTS_PATH);
-    static QString propertiesPctl = "const double T;\n"
+    static const QString propertiesPctl = "const double T;\n"
                                              "\n"
                                              "P=? [ F[T,T] \"corrupted\" ] // security failure F=T\n"
                                              "\n"
                                              "P=? [ F[T,T] \"defective\" ] // safety failure F=T";
 
-    // TODO remove this file on exit
-    QFile tmp(SUBMODULE_PROPERTIES_PATH);
+    QFile tmp(propertiesPath);
     ERIS_CHECK(tmp.open(QFile::WriteOnly | QFile::Text | QFile::Truncate));
     const qint64 written_bytes = tmp.write(propertiesPctl.toStdString().c_str());
     ERIS_CHECK(written_bytes == propertiesPctl.size());
     tmp.close();
 
     auto localPrism = utils::allocateMemoryBlock<Command>(nullptr, "prism");
+    job.attach(localPrism.get());
 
-    localPrism->setArguments(QStringList() << prismModel << SUBMODULE_PROPERTIES_PATH << "-const"
+    localPrism->setArguments(QStringList() << QFileInfo(prismModel).absoluteFilePath()
+                                            << propertiesPath << "-const"
                                             << tr(interval.toString().c_str()) << "-exportresults"
-                                            << SUBMODULE_PROPERTIES_RESULTS_PATH);
+                                            << resultsPath);
     QStringList args = localPrism->arguments();
 
     PRINT_INFO("Arguments : %s ",
@@ -426,7 +497,10 @@ Prism::extractSubmoduleFailureRates(const QString& prismModel,
         return false;
     }
 
-    localPrism->waitForFinished(-1);
+    if (!localPrism->waitUntilFinished(cancelled))
+    {
+        return false;
+    }
 
     if (localPrism->exitCode() != 0)
     {
@@ -438,7 +512,62 @@ Prism::extractSubmoduleFailureRates(const QString& prismModel,
     }
 
     return eval::PrismResultsParser::Get()->parseForSubmodule(
-            SUBMODULE_PROPERTIES_RESULTS_PATH, safetyFailure, securityFailure);
+            resultsPath, safetyFailure, securityFailure);
+}
+
+bool
+Prism::evaluateStep(const QString& prismModel,
+                    const QString& experimentDoc,
+                    const ExperimentInterval& interval,
+                    const EnginePlanner::Plan& plan,
+                    QMap<QString, QList<QPointF>>* results,
+                    const std::atomic_bool* cancelled)
+{
+    utils::Job job("step");
+    if (!job.isValid())
+    {
+        return false;
+    }
+    const QString experimentPath = job.filePath(kExperimentFileName);
+    const QString resultsPath = job.filePath(kExperimentResultsFileName);
+    QFile experiment(experimentPath);
+    if (!experiment.open(QFile::WriteOnly | QFile::Text | QFile::Truncate))
+    {
+        PRINT_ERROR("Failed to write %s", experimentPath.toStdString().c_str());
+        return false;
+    }
+    experiment.write(experimentDoc.toUtf8());
+    experiment.close();
+
+    auto prism = utils::allocateMemoryBlock<Command>(nullptr, "prism");
+    job.attach(prism.get());
+    QStringList arguments;
+    arguments << QFileInfo(prismModel).absoluteFilePath() << experimentPath << "-const"
+              << QString::fromStdString(interval.toString());
+    for (const std::string& arg : plan.arguments())
+    {
+        arguments << QString::fromStdString(arg);
+    }
+    arguments << "-exportresults" << resultsPath;
+    prism->setArguments(arguments);
+    if (!prism->run())
+    {
+        PRINT_ERROR("Failed to start prism");
+        return false;
+    }
+    if (!prism->waitUntilFinished(cancelled))
+    {
+        return false;
+    }
+    if (prism->exitCode() != 0)
+    {
+        PRINT_ERROR("Prism exited with a status code  : %d ", prism->exitCode());
+        PRINT_ERROR("%s", prism->readAll().toStdString().c_str());
+        return false;
+    }
+
+    PrismResultsParser::ParseError error;
+    return PrismResultsParser::readResults(resultsPath, results, &error);
 }
 
-}  // namespace commands
\ No newline at end of file
+}  // namespace commands
@@ -25,6 +25,7 @@
 
 #include "eris_config.h"
 #include "prism_results_parser.h"
+#include "engine_planner.h"
 #include "experiment.h"
 
 #include <QObject>
@@ -35,11 +36,11 @@
 #include <sstream>
 #include <functional>
 #include <atomic>
-#include <mutex>
 
 namespace utils
 {
 class Command;
+class Job;
 }
 namespace widgets
 {
@@ -91,31 +92,59 @@ public:
     void
     addArgument(const QString& arg);
 
+    /**
+     * Sets engine, memory limits and epsilon of the next evaluation, see EnginePlanner.
+     * Without plan the previous defaults (hybrid engine, 4g) are used. reset() discards it.
+     */
+    void
+    setPlan(const EnginePlanner::Plan& plan);
+
     /**
      * Starts the submodule evaluation process and parses the results.
      * Note that his method *always* checks the properties safetyfailure and
      * corrupted, regardless of the user input for the experiment!
      * The obtained results for either property are stored in the provided
      * maps.
+     * @param cancelled kills prism once set (see JobScheduler::Context), may be nullptr
      * @return true if seemingly successful, false otherwise
      */
     bool
     extractSubmoduleFailureRates(const QString& prismModel,
                                     ExperimentInterval interval,
                                     std::map<qreal, QString>* securityFailureRates,
-                                    std::map<qreal, QString>* safetyFailureRates);
+                                    std::map<qreal, QString>* safetyFailureRates,
+                                    const std::atomic_bool* cancelled = nullptr);
+
+    /**
+     * Evaluates an experiment by a prism instance of its own, within the scratch directory of
+     * a new utils::Job, and blocks until it is done. Unlike execute(), it can be called from
+     * several worker threads at once (see JobScheduler), e.g. for the time steps of a model with
+     * submodules.
+     * @param prismModel path of the model (.pm)
+     * @param experimentDoc content of the experiment (.pctl)
+     * @param interval experiment interval
+     * @param plan engine and memory limits, see EnginePlanner
+     * @param results map the points are added to, keyed by property label
+     * @param cancelled kills prism once set, may be nullptr
+     * @return true on success, false otherwise
+     */
+    bool
+    evaluateStep(const QString& prismModel,
+                 const QString& experimentDoc,
+                 const ExperimentInterval& interval,
+                 const EnginePlanner::Plan& plan,
+                 QMap<QString, QList<QPointF>>* results,
+                 const std::atomic_bool* cancelled = nullptr);
     /**
      * Runs the prism command line tool in background in terms of an
      * experiment.
      * @param with_evaluation will lead to displaying the results in the evaluation
      * tab
-     * @param stepwise indicates a single step execution
-     * @param lastStep indicates its the last step of the stepwise execution. This is
-     * needed to publish evaluation results at the end
+     * @param working_directory directory a relative model path is resolved against, PRISM itself
+     * runs in the scratch directory of a new utils::Job
      */
     bool
-    execute(bool with_evaluation, bool stepwise=false, bool lastStep=false,
-        const QString& working_directory = "");
+    execute(bool with_evaluation, const QString& working_directory = "");
 
     /**
      * Sets the parent widget of the working dialog.
@@ -149,6 +178,8 @@ public slots:
     terminate();
 
 protected:
+    void
+    propertyResults(const QMap<QString, QList<QPointF>> results) override;
     void
     failedToParse(PrismResultsParser::ParseError error) override;
     void
@@ -182,6 +213,13 @@ signals:
 private:
     void
     writeExperimentFile();
+
+    /**
+     * Reports the size of the MTBDD PRISM built for the model, to compare module layouts and
+     * variable orders (see graph::Model). Nothing is reported for the explicit engine.
+     */
+    void
+    reportModelSize();
     explicit Prism(QObject* parent, QWidget* parentWidget);
 
     std::stringstream mStdoutBuffer;
@@ -190,8 +228,9 @@ private:
     QStringList mArgs;
     QThreadPool mThreadPool;
     std::atomic_bool mDone;
-    std::mutex mLock;
     std::unique_ptr<utils::Command> mCommand;
+    /** Scratch directory of the current (or last) run, shared with the results parser */
+    std::shared_ptr<utils::Job> mJob;
     std::unique_ptr<widgets::WorkingDialog> mWorkingDialog;
     
     QString mStartTime;
@@ -199,11 +238,11 @@ private:
 
     bool mDoEvaluate;
 
-    /** Flag to indicate that a stepwise execution (with submodule) is performed */
-    bool mStepwiseExecution;
+    /** Results cache key of the running evaluation, empty if the results are not cached */
+    QString mCacheKey;
 
-    /** Ugly way to indicate that this step is the last step (only required if stepwise is true) */
-    bool mLastStep;
+    /** Engine and memory limits of the next evaluation */
+    EnginePlanner::Plan mPlan;
 
 public:
     QString experimentDoc;
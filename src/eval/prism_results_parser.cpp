@@ -21,6 +21,7 @@
 
 #include "prism_results_parser.h"
 #include "checks.h"
+#include "job.h"
 
 #include <QFile>
 #include <QFileInfo>
@@ -80,7 +81,7 @@ PrismResultsParser::~PrismResultsParser()
 }
 
 bool
-PrismResultsParser::parse(const QString& path)
+PrismResultsParser::parse(const QString& path, std::shared_ptr<const utils::Job> job)
 {
     if (!mDone.load(std::memory_order_acquire))
     {
@@ -93,66 +94,51 @@ PrismResultsParser::parse(const QString& path)
     mThreadPool.waitForDone();
     mPath = path;
 
-    mThreadPool.start([=] {
+    mThreadPool.start([this, job]() mutable {
         OperationStartedReady();
         OperationDoneReady(doParse(true));
+        job.reset();  // the results are read, the scratch directory may be removed
         mDone.store(true, std::memory_order_seq_cst);
     });
     return true;
 }
 
 bool
-PrismResultsParser::parseStepResults(const QString& path, bool isLastStep)
+PrismResultsParser::isRunning() const
 {
-    if (!mDone.load(std::memory_order_acquire))
+    return !mDone.load(std::memory_order_acquire);
+}
+
+bool
+PrismResultsParser::doParseHelper()
+{
+    ERIS_CHECK(!mPath.isEmpty());
+    ParseError error;
+    if (!readResults(mPath, &mResults, &error))
     {
-        PRINT_ERROR("PrismResultParser is already running ");
+        FailedToParseReady(error);
         return false;
     }
-    mDone.store(false, std::memory_order_seq_cst);
-
-    // Wait until previous thread exists
-    mThreadPool.waitForDone();
-    mPath = path;
-    bool isFirstStep = mResults.empty();
-
-    mThreadPool.start([=] {
-            if (isFirstStep)
-            {
-                OperationStartedReady();
-            }
-            if (isLastStep)
-            {
-                OperationDoneReady(doParse(true));
-            }
-            else
-            {
-                doParse(false);
-            }
-            //doParse(true);
-            mDone.store(true, std::memory_order_seq_cst);
-        });
     return true;
-}   
+}
 
 bool
-PrismResultsParser::doParseHelper()
+PrismResultsParser::readResults(const QString& path,
+                                QMap<QString, QList<QPointF>>* results,
+                                ParseError* error)
 {
-    ERIS_CHECK(!mPath.isEmpty());
-    if (!QFileInfo::exists(mPath))
+    if (!QFileInfo::exists(path))
     {
-        PRINT_ERROR("File not found : %s ", mPath.toStdString().c_str());
-
-        FailedToParseReady(ParseError::FILE_NOT_FOUND);
+        PRINT_ERROR("File not found : %s ", path.toStdString().c_str());
+        *error = ParseError::FILE_NOT_FOUND;
         return false;
     }
-    QFile file(mPath);
+    QFile file(path);
 
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
     {
-        PRINT_ERROR("File is not readable : %s ", mPath.toStdString().c_str());
-
-        FailedToParseReady(ParseError::FILE_IS_NOT_READABLE);
+        PRINT_ERROR("File is not readable : %s ", path.toStdString().c_str());
+        *error = ParseError::FILE_IS_NOT_READABLE;
         return false;
     }
     QString content = file.readAll();
@@ -181,9 +167,8 @@ PrismResultsParser::doParseHelper()
 
         if (xy.length() != 2)
         {
-            PRINT_ERROR("File is invalid : %s ", mPath.toStdString().c_str());
-
-            FailedToParseReady(ParseError::FILE_IS_INVALID);
+            PRINT_ERROR("File is invalid : %s ", path.toStdString().c_str());
+            *error = ParseError::FILE_IS_INVALID;
             return false;
         }
 
@@ -191,20 +176,20 @@ PrismResultsParser::doParseHelper()
         double x = xy[0].toDouble(&ok);
         if (!ok)
         {
-            PRINT_ERROR("File is invalid : %s ", mPath.toStdString().c_str());
-            FailedToParseReady(ParseError::FILE_IS_INVALID);
+            PRINT_ERROR("File is invalid : %s ", path.toStdString().c_str());
+            *error = ParseError::FILE_IS_INVALID;
             return false;
         }
         double y = xy[1].toDouble(&ok);
         if (!ok)
         {
-            PRINT_ERROR("File is invalid : %s ", mPath.toStdString().c_str());
-            FailedToParseReady(ParseError::FILE_IS_INVALID);
+            PRINT_ERROR("File is invalid : %s ", path.toStdString().c_str());
+            *error = ParseError::FILE_IS_INVALID;
             return false;
         }
 
         bool contains = false;
-        for (QPointF point : mResults[lastProperty])
+        for (QPointF point : (*results)[lastProperty])
         { // Required for stepwise evaluation
             if (point.x() == x)
             {
@@ -214,7 +199,7 @@ PrismResultsParser::doParseHelper()
 
         if (!contains)
         {
-            mResults[lastProperty].append(QPointF(x, y));
+            (*results)[lastProperty].append(QPointF(x, y));
         }
 
     }
@@ -236,6 +221,15 @@ PrismResultsParser::publishResults()
     mResults.clear();
 }
 
+void
+PrismResultsParser::publish(const QMap<QString, QList<QPointF>>& results)
+{
+    OperationStartedReady();
+    mResults = results;
+    publishResults();
+    OperationDoneReady(true);
+}
+
 bool
 PrismResultsParser::doParse(bool publish)
 {
@@ -36,6 +36,11 @@
 #include <memory>
 #include <atomic>
 
+namespace utils
+{
+class Job;
+}
+
 namespace eval
 {
 
@@ -84,25 +89,20 @@ public:
     UnRegisterObserver(Observer* observer);
 
     /**
-     * Starts a thread to parse PRISM results. This function is only meant for
-     * entire, non-stepwise executiom.
+     * Starts a thread to parse PRISM results.
      * An absoulte path is required.
      * Makes use of helper function doParse().
+     * @param job scratch directory containing the results, kept until they are read
      * @return true of the parser could be started successfully, false otherwise
      */
     bool
-    parse(const QString& path);
+    parse(const QString& path, std::shared_ptr<const utils::Job> job = nullptr);
 
     /**
-     * Similar to the normal parse method, a thread for parsing the results is 
-     * started. However, here a stepwise exection is handled, where only one
-     * result at a time is parsed (needed for submodule evaluation).
-     * An absoulte path is required.
-     * Makes use of helper function doParse()
-     * @return true of the parser could be started successfully, false otherwise
+     * @return true while results are being parsed, false otherwise
      */
-    bool 
-    parseStepResults(const QString& path, bool isLastStep);
+    bool
+    isRunning() const;
 
     /**
      * Parses the results of a submodule PRISM evaluation and stores them in the
@@ -114,6 +114,25 @@ public:
                       std::map<qreal, QString>* safetyFailure,
                       std::map<qreal, QString>* securityFailure);
 
+    /**
+     * Reads a PRISM results file (-exportresults) synchronously, without notifying the
+     * observers. Points of a property already contained in results are kept.
+     * @param path path to the results file
+     * @param results map the points are added to, keyed by property label
+     * @param error set to the reason if reading fails
+     * @return true on success, false otherwise
+     */
+    static bool
+    readResults(const QString& path, QMap<QString, QList<QPointF>>* results, ParseError* error);
+
+    /**
+     * Publishes results that were not computed by PRISM (e.g. by the native engine)
+     * to the observers, as if they had been parsed from a results file.
+     * @param results probability curves keyed by property label
+     */
+    void
+    publish(const QMap<QString, QList<QPointF>>& results);
+
     ~PrismResultsParser() override;
 
 private:
@@ -0,0 +1,186 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "results_cache.h"
+
+#include "logger.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <memory>
+
+namespace
+{
+// Identifies cache files, increase the version whenever the format changes
+const quint32 kMagic = 0x45524953;  // "ERIS"
+const quint32 kVersion = 1;
+}  // namespace
+
+namespace eval
+{
+ResultsCache::ResultsCache() :
+    mLock(),
+    mMemory(),
+    mOrder(),
+    mDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/results")
+{
+}
+
+ResultsCache*
+ResultsCache::Get()
+{
+    static std::unique_ptr<ResultsCache> instance(new ResultsCache());
+    return instance.get();
+}
+
+QString
+ResultsCache::key(const QByteArray& model,
+                  const QString& experimentDoc,
+                  const ExperimentInterval& interval,
+                  const QStringList& options)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(model);
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(experimentDoc.toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(QByteArray::fromStdString(interval.toString()));
+    for (const QString& option : options)
+    {
+        hash.addData(QByteArray(1, '\0'));
+        hash.addData(option.toUtf8());
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString
+ResultsCache::path(const QString& key) const
+{
+    return mDirectory + "/" + key + ".results";
+}
+
+void
+ResultsCache::setDirectory(const QString& directory)
+{
+    std::lock_guard<std::mutex> guard(mLock);
+    mDirectory = directory;
+}
+
+QString
+ResultsCache::getDirectory()
+{
+    std::lock_guard<std::mutex> guard(mLock);
+    return mDirectory;
+}
+
+bool
+ResultsCache::lookup(const QString& key, Results* results)
+{
+    std::lock_guard<std::mutex> guard(mLock);
+    auto iter = mMemory.find(key);
+    if (iter != mMemory.end())
+    {
+        mOrder.removeOne(key);
+        mOrder.append(key);
+        *results = iter.value();
+        PRINT_INFO("Results cache hit (memory) : %s", key.toStdString().c_str());
+        return true;
+    }
+    if (mDirectory.isEmpty())
+    {
+        return false;
+    }
+
+    QFile file(path(key));
+    if (!file.open(QFile::ReadOnly))
+    {
+        return false;
+    }
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    Results loaded;
+    stream >> magic >> version;
+    if (magic != kMagic || version != kVersion)
+    {
+        PRINT_WARNING("Ignoring incompatible cache file %s", file.fileName().toStdString().c_str());
+        return false;
+    }
+    stream >> loaded;
+    if (stream.status() != QDataStream::Ok || loaded.isEmpty())
+    {
+        PRINT_WARNING("Ignoring corrupted cache file %s", file.fileName().toStdString().c_str());
+        return false;
+    }
+    PRINT_INFO("Results cache hit (disk) : %s", key.toStdString().c_str());
+    *results = loaded;
+
+    mMemory.insert(key, loaded);
+    mOrder.append(key);
+    while (mOrder.size() > kMaxMemoryEntries)
+    {
+        mMemory.remove(mOrder.takeFirst());
+    }
+    return true;
+}
+
+void
+ResultsCache::store(const QString& key, const Results& results)
+{
+    if (results.isEmpty())
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(mLock);
+    if (!mMemory.contains(key))
+    {
+        mOrder.append(key);
+    }
+    mMemory.insert(key, results);
+    while (mOrder.size() > kMaxMemoryEntries)
+    {
+        mMemory.remove(mOrder.takeFirst());
+    }
+
+    if (mDirectory.isEmpty() || !QDir().mkpath(mDirectory))
+    {
+        return;
+    }
+    // QSaveFile only replaces the target once everything was written
+    QSaveFile file(path(key));
+    if (!file.open(QFile::WriteOnly))
+    {
+        PRINT_WARNING("Cannot write cache file %s", file.fileName().toStdString().c_str());
+        return;
+    }
+    QDataStream stream(&file);
+    stream << kMagic << kVersion << results;
+    if (!file.commit())
+    {
+        PRINT_WARNING("Cannot write cache file %s", file.fileName().toStdString().c_str());
+    }
+}
+
+}  // namespace eval
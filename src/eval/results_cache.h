@@ -0,0 +1,124 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_RESULTS_CACHE_H
+#define ERIS_EVAL_RESULTS_CACHE_H
+
+#include "eris_config.h"
+#include "experiment.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+
+#include <mutex>
+
+namespace eval
+{
+/**
+ * Content addressed cache of experiment results.
+ *
+ * The key is a hash of the generated model, the experiment document, the interval and the PRISM
+ * options (engine, precision, memory), i.e., an unchanged model is never evaluated twice. Results
+ * are kept in memory and written to a cache directory, hence they survive a restart of ERIS.
+ *
+ * Usage scenario:
+ * QString key = ResultsCache::key(modelText, experimentDoc, interval, options);
+ * if (ResultsCache::Get()->lookup(key, &results))
+ *     PrismResultsParser::Get()->publish(results);
+ * else
+ *     ... run PRISM and ResultsCache::Get()->store(key, parsedResults);
+ */
+class ERIS_EXPORT ResultsCache
+{
+public:
+    using Results = QMap<QString, QList<QPointF>>;
+
+    ERIS_DISALLOW_COPY_AND_ASSIGN(ResultsCache);
+
+    static ResultsCache*
+    Get();
+
+    /**
+     * Computes the cache key of an experiment.
+     * @param model content of the generated model (.pm)
+     * @param experimentDoc content of the experiment (.pctl)
+     * @param interval experiment interval
+     * @param options further PRISM arguments the results depend on, e.g. engine and precision
+     * @return hex encoded hash
+     */
+    static QString
+    key(const QByteArray& model,
+        const QString& experimentDoc,
+        const ExperimentInterval& interval,
+        const QStringList& options);
+
+    /**
+     * Looks up the results of the given key, first in memory, then on disk.
+     * @param key cache key
+     * @param results set to the cached results on a hit
+     * @return true on a hit, false otherwise
+     */
+    bool
+    lookup(const QString& key, Results* results);
+
+    /**
+     * Stores the results of the given key in memory and on disk.
+     * @param key cache key
+     * @param results results to store, empty results are ignored
+     */
+    void
+    store(const QString& key, const Results& results);
+
+    /**
+     * Sets the directory the results are written to (default: the ERIS cache location).
+     * @param directory path of the directory, empty to disable the disk cache
+     */
+    void
+    setDirectory(const QString& directory);
+
+    QString
+    getDirectory();
+
+private:
+    ResultsCache();
+
+    QString
+    path(const QString& key) const;
+
+    /** Upper bound for the number of results kept in memory */
+    static const int kMaxMemoryEntries = 32;
+
+    std::mutex mLock;
+
+    QMap<QString, Results> mMemory;
+
+    /** Keys in memory, least recently used first */
+    QStringList mOrder;
+
+    QString mDirectory;
+};
+
+}  // namespace eval
+
+#endif /* ERIS_EVAL_RESULTS_CACHE_H */
@@ -0,0 +1,529 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "steady_state_solver.h"
+
+#include "markov_chain.h"
+#include "logger.h"
+
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cmath>
+
+namespace eval
+{
+using graphInternal::MarkovChain;
+
+SteadyStateSolver::SteadyStateSolver(const MarkovChain& chain) :
+    mChain(chain), mEpsilon(1e-10), mOmega(1.0)
+{
+    const std::vector<uint64_t>& rowStarts = mChain.getRowStarts();
+    const std::vector<uint32_t>& columns = mChain.getColumns();
+    const std::vector<double>& rates = mChain.getRates();
+    const size_t stateCount = mChain.getStateCount();
+
+    // transpose by counting sort, the sources of a state end up in ascending order
+    mExitRates.assign(stateCount, 0.0);
+    mInStarts.assign(stateCount + 1, 0);
+    for (uint32_t column : columns)
+    {
+        ++mInStarts[column + 1];
+    }
+    for (size_t i = 0; i < stateCount; ++i)
+    {
+        mInStarts[i + 1] += mInStarts[i];
+    }
+    mInSources.resize(columns.size());
+    mInRates.resize(columns.size());
+    std::vector<uint64_t> next(mInStarts.begin(), mInStarts.end() - 1);
+    for (size_t i = 0; i < stateCount; ++i)
+    {
+        for (uint64_t j = rowStarts[i]; j < rowStarts[i + 1]; ++j)
+        {
+            mExitRates[i] += rates[j];
+            const uint64_t slot = next[columns[j]]++;
+            mInSources[slot] = static_cast<uint32_t>(i);
+            mInRates[slot] = rates[j];
+        }
+    }
+}
+
+SteadyStateSolver::~SteadyStateSolver() = default;
+
+void
+SteadyStateSolver::setPrecision(double epsilon)
+{
+    mEpsilon = epsilon;
+}
+
+void
+SteadyStateSolver::setRelaxation(double omega)
+{
+    mOmega = omega;
+}
+
+bool
+SteadyStateSolver::checkLabels(const std::vector<std::string>& labels) const
+{
+    if (mChain.getStateCount() == 0)
+    {
+        PRINT_ERROR("Cannot solve empty chain");
+        return false;
+    }
+    for (const std::string& label : labels)
+    {
+        if (!mChain.hasLabel(label))
+        {
+            PRINT_ERROR("Unknown label %s", label.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Update>
+bool
+SteadyStateSolver::relax(const std::vector<uint32_t>& unknowns,
+                         std::vector<double>* x,
+                         bool normalise,
+                         Update update) const
+{
+    if (unknowns.empty())
+    {
+        return true;
+    }
+    const unsigned int threads =
+            unknowns.size() < kParallelUnknowns ? 1U
+                                                : std::max(1, QThread::idealThreadCount());
+    const size_t blockSize = (unknowns.size() + threads - 1) / threads;
+
+    // blocks of other threads are read from the previous sweep
+    std::vector<unsigned int> owner;
+    std::vector<double> previous;
+    if (threads > 1)
+    {
+        owner.assign(x->size(), threads);
+        for (size_t i = 0; i < unknowns.size(); ++i)
+        {
+            owner[unknowns[i]] = static_cast<unsigned int>(i / blockSize);
+        }
+    }
+    std::vector<double> changes(threads, 0.0);
+
+    auto sweepBlock = [&](unsigned int block) {
+        std::vector<double>& values = *x;
+        auto read = [&](uint32_t j) {
+            return threads == 1 || owner[j] == block ? values[j] : previous[j];
+        };
+        const size_t first = block * blockSize;
+        const size_t last = std::min(unknowns.size(), first + blockSize);
+        double change = 0.0;
+        for (size_t i = first; i < last; ++i)
+        {
+            const uint32_t state = unknowns[i];
+            const double value = (1.0 - mOmega) * values[state] + mOmega * update(state, read);
+            const double scale = std::max(std::fabs(value), std::fabs(values[state]));
+            if (scale > 0.0)
+            {
+                change = std::max(change, std::fabs(value - values[state]) / scale);
+            }
+            values[state] = value;
+        }
+        changes[block] = change;
+    };
+
+    // The workers are kept alive between the sweeps, the calling thread relaxes block 0. A
+    // semaphore marks the end of a sweep, QThreadPool::waitForDone() would join the workers.
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(std::max(1, static_cast<int>(threads) - 1));
+    threadPool.setExpiryTimeout(-1);
+    QSemaphore swept;
+    for (unsigned int sweep = 0; sweep < kMaxSweeps; ++sweep)
+    {
+        if (threads > 1)
+        {
+            previous = *x;
+            for (unsigned int block = 1; block < threads; ++block)
+            {
+                threadPool.start([&sweepBlock, &swept, block] {
+                    sweepBlock(block);
+                    swept.release();
+                });
+            }
+            sweepBlock(0);
+            swept.acquire(static_cast<int>(threads) - 1);
+        }
+        else
+        {
+            sweepBlock(0);
+        }
+
+        if (normalise)
+        {
+            double sum = 0.0;
+            for (uint32_t state : unknowns)
+            {
+                sum += (*x)[state];
+            }
+            for (uint32_t state : unknowns)
+            {
+                (*x)[state] /= sum;
+            }
+        }
+        if (*std::max_element(changes.begin(), changes.end()) < mEpsilon)
+        {
+            return true;
+        }
+    }
+    PRINT_WARNING("Iteration did not converge within %u sweeps", kMaxSweeps);
+    return false;
+}
+
+uint32_t
+SteadyStateSolver::stronglyConnectedComponents(std::vector<uint32_t>* components) const
+{
+    const std::vector<uint64_t>& rowStarts = mChain.getRowStarts();
+    const std::vector<uint32_t>& columns = mChain.getColumns();
+    const size_t stateCount = mChain.getStateCount();
+    const uint32_t unvisited = ~0U;
+
+    std::vector<uint32_t> index(stateCount, unvisited);
+    std::vector<uint32_t> lowLink(stateCount, 0);
+    std::vector<bool> onStack(stateCount, false);
+    std::vector<uint32_t> stack;
+    // state and next transition to follow, replaces the recursion
+    std::vector<std::pair<uint32_t, uint64_t>> calls;
+    uint32_t counter = 0;
+    uint32_t count = 0;
+    components->assign(stateCount, 0);
+
+    auto visit = [&](uint32_t state) {
+        index[state] = lowLink[state] = counter++;
+        stack.push_back(state);
+        onStack[state] = true;
+        calls.emplace_back(state, rowStarts[state]);
+    };
+
+    for (uint32_t root = 0; root < stateCount; ++root)
+    {
+        if (index[root] != unvisited)
+        {
+            continue;
+        }
+        visit(root);
+        while (!calls.empty())
+        {
+            const uint32_t state = calls.back().first;
+            if (calls.back().second < rowStarts[state + 1])
+            {
+                const uint32_t successor = columns[calls.back().second++];
+                if (index[successor] == unvisited)
+                {
+                    visit(successor);
+                }
+                else if (onStack[successor])
+                {
+                    lowLink[state] = std::min(lowLink[state], index[successor]);
+                }
+                continue;
+            }
+            if (lowLink[state] == index[state])
+            {  // root of a component
+                uint32_t member = 0;
+                do
+                {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member] = false;
+                    (*components)[member] = count;
+                } while (member != state);
+                ++count;
+            }
+            calls.pop_back();
+            if (!calls.empty())
+            {
+                const uint32_t caller = calls.back().first;
+                lowLink[caller] = std::min(lowLink[caller], lowLink[state]);
+            }
+        }
+    }
+    return count;
+}
+
+bool
+SteadyStateSolver::steadyState(const std::vector<std::string>& labels,
+                               std::map<std::string, double>* results)
+{
+    if (!checkLabels(labels))
+    {
+        return false;
+    }
+    const std::vector<uint64_t>& rowStarts = mChain.getRowStarts();
+    const std::vector<uint32_t>& columns = mChain.getColumns();
+    const std::vector<double>& rates = mChain.getRates();
+    const size_t stateCount = mChain.getStateCount();
+
+    std::vector<uint32_t> components;
+    const uint32_t componentCount = stronglyConnectedComponents(&components);
+    std::vector<bool> bottom(componentCount, true);
+    for (size_t i = 0; i < stateCount; ++i)
+    {
+        for (uint64_t j = rowStarts[i]; j < rowStarts[i + 1]; ++j)
+        {
+            if (components[columns[j]] != components[i])
+            {
+                bottom[components[i]] = false;
+            }
+        }
+    }
+
+    // Probability to enter each bottom state from the initial state: the expected sojourn
+    // times t of the transient states solve t * Q_TT = -e_0, the inflow is t * Q_TB.
+    std::vector<double> inflow(stateCount, 0.0);
+    if (bottom[components[0]])
+    {
+        inflow[0] = 1.0;
+    }
+    else
+    {
+        std::vector<uint32_t> transient;
+        for (uint32_t i = 0; i < stateCount; ++i)
+        {
+            if (!bottom[components[i]])
+            {
+                transient.push_back(i);
+            }
+        }
+        std::vector<double> times(stateCount, 0.0);
+        const bool converged =
+                relax(transient, &times, false, [&](uint32_t state, const auto& read) {
+                    double sum = state == 0 ? 1.0 : 0.0;
+                    for (uint64_t j = mInStarts[state]; j < mInStarts[state + 1]; ++j)
+                    {
+                        if (!bottom[components[mInSources[j]]])
+                        {
+                            sum += read(mInSources[j]) * mInRates[j];
+                        }
+                    }
+                    return sum / mExitRates[state];
+                });
+        if (!converged)
+        {
+            return false;
+        }
+        for (uint32_t i : transient)
+        {
+            for (uint64_t j = rowStarts[i]; j < rowStarts[i + 1]; ++j)
+            {
+                if (bottom[components[columns[j]]])
+                {
+                    inflow[columns[j]] += times[i] * rates[j];
+                }
+            }
+        }
+    }
+
+    // members of the bottom components that are entered, grouped by counting sort
+    std::vector<double> mass(componentCount, 0.0);
+    std::vector<uint32_t> memberStarts(componentCount + 1, 0);
+    for (uint32_t i = 0; i < stateCount; ++i)
+    {
+        if (bottom[components[i]])
+        {
+            mass[components[i]] += inflow[i];
+            ++memberStarts[components[i] + 1];
+        }
+    }
+    for (uint32_t c = 0; c < componentCount; ++c)
+    {
+        memberStarts[c + 1] += memberStarts[c];
+    }
+    std::vector<uint32_t> members(memberStarts.back());
+    std::vector<uint32_t> next(memberStarts.begin(), memberStarts.end() - 1);
+    for (uint32_t i = 0; i < stateCount; ++i)
+    {
+        if (bottom[components[i]])
+        {
+            members[next[components[i]]++] = i;
+        }
+    }
+
+    // the long-run distribution is the stationary distribution of each bottom component
+    // weighted by its mass, solved in place
+    std::vector<double> distribution(stateCount, 0.0);
+    for (uint32_t c = 0; c < componentCount; ++c)
+    {
+        if (!bottom[c] || mass[c] <= 0.0)
+        {
+            continue;
+        }
+        const std::vector<uint32_t> component(members.begin() + memberStarts[c],
+                                              members.begin() + memberStarts[c + 1]);
+        if (component.size() > 1)
+        {
+            for (uint32_t i : component)
+            {
+                distribution[i] = 1.0 / static_cast<double>(component.size());
+            }
+            const bool converged =
+                    relax(component, &distribution, true, [&](uint32_t state, const auto& read) {
+                        double sum = 0.0;
+                        for (uint64_t j = mInStarts[state]; j < mInStarts[state + 1]; ++j)
+                        {
+                            if (components[mInSources[j]] == c)
+                            {
+                                sum += read(mInSources[j]) * mInRates[j];
+                            }
+                        }
+                        return sum / mExitRates[state];
+                    });
+            if (!converged)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            distribution[component.front()] = 1.0;
+        }
+        for (uint32_t i : component)
+        {
+            distribution[i] *= mass[c];
+        }
+    }
+
+    for (const std::string& label : labels)
+    {
+        const std::vector<bool>& satisfied = mChain.getLabelStates(label);
+        double probability = 0.0;
+        for (size_t i = 0; i < stateCount; ++i)
+        {
+            if (satisfied[i])
+            {
+                probability += distribution[i];
+            }
+        }
+        (*results)[label] = std::min(1.0, probability);
+    }
+    return true;
+}
+
+bool
+SteadyStateSolver::meanTime(const std::vector<std::string>& labels,
+                            std::map<std::string, double>* results)
+{
+    if (!checkLabels(labels))
+    {
+        return false;
+    }
+    const std::vector<uint64_t>& rowStarts = mChain.getRowStarts();
+    const std::vector<uint32_t>& columns = mChain.getColumns();
+    const std::vector<double>& rates = mChain.getRates();
+    const size_t stateCount = mChain.getStateCount();
+
+    for (const std::string& label : labels)
+    {
+        const std::vector<bool>& goal = mChain.getLabelStates(label);
+        if (goal[0])
+        {
+            (*results)[label] = 0.0;
+            continue;
+        }
+
+        // states that reach the goal: backward search from the goal states
+        std::vector<bool> reaching(goal.begin(), goal.end());
+        std::vector<uint32_t> queue;
+        for (uint32_t i = 0; i < stateCount; ++i)
+        {
+            if (goal[i])
+            {
+                queue.push_back(i);
+            }
+        }
+        auto searchBackwards = [&](std::vector<bool>* found, bool throughGoal) {
+            while (!queue.empty())
+            {
+                const uint32_t state = queue.back();
+                queue.pop_back();
+                for (uint64_t j = mInStarts[state]; j < mInStarts[state + 1]; ++j)
+                {
+                    const uint32_t source = mInSources[j];
+                    if (!(*found)[source] && (throughGoal || !goal[source]))
+                    {
+                        (*found)[source] = true;
+                        queue.push_back(source);
+                    }
+                }
+            }
+        };
+        searchBackwards(&reaching, true);
+
+        // states that miss the goal with a positive probability: those that reach a state not
+        // reaching the goal before the goal
+        std::vector<bool> missing(stateCount, false);
+        for (uint32_t i = 0; i < stateCount; ++i)
+        {
+            if (!reaching[i])
+            {
+                missing[i] = true;
+                queue.push_back(i);
+            }
+        }
+        searchBackwards(&missing, false);
+        if (missing[0])
+        {
+            (*results)[label] = INFINITY;
+            continue;
+        }
+
+        std::vector<uint32_t> unknowns;
+        for (uint32_t i = 0; i < stateCount; ++i)
+        {
+            if (!goal[i] && !missing[i])
+            {
+                unknowns.push_back(i);
+            }
+        }
+        std::vector<double> times(stateCount, 0.0);
+        const bool converged =
+                relax(unknowns, &times, false, [&](uint32_t state, const auto& read) {
+                    double sum = 1.0;
+                    for (uint64_t j = rowStarts[state]; j < rowStarts[state + 1]; ++j)
+                    {
+                        if (!goal[columns[j]])
+                        {
+                            sum += rates[j] * read(columns[j]);
+                        }
+                    }
+                    return sum / mExitRates[state];
+                });
+        if (!converged)
+        {
+            return false;
+        }
+        (*results)[label] = times[0];
+    }
+    return true;
+}
+
+}  // namespace eval
@@ -0,0 +1,136 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_STEADY_STATE_SOLVER_H
+#define ERIS_EVAL_STEADY_STATE_SOLVER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace graphInternal
+{
+class MarkovChain;
+}
+
+namespace eval
+{
+/**
+ * In-process long-run analysis of a (built) MarkovChain, answering
+ * - S=? [ "label" ], the long-run probability of the label, and
+ * - R{"time"}=? [ F "label" ], the mean time until the label holds first (e.g. the MTTF),
+ * by a single solve each instead of transient analyses for large T.
+ *
+ * The chains of ERIS are not ergodic in general, every non-operational state is absorbing. The
+ * long-run distribution is therefore composed of the stationary distributions of the bottom
+ * strongly connected components, weighted by the probability to enter them from the initial
+ * state. All linear systems are solved by Gauss-Seidel iterations with over-relaxation (SOR),
+ * large systems in parallel blocks: every thread relaxes its block in place and reads the other
+ * blocks from the previous sweep.
+ */
+class SteadyStateSolver
+{
+public:
+    explicit SteadyStateSolver(const graphInternal::MarkovChain& chain);
+    ~SteadyStateSolver();
+
+    /**
+     * Sets the relative precision at which the iterations stop (default 1e-10).
+     */
+    void
+    setPrecision(double epsilon);
+
+    /**
+     * Sets the relaxation factor of the SOR iterations, within (0, 2) (default 1, Gauss-Seidel).
+     */
+    void
+    setRelaxation(double omega);
+
+    /**
+     * Computes the long-run probability of each of the given labels.
+     * @param labels names of the labels (must be defined in the chain)
+     * @param results map the probabilities are stored in, keyed by label
+     * @return true on success, false otherwise
+     */
+    bool
+    steadyState(const std::vector<std::string>& labels, std::map<std::string, double>* results);
+
+    /**
+     * Computes the mean time until each of the given labels holds first, starting in the
+     * initial state. The time is infinite if the label is not reached with probability 1.
+     * @param labels names of the labels (must be defined in the chain)
+     * @param results map the times are stored in, keyed by label
+     * @return true on success, false otherwise
+     */
+    bool
+    meanTime(const std::vector<std::string>& labels, std::map<std::string, double>* results);
+
+    /** Upper bound for the number of sweeps of an iteration */
+    static constexpr unsigned int kMaxSweeps = 100000;
+
+    /** Number of unknowns from which the sweeps are parallelised */
+    static constexpr size_t kParallelUnknowns = 50000;
+
+private:
+    /**
+     * Solves x[i] = update(i, read) for all unknowns i by SOR sweeps, read(j) returns the current
+     * value of x[j]. Values of x that are not unknowns stay fixed.
+     * @param unknowns indices of x to relax
+     * @param x solution, holds the initial guess
+     * @param normalise scale the unknowns to sum 1 after every sweep
+     * @return true if converged, false otherwise
+     */
+    template <typename Update>
+    bool
+    relax(const std::vector<uint32_t>& unknowns,
+          std::vector<double>* x,
+          bool normalise,
+          Update update) const;
+
+    /**
+     * Computes the strongly connected components by Tarjan's algorithm (iterative).
+     * @param components filled with the component of every state
+     * @return number of components
+     */
+    uint32_t
+    stronglyConnectedComponents(std::vector<uint32_t>* components) const;
+
+    bool
+    checkLabels(const std::vector<std::string>& labels) const;
+
+    const graphInternal::MarkovChain& mChain;
+
+    /** Exit rate per state */
+    std::vector<double> mExitRates;
+
+    /** Incoming transitions per state (transposed CSR rate matrix) */
+    std::vector<uint64_t> mInStarts;
+    std::vector<uint32_t> mInSources;
+    std::vector<double> mInRates;
+
+    double mEpsilon;
+
+    double mOmega;
+};
+
+}  // namespace eval
+
+#endif /* ERIS_EVAL_STEADY_STATE_SOLVER_H */
@@ -0,0 +1,536 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "transient_simulator.h"
+
+#include "markov_chain.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+uint64_t
+splitMix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+}  // namespace
+
+namespace eval
+{
+using graphInternal::MarkovChain;
+
+TransientSimulator::TransientSimulator(const MarkovChain& chain) :
+    TransientSimulator(chain, Options())
+{
+}
+
+TransientSimulator::TransientSimulator(const MarkovChain& chain, const Options& options) :
+    mChain(chain), mOptions(options), mTrajectories(0), mFailureBias(0.0)
+{
+    mRecoveries.resize(mChain.getRuleCount());
+    for (size_t rule = 0; rule < mRecoveries.size(); ++rule)
+    {
+        mRecoveries[rule] = mChain.isRecoveryRule(rule);
+    }
+}
+
+TransientSimulator::~TransientSimulator() = default;
+
+uint64_t
+TransientSimulator::getTrajectoryCount() const
+{
+    return mTrajectories;
+}
+
+double
+TransientSimulator::getFailureBias() const
+{
+    return mFailureBias;
+}
+
+uint64_t
+TransientSimulator::chernoffBound(double halfWidth, double confidence)
+{
+    return static_cast<uint64_t>(
+            std::ceil(std::log(2.0 / (1.0 - confidence)) / (2.0 * halfWidth * halfWidth)));
+}
+
+double
+TransientSimulator::normalQuantile(double confidence)
+{
+    // P(-z < X < z) = erf(z / sqrt(2)) is monotonic, bisection is precise enough
+    double low = 0.0;
+    double high = 10.0;
+    for (int i = 0; i < 100; ++i)
+    {
+        const double z = (low + high) / 2;
+        (std::erf(z / std::sqrt(2.0)) < confidence ? low : high) = z;
+    }
+    return (low + high) / 2;
+}
+
+void
+TransientSimulator::wilsonInterval(uint64_t successes,
+                                   uint64_t trials,
+                                   double z,
+                                   double* lower,
+                                   double* upper)
+{
+    if (trials == 0)
+    {
+        *lower = 0.0;
+        *upper = 1.0;
+        return;
+    }
+    const double n = static_cast<double>(trials);
+    const double p = successes / n;
+    const double z2 = z * z;
+    const double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+    const double width = z / (1 + z2 / n) * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n));
+    *lower = std::max(0.0, center - width);
+    *upper = std::min(1.0, center + width);
+}
+
+void
+TransientSimulator::Tally::add(const Tally& other)
+{
+    for (size_t i = 0; i < sums.size(); ++i)
+    {
+        sums[i] += other.sums[i];
+        squares[i] += other.squares[i];
+    }
+    trials += other.trials;
+    transitions += other.transitions;
+}
+
+void
+TransientSimulator::moments(const Tally& tally, size_t entry, double* mean, double* standardError)
+{
+    const double n = static_cast<double>(tally.trials);
+    *mean = tally.sums[entry] / n;
+    const double variance = tally.trials > 1
+                                    ? std::max(0.0, tally.squares[entry] / n - *mean * *mean)
+                                              * n / (n - 1)
+                                    : 0.0;
+    *standardError = std::sqrt(variance / n);
+}
+
+double
+TransientSimulator::random(uint64_t stream, uint64_t counter) const
+{
+    const uint64_t bits = splitMix64(splitMix64(mOptions.seed ^ splitMix64(stream)) + counter);
+    return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+double
+TransientSimulator::biasRates(const std::vector<double>& rates,
+                              double exitRate,
+                              double bias,
+                              double horizon,
+                              std::vector<double>* biased) const
+{
+    double failureRate = 0.0;
+    double recoveryRate = 0.0;
+    size_t failures = 0;
+    for (size_t rule = 0; rule < rates.size(); ++rule)
+    {
+        if (rates[rule] <= 0.0)
+        {
+            continue;
+        }
+        if (mRecoveries[rule])
+        {
+            recoveryRate += rates[rule];
+        }
+        else
+        {
+            failureRate += rates[rule];
+            ++failures;
+        }
+    }
+    biased->assign(rates.size(), 0.0);
+    if (failures == 0)
+    {  // nothing to bias
+        *biased = rates;
+        return exitRate;
+    }
+
+    double biasedFailureRate = 0.0;
+    double biasedExitRate = exitRate;
+    if (recoveryRate == 0.0)
+    {  // accelerate, such that a failure occurs before the horizon with the probability bias
+        biasedFailureRate = std::max(failureRate, -std::log(1.0 - bias) / horizon);
+        biasedExitRate = biasedFailureRate;
+    }
+    else
+    {  // keep the sojourn time, choose a failure with the probability bias
+        biasedFailureRate = std::max(bias, failureRate / exitRate) * exitRate;
+    }
+    for (size_t rule = 0; rule < rates.size(); ++rule)
+    {
+        if (rates[rule] <= 0.0)
+        {
+            continue;
+        }
+        (*biased)[rule] = mRecoveries[rule]
+                                  ? rates[rule] / recoveryRate * (exitRate - biasedFailureRate)
+                                  : biasedFailureRate / static_cast<double>(failures);
+    }
+    return biasedExitRate;
+}
+
+void
+TransientSimulator::simulateTrajectory(uint64_t index,
+                                       const std::vector<double>& times,
+                                       const std::vector<std::string>& labels,
+                                       double bias,
+                                       Tally* tally) const
+{
+    std::vector<uint64_t> state(mChain.getStateWords(), 0);
+    std::vector<double> rates;
+    std::vector<double> biased;
+    uint64_t counter = 0;
+    double now = 0.0;
+    size_t next = 0;  // next time point to record
+    // logarithm of the likelihood ratio of the path up to now
+    double logRatio = 0.0;
+
+    auto record = [&](double until, double drift) {
+        for (; next < times.size() && times[next] < until; ++next)
+        {
+            const double ratio =
+                    bias > 0.0 ? std::exp(logRatio - drift * (times[next] - now)) : 1.0;
+            for (size_t l = 0; l < labels.size(); ++l)
+            {
+                if (mChain.satisfies(labels[l], state.data()))
+                {
+                    tally->sums[l * times.size() + next] += ratio;
+                    tally->squares[l * times.size() + next] += ratio * ratio;
+                }
+            }
+        }
+    };
+
+    ++tally->trials;
+    while (next < times.size())
+    {
+        const double exitRate = mChain.getRuleRates(state.data(), &rates);
+        if (exitRate <= 0.0)
+        {  // absorbing, the state holds for all remaining time points
+            record(INFINITY, 0.0);
+            break;
+        }
+        double biasedExitRate = exitRate;
+        if (bias > 0.0)
+        {
+            biasedExitRate = biasRates(rates, exitRate, bias, times.back(), &biased);
+        }
+        const std::vector<double>& race = bias > 0.0 ? biased : rates;
+        // the likelihood ratio of a sojourn decays with the difference of the exit rates
+        const double drift = exitRate - biasedExitRate;
+
+        // 1 - u is in (0, 1], hence the logarithm is finite
+        const double delay = -std::log(1.0 - random(index, counter++)) / biasedExitRate;
+        record(now + delay, drift);
+        logRatio -= drift * delay;
+        now += delay;
+        if (next == times.size())
+        {
+            break;
+        }
+
+        // the rule that wins the race
+        double target = random(index, counter++) * biasedExitRate;
+        size_t rule = 0;
+        for (; rule + 1 < race.size(); ++rule)
+        {
+            if (race[rule] > 0.0 && target < race[rule])
+            {
+                break;
+            }
+            target -= race[rule];
+        }
+        while (race[rule] <= 0.0)
+        {  // rounding left the last enabled rule behind
+            --rule;
+        }
+        if (bias > 0.0)
+        {
+            logRatio += std::log(rates[rule] / race[rule]);
+        }
+        mChain.fireRule(rule, state.data());
+        ++tally->transitions;
+    }
+}
+
+template <typename Converged>
+void
+TransientSimulator::run(const std::vector<double>& times,
+                        const std::vector<std::string>& labels,
+                        double bias,
+                        uint64_t offset,
+                        uint64_t count,
+                        Converged converged,
+                        Tally* tally) const
+{
+    const uint64_t batchSize = std::max<uint64_t>(1, std::min(mOptions.batchSize, count));
+    const uint64_t batches = (count + batchSize - 1) / batchSize;
+    const unsigned int threads = mOptions.threads > 0
+                                         ? mOptions.threads
+                                         : std::max(1U, std::thread::hardware_concurrency());
+
+    tally->sums.assign(labels.size() * times.size(), 0.0);
+    tally->squares.assign(tally->sums.size(), 0.0);
+    tally->trials = 0;
+    tally->transitions = 0;
+    std::atomic<uint64_t> nextBatch(0);
+    std::atomic_bool done(false);
+    std::mutex mutex;
+
+    auto worker = [&]() {
+        Tally local;
+        while (!done.load(std::memory_order_acquire))
+        {
+            const uint64_t batch = nextBatch.fetch_add(1, std::memory_order_acq_rel);
+            if (batch >= batches)
+            {
+                break;
+            }
+            const uint64_t first = batch * batchSize;
+            const uint64_t last = std::min(count, first + batchSize);
+            local.sums.assign(tally->sums.size(), 0.0);
+            local.squares.assign(tally->sums.size(), 0.0);
+            local.trials = 0;
+            local.transitions = 0;
+            for (uint64_t index = first; index < last; ++index)
+            {
+                simulateTrajectory(offset + index, times, labels, bias, &local);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            tally->add(local);
+            if (converged(*tally))
+            {
+                done.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 1; i < threads; ++i)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool)
+    {
+        thread.join();
+    }
+}
+
+double
+TransientSimulator::tuneBias(const std::vector<double>& times,
+                             const std::vector<std::string>& labels) const
+{
+    static const double candidates[] = {0.3, 0.5, 0.7, 0.9};
+    static const uint64_t pilotTrajectories = 5000;
+
+    double best = candidates[1];
+    size_t bestMissing = labels.size() + 1;
+    double bestWork = INFINITY;
+    for (size_t c = 0; c < sizeof(candidates) / sizeof(candidates[0]); ++c)
+    {
+        // pilot runs use streams of their own, disjoint from the actual simulation
+        Tally tally;
+        run(times, labels, candidates[c], (c + 1) << 56, pilotTrajectories,
+            [](const Tally&) { return false; }, &tally);
+
+        // labels that were never observed weigh more than any variance
+        size_t missing = 0;
+        double relativeVariance = 0.0;
+        for (size_t l = 0; l < labels.size(); ++l)
+        {
+            bool observed = false;
+            for (size_t j = 0; j < times.size(); ++j)
+            {
+                double mean = 0.0;
+                double standardError = 0.0;
+                moments(tally, l * times.size() + j, &mean, &standardError);
+                if (mean > 0.0)
+                {
+                    observed = true;
+                    relativeVariance = std::max(relativeVariance,
+                                                std::pow(standardError / mean, 2) * tally.trials);
+                }
+            }
+            missing += observed ? 0 : 1;
+        }
+        // the cost of a trajectory grows with its transitions
+        const double work = relativeVariance
+                            * (1.0 + static_cast<double>(tally.transitions) / tally.trials);
+        PRINT_INFO("Failure bias %.1f : relative variance %g, %.1f transitions per trajectory",
+                   candidates[c], relativeVariance,
+                   static_cast<double>(tally.transitions) / tally.trials);
+        if (missing < bestMissing || (missing == bestMissing && work < bestWork))
+        {
+            best = candidates[c];
+            bestMissing = missing;
+            bestWork = work;
+        }
+    }
+    return best;
+}
+
+bool
+TransientSimulator::simulate(const ExperimentInterval& interval,
+                             const std::vector<std::string>& labels,
+                             std::map<std::string, Estimates>* results)
+{
+    mTrajectories = 0;
+    mFailureBias = 0.0;
+    if (!mChain.isValid() || interval.from < 0 || interval.to < interval.from)
+    {
+        PRINT_ERROR("Cannot simulate invalid chain or interval %s", interval.toString().c_str());
+        return false;
+    }
+    for (const std::string& label : labels)
+    {
+        if (!mChain.hasLabel(label))
+        {
+            PRINT_ERROR("Unknown label %s", label.c_str());
+            return false;
+        }
+    }
+
+    std::vector<double> times;
+    for (int t = interval.from; t <= interval.to; t += interval.steps)
+    {
+        times.push_back(t);
+        if (interval.steps <= 0)
+        {  // single time point
+            break;
+        }
+    }
+
+    const double z = normalQuantile(mOptions.confidence);
+    Tally tally;
+    if (mOptions.importanceSampling && times.back() > 0.0)
+    {
+        mFailureBias = mOptions.failureBias > 0.0 && mOptions.failureBias < 1.0
+                               ? mOptions.failureBias
+                               : tuneBias(times, labels);
+        const uint64_t bound = mOptions.maxTrajectories > 0 ? mOptions.maxTrajectories
+                                                            : kMaxRareEventTrajectories;
+        auto converged = [&](const Tally& current) {
+            for (size_t l = 0; l < labels.size(); ++l)
+            {
+                bool observed = false;
+                for (size_t j = 0; j < times.size(); ++j)
+                {
+                    double mean = 0.0;
+                    double standardError = 0.0;
+                    moments(current, l * times.size() + j, &mean, &standardError);
+                    if (mean > 0.0 && z * standardError > mOptions.relativeError * mean)
+                    {
+                        return false;
+                    }
+                    observed = observed || mean > 0.0;
+                }
+                if (!observed)
+                {  // zero is only accepted at time points where the label was observed later
+                    return false;
+                }
+            }
+            return true;
+        };
+        run(times, labels, mFailureBias, 0, bound, converged, &tally);
+    }
+    else
+    {
+        const uint64_t bound = mOptions.maxTrajectories > 0
+                                       ? mOptions.maxTrajectories
+                                       : chernoffBound(mOptions.halfWidth, mOptions.confidence);
+        auto converged = [&](const Tally& current) {
+            for (double successes : current.sums)
+            {
+                double lower = 0.0;
+                double upper = 1.0;
+                wilsonInterval(static_cast<uint64_t>(successes), current.trials, z, &lower,
+                               &upper);
+                if ((upper - lower) / 2 > mOptions.halfWidth)
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+        run(times, labels, 0.0, 0, bound, converged, &tally);
+    }
+
+    mTrajectories = tally.trials;
+    double worst = 0.0;
+    for (size_t l = 0; l < labels.size(); ++l)
+    {
+        Estimates& estimates = (*results)[labels[l]];
+        for (size_t j = 0; j < times.size(); ++j)
+        {
+            Estimate estimate;
+            estimate.time = times[j];
+            moments(tally, l * times.size() + j, &estimate.probability, &estimate.standardError);
+            if (mFailureBias > 0.0)
+            {
+                estimate.lower = std::max(0.0, estimate.probability - z * estimate.standardError);
+                estimate.upper = std::min(1.0, estimate.probability + z * estimate.standardError);
+                if (estimate.probability > 0.0)
+                {
+                    worst = std::max(worst, estimate.standardError / estimate.probability);
+                }
+            }
+            else
+            {
+                wilsonInterval(static_cast<uint64_t>(tally.sums[l * times.size() + j]),
+                               tally.trials, z, &estimate.lower, &estimate.upper);
+            }
+            estimates.push_back(estimate);
+        }
+    }
+    if (mFailureBias > 0.0)
+    {
+        PRINT_INFO("Simulated %lu trajectories with failure bias %.1f, relative standard "
+                   "error at most %g",
+                   static_cast<unsigned long>(tally.trials), mFailureBias, worst);
+    }
+    else
+    {
+        PRINT_INFO("Simulated %lu trajectories", static_cast<unsigned long>(tally.trials));
+    }
+    return true;
+}
+
+}  // namespace eval
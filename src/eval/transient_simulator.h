@@ -0,0 +1,247 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_TRANSIENT_SIMULATOR_H
+#define ERIS_EVAL_TRANSIENT_SIMULATOR_H
+
+#include "experiment.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace graphInternal
+{
+class MarkovChain;
+}
+
+namespace eval
+{
+/**
+ * Statistical model checking of a (compiled, not built) MarkovChain by discrete event
+ * simulation, for models whose state space is too large for the TransientSolver. Every
+ * trajectory is an exponential race of the transition rules enabled in the current state, the
+ * state space is never enumerated.
+ *
+ * Answers properties of the form P=? [ F[T,T] "label" ] for every T of an experiment interval
+ * from the same trajectories. Trajectories are simulated in batches by all cores until the Wilson
+ * score interval of every estimate is narrow enough, at most as many as the Chernoff (Okamoto)
+ * bound requires for the absolute error.
+ *
+ * Every trajectory draws its random numbers from its own counter based stream (a hash of the
+ * seed, the trajectory index and a counter), hence a trajectory does not depend on the thread
+ * it was simulated by.
+ *
+ * Highly reliable architectures fail with probabilities far below the precision of plain
+ * simulation. With importanceSampling set, trajectories are simulated under balanced failure
+ * biasing and weighted by their likelihood ratio: in states with enabled recoveries, failures
+ * and attacks are chosen with the probability failureBias (evenly among them) and the sojourn
+ * times are kept, in states without recoveries the failures are accelerated such that one of
+ * them occurs before the last time point with the probability failureBias. The estimates then
+ * have normal confidence intervals and the simulation stops once every non-zero estimate is
+ * within the relative error. Unless given, failureBias is tuned by short pilot runs.
+ */
+class TransientSimulator
+{
+public:
+    struct Options
+    {
+        /** Confidence level of the intervals */
+        double confidence = 0.95;
+        /** Target half width of the confidence intervals */
+        double halfWidth = 0.01;
+        /** Upper bound for the number of trajectories, 0 for the Chernoff bound */
+        uint64_t maxTrajectories = 0;
+        /** Number of worker threads, 0 for the number of cores */
+        unsigned int threads = 0;
+        uint64_t seed = 0;
+        /** Trajectories per batch, the stopping criterion is checked after every batch */
+        uint64_t batchSize = 1000;
+        /** Rare event mode, estimates small probabilities by importance sampling */
+        bool importanceSampling = false;
+        /** Probability of choosing a failure in the rare event mode, 0 to tune automatically */
+        double failureBias = 0.0;
+        /** Target relative half width of the confidence intervals in the rare event mode */
+        double relativeError = 0.1;
+    };
+
+    /** Estimated probability and confidence interval at a time point */
+    struct Estimate
+    {
+        double time;
+        double probability;
+        double lower;
+        double upper;
+        /** Standard deviation of the estimator */
+        double standardError;
+    };
+
+    using Estimates = std::vector<Estimate>;
+
+    explicit TransientSimulator(const graphInternal::MarkovChain& chain);
+    TransientSimulator(const graphInternal::MarkovChain& chain, const Options& options);
+    ~TransientSimulator();
+
+    /**
+     * Estimates the probability of being in a state satisfying each of the given labels at
+     * every time point T=from:steps:to of the interval.
+     * @param interval experiment interval
+     * @param labels names of the labels (must be defined in the chain)
+     * @param results map the estimates are stored in, keyed by label
+     * @return true on success, false otherwise
+     */
+    bool
+    simulate(const ExperimentInterval& interval,
+             const std::vector<std::string>& labels,
+             std::map<std::string, Estimates>* results);
+
+    /**
+     * Number of trajectories the last simulate() used, excluding the pilot runs.
+     */
+    uint64_t
+    getTrajectoryCount() const;
+
+    /**
+     * Failure bias the last simulate() used, 0 without importance sampling.
+     */
+    double
+    getFailureBias() const;
+
+    /**
+     * Number of trajectories that guarantees an absolute error of at most halfWidth with the
+     * given confidence (Okamoto's bound, derived from the Chernoff-Hoeffding inequality).
+     */
+    static uint64_t
+    chernoffBound(double halfWidth, double confidence);
+
+    /**
+     * Computes the Wilson score interval of a binomial proportion.
+     * @param successes number of successes
+     * @param trials number of trials
+     * @param z quantile of the standard normal distribution
+     * @param lower set to the lower bound
+     * @param upper set to the upper bound
+     */
+    static void
+    wilsonInterval(uint64_t successes, uint64_t trials, double z, double* lower, double* upper);
+
+    /**
+     * Returns the quantile z of the standard normal distribution with P(-z < X < z) = confidence.
+     */
+    static double
+    normalQuantile(double confidence);
+
+    /** Upper bound for the number of trajectories in the rare event mode */
+    static constexpr uint64_t kMaxRareEventTrajectories = 100000000;
+
+private:
+    /** Sums of the (weighted) indicators of all labels and time points */
+    struct Tally
+    {
+        /** Indexed by label * times.size() + time point */
+        std::vector<double> sums;
+        std::vector<double> squares;
+        uint64_t trials = 0;
+        uint64_t transitions = 0;
+
+        void
+        add(const Tally& other);
+    };
+
+    /**
+     * Simulates a single trajectory and adds for every label and time point its likelihood
+     * ratio (1 without bias) if the label holds.
+     * @param index of the trajectory, selects the random stream
+     * @param times time points in ascending order
+     * @param labels names of the labels
+     * @param bias failure bias, 0 to simulate the original chain
+     * @param tally sums the trajectory is added to
+     */
+    void
+    simulateTrajectory(uint64_t index,
+                       const std::vector<double>& times,
+                       const std::vector<std::string>& labels,
+                       double bias,
+                       Tally* tally) const;
+
+    /**
+     * Applies balanced failure biasing to the rule rates of a state.
+     * @param rates rates of the original chain
+     * @param exitRate exit rate of the original chain
+     * @param bias failure bias
+     * @param horizon last time point
+     * @param biased resized and filled with the biased rates
+     * @return the biased exit rate
+     */
+    double
+    biasRates(const std::vector<double>& rates,
+              double exitRate,
+              double bias,
+              double horizon,
+              std::vector<double>* biased) const;
+
+    /**
+     * Simulates the trajectories [offset, offset + count) in batches on all threads until
+     * converged(tally) holds after a batch.
+     */
+    template <typename Converged>
+    void
+    run(const std::vector<double>& times,
+        const std::vector<std::string>& labels,
+        double bias,
+        uint64_t offset,
+        uint64_t count,
+        Converged converged,
+        Tally* tally) const;
+
+    /**
+     * Selects the failure bias with the least work normalized variance in short pilot runs.
+     */
+    double
+    tuneBias(const std::vector<double>& times, const std::vector<std::string>& labels) const;
+
+    /**
+     * Computes the mean and the standard error of an entry of the tally.
+     */
+    static void
+    moments(const Tally& tally, size_t entry, double* mean, double* standardError);
+
+    /**
+     * Counter based random number in [0, 1) of the given stream.
+     */
+    double
+    random(uint64_t stream, uint64_t counter) const;
+
+    const graphInternal::MarkovChain& mChain;
+
+    Options mOptions;
+
+    /** Whether each rule of the chain is a recovery */
+    std::vector<bool> mRecoveries;
+
+    uint64_t mTrajectories;
+
+    double mFailureBias;
+};
+
+}  // namespace eval
+
+#endif /* ERIS_EVAL_TRANSIENT_SIMULATOR_H */
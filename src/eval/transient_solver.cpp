@@ -0,0 +1,370 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "transient_solver.h"
+
+#include "markov_chain.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace eval
+{
+using graphInternal::MarkovChain;
+
+TransientSolver::TransientSolver(const MarkovChain& chain) :
+    mChain(chain), mRate(0.0), mEpsilon(1e-12)
+{
+    const std::vector<uint64_t>& rowStarts = mChain.getRowStarts();
+    const std::vector<double>& rates = mChain.getRates();
+    mExitRates.assign(mChain.getStateCount(), 0.0);
+    for (size_t i = 0; i < mExitRates.size(); ++i)
+    {
+        for (uint64_t j = rowStarts[i]; j < rowStarts[i + 1]; ++j)
+        {
+            mExitRates[i] += rates[j];
+        }
+        mRate = std::max(mRate, mExitRates[i]);
+    }
+    // same safety margin as PRISM, keeps the diagonal of P strictly positive
+    mRate *= 1.02;
+}
+
+TransientSolver::~TransientSolver() = default;
+
+const TransientSolver::Curve&
+TransientSolver::getTruncationErrors() const
+{
+    return mTruncationErrors;
+}
+
+void
+TransientSolver::setPrecision(double epsilon)
+{
+    mEpsilon = epsilon;
+}
+
+void
+TransientSolver::poissonWeights(double lambda,
+                                double epsilon,
+                                size_t* left,
+                                std::vector<double>* weights)
+{
+    weights->clear();
+    if (lambda <= 0.0)
+    {
+        *left = 0;
+        weights->push_back(1.0);
+        return;
+    }
+
+    // Start at the mode with an unnormalised weight of 1 and walk outwards, this avoids the
+    // underflow of exp(-lambda) for large lambda.
+    const size_t mode = static_cast<size_t>(std::floor(lambda));
+    const double cutoff = epsilon * 1e-3;
+    double sum = 1.0;
+
+    std::vector<double> lower;
+    double weight = 1.0;
+    size_t k = mode;
+    while (k > 0)
+    {
+        weight *= static_cast<double>(k) / lambda;
+        if (weight < cutoff * sum)
+        {
+            break;
+        }
+        lower.push_back(weight);
+        sum += weight;
+        --k;
+    }
+
+    std::vector<double> upper;
+    weight = 1.0;
+    k = mode;
+    while (true)
+    {
+        weight *= lambda / static_cast<double>(k + 1);
+        if (weight < cutoff * sum)
+        {
+            break;
+        }
+        upper.push_back(weight);
+        sum += weight;
+        ++k;
+    }
+
+    weights->reserve(lower.size() + 1 + upper.size());
+    weights->insert(weights->end(), lower.rbegin(), lower.rend());
+    weights->push_back(1.0);
+    weights->insert(weights->end(), upper.begin(), upper.end());
+    for (double& w : *weights)
+    {
+        w /= sum;
+    }
+    *left = mode - lower.size();
+}
+
+void
+TransientSolver::multiply(const std::vector<double>& in, std::vector<double>* out)
+{
+    const std::vector<uint64_t>& rowStarts = mChain.getRowStarts();
+    const std::vector<uint32_t>& columns = mChain.getColumns();
+    const std::vector<double>& rates = mChain.getRates();
+    std::vector<double>& result = *out;
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        result[i] = in[i] * (1.0 - mExitRates[i] / mRate);
+    }
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        if (in[i] == 0.0)
+        {
+            continue;
+        }
+        const double scaled = in[i] / mRate;
+        for (uint64_t j = rowStarts[i]; j < rowStarts[i + 1]; ++j)
+        {
+            result[columns[j]] += scaled * rates[j];
+        }
+    }
+}
+
+void
+TransientSolver::advance(std::vector<double>* distribution, double t)
+{
+    if (mRate <= 0.0 || t <= 0.0)
+    {  // nothing can happen
+        return;
+    }
+    size_t left = 0;
+    std::vector<double> weights;
+    poissonWeights(mRate * t, mEpsilon, &left, &weights);
+
+    const size_t right = left + weights.size();
+    std::vector<double> current = *distribution;
+    std::vector<double> next(current.size(), 0.0);
+    std::vector<double> result(current.size(), 0.0);
+    double accumulated = 0.0;
+
+    for (size_t k = 0; k < right; ++k)
+    {
+        if (k >= left)
+        {
+            const double weight = weights[k - left];
+            for (size_t i = 0; i < current.size(); ++i)
+            {
+                result[i] += weight * current[i];
+            }
+            accumulated += weight;
+        }
+        if (k + 1 == right)
+        {
+            break;
+        }
+        multiply(current, &next);
+
+        // Steady state detection: once the iteration stops changing, the remaining weights
+        // can be applied at once
+        double difference = 0.0;
+        for (size_t i = 0; i < current.size(); ++i)
+        {
+            difference = std::max(difference, std::fabs(next[i] - current[i]));
+        }
+        current.swap(next);
+        if (difference < mEpsilon * 1e-2)
+        {
+            const double remaining = std::max(0.0, 1.0 - accumulated);
+            for (size_t i = 0; i < current.size(); ++i)
+            {
+                result[i] += remaining * current[i];
+            }
+            break;
+        }
+    }
+    distribution->swap(result);
+}
+
+double
+TransientSolver::probability(const std::vector<double>& distribution,
+                             const std::string& label) const
+{
+    const std::vector<bool>& satisfied = mChain.getLabelStates(label);
+    double probability = 0.0;
+    for (size_t i = 0; i < distribution.size(); ++i)
+    {
+        if (satisfied[i])
+        {
+            probability += distribution[i];
+        }
+    }
+    return std::min(1.0, probability);
+}
+
+bool
+TransientSolver::solve(const ExperimentInterval& interval,
+                       const std::vector<std::string>& labels,
+                       std::map<std::string, Curve>* results)
+{
+    const size_t stateCount = mChain.getStateCount();
+    if (stateCount == 0 || interval.from < 0 || interval.to < interval.from)
+    {
+        PRINT_ERROR("Cannot solve empty chain or invalid interval %s", interval.toString().c_str());
+        return false;
+    }
+    for (const std::string& label : labels)
+    {
+        if (!mChain.hasLabel(label))
+        {
+            PRINT_ERROR("Unknown label %s", label.c_str());
+            return false;
+        }
+    }
+
+    std::vector<double> distribution(stateCount, 0.0);
+    distribution[0] = 1.0;  // initial state
+    double previous = 0.0;
+    const uint32_t truncation = mChain.getTruncationState();
+    mTruncationErrors.clear();
+
+    for (int t = interval.from; t <= interval.to; t += interval.steps)
+    {
+        advance(&distribution, t - previous);
+        previous = t;
+        for (const std::string& label : labels)
+        {
+            (*results)[label].emplace_back(t, probability(distribution, label));
+        }
+        mTruncationErrors.emplace_back(
+                t, truncation == MarkovChain::kNoState ? 0.0 : distribution[truncation]);
+        if (interval.steps <= 0)
+        {  // single time point
+            break;
+        }
+    }
+    return true;
+}
+
+bool
+TransientSolver::solveBounded(MarkovChain& chain,
+                              const ExperimentInterval& interval,
+                              const std::vector<std::string>& labels,
+                              double tolerance,
+                              std::map<std::string, Curve>* results,
+                              Curve* errors)
+{
+    const unsigned int initialDepth = chain.getFailureDepth();
+    bool solved = false;
+    for (unsigned int depth = 1; depth <= chain.getNodeCount(); ++depth)
+    {
+        chain.setFailureDepth(depth);
+        if (!chain.build())
+        {
+            PRINT_WARNING("%s at failure depth %u, the truncation error remains %g",
+                          chain.getError().c_str(), depth,
+                          errors->empty() ? 1.0 : errors->back().second);
+            break;
+        }
+        TransientSolver solver(chain);
+        std::map<std::string, Curve> curves;
+        if (!solver.solve(interval, labels, &curves))
+        {
+            break;
+        }
+        results->swap(curves);
+        *errors = solver.getTruncationErrors();
+        solved = true;
+
+        // the truncation state is absorbing, its probability grows with time
+        if (errors->empty() || errors->back().second <= tolerance)
+        {
+            PRINT_INFO("Failure depth %u of %u, truncation error %g", depth,
+                       chain.getNodeCount(), errors->empty() ? 0.0 : errors->back().second);
+            break;
+        }
+    }
+    chain.setFailureDepth(initialDepth);
+    return solved;
+}
+
+bool
+TransientSolver::solvePiecewise(std::vector<Segment> segments,
+                                const std::vector<std::string>& labels,
+                                std::map<std::string, Curve>* results)
+{
+    std::shared_ptr<MarkovChain> chain;
+    std::unique_ptr<TransientSolver> solver;
+    std::vector<double> distribution;
+    double previous = 0.0;
+
+    for (Segment& segment : segments)
+    {
+        if (segment.chain == nullptr || segment.until < previous)
+        {
+            PRINT_ERROR("Invalid segment at T=%f", segment.until);
+            return false;
+        }
+        if (segment.chain != chain)
+        {  // rates changed, continue with the distribution on the new chain
+            // the members of a lumped group may differ in the next segment
+            segment.chain->setSymmetryReduction(false);
+            if (!segment.chain->build(MarkovChain::kDefaultMaxStates, chain.get()))
+            {
+                PRINT_ERROR("Cannot build chain at T=%f : %s", segment.until,
+                            segment.chain->getError().c_str());
+                return false;
+            }
+            if (chain == nullptr)
+            {
+                distribution.assign(segment.chain->getStateCount(), 0.0);
+                distribution[0] = 1.0;  // initial state
+            }
+            else
+            {
+                std::vector<double> carried;
+                segment.chain->transferDistribution(distribution, &carried);
+                distribution.swap(carried);
+            }
+            solver.reset();
+            chain = segment.chain;
+            solver.reset(new TransientSolver(*chain));
+            for (const std::string& label : labels)
+            {
+                if (!chain->hasLabel(label))
+                {
+                    PRINT_ERROR("Unknown label %s", label.c_str());
+                    return false;
+                }
+            }
+        }
+        segment.chain.reset();
+        solver->advance(&distribution, segment.until - previous);
+        previous = segment.until;
+        for (const std::string& label : labels)
+        {
+            (*results)[label].emplace_back(segment.until,
+                                           solver->probability(distribution, label));
+        }
+    }
+    return true;
+}
+
+}  // namespace eval
@@ -0,0 +1,172 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_EVAL_TRANSIENT_SOLVER_H
+#define ERIS_EVAL_TRANSIENT_SOLVER_H
+
+#include "experiment.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace graphInternal
+{
+class MarkovChain;
+}
+
+namespace eval
+{
+/**
+ * In-process transient analysis of a (built) MarkovChain by uniformization.
+ * Answers properties of the form P=? [ F[T,T] "label" ] for every T of an experiment interval in
+ * a single sweep, i.e., the distribution is carried forward from one time point to the next.
+ */
+class TransientSolver
+{
+public:
+    /** Probability per time point: (T, P) */
+    using Curve = std::vector<std::pair<double, double>>;
+
+    /**
+     * Time point of a piecewise constant experiment: the chain holds the rates that apply from
+     * the previous time point up to this one.
+     */
+    struct Segment
+    {
+        double until;
+        std::shared_ptr<graphInternal::MarkovChain> chain;
+    };
+
+    explicit TransientSolver(const graphInternal::MarkovChain& chain);
+    ~TransientSolver();
+
+    /**
+     * Sets the truncation error of the Poisson series per time step (default 1e-12).
+     * @param epsilon precision
+     */
+    void
+    setPrecision(double epsilon);
+
+    /**
+     * Computes the probability of being in a state satisfying each of the given labels at every
+     * time point T=from:steps:to of the interval.
+     * @param interval experiment interval
+     * @param labels names of the labels (must be defined in the chain)
+     * @param results map the curves are stored in, keyed by label
+     * @return true on success, false otherwise
+     */
+    bool
+    solve(const ExperimentInterval& interval,
+          const std::vector<std::string>& labels,
+          std::map<std::string, Curve>* results);
+
+    /**
+     * Probability of the truncation state (see MarkovChain::setFailureDepth()) at every time
+     * point of the last solve(). The exact probability of a label lies between the computed one
+     * and the computed one plus this error. Zero if the chain is not truncated.
+     */
+    const Curve&
+    getTruncationErrors() const;
+
+    /**
+     * Computes the label probabilities on failure depth bounded state spaces. The depth is
+     * increased from 1 until the truncation error is at most the tolerance at every time point,
+     * the full state space is reached or the state space exceeds its limit (the results of the
+     * largest depth are kept then). The failure depth of the chain is restored afterwards.
+     * @param chain markov chain, rebuilt for every depth
+     * @param interval experiment interval
+     * @param labels names of the labels (must be defined in the chain)
+     * @param tolerance accepted truncation error
+     * @param results map the curves are stored in, keyed by label
+     * @param errors filled with the truncation errors of the results
+     * @return true on success, false if not even depth 1 could be solved
+     */
+    static bool
+    solveBounded(graphInternal::MarkovChain& chain,
+                 const ExperimentInterval& interval,
+                 const std::vector<std::string>& labels,
+                 double tolerance,
+                 std::map<std::string, Curve>* results,
+                 Curve* errors);
+
+    /**
+     * Computes the label probabilities for a model whose rates change over time, e.g. due to the
+     * time dependent rates of submodules. The distribution is carried forward from one segment
+     * to the next, consecutive segments sharing a chain are solved without rebuilding it.
+     * The chains are (re)built, each one seeded with the states of its predecessor, and released
+     * as soon as the analysis moved on.
+     * @param segments time points in ascending order and the chains valid up to them
+     * @param labels names of the labels (must be defined in every chain)
+     * @param results map the curves are stored in, keyed by label, one point per segment
+     * @return true on success, false otherwise
+     */
+    static bool
+    solvePiecewise(std::vector<Segment> segments,
+                   const std::vector<std::string>& labels,
+                   std::map<std::string, Curve>* results);
+
+    /**
+     * Computes the truncated, normalised Poisson probabilities for the given parameter.
+     * @param lambda parameter (uniformization rate times time)
+     * @param epsilon accepted truncation error
+     * @param left set to the index of the first weight
+     * @param weights filled with the weights from left onwards
+     */
+    static void
+    poissonWeights(double lambda, double epsilon, size_t* left, std::vector<double>* weights);
+
+private:
+    /**
+     * Advances the given distribution by time t: pi := pi * exp(Q t).
+     */
+    void
+    advance(std::vector<double>* distribution, double t);
+
+    /**
+     * One uniformized step: out := in * P with P = I + Q/q.
+     */
+    void
+    multiply(const std::vector<double>& in, std::vector<double>* out);
+
+    /**
+     * Sums the probabilities of the states satisfying the given label.
+     */
+    double
+    probability(const std::vector<double>& distribution, const std::string& label) const;
+
+    const graphInternal::MarkovChain& mChain;
+
+    /** Uniformization rate */
+    double mRate;
+
+    /** Exit rate per state */
+    std::vector<double> mExitRates;
+
+    double mEpsilon;
+
+    Curve mTruncationErrors;
+};
+
+}  // namespace eval
+
+#endif /* ERIS_EVAL_TRANSIENT_SOLVER_H */
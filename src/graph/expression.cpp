@@ -0,0 +1,844 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+namespace graphInternal
+{
+namespace
+{
+/** Structure of an expression, used as key of the unique table */
+struct ExpressionKey
+{
+    Expression::Kind kind;
+    unsigned int node;
+    int value;
+    std::vector<const Expression*> operands;
+
+    bool
+    operator==(const ExpressionKey& other) const
+    {
+        return kind == other.kind && node == other.node && value == other.value
+               && operands == other.operands;
+    }
+};
+
+struct ExpressionKeyHash
+{
+    size_t
+    operator()(const ExpressionKey& key) const
+    {
+        size_t hash = static_cast<size_t>(key.kind) * 0x9e3779b97f4a7c15ULL;
+        auto combine = [&hash](size_t value) {
+            hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        };
+        combine(key.node);
+        combine(static_cast<size_t>(key.value));
+        for (const Expression* operand : key.operands)
+        {
+            combine(reinterpret_cast<size_t>(operand));
+        }
+        return hash;
+    }
+};
+
+/**
+ * Weak references to all living expressions. Operands are kept alive by their parents, hence
+ * the operand pointers of a key are valid as long as the entry has not expired.
+ */
+class UniqueTable
+{
+public:
+    static UniqueTable&
+    getInstance()
+    {
+        static UniqueTable instance;
+        return instance;
+    }
+
+    template <typename Create>
+    Expression::Ptr
+    lookup(ExpressionKey key, const Create& create)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto iter = mTable.find(key);
+        if (iter != mTable.end())
+        {
+            Expression::Ptr ret = iter->second.lock();
+            if (ret != nullptr)
+            {
+                return ret;
+            }
+        }
+        if (mTable.size() >= 2 * mSweepSize)
+        {  // drop the expired entries from time to time
+            for (auto entry = mTable.begin(); entry != mTable.end();)
+            {
+                entry = entry->second.expired() ? mTable.erase(entry) : std::next(entry);
+            }
+            mSweepSize = std::max<size_t>(mTable.size(), 1024);
+        }
+        Expression::Ptr ret = create();
+        mTable[std::move(key)] = ret;
+        return ret;
+    }
+
+private:
+    UniqueTable() : mSweepSize(1024)
+    {
+    }
+
+    std::mutex mMutex;
+    std::unordered_map<ExpressionKey, std::weak_ptr<const Expression>, ExpressionKeyHash> mTable;
+    size_t mSweepSize;
+};
+
+/** Binding strength used by the pretty printer */
+int
+precedence(Expression::Kind kind)
+{
+    switch (kind)
+    {
+        case Expression::Kind::disjunction:
+            return 1;
+        case Expression::Kind::conjunction:
+            return 2;
+        case Expression::Kind::negation:
+        case Expression::Kind::atLeast:
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+}  // namespace
+
+/**
+ * Recursive descent parser for the formula subset described in expression.h.
+ * Precedence (lowest first): |, &, !, counted thresholds (c1?1:0)+...>=k
+ */
+class ExpressionParser
+{
+public:
+    ExpressionParser(const std::string& formula, const std::map<std::string, Expression::Ptr>* formulas) :
+        mFormula(formula), mFormulas(formulas), mPos(0)
+    {
+    }
+
+    Expression::Ptr
+    parse(std::string* error)
+    {
+        Expression::Ptr ret = parseDisjunction();
+        skipWhiteSpaces();
+        if (ret != nullptr && mPos != mFormula.size())
+        {
+            fail("unexpected character '" + std::string(1, mFormula[mPos]) + "'");
+            ret = nullptr;
+        }
+        if (ret == nullptr && error != nullptr)
+        {
+            *error = mError;
+        }
+        return ret;
+    }
+
+private:
+    void
+    skipWhiteSpaces()
+    {
+        while (mPos < mFormula.size() && std::isspace(static_cast<unsigned char>(mFormula[mPos])))
+        {
+            ++mPos;
+        }
+    }
+
+    bool
+    accept(char c)
+    {
+        skipWhiteSpaces();
+        if (mPos < mFormula.size() && mFormula[mPos] == c)
+        {
+            ++mPos;
+            return true;
+        }
+        return false;
+    }
+
+    Expression::Ptr
+    fail(const std::string& message)
+    {
+        if (mError.empty())
+        {
+            mError = message + " at position " + std::to_string(mPos) + " of \"" + mFormula + "\"";
+        }
+        return nullptr;
+    }
+
+    Expression::Ptr
+    parseDisjunction()
+    {
+        std::vector<Expression::Ptr> operands;
+        do
+        {
+            Expression::Ptr operand = parseConjunction();
+            if (operand == nullptr)
+            {
+                return nullptr;
+            }
+            operands.push_back(operand);
+        } while (accept('|'));
+
+        if (operands.size() == 1)
+        {
+            return operands.front();
+        }
+        return Expression::makeDisjunction(std::move(operands));
+    }
+
+    Expression::Ptr
+    parseConjunction()
+    {
+        std::vector<Expression::Ptr> operands;
+        do
+        {
+            Expression::Ptr operand = parseUnary();
+            if (operand == nullptr)
+            {
+                return nullptr;
+            }
+            operands.push_back(operand);
+        } while (accept('&'));
+
+        if (operands.size() == 1)
+        {
+            return operands.front();
+        }
+        return Expression::makeConjunction(std::move(operands));
+    }
+
+    Expression::Ptr
+    parseUnary()
+    {
+        skipWhiteSpaces();
+        // "!=" is only valid after an identifier, hence a leading '!' is always a negation
+        if (accept('!'))
+        {
+            Expression::Ptr operand = parseUnary();
+            return operand == nullptr ? nullptr : Expression::makeNegation(operand);
+        }
+        return parsePrimary();
+    }
+
+    /**
+     * Parses the remainder of a threshold "(c1?1:0)+(c2?1:0)>=k" once its first condition has
+     * been read, i.e. at the '?'.
+     */
+    Expression::Ptr
+    parseThreshold(Expression::Ptr first)
+    {
+        std::vector<Expression::Ptr> operands{std::move(first)};
+        while (true)
+        {
+            if (!accept('1') || !accept(':') || !accept('0') || !accept(')'))
+            {
+                return fail("counted condition (c?1:0) expected");
+            }
+            if (!accept('+'))
+            {
+                break;
+            }
+            Expression::Ptr operand;
+            if (!accept('(') || (operand = parseDisjunction()) == nullptr || !accept('?'))
+            {
+                return fail("counted condition (c?1:0) expected");
+            }
+            operands.push_back(std::move(operand));
+        }
+        if (!accept('>') || !accept('='))
+        {
+            return fail("'>=' expected");
+        }
+        skipWhiteSpaces();
+        size_t valueStart = mPos;
+        while (mPos < mFormula.size() && std::isdigit(static_cast<unsigned char>(mFormula[mPos])))
+        {
+            ++mPos;
+        }
+        if (valueStart == mPos)
+        {
+            return fail("value expected");
+        }
+        int required = std::stoi(mFormula.substr(valueStart, mPos - valueStart));
+        return Expression::makeAtLeast(required, std::move(operands));
+    }
+
+    Expression::Ptr
+    parsePrimary()
+    {
+        if (accept('('))
+        {
+            Expression::Ptr inner = parseDisjunction();
+            if (inner == nullptr)
+            {
+                return nullptr;
+            }
+            if (accept('?'))
+            {
+                return parseThreshold(inner);
+            }
+            if (!accept(')'))
+            {
+                return fail("missing ')'");
+            }
+            return inner;
+        }
+
+        skipWhiteSpaces();
+        size_t start = mPos;
+        while (mPos < mFormula.size()
+               && (std::isalnum(static_cast<unsigned char>(mFormula[mPos])) || mFormula[mPos] == '_'))
+        {
+            ++mPos;
+        }
+        if (start == mPos)
+        {
+            return fail("identifier expected");
+        }
+        std::string name = mFormula.substr(start, mPos - start);
+
+        if (name == "true" || name == "false")
+        {
+            return Expression::makeConstant(name == "true");
+        }
+
+        // Node variables are named n<number>, their defect flags n<number>internalfailure
+        size_t digits = 1;
+        while (digits < name.size() && std::isdigit(static_cast<unsigned char>(name[digits])))
+        {
+            ++digits;
+        }
+        bool isNode = (name[0] == 'n' || name[0] == 'N') && digits > 1;
+        if (isNode && digits == name.size())
+        {
+            unsigned int node = std::stoul(name.substr(1));
+            bool equals;
+            if (accept('='))
+            {
+                equals = true;
+            }
+            else if (accept('!') && accept('='))
+            {
+                equals = false;
+            }
+            else
+            {
+                return fail("comparison expected after " + name);
+            }
+            skipWhiteSpaces();
+            size_t valueStart = mPos;
+            while (mPos < mFormula.size() && std::isdigit(static_cast<unsigned char>(mFormula[mPos])))
+            {
+                ++mPos;
+            }
+            if (valueStart == mPos)
+            {
+                return fail("value expected");
+            }
+            int value = std::stoi(mFormula.substr(valueStart, mPos - valueStart));
+            return Expression::makeComparison(node, value, equals);
+        }
+        if (isNode && name.compare(digits, std::string::npos, "internalfailure") == 0)
+        {
+            unsigned int node = std::stoul(name.substr(1, digits - 1));
+            return Expression::makeFlag(node);
+        }
+        if (mFormulas != nullptr)
+        {
+            auto iter = mFormulas->find(name);
+            if (iter != mFormulas->end())
+            {
+                return iter->second;
+            }
+        }
+        return fail("unknown identifier " + name);
+    }
+
+    const std::string& mFormula;
+    const std::map<std::string, Expression::Ptr>* mFormulas;
+    size_t mPos;
+    std::string mError;
+};
+
+Expression::Expression(Kind kind, unsigned int node, int value, std::vector<Ptr> operands) :
+    mKind(kind), mNode(node), mValue(value), mOperands(std::move(operands))
+{
+}
+
+Expression::Ptr
+Expression::intern(Kind kind, unsigned int node, int value, std::vector<Ptr> operands)
+{
+    ExpressionKey key{kind, node, value, {}};
+    key.operands.reserve(operands.size());
+    for (const Ptr& operand : operands)
+    {
+        key.operands.push_back(operand.get());
+    }
+    return UniqueTable::getInstance().lookup(std::move(key), [&]() {
+        return Ptr(new Expression(kind, node, value, std::move(operands)));
+    });
+}
+
+Expression::Ptr
+Expression::parse(const std::string& formula,
+                  const std::map<std::string, Ptr>* formulas,
+                  std::string* error)
+{
+    ExpressionParser parser(formula, formulas);
+    return parser.parse(error);
+}
+
+Expression::Ptr
+Expression::makeConstant(bool value)
+{
+    return intern(Kind::constant, 0, value ? 1 : 0, {});
+}
+
+Expression::Ptr
+Expression::makeComparison(unsigned int node, int value, bool equals)
+{
+    return intern(equals ? Kind::equals : Kind::notEquals, node, value, {});
+}
+
+Expression::Ptr
+Expression::makeFlag(unsigned int node)
+{
+    return intern(Kind::flag, node, 0, {});
+}
+
+Expression::Ptr
+Expression::makeNegation(const Ptr& operand)
+{
+    if (operand->mKind == Kind::constant)
+    {
+        return makeConstant(operand->mValue == 0);
+    }
+    if (operand->mKind == Kind::negation)
+    {
+        return operand->mOperands.front();
+    }
+    return intern(Kind::negation, 0, 0, {operand});
+}
+
+Expression::Ptr
+Expression::makeConjunction(std::vector<Ptr> operands)
+{
+    return makeJunction(Kind::conjunction, std::move(operands));
+}
+
+Expression::Ptr
+Expression::makeDisjunction(std::vector<Ptr> operands)
+{
+    return makeJunction(Kind::disjunction, std::move(operands));
+}
+
+Expression::Ptr
+Expression::makeAtLeast(int required, std::vector<Ptr> operands)
+{
+    std::vector<Ptr> counted;
+    counted.reserve(operands.size());
+    for (Ptr& operand : operands)
+    {
+        if (operand->mKind != Kind::constant)
+        {
+            counted.push_back(std::move(operand));
+        }
+        else if (operand->mValue != 0)
+        {  // always counts
+            --required;
+        }
+    }
+    if (required <= 0 || required > static_cast<int>(counted.size()))
+    {
+        return makeConstant(required <= 0);
+    }
+    if (required == 1)
+    {
+        return makeJunction(Kind::disjunction, std::move(counted));
+    }
+    if (required == static_cast<int>(counted.size()))
+    {
+        return makeJunction(Kind::conjunction, std::move(counted));
+    }
+    return intern(Kind::atLeast, 0, required, std::move(counted));
+}
+
+Expression::Ptr
+Expression::makeJunction(Kind kind, std::vector<Ptr> operands)
+{
+    // neutral element: true for conjunctions, false for disjunctions
+    const int neutral = kind == Kind::conjunction ? 1 : 0;
+    const Kind other = kind == Kind::conjunction ? Kind::disjunction : Kind::conjunction;
+
+    std::vector<Ptr> flat;
+    std::set<const Expression*> seen;
+    std::vector<Ptr> pending(operands.rbegin(), operands.rend());
+    while (!pending.empty())
+    {  // flatten depth first to keep the order of the operands
+        Ptr operand = std::move(pending.back());
+        pending.pop_back();
+        if (operand->mKind == kind)
+        {
+            pending.insert(pending.end(), operand->mOperands.rbegin(), operand->mOperands.rend());
+        }
+        else if (operand->mKind == Kind::constant)
+        {
+            if (operand->mValue != neutral)
+            {  // absorbing element
+                return operand;
+            }
+        }
+        else if (seen.insert(operand.get()).second)
+        {
+            flat.push_back(std::move(operand));
+        }
+    }
+
+    std::vector<Ptr> result;
+    result.reserve(flat.size());
+    for (const Ptr& operand : flat)
+    {
+        if (operand->mKind == Kind::negation && seen.count(operand->mOperands.front().get()) != 0)
+        {  // a & !a, a | !a
+            return makeConstant(neutral == 0);
+        }
+        if (operand->mKind == other)
+        {  // absorption: a & (a | b) = a, a | (a & b) = a
+            bool absorbed = std::any_of(
+                    operand->mOperands.begin(), operand->mOperands.end(),
+                    [&seen](const Ptr& inner) { return seen.count(inner.get()) != 0; });
+            if (absorbed)
+            {
+                continue;
+            }
+        }
+        result.push_back(operand);
+    }
+
+    if (result.empty())
+    {
+        return makeConstant(neutral != 0);
+    }
+    if (result.size() == 1)
+    {
+        return result.front();
+    }
+    return intern(kind, 0, 0, std::move(result));
+}
+
+Expression::Ptr
+Expression::replaceAtoms(const std::function<Ptr(const Ptr&)>& replace) const
+{
+    std::map<const Expression*, Ptr> done;
+    return replaceAtoms(replace, &done);
+}
+
+Expression::Ptr
+Expression::replaceAtoms(const std::function<Ptr(const Ptr&)>& replace,
+                         std::map<const Expression*, Ptr>* done) const
+{
+    auto iter = done->find(this);
+    if (iter != done->end())
+    {
+        return iter->second;
+    }
+    Ptr ret;
+    switch (mKind)
+    {
+        case Kind::constant:
+            ret = shared_from_this();
+            break;
+        case Kind::equals:
+        case Kind::notEquals:
+        case Kind::flag:
+            ret = replace(shared_from_this());
+            break;
+        default:
+        {
+            std::vector<Ptr> operands;
+            operands.reserve(mOperands.size());
+            for (const Ptr& operand : mOperands)
+            {
+                operands.push_back(operand->replaceAtoms(replace, done));
+            }
+            if (mKind == Kind::negation)
+            {
+                ret = makeNegation(operands.front());
+            }
+            else if (mKind == Kind::atLeast)
+            {
+                ret = makeAtLeast(mValue, std::move(operands));
+            }
+            else
+            {
+                ret = makeJunction(mKind, std::move(operands));
+            }
+            break;
+        }
+    }
+    (*done)[this] = ret;
+    return ret;
+}
+
+Expression::Ptr
+Expression::swapNodes(unsigned int first, unsigned int second) const
+{
+    if (first == second)
+    {
+        return shared_from_this();
+    }
+    return replaceAtoms([first, second](const Ptr& atom) {
+        if (atom->mNode != first && atom->mNode != second)
+        {
+            return atom;
+        }
+        const unsigned int other = atom->mNode == first ? second : first;
+        if (atom->mKind == Kind::flag)
+        {
+            return makeFlag(other);
+        }
+        return makeComparison(other, atom->mValue, atom->mKind == Kind::equals);
+    });
+}
+
+std::string
+Expression::toCanonicalString() const
+{
+    switch (mKind)
+    {
+        case Kind::conjunction:
+        case Kind::disjunction:
+        {
+            std::vector<std::string> operands;
+            for (const Ptr& operand : mOperands)
+            {
+                operands.push_back(operand->toCanonicalString());
+            }
+            std::sort(operands.begin(), operands.end());
+            std::string ret = "(";
+            for (size_t i = 0; i < operands.size(); ++i)
+            {
+                ret += (i == 0 ? "" : mKind == Kind::conjunction ? " & " : " | ") + operands[i];
+            }
+            return ret + ")";
+        }
+        case Kind::atLeast:
+        {
+            std::vector<std::string> operands;
+            for (const Ptr& operand : mOperands)
+            {
+                operands.push_back(operand->toCanonicalString());
+            }
+            std::sort(operands.begin(), operands.end());
+            std::string ret = "(";
+            for (const std::string& operand : operands)
+            {
+                ret += (ret.size() == 1 ? "(" : "+(") + operand + "?1:0)";
+            }
+            return ret + ">=" + std::to_string(mValue) + ")";
+        }
+        case Kind::negation:
+            return "!(" + mOperands.front()->toCanonicalString() + ")";
+        default:
+            return toString();
+    }
+}
+
+Expression::Ptr
+Expression::dual() const
+{
+    std::map<const Expression*, Ptr> done;
+    return dual(&done);
+}
+
+Expression::Ptr
+Expression::dual(std::map<const Expression*, Ptr>* done) const
+{
+    auto iter = done->find(this);
+    if (iter != done->end())
+    {
+        return iter->second;
+    }
+    Ptr ret;
+    switch (mKind)
+    {
+        case Kind::constant:
+            ret = makeConstant(mValue == 0);
+            break;
+        case Kind::equals:
+        case Kind::notEquals:
+            ret = mValue == 0 ? makeComparison(mNode, 1, mKind == Kind::equals)
+                              : shared_from_this();
+            break;
+        case Kind::flag:
+            ret = shared_from_this();
+            break;
+        case Kind::negation:
+            ret = makeNegation(mOperands.front()->dual(done));
+            break;
+        case Kind::atLeast:
+        {  // the dual of k-out-of-n is (n-k+1)-out-of-n
+            std::vector<Ptr> operands;
+            operands.reserve(mOperands.size());
+            for (const Ptr& operand : mOperands)
+            {
+                operands.push_back(operand->dual(done));
+            }
+            ret = makeAtLeast(static_cast<int>(mOperands.size()) - mValue + 1, std::move(operands));
+            break;
+        }
+        default:
+        {
+            std::vector<Ptr> operands;
+            operands.reserve(mOperands.size());
+            for (const Ptr& operand : mOperands)
+            {
+                operands.push_back(operand->dual(done));
+            }
+            ret = makeJunction(mKind == Kind::conjunction ? Kind::disjunction : Kind::conjunction,
+                               std::move(operands));
+            break;
+        }
+    }
+    (*done)[this] = ret;
+    return ret;
+}
+
+std::string
+Expression::toString() const
+{
+    std::string ret;
+    print(&ret);
+    return ret;
+}
+
+void
+Expression::print(std::string* out) const
+{
+    switch (mKind)
+    {
+        case Kind::constant:
+            *out += mValue != 0 ? "true" : "false";
+            break;
+        case Kind::equals:
+            *out += "n" + std::to_string(mNode) + "=" + std::to_string(mValue);
+            break;
+        case Kind::notEquals:
+            *out += "n" + std::to_string(mNode) + "!=" + std::to_string(mValue);
+            break;
+        case Kind::flag:
+            *out += "n" + std::to_string(mNode) + "internalfailure";
+            break;
+        case Kind::atLeast:
+            // "?:" binds weakest in PRISM, the conditions never need additional parentheses
+            for (size_t i = 0; i < mOperands.size(); ++i)
+            {
+                *out += i == 0 ? "(" : "+(";
+                mOperands[i]->print(out);
+                *out += "?1:0)";
+            }
+            *out += ">=" + std::to_string(mValue);
+            break;
+        default:
+        {
+            const char* separator = mKind == Kind::conjunction ? " & " : " | ";
+            for (size_t i = 0; i < mOperands.size(); ++i)
+            {
+                if (mKind == Kind::negation)
+                {
+                    *out += "!";
+                }
+                else if (i > 0)
+                {
+                    *out += separator;
+                }
+                // operands binding weaker than this operator need parentheses, negations are
+                // only applied to atoms without them
+                int required = mKind == Kind::negation ? precedence(Kind::flag) : precedence(mKind);
+                bool parenthesize = precedence(mOperands[i]->mKind) < required;
+                if (parenthesize)
+                {
+                    *out += "(";
+                }
+                mOperands[i]->print(out);
+                if (parenthesize)
+                {
+                    *out += ")";
+                }
+            }
+            break;
+        }
+    }
+}
+
+bool
+Expression::isStateFormula() const
+{
+    switch (mKind)
+    {
+        case Kind::constant:
+            return true;
+        case Kind::equals:
+        case Kind::notEquals:
+            return mValue >= 0 && mValue <= 2;
+        case Kind::flag:
+            return false;
+        default:
+            return std::all_of(mOperands.begin(), mOperands.end(),
+                               [](const Ptr& operand) { return operand->isStateFormula(); });
+    }
+}
+
+void
+Expression::collectNodes(std::vector<unsigned int>* nodes) const
+{
+    switch (mKind)
+    {
+        case Kind::equals:
+        case Kind::notEquals:
+        case Kind::flag:
+            nodes->push_back(mNode);
+            break;
+        default:
+            for (const Ptr& operand : mOperands)
+            {
+                operand->collectNodes(nodes);
+            }
+            break;
+    }
+}
+
+}  // namespace graphInternal
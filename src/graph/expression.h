@@ -0,0 +1,287 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_GRAPH_INTERNAL_EXPRESSION_H
+#define ERIS_GRAPH_INTERNAL_EXPRESSION_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace graphInternal
+{
+/**
+ * A parsed boolean state formula over the node variables of a model, e.g. "n17=0 & n16=0".
+ * Only the subset of the PRISM language that ERIS generates is supported: comparisons of node
+ * variables with constants, boolean flags (nXinternalfailure), references to named formulas,
+ * negation, conjunction, disjunction, parentheses and thresholds over counted conditions, e.g.
+ * "(n2=0?1:0)+(n3=0?1:0)+(n4=0?1:0)>=2" for k-out-of-n groups.
+ *
+ * Expressions are hash-consed: structurally equal expressions are represented by the same object,
+ * i.e., pointer comparison is structural comparison and common sub formulas are shared. The
+ * factory functions simplify on construction (flattening, constant folding, duplicate removal and
+ * absorption), toString() prints the PRISM representation.
+ */
+class Expression : public std::enable_shared_from_this<Expression>
+{
+public:
+    using Ptr = std::shared_ptr<const Expression>;
+
+    enum class Kind
+    {
+        constant,
+        equals,
+        notEquals,
+        flag,
+        negation,
+        conjunction,
+        disjunction,
+        atLeast,
+    };
+
+    /**
+     * Parses the given formula. Names that are not node variables or flags are looked up in the
+     * provided formulas map, i.e., "!operational" can be parsed once operational is known.
+     * @param formula the string representation
+     * @param formulas previously parsed named formulas (may be null)
+     * @param error set to a description of the problem if parsing fails (may be null)
+     * @return the expression, nullptr if the formula is syntactically incorrect
+     */
+    static Ptr
+    parse(const std::string& formula,
+          const std::map<std::string, Ptr>* formulas = nullptr,
+          std::string* error = nullptr);
+
+    static Ptr
+    makeConstant(bool value);
+
+    /**
+     * Creates the comparison n<node>=<value> (or n<node>!=<value>).
+     */
+    static Ptr
+    makeComparison(unsigned int node, int value, bool equals = true);
+
+    /**
+     * Creates the flag n<node>internalfailure.
+     */
+    static Ptr
+    makeFlag(unsigned int node);
+
+    static Ptr
+    makeNegation(const Ptr& operand);
+
+    /**
+     * Creates the conjunction of the given operands. Nested conjunctions are flattened, true
+     * and duplicate operands are dropped, absorbed disjunctions (a & (a | b)) are removed.
+     * @return the simplified expression, true for an empty list
+     */
+    static Ptr
+    makeConjunction(std::vector<Ptr> operands);
+
+    /**
+     * Creates the disjunction of the given operands, the dual of makeConjunction().
+     * @return the simplified expression, false for an empty list
+     */
+    static Ptr
+    makeDisjunction(std::vector<Ptr> operands);
+
+    /**
+     * Creates the threshold "at least required of the operands hold". Constant operands are
+     * counted, 1-out-of-n is a disjunction and n-out-of-n a conjunction. Duplicates are kept,
+     * each operand counts once.
+     * @return the simplified expression
+     */
+    static Ptr
+    makeAtLeast(int required, std::vector<Ptr> operands);
+
+    /**
+     * Rebuilds the expression with every comparison and flag replaced by the result of the
+     * given function. Shared sub expressions are only rewritten once.
+     * @param replace callable returning the replacement of an atom (may return the atom)
+     * @return the rewritten (and simplified) expression
+     */
+    Ptr
+    replaceAtoms(const std::function<Ptr(const Ptr&)>& replace) const;
+
+    /**
+     * Returns the expression with the nodes first and second (variables and flags) swapped.
+     */
+    Ptr
+    swapNodes(unsigned int first, unsigned int second) const;
+
+    /**
+     * Prints a key that identifies the expression up to the order of the operands of
+     * conjunctions and disjunctions, e.g. to check whether swapping nodes preserves it.
+     */
+    std::string
+    toCanonicalString() const;
+
+    /**
+     * Returns the dual of the expression with ok replaced by defective, i.e., conjunctions and
+     * disjunctions as well as true and false are swapped, k-out-of-n thresholds require n-k+1
+     * and comparisons with 0 compare with 1. This turns the operational formula into the
+     * defective label.
+     */
+    Ptr
+    dual() const;
+
+    /**
+     * Prints the expression in PRISM syntax with a minimum of parentheses.
+     */
+    std::string
+    toString() const;
+
+    /**
+     * Checks whether the expression only consists of comparisons of node variables with node
+     * states (0-2), constants and logical operators, which is what users may enter as essential
+     * nodes or recovery formulas.
+     */
+    bool
+    isStateFormula() const;
+
+    /**
+     * Evaluates the expression. The lookup is called with the node number and a flag indicating
+     * whether the node variable (false) or the internalfailure flag (true) is requested.
+     * @param lookup callable int(unsigned int node, bool flag)
+     * @return truth value of the expression in the given state
+     */
+    template <typename Lookup>
+    bool
+    evaluate(const Lookup& lookup) const
+    {
+        switch (mKind)
+        {
+            case Kind::constant:
+                return mValue != 0;
+            case Kind::equals:
+                return lookup(mNode, false) == mValue;
+            case Kind::notEquals:
+                return lookup(mNode, false) != mValue;
+            case Kind::flag:
+                return lookup(mNode, true) != 0;
+            case Kind::negation:
+                return !mOperands.front()->evaluate(lookup);
+            case Kind::conjunction:
+                for (const Ptr& operand : mOperands)
+                {
+                    if (!operand->evaluate(lookup))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            case Kind::disjunction:
+                for (const Ptr& operand : mOperands)
+                {
+                    if (operand->evaluate(lookup))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            case Kind::atLeast:
+            {
+                int count = 0;
+                for (const Ptr& operand : mOperands)
+                {
+                    if (operand->evaluate(lookup) && ++count >= mValue)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * Collects the numbers of all nodes (variables and flags) the expression depends on.
+     * @param nodes vector the node numbers are appended to
+     */
+    void
+    collectNodes(std::vector<unsigned int>* nodes) const;
+
+    Kind
+    getKind() const
+    {
+        return mKind;
+    }
+
+    /** Node number of a comparison or flag */
+    unsigned int
+    getNode() const
+    {
+        return mNode;
+    }
+
+    /** Constant compared to (truth value of a constant, threshold of atLeast) */
+    int
+    getValue() const
+    {
+        return mValue;
+    }
+
+    const std::vector<Ptr>&
+    getOperands() const
+    {
+        return mOperands;
+    }
+
+private:
+    Expression(Kind kind, unsigned int node, int value, std::vector<Ptr> operands);
+
+    /**
+     * Returns the unique object for the given structure, creates it if necessary.
+     */
+    static Ptr
+    intern(Kind kind, unsigned int node, int value, std::vector<Ptr> operands);
+
+    static Ptr
+    makeJunction(Kind kind, std::vector<Ptr> operands);
+
+    Ptr
+    replaceAtoms(const std::function<Ptr(const Ptr&)>& replace,
+                 std::map<const Expression*, Ptr>* done) const;
+
+    Ptr
+    dual(std::map<const Expression*, Ptr>* done) const;
+
+    void
+    print(std::string* out) const;
+
+    Kind mKind;
+
+    /** Node number of a comparison or flag */
+    unsigned int mNode;
+
+    /** Constant compared to (truth value of a constant, threshold of atLeast) */
+    int mValue;
+
+    /** Sub expressions of negations, conjunctions, disjunctions and thresholds */
+    std::vector<Ptr> mOperands;
+};
+
+}  // namespace graphInternal
+
+#endif /* ERIS_GRAPH_INTERNAL_EXPRESSION_H */
@@ -38,6 +38,10 @@
 #include "qt_utils.h"
 #include "evaluation_settings.h"
 #include "prism.h"
+#include "engine_planner.h"
+#include "native_engine.h"
+#include "importance_analysis.h"
+#include "markov_chain.h"
 #include "tokenizer.h"
 #include "qt_utils.h"
 #include "model.h"
@@ -47,6 +51,7 @@
 
 #include "counter.h"
 #include "octave.h"
+#include "job.h"
 #include <QGraphicsTransform>
 #include <QGuiApplication>
 #include <QFileDialog>
@@ -60,11 +65,14 @@
 #include <QAction>
 #include <QScrollBar>
 
+#include <algorithm>
+
 namespace graph
 {
 using namespace utils;
 using eval::Prism;
 using eval::Octave;
+using eval::JobScheduler;
 using widgets::ErrorHandler;
 using widgets::Errors;
 using widgets::EvaluationSettingsDialog;
@@ -73,6 +81,10 @@ using widgets::MainWindow;
 using widgets::MainWindowButtonsGroupManager;
 using widgets::MainWindowToolButtonsManager;
 
+/** Priorities of the evaluation jobs, submodules are started before the steps of other models */
+constexpr int kSubmodulePriority = 1;
+constexpr int kStepPriority = 0;
+
 static int
 NextId()
 {
@@ -90,6 +102,12 @@ GraphicScene::GraphicScene(QObject* parent, bool passive_submodule) :
 
 GraphicScene::~GraphicScene()
 {
+    // the jobs refer to the node items and to this scene
+    for (JobScheduler::Id job : mJobs)
+    {
+        JobScheduler::getInstance()->cancel(job);
+    }
+    JobScheduler::getInstance()->wait(mJobs);
     auto current_items = items();
     for (int i = 0; i < current_items.size(); ++i)
     {
@@ -841,7 +859,8 @@ GraphicScene::buildAndStartXPrism()
         MainWindow::getInstance()->disableGuiElements(true);
         qApp->processEvents();
 
-        if (mTransformer->start(mRedundancy, mOutFileName.toStdString()))
+        // the experiment is entered in the PRISM GUI, hence the model is not reduced to it
+        if (mTransformer->start(mRedundancy, mOutFileName.toStdString(), QString()))
         {
             
         }
@@ -867,78 +886,200 @@ GraphicScene::transform()
         MainWindow::getInstance()->mInformationLabel->setText(" Building PRISM Model...");
         MainWindow::getInstance()->disableGuiElements(true);
     }
-    return mTransformer->start(mRedundancy, mOutFileName.toStdString());
+    // the model is generated for the experiment of the evaluation settings
+    QString experimentDoc;
+    eval::ExperimentInterval interval;
+    EvaluationSettingsDialog::Get()->experimentDocument(experimentDoc, &interval);
+    return mTransformer->start(mRedundancy, mOutFileName.toStdString(), experimentDoc);
 }
 
 bool
-GraphicScene::evaluteErisModule(NodeItem* submoduleNode, eval::ExperimentInterval interval)
+GraphicScene::evaluteErisModule(NodeItem* submoduleNode,
+                                 eval::ExperimentInterval interval,
+                                 JobScheduler::Id* job)
 {
     PRINT_INFO("Submodule found, will evaluate it...");
     
     QString submodulePath = submoduleNode->getSubmodulePath();
     auto submodule = Create(nullptr, true);
     PRINT_INFO("Loading submodule %s ", submodulePath.toStdString().c_str());
-    if (submodule->load(submodulePath, true))
+    if (!submodule->load(submodulePath, true))
     {
-        if (submodule->transform()) //  transform the found submodule, recursive call
-        {
-            submoduleNode->getIntrusionIndicatorPtr()->clear();
-            submoduleNode->getFailureIndicatorPtr()->clear();
-            if (eval::Prism::getInstance()->extractSubmoduleFailureRates(
-                    submodule->getOutfileName(), interval,
-                    submoduleNode->getFailureIndicatorPtr(),
-                    submoduleNode->getIntrusionIndicatorPtr()))
-            {
-                return true;
-            }
-            else
-            {
-                PRINT_ERROR("Failed to evaluate submodule %s .. ", submoduleNode->getSubmodulePath());
-                return false;
-            }
-            
-        }
-        else
-        {
-            PRINT_ERROR("Failed to transform submodule %s ", submodulePath);
-            //ErrorHandler::getInstance().setError(Errors::transformationError());
-            return false;
-        }
+        PRINT_ERROR("Failed to load submodule %s ", submodulePath.toStdString().c_str());
+        //ErrorHandler::getInstance().setError(Errors::submoduleFailedToLoad(nodeItem->getSubmodulePath(), nodeItem->getId()));
+        return false;
     }
-    else
+    // The scene is transformed on this thread, only the PRISM run is a job
+    if (!submodule->transform())
     {
-        PRINT_ERROR("Failed to load submodule %s ", submodulePath);
-        //ErrorHandler::getInstance().setError(Errors::submoduleFailedToLoad(nodeItem->getSubmodulePath(), nodeItem->getId()));
+        PRINT_ERROR("Failed to transform submodule %s ", submodulePath.toStdString().c_str());
+        //ErrorHandler::getInstance().setError(Errors::transformationError());
         return false;
     }
-    PRINT_INFO("Successfully evaluated Submodule %s ", submoduleNode->getSubmodulePath().toStdString().c_str());
-    //nodeItem->setFailureIndicator(tr(std::to_string(safetyFailure).c_str()));
-    //nodeItem->setIntrusionIndicator(tr(std::to_string(securityFailure).c_str()));
+
+    submoduleNode->getIntrusionIndicatorPtr()->clear();
+    submoduleNode->getFailureIndicatorPtr()->clear();
+    const QString prismModel = submodule->getOutfileName();
+    *job = submitJob(
+            "Submodule " + submodulePath,
+            [=](JobScheduler::Context& context) {
+                if (eval::Prism::getInstance()->extractSubmoduleFailureRates(
+                            prismModel, interval,
+                            submoduleNode->getFailureIndicatorPtr(),
+                            submoduleNode->getIntrusionIndicatorPtr(),
+                            context.cancelled()))
+                {
+                    PRINT_INFO("Successfully evaluated Submodule %s ",
+                               submodulePath.toStdString().c_str());
+                    return true;
+                }
+                PRINT_ERROR("Failed to evaluate submodule %s .. ",
+                            submodulePath.toStdString().c_str());
+                return false;
+            },
+            kSubmodulePriority);
     return true;
 }
 
 bool
-GraphicScene::evaluteSimulationModule(NodeItem* submoduleNode, eval::ExperimentInterval interval)
+GraphicScene::evaluteSimulationModule(NodeItem* submoduleNode,
+                                       eval::ExperimentInterval interval,
+                                       JobScheduler::Id* job)
 {
     submoduleNode->getIntrusionIndicatorPtr()->clear();
     submoduleNode->getFailureIndicatorPtr()->clear();
-    if (eval::Octave::getInstance()->extractSimulationFailureRates(
-            submoduleNode->getSimulationPath(), interval, 
-            submoduleNode->getFailureIndicatorPtr(),
-            submoduleNode->getIntrusionIndicatorPtr()))
+    const QString simulationPath = submoduleNode->getSimulationPath();
+    *job = submitJob(
+            "Simulation " + simulationPath,
+            [=](JobScheduler::Context& context) {
+                if (eval::Octave::getInstance()->extractSimulationFailureRates(
+                            simulationPath, interval,
+                            submoduleNode->getFailureIndicatorPtr(),
+                            submoduleNode->getIntrusionIndicatorPtr(),
+                            context.cancelled()))
+                {
+                    PRINT_INFO("Successfully simulated submodule %s ",
+                               simulationPath.toStdString().c_str());
+                    return true;
+                }
+                PRINT_ERROR("Failed to simulate submodule %s .. ",
+                            simulationPath.toStdString().c_str());
+                return false;
+            },
+            kSubmodulePriority);
+    return true;
+}
+
+std::vector<JobScheduler::Id>
+GraphicScene::evaluateSubmodules(const std::vector<NodeItem*>& submoduleNodes,
+                                 eval::ExperimentInterval interval)
+{
+    // Every submodule file is evaluated once, nodes referring to the same file share the results
+    std::map<QString, std::pair<NodeItem*, JobScheduler::Id>> evaluated;
+    std::vector<JobScheduler::Id> jobs;
+    for (const auto& moduleNode : submoduleNodes)
     {
-        return true;
+        const QString path = moduleNode->isErisModule() ? moduleNode->getSubmodulePath()
+                                                        : moduleNode->getSimulationPath();
+        auto it = evaluated.find(path);
+        if (it != evaluated.end())
+        {  // copied once the evaluation of the first node is done
+            NodeItem* source = it->second.first;
+            jobs.push_back(submitJob(
+                    "Share results of " + path,
+                    [moduleNode, source](JobScheduler::Context&) {
+                        *moduleNode->getFailureIndicatorPtr() = *source->getFailureIndicatorPtr();
+                        *moduleNode->getIntrusionIndicatorPtr() =
+                                *source->getIntrusionIndicatorPtr();
+                        return true;
+                    },
+                    kSubmodulePriority, {it->second.second}));
+            continue;
+        }
+        JobScheduler::Id job = 0;
+        if (moduleNode->isErisModule() && evaluteErisModule(moduleNode, interval, &job))
+        {
+            evaluated[path] = {moduleNode, job};
+            jobs.push_back(job);
+        }
+        else if (moduleNode->isSimulationModule()
+                 && evaluteSimulationModule(moduleNode, interval, &job))
+        {
+            evaluated[path] = {moduleNode, job};
+            jobs.push_back(job);
+        }
     }
-    else
+    return jobs;
+}
+
+void
+GraphicScene::evaluateWithSubmodules(const std::vector<NodeItem*>& submoduleNodes,
+                                     const eval::ExperimentInterval& interval)
+{
+    if (evaluateNativelyOverTime(submoduleNodes, interval))
     {
-        PRINT_ERROR("Failed to simulate submodule %s .. ", submoduleNode->getSubmodulePath());
-        return false;
+        return;
+    }
+
+    // One PRISM job per time step on a copy of the model transformed with the submodule rates
+    // of the step, the transformation needs the scene and hence the GUI thread. The steps run
+    // in order, the last one publishes the results of all steps.
+    auto models = std::make_shared<utils::Job>("steps");
+    if (!models->isValid())
+    {
+        PRINT_ERROR("Failed to create a scratch directory : %s",
+                    models->errorString().toStdString().c_str());
+        return;
+    }
+    std::vector<std::pair<eval::ExperimentInterval, QString>> steps;
+    for (int i = interval.from; i < interval.to && interval.steps > 0; i += interval.steps)
+    {
+        const eval::ExperimentInterval step(i, i + interval.steps, interval.steps);
+        for (const auto& submodule : submoduleNodes)
+        {
+            // Set intrusion/failure indicator for current time step (its end, for some reason
+            // module step is 0)
+            submodule->setIntrusionIndicator(submodule->getIntrusionIndicator(step.to));
+            submodule->setFailureIndicator(submodule->getFailureIndicator(step.to));
+            DPRINT_INFO("set failure rate %s",
+                        submodule->getFailureIndicator().toStdString().c_str());
+            DPRINT_INFO("set intrusion rate %s",
+                        submodule->getIntrusionIndicator().toStdString().c_str());
+        }
+        const QString model = models->filePath(QString("step%1.pm").arg(steps.size()));
+        if (!transform() || !QFile::copy(mOutFileName, model))
+        {
+            PRINT_ERROR("Failed to transform the model of step T=%d..%d", step.from, step.to);
+            return;
+        }
+        steps.emplace_back(step, model);
+    }
+
+    auto results = std::make_shared<QMap<QString, QList<QPointF>>>();
+    const QString experimentDoc = Prism::getInstance()->experimentDoc;
+    const eval::EnginePlanner::Plan plan = planEngine(interval);
+    std::vector<JobScheduler::Id> previous;
+    for (const auto& entry : steps)
+    {
+        const eval::ExperimentInterval step = entry.first;
+        const QString model = entry.second;
+        const bool lastStep = step.to >= interval.to;
+        auto work = [models, model, experimentDoc, step, plan, lastStep, results](
+                            JobScheduler::Context& context) {
+            if (!Prism::getInstance()->evaluateStep(model, experimentDoc, step, plan,
+                                                    results.get(), context.cancelled()))
+            {
+                return false;
+            }
+            if (lastStep)
+            {
+                eval::PrismResultsParser::Get()->publish(*results);
+            }
+            return true;
+        };
+        previous = {submitJob(
+                tr("Step T=%1..%2").arg(step.from).arg(step.to), work, kStepPriority, previous)};
     }
-    
-    PRINT_INFO("Successfully simulated submodule %s ", submoduleNode->getSubmodulePath().toStdString().c_str());
-    //nodeItem->setFailureIndicator(tr(std::to_string(safetyFailure).c_str()));
-    //nodeItem->setIntrusionIndicator(tr(std::to_string(securityFailure).c_str()));
-    return true;
 }
 
 bool
@@ -953,56 +1094,23 @@ GraphicScene::evaluateExperiment()
     std::vector<NodeItem*> submoduleNodes;
     getModuleNodeItems(submoduleNodes);
 
-    for (const auto& moduleNode : submoduleNodes)
-    {  
-        if (moduleNode->isErisModule())
-        {
-            this->evaluteErisModule(moduleNode, interval);
-        }
-        else if (moduleNode->isSimulationModule())
-        {
-            this->evaluteSimulationModule(moduleNode, interval);
-        }
-    }
-
     if (!submoduleNodes.empty())
     {
-        for (int i=interval.from; i < interval.to; i+=interval.steps)
-        {
-            for (const auto& submodule : submoduleNodes)
-            {
-                // Set intrusion/failure indicator for current time step
-                double step = i+interval.steps; // for some reason module step is 0
-                submodule->setIntrusionIndicator(submodule->getIntrusionIndicator(step));
-                submodule->setFailureIndicator(submodule->getFailureIndicator(step));
-                PRINT_INFO("set failure rate %s", submodule->getFailureIndicator().toStdString().c_str());
-                PRINT_INFO("set intrusion rate %s", submodule->getIntrusionIndicator().toStdString().c_str());
-            }
-            // Evaluate top module for current time step
-            transform();
-            if (!Prism::getInstance()->isRunning())
-            {
-                Prism::getInstance()->reset();
-                auto currentInterval = Prism::getInstance()->mExperimentInterval.get();
-                currentInterval->from = i;
-                currentInterval->to = i+interval.steps;
-                currentInterval->steps = interval.steps;
-
-                Prism::getInstance()->addArgument(mOutFileName);
-                if (!Prism::getInstance()->execute(true, true, (currentInterval->to>=interval.to)))
-                {
-                    ErrorHandler::getInstance().setError(Errors::programExecutionError("prism"));
-                    ErrorHandler::getInstance().show();
-                }
-
-                while (Prism::getInstance()->isRunning())
-                {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-                    qApp->processEvents();
-                }
-            }
-        }
+        // The parent module continues on the GUI thread once all submodules are done
+        const std::vector<JobScheduler::Id> submodules =
+                evaluateSubmodules(submoduleNodes, interval);
+        submitJob(
+                "Evaluate " + mFileName,
+                [this, submoduleNodes, interval](JobScheduler::Context&) {
+                    QMetaObject::invokeMethod(
+                            this,
+                            [this, submoduleNodes, interval] {
+                                evaluateWithSubmodules(submoduleNodes, interval);
+                            },
+                            Qt::QueuedConnection);
+                    return true;
+                },
+                kStepPriority, submodules);
     }
     else
     {
@@ -1012,12 +1120,24 @@ GraphicScene::evaluateExperiment()
             mTransformer->DeprecatedTransformationFinished(true);
         }
 
-        MainWindow::getInstance()->mInformationLabel->setText(" Running PRISM Experiment...");
+        if (evaluateNatively())
+        {
+            return true;
+        }
+
+        // Estimate the size of the model before handing it to PRISM and choose the engine
+        // accordingly
+        const eval::EnginePlanner::Plan plan = planEngine(interval);
+        MainWindow::getInstance()->mInformationLabel->setText(
+                tr(" Running PRISM Experiment (%1%2 states)...")
+                        .arg(plan.exact ? "" : "~")
+                        .arg(plan.states, 0, 'g', plan.exact ? 12 : 2));
         // Experiment Code (PRISM in background) goes here!
         if (!Prism::getInstance()->isRunning())
         {
             // NOTE : Always reset prism command line
             Prism::getInstance()->reset();
+            Prism::getInstance()->setPlan(plan);
 
             EvaluationSettingsDialog::Get()->experimentDocument(Prism::getInstance()->experimentDoc,
                                                                 Prism::getInstance()->mExperimentInterval.get());
@@ -1035,6 +1155,279 @@ GraphicScene::evaluateExperiment()
     return true;
 }
 
+eval::EnginePlanner::Plan
+GraphicScene::planEngine(const eval::ExperimentInterval& interval)
+{
+    // The chain is only available for CTMCs, MDPs are planned by their size
+    auto chain = mTransformer->getMarkovChain();
+    if (chain != nullptr && chain->isValid())
+    {
+        return eval::EnginePlanner::plan(chain.get(), interval);
+    }
+    std::vector<NodeItem*> nodes;
+    std::vector<NodeItem*> envNodes;
+    std::vector<EdgeItem*> edges;
+    getSortedSceneItems(nodes, envNodes, edges);
+    return eval::EnginePlanner::plan(static_cast<unsigned int>(nodes.size()), interval);
+}
+
+JobScheduler::Id
+GraphicScene::submitJob(const QString& name,
+                        JobScheduler::Work work,
+                        int priority,
+                        const std::vector<JobScheduler::Id>& dependencies)
+{
+    JobScheduler* scheduler = JobScheduler::getInstance();
+    mJobs.erase(std::remove_if(mJobs.begin(), mJobs.end(),
+                               [scheduler](JobScheduler::Id job) {
+                                   return JobScheduler::isDone(scheduler->state(job));
+                               }),
+                mJobs.end());
+    mJobs.push_back(scheduler->submit(name, std::move(work), priority, dependencies));
+    return mJobs.back();
+}
+
+bool
+GraphicScene::evaluateParameterSweep(const std::vector<eval::ParameterSweep::Parameter>& parameters,
+                                     const std::vector<eval::ParameterSweep::Point>& points)
+{
+    if (eval::ParameterSweep::getInstance()->isRunning())
+    {
+        PRINT_WARNING("Previous parameter sweep did not finish yet");
+        return false;
+    }
+    std::vector<NodeItem*> submoduleNodes;
+    getModuleNodeItems(submoduleNodes);
+    if (!submoduleNodes.empty())
+    {  // their rates depend on time and are not constants of the model
+        PRINT_ERROR("Parameter sweeps of modules with submodules are not supported");
+        return false;
+    }
+    if (hasChanged())
+    {
+        transform();
+        mTransformer->DeprecatedTransformationFinished(true);
+    }
+
+    QString experimentDoc;
+    eval::ExperimentInterval interval;
+    std::vector<std::string> labels;
+    EvaluationSettingsDialog::Get()->experimentDocument(experimentDoc, &interval);
+    auto chain = mTransformer->getMarkovChain();
+    MainWindow::getInstance()->mInformationLabel->setText(
+            tr(" Running Parameter Sweep (%1 points)...").arg(points.size()));
+    if (EvaluationSettingsDialog::Get()->nativeEngineSelected() && chain != nullptr
+        && chain->isValid() && eval::NativeEngine::supportedProperties(experimentDoc, &labels))
+    {  // the sweep works on a copy, the chain of the transformer is rebuilt by other evaluations
+        return eval::ParameterSweep::getInstance()->execute(
+                std::make_shared<const graphInternal::MarkovChain>(*chain),
+                labels, interval, parameters, points);
+    }
+
+    std::set<std::string> constants;
+    for (const auto& parameter : parameters)
+    {
+        constants.insert(parameter.constant);
+    }
+    QFileInfo outFile(mOutFileName);
+    const QString prismModel = outFile.dir().filePath(outFile.completeBaseName() + "_sweep.pm");
+    if (!mTransformer->writeParametricModel(constants, prismModel.toStdString()))
+    {
+        PRINT_ERROR("Failed to write the parametric model %s", prismModel.toStdString().c_str());
+        return false;
+    }
+    return eval::ParameterSweep::getInstance()->execute(
+            prismModel, experimentDoc, interval, parameters, points);
+}
+
+bool
+GraphicScene::evaluateImportance(int failedValue)
+{
+    if (eval::ImportanceAnalysis::getInstance()->isRunning())
+    {
+        PRINT_WARNING("Previous importance analysis did not finish yet");
+        return false;
+    }
+    std::vector<NodeItem*> submoduleNodes;
+    getModuleNodeItems(submoduleNodes);
+    if (!submoduleNodes.empty())
+    {  // their rates depend on time
+        PRINT_ERROR("Importance analyses of modules with submodules are not supported");
+        return false;
+    }
+    if (hasChanged())
+    {
+        transform();
+        mTransformer->DeprecatedTransformationFinished(true);
+    }
+
+    QString experimentDoc;
+    eval::ExperimentInterval interval;
+    std::vector<std::string> labels;
+    EvaluationSettingsDialog::Get()->experimentDocument(experimentDoc, &interval);
+    auto chain = mTransformer->getMarkovChain();
+    if (chain == nullptr || !chain->isValid()
+        || !eval::NativeEngine::supportedProperties(experimentDoc, &labels))
+    {
+        PRINT_ERROR("Importance analyses require a CTMC and F[T,T] label properties");
+        return false;
+    }
+    MainWindow::getInstance()->mInformationLabel->setText(" Running Importance Analysis...");
+    // the conditions work on copies, the chain of the transformer is rebuilt by other evaluations
+    return eval::ImportanceAnalysis::getInstance()->execute(
+            std::make_shared<const graphInternal::MarkovChain>(*chain), labels, interval,
+            failedValue);
+}
+
+bool
+GraphicScene::evaluateNatively()
+{
+    const bool simulation = EvaluationSettingsDialog::Get()->simulationSelected();
+    if (!EvaluationSettingsDialog::Get()->nativeEngineSelected() && !simulation)
+    {
+        return false;
+    }
+    auto chain = mTransformer->getMarkovChain();
+    if (chain == nullptr || !chain->isValid())
+    {
+        PRINT_INFO("Native engine not applicable to this model, falling back to PRISM");
+        return false;
+    }
+
+    QString experimentDoc;
+    eval::ExperimentInterval interval;
+    std::vector<std::string> labels;
+    std::vector<eval::NativeEngine::Property> properties;
+    EvaluationSettingsDialog::Get()->experimentDocument(experimentDoc, &interval);
+    if (!eval::NativeEngine::supportedProperties(experimentDoc, &labels)
+        && (simulation || !eval::NativeEngine::supportedProperties(experimentDoc, &properties)))
+    {
+        PRINT_INFO("Native engine does not support the experiment, falling back to PRISM");
+        return false;
+    }
+    if (eval::NativeEngine::getInstance()->isRunning())
+    {
+        PRINT_WARNING("Previous native evaluation did not finish yet");
+        return true;
+    }
+
+    if (!properties.empty())
+    {  // long-run properties need the full state space
+        if (chain->getStateCount() == 0)
+        {
+            MainWindow::getInstance()->mInformationLabel->setText(" Building State Space...");
+            qApp->processEvents();
+            if (!chain->build())
+            {
+                PRINT_WARNING("%s, falling back to PRISM", chain->getError().c_str());
+                return false;
+            }
+        }
+        MainWindow::getInstance()->mInformationLabel->setText(" Running Native Experiment...");
+        return eval::NativeEngine::getInstance()->execute(chain, properties, interval);
+    }
+
+    if (simulation)
+    {
+        MainWindow::getInstance()->mInformationLabel->setText(" Running Simulation...");
+        return eval::NativeEngine::getInstance()->simulate(
+                chain, labels, interval, EvaluationSettingsDialog::Get()->simulationOptions());
+    }
+    const double tolerance = EvaluationSettingsDialog::Get()->truncationTolerance();
+    if (tolerance > 0.0)
+    {
+        MainWindow::getInstance()->mInformationLabel->setText(" Running Bounded Experiment...");
+        return eval::NativeEngine::getInstance()->executeBounded(
+                chain, labels, interval, tolerance);
+    }
+    if (chain->getStateCount() == 0)
+    {  // the chain is kept until the next transformation
+        MainWindow::getInstance()->mInformationLabel->setText(" Building State Space...");
+        qApp->processEvents();
+        if (!chain->build())
+        {  // too large for an exact analysis, PRISM would not cope either
+            PRINT_WARNING("%s, falling back to simulation", chain->getError().c_str());
+            MainWindow::getInstance()->mInformationLabel->setText(" Running Simulation...");
+            return eval::NativeEngine::getInstance()->simulate(
+                    chain, labels, interval, EvaluationSettingsDialog::Get()->simulationOptions());
+        }
+    }
+
+    MainWindow::getInstance()->mInformationLabel->setText(" Running Native Experiment...");
+    return eval::NativeEngine::getInstance()->execute(chain, labels, interval);
+}
+
+bool
+GraphicScene::evaluateNativelyOverTime(const std::vector<NodeItem*>& submoduleNodes,
+                                       const eval::ExperimentInterval& interval)
+{
+    if (!EvaluationSettingsDialog::Get()->nativeEngineSelected())
+    {
+        return false;
+    }
+    std::vector<std::string> labels;
+    if (!eval::NativeEngine::supportedProperties(Prism::getInstance()->experimentDoc, &labels))
+    {
+        PRINT_INFO("Native engine does not support the experiment, falling back to PRISM");
+        return false;
+    }
+    if (eval::NativeEngine::getInstance()->isRunning())
+    {
+        PRINT_WARNING("Previous native evaluation did not finish yet");
+        return true;
+    }
+
+    // A new chain is only transformed when a submodule rate changes, the transformation then
+    // regenerates the changed nodes only. Time points with equal rates share the chain of the
+    // previous segment.
+    std::vector<eval::TransientSolver::Segment> segments;
+    for (int t = interval.from; t <= interval.to; t += interval.steps)
+    {
+        bool changed = segments.empty();
+        for (const auto& submodule : submoduleNodes)
+        {
+            auto failure = submodule->getFailureIndicatorPtr()->find(t);
+            if (failure != submodule->getFailureIndicatorPtr()->end()
+                && failure->second != submodule->getFailureIndicator())
+            {
+                submodule->setFailureIndicator(failure->second);
+                changed = true;
+            }
+            auto intrusion = submodule->getIntrusionIndicatorPtr()->find(t);
+            if (intrusion != submodule->getIntrusionIndicatorPtr()->end()
+                && intrusion->second != submodule->getIntrusionIndicator())
+            {
+                submodule->setIntrusionIndicator(intrusion->second);
+                changed = true;
+            }
+        }
+        if (!changed)
+        {
+            segments.push_back({static_cast<double>(t), segments.back().chain});
+            continue;
+        }
+        if (!transform())
+        {
+            PRINT_ERROR("Failed to transform the model for T=%d", t);
+            return true;
+        }
+        auto chain = mTransformer->getMarkovChain();
+        if (chain == nullptr || !chain->isValid())
+        {
+            PRINT_INFO("Native engine not applicable to this model, falling back to PRISM");
+            return false;
+        }
+        segments.push_back({static_cast<double>(t), chain});
+        if (interval.steps <= 0)
+        {  // single time point
+            break;
+        }
+    }
+
+    MainWindow::getInstance()->mInformationLabel->setText(" Running Native Experiment...");
+    return eval::NativeEngine::getInstance()->execute(std::move(segments), labels);
+}
+
 /*bool
 GraphicScene::stopTransformer()
 {
@@ -29,7 +29,10 @@
 #include "main_window_tool_buttons_manager.h"
 #include "main_window_buttons_group_manager.h"
 #include "file_manager.h"
+#include "engine_planner.h"
 #include "experiment.h"
+#include "job_scheduler.h"
+#include "parameter_sweep.h"
 #include "prism_results_parser.h"
 #include "rate_interpretation.h"
 
@@ -280,6 +283,28 @@ public:
     bool
     evaluateExperiment();
 
+    /**
+     * Evaluates the experiment for every point of a parameter sweep of the current module. The
+     * points are evaluated concurrently, natively if selected and applicable, otherwise by prism
+     * on a parametric model. The results are reported by eval::ParameterSweep.
+     * @param parameters swept rate constants
+     * @param points values of the parameters
+     * @return true if the sweep was started, false otherwise
+     */
+    bool
+    evaluateParameterSweep(const std::vector<eval::ParameterSweep::Parameter>& parameters,
+                           const std::vector<eval::ParameterSweep::Point>& points);
+
+    /**
+     * Computes the importance measures of all nodes of the current module for the experiment,
+     * natively and concurrently for all nodes. The results are reported by
+     * eval::ImportanceAnalysis.
+     * @param failedValue state of a failed node, 1 defective or 2 corrupted
+     * @return true if the analysis was started, false otherwise
+     */
+    bool
+    evaluateImportance(int failedValue);
+
    /* bool
     stopTransformer();*/
     bool
@@ -526,18 +551,81 @@ private:
     nodeOverlaps(NodeItem* newItem);
 
     /**
-     * Triggers Markov evaluation process (via PRISM) for the given ERIS module node and
-     * stores results in the associated NodeItems map. 
+     * Loads and transforms the given ERIS module node and submits its Markov evaluation (via
+     * PRISM) to the eval::JobScheduler. The results are stored in the associated NodeItems map.
+     * @param job set to the id of the submitted job
+     * @return true if the evaluation was submitted, false otherwise
      */
     bool
-    evaluteErisModule(NodeItem* submoduleNode, eval::ExperimentInterval interval);
+    evaluteErisModule(NodeItem* submoduleNode,
+                      eval::ExperimentInterval interval,
+                      eval::JobScheduler::Id* job);
     
     /**
-     * Triggers the simulation process (via Octave) for the given Simulation module node and
-     * stores results in the associated NodeItems map. 
+     * Submits the simulation process (via Octave) for the given Simulation module node to the
+     * eval::JobScheduler. The results are stored in the associated NodeItems map.
+     * @param job set to the id of the submitted job
+     * @return true if the simulation was submitted, false otherwise
+     */
+    bool
+    evaluteSimulationModule(NodeItem* submoduleNode,
+                            eval::ExperimentInterval interval,
+                            eval::JobScheduler::Id* job);
+
+    /**
+     * Submits the evaluation of the given module nodes, they run concurrently. Nodes referring
+     * to the same file share the results of a single evaluation.
+     * @return the jobs the parent module has to wait for
+     */
+    std::vector<eval::JobScheduler::Id>
+    evaluateSubmodules(const std::vector<NodeItem*>& submoduleNodes,
+                       eval::ExperimentInterval interval);
+
+    /**
+     * Evaluates the experiment of the parent module once its submodules are done, natively or
+     * by one PRISM job per time step. The model of every step is transformed with the submodule
+     * rates of its time step on the GUI thread before any step is submitted, the jobs only run
+     * PRISM on their own copy of it.
+     */
+    void
+    evaluateWithSubmodules(const std::vector<NodeItem*>& submoduleNodes,
+                           const eval::ExperimentInterval& interval);
+
+    /**
+     * Evaluates the experiment in-process if the native engine or the simulation is selected and
+     * applicable, i.e. the model is a CTMC and only F[T,T] label properties are requested.
+     * Models whose state space exceeds the native engine are simulated.
+     * @return true if the native evaluation was started, false if PRISM has to be used
+     */
+    bool
+    evaluateNatively();
+
+    /**
+     * Evaluates the experiment of a model with submodules in a single in-process pass if the
+     * native engine is selected and applicable. The submodule rates are piecewise constant, the
+     * rates at a time point T apply from the previous time point up to T.
+     * @return true if the experiment was handled, false if the stepwise PRISM loop has to be used
      */
     bool
-    evaluteSimulationModule(NodeItem* submoduleNode, eval::ExperimentInterval interval);
+    evaluateNativelyOverTime(const std::vector<NodeItem*>& submoduleNodes,
+                             const eval::ExperimentInterval& interval);
+
+    /**
+     * Plans the PRISM evaluation of the transformed model, by its Markov chain if available
+     * (CTMC) and by its number of nodes otherwise.
+     */
+    eval::EnginePlanner::Plan
+    planEngine(const eval::ExperimentInterval& interval);
+
+    /**
+     * Submits a job to the eval::JobScheduler on behalf of this scene, the scene cancels it and
+     * waits for it once it is destroyed. See JobScheduler::submit() for the parameters.
+     */
+    eval::JobScheduler::Id
+    submitJob(const QString& name,
+              eval::JobScheduler::Work work,
+              int priority,
+              const std::vector<eval::JobScheduler::Id>& dependencies = {});
 
     bool mPrismMode = false;
 
@@ -582,6 +670,9 @@ private:
     /** Enum indicating in what form rates are interpreted. This is currently graphic scene dependent*/
     graph::RateInterpretation mActiveRateInterpretation;
 
+    /** Jobs submitted for this scene that may not be done yet, see submitJob() */
+    std::vector<eval::JobScheduler::Id> mJobs;
+
 public:
     std::unique_ptr<graphInternal::Transformer> mTransformer;
 };
@@ -0,0 +1,1133 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "markov_chain.h"
+
+#include "node.h"
+#include "logger.h"
+#include "transcriber.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+
+using namespace graph;
+
+namespace
+{
+/**
+ * Open addressing hash set of packed states. The states themselves are stored consecutively in
+ * the given storage, the table only holds (index + 1) of a state, 0 marks an empty bucket.
+ */
+class PackedStateSet
+{
+public:
+    PackedStateSet(unsigned int words, std::vector<uint64_t>* storage) :
+        mWords(words), mStorage(storage), mTable(1024, 0), mCount(0)
+    {
+    }
+
+    /**
+     * Inserts the given state unless it is already contained.
+     * @param state packed state of mWords words
+     * @return index of the state and whether it was inserted
+     */
+    std::pair<uint32_t, bool>
+    insert(const uint64_t* state)
+    {
+        if (2 * (mCount + 1) > mTable.size())
+        {
+            grow();
+        }
+        const size_t mask = mTable.size() - 1;
+        size_t bucket = hash(state) & mask;
+        while (mTable[bucket] != 0)
+        {
+            const uint32_t index = mTable[bucket] - 1;
+            if (std::memcmp(&(*mStorage)[size_t(index) * mWords], state, mWords * sizeof(uint64_t))
+                == 0)
+            {
+                return {index, false};
+            }
+            bucket = (bucket + 1) & mask;
+        }
+        const uint32_t index = static_cast<uint32_t>(mCount++);
+        mStorage->insert(mStorage->end(), state, state + mWords);
+        mTable[bucket] = index + 1;
+        return {index, true};
+    }
+
+    size_t
+    size() const
+    {
+        return mCount;
+    }
+
+private:
+    uint64_t
+    hash(const uint64_t* state) const
+    {
+        uint64_t h = 0x9E3779B97F4A7C15ULL;
+        for (unsigned int i = 0; i < mWords; ++i)
+        {  // splitmix64 finalizer per word
+            uint64_t x = state[i] + h;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            h = x ^ (x >> 31);
+        }
+        return h;
+    }
+
+    void
+    grow()
+    {
+        std::vector<uint32_t> table(mTable.size() * 2, 0);
+        const size_t mask = table.size() - 1;
+        for (size_t index = 0; index < mCount; ++index)
+        {
+            size_t bucket = hash(&(*mStorage)[index * mWords]) & mask;
+            while (table[bucket] != 0)
+            {
+                bucket = (bucket + 1) & mask;
+            }
+            table[bucket] = static_cast<uint32_t>(index + 1);
+        }
+        mTable.swap(table);
+    }
+
+    unsigned int mWords;
+    std::vector<uint64_t>* mStorage;
+    std::vector<uint32_t> mTable;
+    size_t mCount;
+};
+}  // namespace
+
+namespace graphInternal
+{
+MarkovChain::MarkovChain(const std::vector<Node*>& nodes,
+                         const Expression::Ptr& operational,
+                         const std::vector<std::pair<std::string, Expression::Ptr>>& labels) :
+    mValid(true),
+    mStateSize(0),
+    mWords(1),
+    mFailureDepth(kUnbounded),
+    mSymmetryReduction(true),
+    mTruncationState(kNoState)
+{
+    unsigned int maxNumber = 0;
+    for (Node* node : nodes)
+    {
+        mPositions[node->getNumber()] = mStateSize++;
+        maxNumber = std::max(maxNumber, node->getNumber());
+    }
+    mPositionByNumber.assign(maxNumber + 1, -1);
+    mFlagPositionByNumber.assign(maxNumber + 1, -1);
+    for (Node* node : nodes)
+    {
+        mPositionByNumber[node->getNumber()] = static_cast<int>(mPositions[node->getNumber()]);
+    }
+    for (Node* node : nodes)
+    {  // same condition the Transcriber uses to declare nXinternalfailure
+        if (node->hasValidFailureIndicator() && node->isRecoverableFromDefect()
+            && node->hasValidDefectRecoveryIndicator() && node->hasEssentialNodes())
+        {
+            mFlagPositionByNumber[node->getNumber()] = static_cast<int>(mStateSize);
+            mFlagPositions[node->getNumber()] = mStateSize++;
+        }
+    }
+    mWords = std::max(1U, (2 * mStateSize + 63) / 64);
+    for (Node* node : nodes)
+    {
+        compileNode(node);
+    }
+
+    mOperational = checkFormula(operational);
+    for (const auto& label : labels)
+    {
+        mLabelFormulas[label.first] = checkFormula(label.second);
+    }
+}
+
+MarkovChain::~MarkovChain() = default;
+
+bool
+MarkovChain::isValid() const
+{
+    return mValid;
+}
+
+const std::string&
+MarkovChain::getError() const
+{
+    return mError;
+}
+
+bool
+MarkovChain::setConstant(const std::string& name, double value)
+{
+    bool found = false;
+    for (Rule& rule : mRules)
+    {
+        if (rule.constant == name)
+        {
+            rule.rate = value;
+            found = true;
+        }
+        for (size_t i = 0; i < rule.guaranteeConstants.size(); ++i)
+        {
+            if (rule.guaranteeConstants[i] == name)
+            {
+                rule.guarantees[i].second = value;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+bool
+MarkovChain::fixNode(unsigned int node, int value)
+{
+    auto position = mPositions.find(node);
+    if (position == mPositions.end() || value < 0 || value > 2)
+    {
+        return false;
+    }
+    const Slot slot = slotOf(position->second);
+    for (Rule& rule : mRules)
+    {
+        if (rule.variable.word == slot.word && rule.variable.shift == slot.shift)
+        {
+            rule.fixed = true;
+        }
+    }
+    mFixedValues.emplace_back(slot, static_cast<uint64_t>(value));
+    return true;
+}
+
+Expression::Ptr
+MarkovChain::compileFormula(const std::string& formula)
+{
+    std::string error;
+    Expression::Ptr ret = Expression::parse(formula, nullptr, &error);
+    if (ret == nullptr)
+    {
+        mValid = false;
+        mError = error;
+        return nullptr;
+    }
+    return checkFormula(ret);
+}
+
+Expression::Ptr
+MarkovChain::checkFormula(const Expression::Ptr& formula)
+{
+    if (formula == nullptr)
+    {
+        mValid = false;
+        mError = "Missing formula";
+        return nullptr;
+    }
+    std::vector<unsigned int> referenced;
+    formula->collectNodes(&referenced);
+    for (unsigned int number : referenced)
+    {
+        if (mPositions.find(number) == mPositions.end())
+        {  // e.g. environment nodes, PRISM would reject these as well
+            mValid = false;
+            mError = "Unknown node n" + std::to_string(number) + " in \"" + formula->toString()
+                     + "\"";
+            return nullptr;
+        }
+    }
+    return formula;
+}
+
+Expression::Ptr
+MarkovChain::compileRecoveryFormula(Node* node, bool corruption)
+{
+    Recovery::Strategy strategy = corruption ? node->getCorruptionRecoveryStrategy()
+                                             : node->getDefectRecoveryStrategy();
+    switch (strategy)
+    {
+        case Recovery::Strategy::general:
+            return Expression::makeConstant(true);
+        case Recovery::Strategy::restricted:
+        {
+            std::string formula = node->getRestrictedRecoveryFormula();
+            if (formula.empty())
+            {  // The Transcriber omits the transition as well
+                return nullptr;
+            }
+            return compileFormula(formula);
+        }
+        case Recovery::Strategy::custom:
+        {
+            std::string formula = corruption ? node->getCustomCorrRecoveryFormula()
+                                             : node->getCustomDefRecoveryFormula();
+            return compileFormula(formula);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+void
+MarkovChain::addSecurityRule(Node* target, int attacker)
+{
+    auto position = mPositions.find(target->getNumber());
+    if (position == mPositions.end())
+    {
+        mValid = false;
+        mError = "Reach edge to unknown node " + target->getStringRepresentation();
+        return;
+    }
+    Rule rule;
+    rule.variable = slotOf(position->second);
+    rule.from = 0;
+    rule.to = 2;
+    rule.rate = std::atof(target->getIntrusionIndicator().c_str());
+    rule.constant = Transcriber::constantName(target->getNumber(), "SEC");
+    if (attacker >= 0)
+    {
+        rule.hasAttacker = true;
+        rule.attacker = slotOf(static_cast<unsigned int>(attacker));
+    }
+    for (Node* securingNode : target->getSecuringNodes())
+    {
+        auto securing = mPositions.find(securingNode->getNumber());
+        if (securing == mPositions.end())
+        {
+            mValid = false;
+            mError = "Security edge from unknown node " + securingNode->getStringRepresentation();
+            return;
+        }
+        rule.guarantees.emplace_back(slotOf(securing->second),
+                                     std::atof(securingNode->getSecurityIndicator().c_str()));
+        rule.guaranteeConstants.push_back(
+                Transcriber::constantName(securingNode->getNumber(), "GUAR"));
+    }
+    mRules.push_back(rule);
+}
+
+void
+MarkovChain::compileNode(Node* node)
+{
+    const unsigned int position = mPositions[node->getNumber()];
+    const Slot variable = slotOf(position);
+    auto flag = mFlagPositions.find(node->getNumber());
+    const bool hasFlag = flag != mFlagPositions.end();
+    const Slot flagSlot = hasFlag ? slotOf(flag->second) : Slot();
+    const double failureRate = std::atof(node->getFailureIndicator().c_str());
+
+    if (node->hasValidFailureIndicator())
+    {
+        // ----- n=0 -> n=1 -----
+        Rule safety;
+        safety.variable = variable;
+        safety.from = 0;
+        safety.to = 1;
+        safety.rate = failureRate;
+        safety.constant = Transcriber::constantName(node->getNumber(), "SAFE");
+        if (hasFlag)
+        {
+            safety.hasUpdatedFlag = true;
+            safety.updatedFlag = flagSlot;
+            safety.updatedFlagValue = 1;
+        }
+        mRules.push_back(safety);
+
+        if (node->hasEssentialNodes())
+        {  // turns defective (with PRISM's default rate 1) once its essentials are lost
+            Expression::Ptr essentials = checkFormula(node->getEssentialExpression());
+            if (essentials != nullptr)
+            {
+                Rule essential;
+                essential.variable = variable;
+                essential.from = 0;
+                essential.to = 1;
+                essential.rate = 1.0;
+                essential.guard = Expression::makeNegation(essentials);
+                mRules.push_back(essential);
+            }
+        }
+
+        // ----- n=1 -> n=0 -----
+        if (node->isRecoverableFromDefect() && node->hasValidDefectRecoveryIndicator())
+        {
+            Expression::Ptr formula = compileRecoveryFormula(node, false);
+            if (formula != nullptr)
+            {
+                Rule recovery;
+                recovery.variable = variable;
+                recovery.from = 1;
+                recovery.to = 0;
+                recovery.rate = std::atof(node->getDefectRecoveryIndicator().c_str());
+                recovery.constant = Transcriber::constantName(node->getNumber(), "DEFREC");
+                recovery.guard = formula;
+                recovery.hasRequiredFlag = hasFlag;
+                recovery.requiredFlag = flagSlot;
+                recovery.hasUpdatedFlag = hasFlag;
+                recovery.updatedFlag = flagSlot;
+                recovery.updatedFlagValue = 0;
+                mRules.push_back(recovery);
+            }
+        }
+    }
+
+    if (node->isReachable())
+    {
+        // ----- n=0 -> n=2 -----
+        if (node->isReachableFromEnv() && node->hasValidIntrusionIndicator())
+        {
+            addSecurityRule(node, -1);
+        }
+
+        // ----- n=2 -> n=1 -----
+        if (node->hasValidFailureIndicator())
+        {
+            Rule safety;
+            safety.variable = variable;
+            safety.from = 2;
+            safety.to = 1;
+            safety.rate = failureRate;
+            safety.constant = Transcriber::constantName(node->getNumber(), "SAFE");
+            mRules.push_back(safety);
+        }
+
+        // ----- n=2 -> n'=2 -----
+        for (Node* reachNode : node->getReachableNodes())
+        {
+            addSecurityRule(reachNode, static_cast<int>(position));
+        }
+
+        // ----- n=2 -> n=0 -----
+        if (node->isRecoverableFromCorruption() && node->hasValidCorruptionRecoveryIndicator())
+        {
+            Expression::Ptr formula = compileRecoveryFormula(node, true);
+            if (formula != nullptr)
+            {
+                Rule recovery;
+                recovery.variable = variable;
+                recovery.from = 2;
+                recovery.to = 0;
+                recovery.rate = std::atof(node->getCorruptionRecoveryIndicator().c_str());
+                recovery.constant = Transcriber::constantName(node->getNumber(), "CORREC");
+                recovery.guard = formula;
+                mRules.push_back(recovery);
+            }
+        }
+    }
+}
+
+MarkovChain::Slot
+MarkovChain::slotOf(unsigned int position) const
+{
+    Slot slot;
+    slot.word = position / 32;
+    slot.shift = (position % 32) * 2;
+    return slot;
+}
+
+bool
+MarkovChain::evaluate(const Expression::Ptr& expression, const uint64_t* state) const
+{
+    return expression->evaluate([&](unsigned int number, bool flag) -> int {
+        const std::vector<int>& positions = flag ? mFlagPositionByNumber : mPositionByNumber;
+        if (number >= positions.size() || positions[number] < 0)
+        {  // only flags may be missing, checkFormula rejects unknown nodes
+            return 0;
+        }
+        return slotOf(static_cast<unsigned int>(positions[number])).get(state);
+    });
+}
+
+double
+MarkovChain::ruleRate(const Rule& rule, const uint64_t* state) const
+{
+    if (rule.fixed || rule.variable.get(state) != rule.from
+        || (rule.hasAttacker && rule.attacker.get(state) != 2)
+        || (rule.hasRequiredFlag && rule.requiredFlag.get(state) == 0)
+        || (rule.guard != nullptr && !evaluate(rule.guard, state)))
+    {
+        return 0.0;
+    }
+    double rate = rule.rate;
+    for (const auto& guarantee : rule.guarantees)
+    {
+        if (guarantee.first.get(state) == 0)
+        {
+            rate -= guarantee.second;
+        }
+    }
+    // The Transcriber removes transitions with a rate of zero or below as well
+    return std::max(rate, 0.0);
+}
+
+void
+MarkovChain::applyRule(const Rule& rule, uint64_t* state) const
+{
+    rule.variable.set(state, rule.to);
+    if (rule.hasUpdatedFlag)
+    {
+        rule.updatedFlag.set(state, rule.updatedFlagValue);
+    }
+}
+
+unsigned int
+MarkovChain::getStateWords() const
+{
+    return mWords;
+}
+
+size_t
+MarkovChain::getRuleCount() const
+{
+    return mRules.size();
+}
+
+double
+MarkovChain::getRuleRates(const uint64_t* state, std::vector<double>* rates) const
+{
+    rates->assign(mRules.size(), 0.0);
+    if (!evaluate(mOperational, state))
+    {  // absorbing, since every command is guarded by (operational)
+        return 0.0;
+    }
+    double exitRate = 0.0;
+    for (size_t i = 0; i < mRules.size(); ++i)
+    {
+        (*rates)[i] = ruleRate(mRules[i], state);
+        exitRate += (*rates)[i];
+    }
+    return exitRate;
+}
+
+void
+MarkovChain::fireRule(size_t rule, uint64_t* state) const
+{
+    applyRule(mRules[rule], state);
+}
+
+bool
+MarkovChain::isRecoveryRule(size_t rule) const
+{
+    return mRules[rule].to == 0;
+}
+
+bool
+MarkovChain::satisfies(const std::string& label, const uint64_t* state) const
+{
+    auto formula = mLabelFormulas.find(label);
+    return formula != mLabelFormulas.end() && evaluate(formula->second, state);
+}
+
+void
+MarkovChain::translate(const MarkovChain& other, const uint64_t* state, uint64_t* result) const
+{
+    auto valueOf = [&](const std::vector<int>& positions, unsigned int number) -> uint64_t {
+        if (number >= positions.size() || positions[number] < 0)
+        {  // unknown to the other chain, i.e. ok
+            return 0;
+        }
+        return static_cast<uint64_t>(
+                other.slotOf(static_cast<unsigned int>(positions[number])).get(state));
+    };
+    std::fill_n(result, mWords, 0);
+    for (const auto& position : mPositions)
+    {
+        slotOf(position.second).set(result, valueOf(other.mPositionByNumber, position.first));
+    }
+    for (const auto& position : mFlagPositions)
+    {
+        slotOf(position.second).set(result, valueOf(other.mFlagPositionByNumber, position.first));
+    }
+}
+
+void
+MarkovChain::setFailureDepth(unsigned int depth)
+{
+    mFailureDepth = depth;
+}
+
+unsigned int
+MarkovChain::getFailureDepth() const
+{
+    return mFailureDepth;
+}
+
+unsigned int
+MarkovChain::getNodeCount() const
+{
+    return static_cast<unsigned int>(mPositions.size());
+}
+
+std::vector<unsigned int>
+MarkovChain::getConeOfInfluence(const std::vector<unsigned int>& observed,
+                                std::vector<unsigned int>* frozen) const
+{
+    // owner (node number) of every state position, flags belong to their node
+    std::vector<unsigned int> owners(mStateSize, 0);
+    for (const auto& position : mPositions)
+    {
+        owners[position.second] = position.first;
+    }
+    for (const auto& position : mFlagPositions)
+    {
+        owners[position.second] = position.first;
+    }
+    auto ownerOf = [&owners](const Slot& slot) { return owners[slot.word * 32 + slot.shift / 2]; };
+
+    // nodes each node depends on through its enabled rules
+    std::map<unsigned int, std::set<unsigned int>> dependencies;
+    for (const Rule& rule : mRules)
+    {
+        if (rule.fixed || rule.rate <= 0.0
+            || (rule.guard != nullptr && rule.guard->getKind() == Expression::Kind::constant
+                && rule.guard->getValue() == 0))
+        {
+            continue;
+        }
+        std::set<unsigned int>& nodes = dependencies[ownerOf(rule.variable)];
+        if (rule.hasAttacker)
+        {
+            nodes.insert(ownerOf(rule.attacker));
+        }
+        for (const auto& guarantee : rule.guarantees)
+        {
+            nodes.insert(ownerOf(guarantee.first));
+        }
+        if (rule.guard != nullptr)
+        {
+            std::vector<unsigned int> referenced;
+            rule.guard->collectNodes(&referenced);
+            nodes.insert(referenced.begin(), referenced.end());
+        }
+    }
+
+    std::vector<unsigned int> pending(observed);
+    if (mOperational != nullptr)
+    {
+        mOperational->collectNodes(&pending);
+    }
+    std::set<unsigned int> cone;
+    while (!pending.empty())
+    {
+        const unsigned int number = pending.back();
+        pending.pop_back();
+        if (mPositions.count(number) == 0 || !cone.insert(number).second)
+        {
+            continue;
+        }
+        auto rules = dependencies.find(number);
+        if (rules != dependencies.end())
+        {
+            pending.insert(pending.end(), rules->second.begin(), rules->second.end());
+        }
+    }
+    if (frozen != nullptr)
+    {
+        frozen->clear();
+        for (unsigned int number : cone)
+        {
+            if (dependencies.count(number) == 0)
+            {
+                frozen->push_back(number);
+            }
+        }
+    }
+    return std::vector<unsigned int>(cone.begin(), cone.end());
+}
+
+std::vector<unsigned int>
+MarkovChain::getNodeNumbers() const
+{
+    std::vector<unsigned int> numbers;
+    numbers.reserve(mPositions.size());
+    for (const auto& position : mPositions)
+    {
+        numbers.push_back(position.first);
+    }
+    std::sort(numbers.begin(), numbers.end());
+    return numbers;
+}
+
+uint32_t
+MarkovChain::getTruncationState() const
+{
+    return mTruncationState;
+}
+
+void
+MarkovChain::setSymmetryReduction(bool enabled)
+{
+    mSymmetryReduction = enabled;
+}
+
+std::string
+MarkovChain::ruleKey(const Rule& rule, unsigned int first, unsigned int second) const
+{
+    // positions of the variables and flags of both nodes are exchanged
+    std::map<unsigned int, unsigned int> image;
+    if (first != second)
+    {
+        image[mPositions.at(first)] = mPositions.at(second);
+        image[mPositions.at(second)] = mPositions.at(first);
+        auto firstFlag = mFlagPositions.find(first);
+        auto secondFlag = mFlagPositions.find(second);
+        if (firstFlag != mFlagPositions.end() && secondFlag != mFlagPositions.end())
+        {
+            image[firstFlag->second] = secondFlag->second;
+            image[secondFlag->second] = firstFlag->second;
+        }
+    }
+    auto position = [&image](const Slot& slot) {
+        const unsigned int position = slot.word * 32 + slot.shift / 2;
+        auto mapped = image.find(position);
+        return std::to_string(mapped == image.end() ? position : mapped->second);
+    };
+    auto number = [](double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%a", value);
+        return std::string(buffer);
+    };
+
+    std::string key = position(rule.variable) + ":" + std::to_string(rule.from) + ">"
+                      + std::to_string(rule.to) + "@" + number(rule.rate);
+    if (rule.fixed)
+    {
+        key += " fixed";
+    }
+    if (rule.hasAttacker)
+    {
+        key += " attacker " + position(rule.attacker);
+    }
+    std::vector<std::string> guarantees;
+    for (const auto& guarantee : rule.guarantees)
+    {
+        guarantees.push_back(position(guarantee.first) + "@" + number(guarantee.second));
+    }
+    std::sort(guarantees.begin(), guarantees.end());
+    for (const std::string& guarantee : guarantees)
+    {
+        key += " guarantee " + guarantee;
+    }
+    if (rule.guard != nullptr)
+    {
+        key += " guard " + rule.guard->swapNodes(first, second)->toCanonicalString();
+    }
+    if (rule.hasRequiredFlag)
+    {
+        key += " requires " + position(rule.requiredFlag);
+    }
+    if (rule.hasUpdatedFlag)
+    {
+        key += " updates " + position(rule.updatedFlag) + "="
+               + std::to_string(rule.updatedFlagValue);
+    }
+    return key;
+}
+
+bool
+MarkovChain::isInterchangeable(unsigned int first,
+                               unsigned int second,
+                               const std::vector<std::string>& ruleKeys) const
+{
+    if (mFlagPositions.count(first) != mFlagPositions.count(second))
+    {
+        return false;
+    }
+    std::vector<std::string> swapped;
+    swapped.reserve(mRules.size());
+    for (const Rule& rule : mRules)
+    {
+        swapped.push_back(ruleKey(rule, first, second));
+    }
+    std::sort(swapped.begin(), swapped.end());
+    if (swapped != ruleKeys)
+    {
+        return false;
+    }
+
+    auto invariant = [&](const Expression::Ptr& formula) {
+        return formula->toCanonicalString()
+               == formula->swapNodes(first, second)->toCanonicalString();
+    };
+    if (!invariant(mOperational))
+    {
+        return false;
+    }
+    for (const auto& label : mLabelFormulas)
+    {
+        if (!invariant(label.second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::vector<unsigned int>>
+MarkovChain::getSymmetryGroups() const
+{
+    std::vector<std::vector<unsigned int>> groups;
+    if (!mValid)
+    {
+        return groups;
+    }
+    std::vector<std::string> ruleKeys;
+    ruleKeys.reserve(mRules.size());
+    for (const Rule& rule : mRules)
+    {
+        ruleKeys.push_back(ruleKey(rule, 0, 0));
+    }
+    std::sort(ruleKeys.begin(), ruleKeys.end());
+
+    // Only nodes with the same rules of their own are candidates, the full check swaps them in
+    // all rules and formulas
+    std::map<std::string, std::vector<unsigned int>> candidates;
+    for (unsigned int number : getNodeNumbers())
+    {
+        const Slot variable = slotOf(mPositions.at(number));
+        std::vector<std::string> rules;
+        for (const Rule& rule : mRules)
+        {
+            if (rule.variable.word == variable.word && rule.variable.shift == variable.shift)
+            {
+                rules.push_back(std::to_string(rule.from) + ">" + std::to_string(rule.to) + "@"
+                                + std::to_string(rule.rate) + (rule.fixed ? " fixed" : "")
+                                + (rule.hasAttacker ? " attacker" : "")
+                                + (rule.guard != nullptr ? " guard" : "")
+                                + std::to_string(rule.guarantees.size()));
+            }
+        }
+        std::sort(rules.begin(), rules.end());
+        std::string signature = mFlagPositions.count(number) != 0 ? "flag" : "";
+        for (const std::string& rule : rules)
+        {
+            signature += ";" + rule;
+        }
+        candidates[signature].push_back(number);
+    }
+
+    for (const auto& candidate : candidates)
+    {  // the transpositions with the first member generate all permutations of a group
+        std::vector<std::vector<unsigned int>> found;
+        for (unsigned int number : candidate.second)
+        {
+            auto group = std::find_if(found.begin(), found.end(), [&](const auto& members) {
+                return isInterchangeable(members.front(), number, ruleKeys);
+            });
+            if (group != found.end())
+            {
+                group->push_back(number);
+            }
+            else
+            {
+                found.push_back({number});
+            }
+        }
+        for (auto& members : found)
+        {
+            if (members.size() > 1)
+            {
+                groups.push_back(std::move(members));
+            }
+        }
+    }
+    std::sort(groups.begin(), groups.end());
+    return groups;
+}
+
+void
+MarkovChain::canonicalise(uint64_t* state, std::vector<unsigned int>* scratch) const
+{
+    for (const Group& group : mGroups)
+    {
+        const bool flags = !group.flags.empty();
+        scratch->clear();
+        for (size_t i = 0; i < group.variables.size(); ++i)
+        {
+            scratch->push_back(static_cast<unsigned int>(
+                    group.variables[i].get(state) | (flags ? group.flags[i].get(state) << 2 : 0)));
+        }
+        std::sort(scratch->begin(), scratch->end());
+        for (size_t i = 0; i < group.variables.size(); ++i)
+        {
+            group.variables[i].set(state, (*scratch)[i] & 3U);
+            if (flags)
+            {
+                group.flags[i].set(state, (*scratch)[i] >> 2);
+            }
+        }
+    }
+}
+
+std::vector<size_t>
+MarkovChain::getLumpedGroupSizes() const
+{
+    std::vector<size_t> sizes;
+    for (const Group& group : mGroups)
+    {
+        sizes.push_back(group.variables.size());
+    }
+    return sizes;
+}
+
+bool
+MarkovChain::build(size_t maxStates, const MarkovChain* previous)
+{
+    mStates.clear();
+    mRowStarts.clear();
+    mColumns.clear();
+    mRates.clear();
+    mLabelStates.clear();
+    mPreviousStates.clear();
+    mTruncationState = kNoState;
+    mGroups.clear();
+    if (!mValid)
+    {
+        return false;
+    }
+    if (mSymmetryReduction)
+    {
+        for (const auto& members : getSymmetryGroups())
+        {
+            Group group;
+            for (unsigned int number : members)
+            {
+                group.variables.push_back(slotOf(mPositions.at(number)));
+                auto flag = mFlagPositions.find(number);
+                if (flag != mFlagPositions.end())
+                {
+                    group.flags.push_back(slotOf(flag->second));
+                }
+            }
+            mGroups.push_back(std::move(group));
+        }
+    }
+
+    // The lower bit of every node variable, (value | value >> 1) & mask marks the nodes that
+    // are not ok. The truncation state uses the value 3 no node variable takes.
+    const bool bounded = mFailureDepth < getNodeCount();
+    std::vector<uint64_t> depthMask(mWords, 0);
+    std::vector<uint64_t> truncated(mWords, 0);
+    for (const auto& position : mPositions)
+    {
+        const Slot slot = slotOf(position.second);
+        depthMask[slot.word] |= uint64_t(1) << slot.shift;
+    }
+    if (bounded)
+    {
+        slotOf(0).set(truncated.data(), 3);
+    }
+    auto exceedsDepth = [&](const uint64_t* state) {
+        size_t depth = 0;
+        for (unsigned int word = 0; word < mWords; ++word)
+        {
+            depth += std::bitset<64>((state[word] | state[word] >> 1) & depthMask[word]).count();
+        }
+        return depth > mFailureDepth;
+    };
+
+    PackedStateSet states(mWords, &mStates);
+    std::vector<uint64_t> current(mWords, 0);
+    std::vector<uint64_t> successor(mWords, 0);
+    std::vector<unsigned int> scratch;
+    for (const auto& fixed : mFixedValues)
+    {
+        fixed.first.set(current.data(), fixed.second);
+    }
+    canonicalise(current.data(), &scratch);
+    states.insert(current.data());  // initial state, all nodes ok unless fixed
+    if (previous != nullptr)
+    {  // the states of the previous chain are queued right after the initial state
+        const size_t previousCount = previous->getStateCount();
+        mPreviousStates.reserve(previousCount);
+        for (size_t i = 0; i < previousCount; ++i)
+        {
+            if (bounded && i == previous->mTruncationState)
+            {
+                successor = truncated;
+            }
+            else
+            {
+                translate(*previous, &previous->mStates[i * previous->mWords], successor.data());
+            }
+            mPreviousStates.push_back(states.insert(successor.data()).first);
+            if (bounded && successor == truncated)
+            {
+                mTruncationState = mPreviousStates.back();
+            }
+        }
+    }
+    mRowStarts.push_back(0);
+
+    // The states are stored in discovery order, hence the storage itself is the BFS queue
+    for (size_t index = 0; index < states.size(); ++index)
+    {
+        std::copy_n(&mStates[index * mWords], mWords, current.begin());
+        const uint64_t* state = current.data();
+        const size_t rowStart = mColumns.size();
+
+        if (index != mTruncationState && evaluate(mOperational, state))
+        {  // otherwise absorbing, since every command is guarded by (operational)
+            for (const Rule& rule : mRules)
+            {
+                const double rate = ruleRate(rule, state);
+                if (rate <= 0.0)
+                {
+                    continue;
+                }
+
+                successor = current;
+                applyRule(rule, successor.data());
+                canonicalise(successor.data(), &scratch);
+                if (bounded && exceedsDepth(successor.data()))
+                {
+                    successor = truncated;
+                }
+
+                auto inserted = states.insert(successor.data());
+                if (inserted.second && states.size() > maxStates)
+                {
+                    mError = "State space exceeds " + std::to_string(maxStates) + " states";
+                    mStates.clear();
+                    mRowStarts.clear();
+                    mColumns.clear();
+                    mRates.clear();
+                    return false;
+                }
+                if (bounded && successor == truncated)
+                {
+                    mTruncationState = inserted.first;
+                }
+
+                // merge rules leading to the same state (e.g. essential and safety failure)
+                auto begin = mColumns.begin() + static_cast<std::ptrdiff_t>(rowStart);
+                auto existing = std::find(begin, mColumns.end(), inserted.first);
+                if (existing != mColumns.end())
+                {
+                    mRates[static_cast<size_t>(existing - mColumns.begin())] += rate;
+                }
+                else
+                {
+                    mColumns.push_back(inserted.first);
+                    mRates.push_back(rate);
+                }
+            }
+        }
+        mRowStarts.push_back(mColumns.size());
+    }
+
+    const size_t stateCount = states.size();
+    for (const auto& label : mLabelFormulas)
+    {
+        std::vector<bool>& satisfied = mLabelStates[label.first];
+        satisfied.resize(stateCount, false);
+        for (size_t i = 0; i < stateCount; ++i)
+        {
+            satisfied[i] = i != mTruncationState && evaluate(label.second, &mStates[i * mWords]);
+        }
+    }
+    if (!mGroups.empty())
+    {
+        PRINT_INFO("Lumped %zu groups of interchangeable nodes", mGroups.size());
+    }
+    if (bounded)
+    {
+        PRINT_INFO("Built CTMC with %lu states and %lu transitions up to failure depth %u",
+                   stateCount, mColumns.size(), mFailureDepth);
+    }
+    else
+    {
+        PRINT_INFO("Built CTMC with %lu states and %lu transitions", stateCount, mColumns.size());
+    }
+    return true;
+}
+
+size_t
+MarkovChain::getStateCount() const
+{
+    return mRowStarts.empty() ? 0 : mRowStarts.size() - 1;
+}
+
+size_t
+MarkovChain::getTransitionCount() const
+{
+    return mColumns.size();
+}
+
+const std::vector<uint64_t>&
+MarkovChain::getRowStarts() const
+{
+    return mRowStarts;
+}
+
+const std::vector<uint32_t>&
+MarkovChain::getColumns() const
+{
+    return mColumns;
+}
+
+const std::vector<double>&
+MarkovChain::getRates() const
+{
+    return mRates;
+}
+
+bool
+MarkovChain::hasLabel(const std::string& label) const
+{
+    return mLabelFormulas.find(label) != mLabelFormulas.end();
+}
+
+const std::vector<bool>&
+MarkovChain::getLabelStates(const std::string& label) const
+{
+    return mLabelStates.at(label);
+}
+
+void
+MarkovChain::transferDistribution(const std::vector<double>& previous,
+                                  std::vector<double>* distribution) const
+{
+    distribution->assign(getStateCount(), 0.0);
+    for (size_t i = 0; i < previous.size() && i < mPreviousStates.size(); ++i)
+    {
+        (*distribution)[mPreviousStates[i]] += previous[i];
+    }
+}
+
+int
+MarkovChain::getNodeValue(uint32_t state, unsigned int node) const
+{
+    if (node >= mPositionByNumber.size() || mPositionByNumber[node] < 0)
+    {
+        return -1;
+    }
+    return slotOf(static_cast<unsigned int>(mPositionByNumber[node]))
+            .get(&mStates[size_t(state) * mWords]);
+}
+
+}  // namespace graphInternal
@@ -0,0 +1,482 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_GRAPH_INTERNAL_MARKOV_CHAIN_H
+#define ERIS_GRAPH_INTERNAL_MARKOV_CHAIN_H
+
+#include "expression.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graphInternal
+{
+class Node;
+
+/**
+ * Explicit representation of the CTMC that the Transcriber writes as PRISM code. The transition
+ * rules are taken from the same node data the Transcriber uses (safety, security, essential and
+ * recovery transitions, all guarded by the operational formula), so that the reachable states can
+ * be enumerated in-process and handed to a native solver instead of PRISM.
+ *
+ * Every node variable (and internalfailure flag) occupies two bits of a state, i.e., a model of up
+ * to 32 variables fits into a single uint64_t. The reachable states are stored in a compact open
+ * addressing hash set and the rate matrix is stored in compressed sparse row (CSR) format.
+ */
+class MarkovChain
+{
+public:
+    /**
+     * Compiles the transition rules of the given nodes. The node objects are not referenced
+     * after construction.
+     * @param nodes all nodes excluding the environment nodes
+     * @param operational the operational formula as generated by the Transcriber
+     * @param labels label names and formulas as generated by the Transcriber
+     */
+    MarkovChain(const std::vector<Node*>& nodes,
+                const Expression::Ptr& operational,
+                const std::vector<std::pair<std::string, Expression::Ptr>>& labels);
+    ~MarkovChain();
+
+    /**
+     * Indicates whether the rules and labels could be compiled. If not, the model can only be
+     * analysed by PRISM.
+     * @return true if valid, false otherwise
+     */
+    bool
+    isValid() const;
+
+    /**
+     * Returns the reason why the chain is invalid or could not be built.
+     * @return error description
+     */
+    const std::string&
+    getError() const;
+
+    /**
+     * Replaces the value of a rate constant (see Transcriber::constantName()) in all transition
+     * rules using it, e.g. to evaluate a copy of the chain for another parameter value. Takes
+     * effect with the next build(). Transitions whose rate was zero when the chain was compiled
+     * do not exist and are not affected.
+     * @param name of the constant, e.g. rn3SAFE
+     * @param value new rate
+     * @return true if a rule uses the constant, false otherwise
+     */
+    bool
+    setConstant(const std::string& name, double value);
+
+    /**
+     * Fixes the variable of a node to the given value: the initial state holds it and the
+     * transition rules of the node are disabled. Used to condition the model on the state of a
+     * component, e.g. for importance measures. Takes effect with the next build().
+     * @param node number of the node
+     * @param value 0 ok, 1 defective or 2 corrupted
+     * @return false if the node is unknown or the value invalid
+     */
+    bool
+    fixNode(unsigned int node, int value);
+
+    /**
+     * Bounds the exploration of build() to the states in which at most the given number of
+     * nodes are not ok. Transitions leaving these states lead to a single absorbing truncation
+     * state instead, its probability bounds the error of every result from above. Takes effect
+     * with the next build().
+     * @param depth maximum number of defective or corrupted nodes, kUnbounded for all states
+     */
+    void
+    setFailureDepth(unsigned int depth);
+
+    unsigned int
+    getFailureDepth() const;
+
+    /**
+     * Number of node variables, i.e. the largest failure depth.
+     */
+    unsigned int
+    getNodeCount() const;
+
+    /**
+     * Enables the symmetry reduction of build() (default on): nodes that are interchangeable,
+     * i.e., swapping them maps every transition rule, the operational formula and all labels
+     * onto themselves, are stored as a multiset. Each reachable state is replaced by the
+     * canonical representative of its orbit (the values of each group sorted), which is the
+     * counter abstraction "how many are ok, defective or corrupted". The resulting chain is the
+     * exact lumping of the full chain, all label probabilities are preserved. getNodeValue()
+     * returns the values of the representatives. Takes effect with the next build().
+     */
+    void
+    setSymmetryReduction(bool enabled);
+
+    /**
+     * Detects the groups of interchangeable nodes in the current transition rules (taking
+     * setConstant() and fixNode() into account).
+     * @return node numbers of each group with at least two members, in ascending order
+     */
+    std::vector<std::vector<unsigned int>>
+    getSymmetryGroups() const;
+
+    /**
+     * Sizes of the groups of interchangeable nodes lumped by the last build(), empty if the
+     * symmetry reduction is disabled.
+     */
+    std::vector<size_t>
+    getLumpedGroupSizes() const;
+
+    /**
+     * Computes the cone of influence of the given nodes: the nodes themselves, the nodes of the
+     * operational formula (it guards every rule) and, transitively, the nodes the rules of nodes
+     * in the cone depend on (attackers, securing nodes, guards). Nodes outside the cone never
+     * influence the values of the nodes inside, i.e., labels over the given nodes keep their
+     * probabilities if the other nodes are removed. Takes setConstant() and fixNode() into
+     * account, rules with a rate of zero are ignored.
+     * @param observed numbers of the nodes the labels of interest refer to
+     * @param frozen vector the nodes of the cone without enabled rules are stored in, i.e. nodes
+     * that keep their initial value (may be null)
+     * @return node numbers of the cone in ascending order
+     */
+    std::vector<unsigned int>
+    getConeOfInfluence(const std::vector<unsigned int>& observed,
+                       std::vector<unsigned int>* frozen) const;
+
+    /**
+     * Numbers of all nodes of the chain in ascending order.
+     */
+    std::vector<unsigned int>
+    getNodeNumbers() const;
+
+    /**
+     * Returns the index of the truncation state, kNoState if no transition was truncated by
+     * the failure depth. Only valid after build().
+     */
+    uint32_t
+    getTruncationState() const;
+
+    /**
+     * Enumerates all states reachable from the initial state (all nodes ok unless fixed) by
+     * breadth first search and stores the rate matrix and the label sets.
+     * If a previous (built) chain of the same nodes is given, its states are explored as well, so
+     * that a distribution over them can be carried over by transferDistribution(). This is used
+     * when rates change over time, the symmetry reduction has to be disabled in both chains.
+     * @param maxStates upper bound for the number of states, exploration fails when exceeded
+     * @param previous chain whose states are added to the initial state, may be null
+     * @return true on success, false otherwise
+     */
+    bool
+    build(size_t maxStates = kDefaultMaxStates, const MarkovChain* previous = nullptr);
+
+    /**
+     * Maps a distribution over the states of the previous chain given to build() onto the
+     * states of this chain.
+     * @param previous distribution indexed by the states of the previous chain
+     * @param distribution resized to getStateCount() and filled with the mapped distribution
+     */
+    void
+    transferDistribution(const std::vector<double>& previous,
+                         std::vector<double>* distribution) const;
+
+    size_t
+    getStateCount() const;
+
+    size_t
+    getTransitionCount() const;
+
+    /**
+     * Row offsets of the CSR rate matrix: the transitions of state i are stored at the indices
+     * [getRowStarts()[i], getRowStarts()[i + 1]) of getColumns() and getRates().
+     * Index 0 is the initial state.
+     * @return stateCount + 1 offsets
+     */
+    const std::vector<uint64_t>&
+    getRowStarts() const;
+
+    /**
+     * Target states of the CSR rate matrix.
+     */
+    const std::vector<uint32_t>&
+    getColumns() const;
+
+    /**
+     * Rates of the CSR rate matrix.
+     */
+    const std::vector<double>&
+    getRates() const;
+
+    /**
+     * Checks whether a label with the given name is defined.
+     * @param label name of the label
+     * @return true if defined, false otherwise
+     */
+    bool
+    hasLabel(const std::string& label) const;
+
+    /**
+     * Returns for each state whether it satisfies the given label. Only valid after build().
+     * @param label name of the label
+     * @return vector indexed by state
+     */
+    const std::vector<bool>&
+    getLabelStates(const std::string& label) const;
+
+    /**
+     * Returns the value (0 ok, 1 defective, 2 corrupted) of the given node in the given state.
+     * Only valid after build().
+     * @param state index of the state
+     * @param node number of the node
+     * @return value of the node variable, -1 if the node is unknown
+     */
+    int
+    getNodeValue(uint32_t state, unsigned int node) const;
+
+    /**
+     * Number of uint64_t per packed state. The initial state (all nodes ok) is all zero.
+     */
+    unsigned int
+    getStateWords() const;
+
+    /**
+     * Number of transition rules, see getRuleRates().
+     */
+    size_t
+    getRuleCount() const;
+
+    /**
+     * Computes the rates of all transition rules in the given packed state, without exploring
+     * the state space. Used to simulate models that are too large to be built.
+     * @param state packed state of getStateWords() words
+     * @param rates resized to getRuleCount(), 0 for rules that are not enabled
+     * @return the exit rate of the state, 0 if absorbing
+     */
+    double
+    getRuleRates(const uint64_t* state, std::vector<double>* rates) const;
+
+    /**
+     * Applies the transition rule with the given index to the packed state.
+     */
+    void
+    fireRule(size_t rule, uint64_t* state) const;
+
+    /**
+     * Checks whether the transition rule with the given index recovers a node (i.e. sets it to
+     * ok), all other rules are failures or attacks.
+     */
+    bool
+    isRecoveryRule(size_t rule) const;
+
+    /**
+     * Checks whether the packed state satisfies the given label.
+     * @return true if satisfied, false otherwise or if the label is unknown
+     */
+    bool
+    satisfies(const std::string& label, const uint64_t* state) const;
+
+    static constexpr size_t kDefaultMaxStates = 1 << 24;
+
+    static constexpr unsigned int kUnbounded = ~0U;
+
+    static constexpr uint32_t kNoState = ~0U;
+
+private:
+    /** Location of a 2 bit variable within a packed state */
+    struct Slot
+    {
+        uint32_t word = 0;
+        uint32_t shift = 0;
+
+        int
+        get(const uint64_t* state) const
+        {
+            return static_cast<int>((state[word] >> shift) & 3U);
+        }
+
+        void
+        set(uint64_t* state, uint64_t value) const
+        {
+            state[word] = (state[word] & ~(uint64_t(3) << shift)) | (value << shift);
+        }
+    };
+
+    /**
+     * A transition rule of a single node variable, corresponding to one PRISM command
+     * (or one family of commands in case of security guarantees).
+     */
+    struct Rule
+    {
+        /** Variable that changes */
+        Slot variable;
+        uint8_t from;
+        uint8_t to;
+        double rate;
+        /** Name of the rate constant, empty for fixed rates */
+        std::string constant;
+        /** Corrupted node the attack originates from */
+        bool hasAttacker = false;
+        Slot attacker;
+        /** Securing nodes whose guarantee is deducted if ok */
+        std::vector<std::pair<Slot, double>> guarantees;
+        /** Names of the guarantee constants, same order as guarantees */
+        std::vector<std::string> guaranteeConstants;
+        /** Additional guard (essential nodes, recovery formula), may be null */
+        Expression::Ptr guard;
+        /** internalfailure flag that has to be set */
+        bool hasRequiredFlag = false;
+        Slot requiredFlag;
+        /** internalfailure flag that is updated */
+        bool hasUpdatedFlag = false;
+        Slot updatedFlag;
+        uint8_t updatedFlagValue = 0;
+        /** Disabled by fixNode() */
+        bool fixed = false;
+    };
+
+    /** Interchangeable nodes, see setSymmetryReduction() */
+    struct Group
+    {
+        std::vector<Slot> variables;
+        /** internalfailure flags of the members, empty if they have none */
+        std::vector<Slot> flags;
+    };
+
+    Slot
+    slotOf(unsigned int position) const;
+
+    /**
+     * Checks whether swapping the nodes with the given numbers maps the rules, the operational
+     * formula and the labels onto themselves.
+     * @param ruleKeys sorted keys of all rules, see ruleKey()
+     */
+    bool
+    isInterchangeable(unsigned int first,
+                      unsigned int second,
+                      const std::vector<std::string>& ruleKeys) const;
+
+    /**
+     * Returns a string identifying the rule after the nodes first and second are swapped
+     * (first == second for the rule itself). Guards are compared up to the order of operands.
+     */
+    std::string
+    ruleKey(const Rule& rule, unsigned int first, unsigned int second) const;
+
+    /**
+     * Replaces the state by the representative of its orbit, i.e., sorts the member values of
+     * every group.
+     * @param scratch reused buffer
+     */
+    void
+    canonicalise(uint64_t* state, std::vector<unsigned int>* scratch) const;
+
+    void
+    compileNode(Node* node);
+
+    void
+    addSecurityRule(Node* target, int attacker);
+
+    Expression::Ptr
+    compileFormula(const std::string& formula);
+
+    /**
+     * Checks that all nodes the expression refers to are part of the chain.
+     * @return the expression, nullptr (and invalid chain) otherwise
+     */
+    Expression::Ptr
+    checkFormula(const Expression::Ptr& formula);
+
+    Expression::Ptr
+    compileRecoveryFormula(Node* node, bool corruption);
+
+    bool
+    evaluate(const Expression::Ptr& expression, const uint64_t* state) const;
+
+    /**
+     * Returns the rate of the rule in the given state, 0 if the rule is not enabled. The
+     * operational formula is not checked.
+     */
+    double
+    ruleRate(const Rule& rule, const uint64_t* state) const;
+
+    void
+    applyRule(const Rule& rule, uint64_t* state) const;
+
+    /**
+     * Converts a packed state of another chain into the layout of this chain, node variables and
+     * flags are matched by node number.
+     */
+    void
+    translate(const MarkovChain& other, const uint64_t* state, uint64_t* result) const;
+
+    bool mValid;
+
+    std::string mError;
+
+    /** Maps node numbers to state positions */
+    std::unordered_map<unsigned int, unsigned int> mPositions;
+
+    /** Maps node numbers to the state position of their internalfailure flag */
+    std::unordered_map<unsigned int, unsigned int> mFlagPositions;
+
+    /** State positions indexed by node number for fast expression evaluation, -1 if unused */
+    std::vector<int> mPositionByNumber;
+    std::vector<int> mFlagPositionByNumber;
+
+    /** Number of variables per state (node variables followed by flags) */
+    unsigned int mStateSize;
+
+    /** Number of uint64_t per packed state */
+    unsigned int mWords;
+
+    std::vector<Rule> mRules;
+
+    Expression::Ptr mOperational;
+
+    std::map<std::string, Expression::Ptr> mLabelFormulas;
+
+    /** Packed states, mWords per state */
+    std::vector<uint64_t> mStates;
+
+    std::vector<uint64_t> mRowStarts;
+
+    std::vector<uint32_t> mColumns;
+
+    std::vector<double> mRates;
+
+    std::map<std::string, std::vector<bool>> mLabelStates;
+
+    /** Index in this chain of every state of the previous chain given to build() */
+    std::vector<uint32_t> mPreviousStates;
+
+    /** Initial values of the nodes fixed by fixNode() */
+    std::vector<std::pair<Slot, uint64_t>> mFixedValues;
+
+    unsigned int mFailureDepth;
+
+    bool mSymmetryReduction;
+
+    /** Groups of interchangeable nodes of the last build() */
+    std::vector<Group> mGroups;
+
+    uint32_t mTruncationState;
+};
+
+}  // namespace graphInternal
+
+#endif /* ERIS_GRAPH_INTERNAL_MARKOV_CHAIN_H */
@@ -0,0 +1,319 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "minimal_paths.h"
+
+#include "node.h"
+
+#include <utility>
+
+namespace graphInternal
+{
+MinimalPaths::MinimalPaths(const std::vector<Node*>& nodes)
+{
+    // terminals, the variable is never evaluated
+    mNodes.push_back({~0U, kEmpty, kEmpty});
+    mNodes.push_back({~0U, kBase, kBase});
+
+    for (Node* node : nodes)
+    {
+        mPaths[node->getNumber()] = kEmpty;
+    }
+
+    // Paths(v) = minimal(U_{u reaching v} (u is env ? {{}} : Paths(u) x {u})), iterated until no
+    // family changes. Sets passing v itself are absorbed by their prefix, hence cycles terminate.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (Node* node : nodes)
+        {
+            Id family = kEmpty;
+            for (Node* reaching : node->getReachingNodes())
+            {
+                if (!reaching->isReachable())
+                {
+                    continue;
+                }
+                if (reaching->isEnvironment())
+                {
+                    family = unite(family, kBase);
+                }
+                else if (reaching != node)
+                {
+                    family = unite(family,
+                                   addElement(mPaths[reaching->getNumber()], reaching->getNumber()));
+                }
+            }
+            family = minimal(family);
+            Id& current = mPaths[node->getNumber()];
+            if (family != current)
+            {
+                current = family;
+                changed = true;
+            }
+        }
+    }
+}
+
+MinimalPaths::~MinimalPaths() = default;
+
+const std::string&
+MinimalPaths::getFormula(Node* node)
+{
+    auto iter = mFormulas.find(node->getNumber());
+    if (iter != mFormulas.end())
+    {
+        return iter->second;
+    }
+    std::string& formula = mFormulas[node->getNumber()];
+    const Id paths = mPaths.at(node->getNumber());
+    if (paths != kEmpty)
+    {
+        formula = toFormula(paths);
+    }
+    return formula;
+}
+
+size_t
+MinimalPaths::getPathCount(Node* node)
+{
+    return count(mPaths.at(node->getNumber()));
+}
+
+MinimalPaths::Id
+MinimalPaths::makeNode(unsigned int variable, Id low, Id high)
+{
+    if (high == kEmpty)
+    {  // zero-suppression rule
+        return low;
+    }
+    auto key = std::make_tuple(variable, low, high);
+    auto iter = mUniqueTable.find(key);
+    if (iter != mUniqueTable.end())
+    {
+        return iter->second;
+    }
+    const Id id = static_cast<Id>(mNodes.size());
+    mNodes.push_back({variable, low, high});
+    mUniqueTable.emplace(key, id);
+    return id;
+}
+
+MinimalPaths::Id
+MinimalPaths::unite(Id f, Id g)
+{
+    if (f == kEmpty || f == g)
+    {
+        return g;
+    }
+    if (g == kEmpty)
+    {
+        return f;
+    }
+    if (f > g)
+    {
+        std::swap(f, g);
+    }
+    auto key = std::make_pair(f, g);
+    auto iter = mUnionCache.find(key);
+    if (iter != mUnionCache.end())
+    {
+        return iter->second;
+    }
+
+    Id ret;
+    const ZddNode a = mNodes[f];
+    const ZddNode b = mNodes[g];
+    if (f == kBase)
+    {  // only g is a decision node
+        ret = makeNode(b.variable, unite(kBase, b.low), b.high);
+    }
+    else if (a.variable < b.variable)
+    {
+        ret = makeNode(a.variable, unite(a.low, g), a.high);
+    }
+    else if (a.variable > b.variable)
+    {
+        ret = makeNode(b.variable, unite(f, b.low), b.high);
+    }
+    else
+    {
+        ret = makeNode(a.variable, unite(a.low, b.low), unite(a.high, b.high));
+    }
+    mUnionCache.emplace(key, ret);
+    return ret;
+}
+
+MinimalPaths::Id
+MinimalPaths::addElement(Id f, unsigned int variable)
+{
+    if (f == kEmpty)
+    {
+        return kEmpty;
+    }
+    if (f == kBase)
+    {
+        return makeNode(variable, kEmpty, kBase);
+    }
+    auto key = std::make_pair(f, variable);
+    auto iter = mAddCache.find(key);
+    if (iter != mAddCache.end())
+    {
+        return iter->second;
+    }
+
+    Id ret;
+    const ZddNode node = mNodes[f];
+    if (node.variable < variable)
+    {
+        ret = makeNode(node.variable, addElement(node.low, variable), addElement(node.high, variable));
+    }
+    else if (node.variable == variable)
+    {
+        ret = makeNode(variable, kEmpty, unite(node.low, node.high));
+    }
+    else
+    {
+        ret = makeNode(variable, kEmpty, f);
+    }
+    mAddCache.emplace(key, ret);
+    return ret;
+}
+
+bool
+MinimalPaths::containsEmptySet(Id f) const
+{
+    while (f > kBase)
+    {
+        f = mNodes[f].low;
+    }
+    return f == kBase;
+}
+
+MinimalPaths::Id
+MinimalPaths::nonSuperset(Id f, Id g)
+{
+    if (g == kEmpty || f == kEmpty)
+    {
+        return f;
+    }
+    if (f == g || containsEmptySet(g))
+    {  // every set is a superset of itself and of the empty set
+        return kEmpty;
+    }
+    if (f == kBase)
+    {  // the empty set is no superset of a non-empty set
+        return kBase;
+    }
+    auto key = std::make_pair(f, g);
+    auto iter = mNonSupersetCache.find(key);
+    if (iter != mNonSupersetCache.end())
+    {
+        return iter->second;
+    }
+
+    Id ret;
+    const ZddNode a = mNodes[f];
+    const ZddNode b = mNodes[g];
+    if (a.variable < b.variable)
+    {  // the sets of g do not contain a.variable
+        ret = makeNode(a.variable, nonSuperset(a.low, g), nonSuperset(a.high, g));
+    }
+    else if (a.variable > b.variable)
+    {  // the sets of f cannot be supersets of sets containing b.variable
+        ret = nonSuperset(f, b.low);
+    }
+    else
+    {
+        ret = makeNode(a.variable,
+                       nonSuperset(a.low, b.low),
+                       nonSuperset(nonSuperset(a.high, b.high), b.low));
+    }
+    mNonSupersetCache.emplace(key, ret);
+    return ret;
+}
+
+MinimalPaths::Id
+MinimalPaths::minimal(Id f)
+{
+    if (f <= kBase)
+    {
+        return f;
+    }
+    auto iter = mMinimalCache.find(f);
+    if (iter != mMinimalCache.end())
+    {
+        return iter->second;
+    }
+    const ZddNode node = mNodes[f];
+    const Id low = minimal(node.low);
+    const Id ret = makeNode(node.variable, low, nonSuperset(minimal(node.high), low));
+    mMinimalCache.emplace(f, ret);
+    return ret;
+}
+
+size_t
+MinimalPaths::count(Id f)
+{
+    if (f <= kBase)
+    {
+        return f;
+    }
+    auto iter = mCountCache.find(f);
+    if (iter != mCountCache.end())
+    {
+        return iter->second;
+    }
+    const size_t ret = count(mNodes[f].low) + count(mNodes[f].high);
+    mCountCache.emplace(f, ret);
+    return ret;
+}
+
+std::string
+MinimalPaths::toFormula(Id f)
+{
+    if (f == kBase)
+    {
+        return "true";
+    }
+    auto iter = mFormulaCache.find(f);
+    if (iter != mFormulaCache.end())
+    {
+        return iter->second;
+    }
+
+    // f = (n=0 & high) | low
+    const ZddNode node = mNodes[f];
+    std::string ret = "n" + std::to_string(node.variable) + "=0";
+    if (node.high != kBase)
+    {
+        const std::string high = toFormula(node.high);
+        ret += " & " + (mNodes[node.high].low != kEmpty ? "(" + high + ")" : high);
+    }
+    if (node.low != kEmpty)
+    {
+        ret += " | " + toFormula(node.low);
+    }
+    mFormulaCache.emplace(f, ret);
+    return ret;
+}
+
+}  // namespace graphInternal
@@ -0,0 +1,132 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_GRAPH_INTERNAL_MINIMAL_PATHS_H
+#define ERIS_GRAPH_INTERNAL_MINIMAL_PATHS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace graphInternal
+{
+class Node;
+
+/**
+ * Minimal path sets from the environment to every node, i.e. the sets of intermediate nodes of
+ * all reach paths that do not contain the nodes of another path. A restricted recovery of a node
+ * is possible iff all nodes of at least one of its minimal path sets are ok.
+ *
+ * The families of sets are represented as a zero-suppressed decision diagram (ZDD) with shared,
+ * hash-consed nodes. The path sets of all nodes are computed once per transformation as a fixed
+ * point over the reach edges, which also covers cyclic reach graphs, and the recovery formulas
+ * are emitted in factored form from the diagram, e.g. n3=0 & (n1=0 | n2=0) instead of
+ * n1=0 & n3=0 | n2=0 & n3=0.
+ */
+class MinimalPaths
+{
+public:
+    /**
+     * Computes the minimal path sets of all nodes. Reachability::compute() has to be run before.
+     * @param nodes all nodes excluding the environment nodes
+     */
+    explicit MinimalPaths(const std::vector<Node*>& nodes);
+    ~MinimalPaths();
+
+    /**
+     * Returns the restricted recovery formula of the given node (memoized).
+     * @param node the node
+     * @return "true" if directly connected to the environment, empty string if no path exists
+     */
+    const std::string&
+    getFormula(Node* node);
+
+    /**
+     * Returns the number of minimal path sets of the given node.
+     */
+    size_t
+    getPathCount(Node* node);
+
+private:
+    using Id = uint32_t;
+
+    /** Empty family */
+    static constexpr Id kEmpty = 0;
+    /** Family containing only the empty set */
+    static constexpr Id kBase = 1;
+
+    struct ZddNode
+    {
+        unsigned int variable;
+        Id low;
+        Id high;
+    };
+
+    Id
+    makeNode(unsigned int variable, Id low, Id high);
+
+    Id
+    unite(Id f, Id g);
+
+    /** Adds the given variable to every set of the family */
+    Id
+    addElement(Id f, unsigned int variable);
+
+    /** Removes all sets that are supersets of other sets */
+    Id
+    minimal(Id f);
+
+    /** Sets of f that are no superset of any set of g */
+    Id
+    nonSuperset(Id f, Id g);
+
+    bool
+    containsEmptySet(Id f) const;
+
+    size_t
+    count(Id f);
+
+    std::string
+    toFormula(Id f);
+
+    std::vector<ZddNode> mNodes;
+
+    std::map<std::tuple<unsigned int, Id, Id>, Id> mUniqueTable;
+
+    std::map<std::pair<Id, Id>, Id> mUnionCache;
+    std::map<std::pair<Id, unsigned int>, Id> mAddCache;
+    std::unordered_map<Id, Id> mMinimalCache;
+    std::map<std::pair<Id, Id>, Id> mNonSupersetCache;
+    std::unordered_map<Id, size_t> mCountCache;
+    std::unordered_map<Id, std::string> mFormulaCache;
+
+    /** Path sets per node number */
+    std::unordered_map<unsigned int, Id> mPaths;
+
+    /** Formulas per node number */
+    std::unordered_map<unsigned int, std::string> mFormulas;
+};
+
+}  // namespace graphInternal
+
+#endif /* ERIS_GRAPH_INTERNAL_MINIMAL_PATHS_H */
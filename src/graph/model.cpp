@@ -36,6 +36,42 @@ Model::getType()
     return mType;
 }
 
+void
+Model::setSecurityEncoding(SecurityEncoding encoding)
+{
+    mSecurityEncoding = encoding;
+}
+
+Model::SecurityEncoding
+Model::getSecurityEncoding()
+{
+    return mSecurityEncoding;
+}
+
+void
+Model::setModuleLayout(ModuleLayout layout)
+{
+    mModuleLayout = layout;
+}
+
+Model::ModuleLayout
+Model::getModuleLayout()
+{
+    return mModuleLayout;
+}
+
+void
+Model::setVariableOrder(VariableOrder order)
+{
+    mVariableOrder = order;
+}
+
+Model::VariableOrder
+Model::getVariableOrder()
+{
+    return mVariableOrder;
+}
+
 QString
 Model::getTypeAsString(Type type)
 {
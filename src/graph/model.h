@@ -39,6 +39,33 @@ public:
         CTMC = 1,
     };
 
+    /** Encoding of the security transitions of nodes with securing nodes */
+    enum SecurityEncoding
+    {
+        /** One command per attack whose rate deducts the guarantees of ok securing nodes */
+        compact = 0,
+        /** One command per ok/not-ok permutation of the securing nodes (2^k commands) */
+        expanded = 1,
+    };
+
+    /** Modules of the generated PRISM model */
+    enum ModuleLayout
+    {
+        /** All variables and commands in module generatedScenario */
+        singleModule = 0,
+        /** One module per node, respectively per group of interchangeable nodes */
+        modulePerNode = 1,
+    };
+
+    /** Order of the variable declarations, i.e. of the MTBDD variables of PRISM */
+    enum VariableOrder
+    {
+        /** By node number */
+        numberOrder = 0,
+        /** Reverse Cuthill-McKee order of the dependencies between nodes, see VariableOrder */
+        dependencyOrder = 1,
+    };
+
     /**
      * Singleton
      * @param
@@ -74,6 +101,48 @@ public:
 
     QString
     getTypeAsString(Type=Model::getInstance().getType()); // Geht das?
+
+    /**
+     * Sets the encoding of security transitions used by the Transcriber.
+     * @param encoding
+     */
+    void
+    setSecurityEncoding(SecurityEncoding encoding);
+
+    /**
+     * Returns the currently set encoding of security transitions.
+     * @return
+     */
+    SecurityEncoding
+    getSecurityEncoding();
+
+    /**
+     * Sets the module layout of the generated model.
+     * @param layout
+     */
+    void
+    setModuleLayout(ModuleLayout layout);
+
+    /**
+     * Returns the currently set module layout.
+     * @return
+     */
+    ModuleLayout
+    getModuleLayout();
+
+    /**
+     * Sets the order of the variable declarations in the generated model.
+     * @param order
+     */
+    void
+    setVariableOrder(VariableOrder order);
+
+    /**
+     * Returns the currently set variable order.
+     * @return
+     */
+    VariableOrder
+    getVariableOrder();
         
 
 signals:
@@ -83,10 +152,20 @@ signals:
 
 private:
     /** Initialise counter object */
-    Model() : mType(Type::CTMC) {};
+    Model() :
+        mType(Type::CTMC),
+        mSecurityEncoding(SecurityEncoding::compact),
+        mModuleLayout(ModuleLayout::singleModule),
+        mVariableOrder(VariableOrder::numberOrder) {};
 
     /** Incrementing integer used to get the next ID */
     Type mType;
+
+    SecurityEncoding mSecurityEncoding;
+
+    ModuleLayout mModuleLayout;
+
+    VariableOrder mVariableOrder;
 };
 
 }  // namespace graph
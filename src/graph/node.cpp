@@ -23,8 +23,10 @@
 #include "errors.h"
 #include "edge.h"
 #include "logger.h"
+#include "checks.h"
 
 #include <set>
+#include <utility>
 
 using namespace graph;
 
@@ -47,6 +49,7 @@ Node::Node(ComponentType type,
            Recovery::Strategy corrStrategy,
            const std::string& customDefRecoveryFormula,
            Recovery::Strategy defStrategy) :
+    mVotingThreshold(0),
     mCritical(false),
     mEnvironment(false),
     mRecoverableFromDefect(recoverableDefect),
@@ -54,7 +57,10 @@ Node::Node(ComponentType type,
     mProvidesGuarantees(false),
     mStatusChange(""),
     mNumber(id),
+    mName("n" + std::to_string(id)),
     mReachableFromEnv(false),
+    mReachable(false),
+    mReachabilityComputed(false),
     mIntrusionIndicator(intrusionIndicator),
     mFailureIndicator(failureIndicator),
     mSecurityIndicator(securityIndicator),
@@ -77,6 +83,7 @@ Node::Node(ComponentType type,
         default: 
             break;
     }
+    parseEssentialNodes();
 }
 
 Node::~Node()
@@ -84,10 +91,54 @@ Node::~Node()
     
 }
 
-std::string
-Node::getStringRepresentation()
+void
+Node::setAttributes(bool recoverableDefect,
+                    bool recoverableCorruption,
+                    const std::string& intrusionIndicator,
+                    const std::string& failureIndicator,
+                    const std::string& securityIndicator,
+                    const std::string& defectRecoveryIndicator,
+                    const std::string& corruptionRecoveryIndicator,
+                    const std::string& essentialNodes,
+                    const std::string& customCorrRecoveryFormula,
+                    Recovery::Strategy corrStrategy,
+                    const std::string& customDefRecoveryFormula,
+                    Recovery::Strategy defStrategy)
+{
+    mRecoverableFromDefect = recoverableDefect;
+    mRecoverableFromCorruption = recoverableCorruption;
+    mIntrusionIndicator = intrusionIndicator;
+    mFailureIndicator = failureIndicator;
+    mSecurityIndicator = securityIndicator;
+    mDefectRecoveryIndicator = defectRecoveryIndicator;
+    mCorruptionRecoveryIndicator = corruptionRecoveryIndicator;
+    mEssentialNodes = essentialNodes;
+    mCustomCorrRecoveryFormula = customCorrRecoveryFormula;
+    mCustomDefRecoveryFormula = customDefRecoveryFormula;
+    mCorruptionRecoveryStrategy = corrStrategy;
+    mDefectRecoveryStrategy = defStrategy;
+    parseEssentialNodes();
+}
+
+void
+Node::parseEssentialNodes()
+{
+    mEssentialExpression = nullptr;
+    if (!mEssentialNodes.empty())
+    {
+        std::string error;
+        mEssentialExpression = Expression::parse(mEssentialNodes, nullptr, &error);
+        if (mEssentialExpression == nullptr)
+        {
+            PRINT_WARNING("Ignoring essential nodes of n%u : %s", mNumber, error.c_str());
+        }
+    }
+}
+
+const std::string&
+Node::getStringRepresentation() const
 {
-    return "n" + std::to_string(mNumber);
+    return mName;
 }
 
 void
@@ -201,35 +252,15 @@ Node::isReachableFromEnv()
 bool
 Node::isReachable()
 {
-    std::list<unsigned int> visited;
-    return findReachable(visited);
+    ERIS_CHECK(mReachabilityComputed);
+    return mReachable;
 }
 
-bool
-Node::findReachable(std::list<unsigned int> visited)
+void
+Node::setReachability(bool reachable)
 {
-    visited.push_back(mNumber);
-    if (mReachableFromEnv)
-    {
-        return true;
-    }
-    else
-    {
-        for (Node* node : mReachingNodes)
-        {
-            std::list<unsigned int>::iterator iter =
-                    std::find(visited.begin(), visited.end(), node->getNumber());
-            if (iter != visited.end())
-            {              // snake is eating its tail
-                continue;  // break endless loop
-            }
-            else if (node->findReachable(visited))
-            {
-                return true;
-            }
-        }
-        return false;
-    }
+    mReachable = reachable;
+    mReachabilityComputed = true;
 }
 
 std::string
@@ -238,10 +269,16 @@ Node::getEssentialNodes()
     return mEssentialNodes;
 }
 
+Expression::Ptr
+Node::getEssentialExpression()
+{
+    return mEssentialExpression;
+}
+
 bool
 Node::hasEssentialNodes()
 {
-    return (!mEssentialNodes.empty());
+    return (mEssentialExpression != nullptr);
 }
 
 bool
@@ -377,34 +414,79 @@ Node::getRedundantNodes()
     return mRedundantNodes;
 }
 
-std::string
-Node::getRedundantNodesAsString(std::string nodeStatus)
+Expression::Ptr
+Node::getRedundantNodesExpression(int nodeStatus)
 {
-    std::string ret = "";
+    std::vector<Expression::Ptr> operands;
     for (Node* redundantNode : mRedundantNodes)
     {
-        ret += redundantNode->getStringRepresentation() + "=" + nodeStatus + " & ";
+        operands.push_back(Expression::makeComparison(redundantNode->getNumber(), nodeStatus));
     }
-    ret = ret.substr(0, ret.size() - 3);
-    return ret;
+    return Expression::makeConjunction(std::move(operands));
 }
 
-std::string
-Node::getRedundantAndEssentialNodesAsString(std::string nodeStatus)
+void
+Node::setVotingGroup(unsigned int required, const std::vector<Node*>& members)
+{
+    mVotingThreshold = required;
+    mVotingGroup = members;
+}
+
+bool
+Node::isInVotingGroup() const
+{
+    return mVotingThreshold > 0;
+}
+
+const std::vector<Node*>&
+Node::getVotingGroup() const
+{
+    return mVotingGroup;
+}
+
+Expression::Ptr
+Node::getVotingGroupExpression(bool withEssentialNodes)
+{
+    std::vector<Expression::Ptr> operands;
+    for (Node* member : mVotingGroup)
+    {
+        Expression::Ptr ok = Expression::makeComparison(member->getNumber(), 0);
+        if (withEssentialNodes && member->hasEssentialNodes())
+        {
+            ok = Expression::makeConjunction({ok, member->collectEssentialNodes()});
+        }
+        operands.push_back(ok);
+    }
+    return Expression::makeAtLeast(static_cast<int>(mVotingThreshold), std::move(operands));
+}
+
+Expression::Ptr
+Node::getVotingGroupCorruptedExpression() const
 {
-    std::string ret = "";
+    std::vector<Expression::Ptr> operands;
+    for (Node* member : mVotingGroup)
+    {
+        operands.push_back(Expression::makeComparison(member->getNumber(), 2));
+    }
+    const int size = static_cast<int>(mVotingGroup.size());
+    return Expression::makeAtLeast(size - static_cast<int>(mVotingThreshold) + 1,
+                                   std::move(operands));
+}
+
+Expression::Ptr
+Node::getRedundantAndEssentialNodesExpression(int nodeStatus)
+{
+    std::vector<Expression::Ptr> operands;
     for (Node* redundantNode : mRedundantNodes)
     {
-        ret += redundantNode->getStringRepresentation() + "=" + nodeStatus;
+        Expression::Ptr ret = Expression::makeComparison(redundantNode->getNumber(), nodeStatus);
         if (redundantNode->hasEssentialNodes())
         {
-            ret += " & (" + redundantNode->collectEssentialNodes(redundantNode->getNumber()) + ")";
+            ret = Expression::makeConjunction({ret, redundantNode->collectEssentialNodes()});
         }
-        ret += " | ";
+        operands.push_back(ret);
     }
-    ret = ret.substr(0, ret.size() - 3);
-
-    return ret;
+    return Expression::makeDisjunction(std::move(operands));
 }
 
 bool
@@ -421,125 +503,61 @@ Node::findFunctionalNode(unsigned int number, Node*& searchedNode)
     return false;
 }
 
-std::string
-Node::collectEssentialNodes(unsigned int origin)
-{
-    std::string totalEssentialNodes;
-    totalEssentialNodes.reserve(1000);  // sollte wohl reichen
-    totalEssentialNodes.insert(0, mEssentialNodes);
-
-    std::regex nodeElem("(n[0-9][0-9]*)");
-    std::smatch match;
-    Node* node;
-    unsigned int offset = 0;
-    std::regex_search(mEssentialNodes, match, nodeElem);
-    for (unsigned int i = 1; i < match.size(); ++i)  // skip first match (the whole string)
+Expression::Ptr
+Node::collectEssentialNodes()
+{
+    std::set<unsigned int> visiting;
+    return collectEssentialNodes(&visiting);
+}
+
+Expression::Ptr
+Node::collectEssentialNodes(std::set<unsigned int>* visiting)
+{
+    if (mEssentialExpression == nullptr)
     {
-        std::string elem = match[i];
-        std::string number = elem.substr(1);                     // cut off the n
-        unsigned int pos = match.position(i);   // point before elem n12=0
-        //         ^
-        // now check if the node has essential nodes and find the appropriate position to add them
-        if (std::stoul(number) == origin)
+        return nullptr;
+    }
+    visiting->insert(mNumber);
+    Expression::Ptr ret = mEssentialExpression->replaceAtoms([&](const Expression::Ptr& atom) {
+        if (atom->getKind() != Expression::Kind::equals)
+        {
+            return atom;
+        }
+        unsigned int number = atom->getNode();
+        if (visiting->count(number) != 0)
         {  // loop detected, break it!
             PRINT_INFO("Loop detected while collecting essential nodes");
-            continue;
-        }
-        if (findFunctionalNode(std::stoi(number), node))
-        {
-            if (node->hasEssentialNodes())
-            {  // now place them on the appropriate position and update the offset for further
-                // calculations
-                std::string curr = totalEssentialNodes.substr(pos, elem.size()+2);
-                totalEssentialNodes.erase(pos+offset, elem.size()+2);
-                std::string essentials = "(" + curr + " & (" + node->collectEssentialNodes(origin) + "))";
-
-                totalEssentialNodes.insert(pos + offset, essentials);
-                offset += essentials.size() - (elem.size() + 2);
-            }
+            return atom;
         }
-        else
+        Node* node;
+        if (!findFunctionalNode(number, node))
         {  // this should never happen
             ErrorHandler::getInstance().setError(
-                    Errors::essentialNodeNotInSetOfFunctionalNodes(mNumber, std::stoi(number)));
+                    Errors::essentialNodeNotInSetOfFunctionalNodes(mNumber, number));
             ErrorHandler::getInstance().show();
-            continue;
+            return atom;
         }
-    }
-    return totalEssentialNodes;
+        if (!node->hasEssentialNodes())
+        {
+            return atom;
+        }
+        return Expression::makeConjunction({atom, node->collectEssentialNodes(visiting)});
+    });
+    visiting->erase(mNumber);
+    return ret;
 }
 
 std::string
 Node::getRestrictedRecoveryFormula()
 {
-    std::set<std::set<unsigned int>>* pathes = new std::set<std::set<unsigned int>>();
-    std::set<unsigned int>* tmp = new std::set<unsigned int>();
-    std::string ret = "";
-
-    findPathToEnv(mNumber, pathes, tmp);
-
-    auto pathesIter = pathes->begin();
-    for (; pathesIter != pathes->end(); ++pathesIter)
-    {
-        auto iter = pathesIter->begin();
-        for (; iter != pathesIter->end(); ++iter)
-        {
-            ret += "n" + std::to_string(*iter) + "=0";
-            if (std::next(iter) != pathesIter->end())
-            {
-                ret += " & ";
-            }
-        }
-        if (std::next(pathesIter) != pathes->end())
-        {
-            ret += " | ";
-        }
-    }
-    return ret;
+    ERIS_CHECK(mMinimalPaths != nullptr);
+    return mMinimalPaths->getFormula(this);
 }
 
 void
-Node::findPathToEnv(unsigned int origin,
-                    std::set<std::set<unsigned int>>* pathes,
-                    std::set<unsigned int>* path)
+Node::setMinimalPaths(std::shared_ptr<MinimalPaths> minimalPaths)
 {
-    unsigned int i = 0;
-    std::set<unsigned int> content = (*path);
-    std::set<unsigned int>* workingCopy = path;
-
-    for (Node* node : mReachingNodes)
-    {
-        if (node->getNumber() == origin)
-        {  // Do not take paths into account that go back to the original node
-            continue;
-        }
-        if (node->isReachable())
-        {  // node is connected to the env, keep going!
-            if (i > 0)
-            {  // more than one reaching node, copy junction path for other nodes
-                workingCopy = new std::set<unsigned int>(content);
-            }
-            // std::string viewElem = "n" + std::to_string(node->getNumber());
-
-            if (workingCopy->find(node->getNumber()) != workingCopy->end())
-            {  // Ignore element if its already included in the path
-                continue;
-            }
-
-            if (node->isEnvironment())
-            {
-                // only inserts unique elements
-                pathes->insert(*workingCopy);
-            }
-            else
-            {
-                workingCopy->insert(node->getNumber());
-            }
-
-            node->findPathToEnv(origin, pathes, workingCopy);
-        }
-        ++i;
-    }
+    mMinimalPaths = std::move(minimalPaths);
 }
 
 }  // namespace graph
\ No newline at end of file
@@ -22,12 +22,14 @@
 #define ERIS_GRAPH_INTERNAL_NODE_H
 
 #include "component_type.h"
+#include "expression.h"
 #include "recovery_strategy.h"
+#include "minimal_paths.h"
 
 #include <QGraphicsEllipseItem>
 #include <QGraphicsScene>
 #include <QRectF>
-#include <regex>
+#include <memory>
 #include <set>
 
 namespace graphInternal
@@ -64,11 +66,30 @@ public:
     ~Node();
 
     /**
-     * Get the string representation of the node.
+     * Replaces the attributes of the node (see constructor) while keeping its edges, used to
+     * update the persistent logic graph in place.
+     */
+    void
+    setAttributes(bool recoverableDefect,
+                  bool recoverableCorruption,
+                  const std::string& intrusionIndicator,
+                  const std::string& failureIndicator,
+                  const std::string& securityIndicator,
+                  const std::string& defectRecoveryIndicator,
+                  const std::string& corruptionRecoveryIndicator,
+                  const std::string& essentialNodes,
+                  const std::string& customCorrRecoveryStrategy,
+                  graph::Recovery::Strategy corrStrategy,
+                  const std::string& customDefRecoveryStrategy,
+                  graph::Recovery::Strategy defStrategy);
+
+    /**
+     * Get the string representation of the node, e.g. n3. The name is built once by the
+     * constructor, the transcriber refers to it in almost every generated line.
      * @return string of the node
      */
-    std::string
-    getStringRepresentation();
+    const std::string&
+    getStringRepresentation() const;
 
     /**
      * Adds an Edge to the Node, i.e. inserts it in the list.
@@ -127,16 +148,20 @@ public:
     isReachableFromEnv();
 
     /**
-     * Iterates over all reach edges and identifies whether the node has a continues connection
-     * starting in an environment node. Therefore the function is called recursively
-     * on the nodes that are targetting this node by reach edges. In order to avoid endless loops,
-     * the caller has to provide the ID of the original node, which will be carried further and the
-     * loop will be broken if the ID is met again and false is returned.
+     * States whether the node has a continuous connection via reach edges starting in an
+     * environment node. Requires Reachability::compute() to be run after the edges were added.
      * @return true if reachable, false otherwise
      */
     bool
     isReachable();
 
+    /**
+     * Stores the reachability information, see Reachability::compute().
+     * @param reachable whether the node is reachable from the environment
+     */
+    void
+    setReachability(bool reachable);
+
     /**
      * Returns the nodes that this node targets via reach edges.
      * @return
@@ -173,7 +198,14 @@ public:
     getEssentialNodes();
 
     /**
-     * Indicates whether the node has essential nodes defined (string not empty) or not.
+     * Returns the parsed essential nodes of the current node.
+     * @return the expression, nullptr if no (valid) essential nodes are defined
+     */
+    Expression::Ptr
+    getEssentialExpression();
+
+    /**
+     * Indicates whether the node has (valid) essential nodes defined or not.
      * @return true if the node has essential nodes, false otherwise
      */
     bool
@@ -304,20 +336,60 @@ public:
     getRedundantNodes();
     
     /**
-     * Returns the redundant nodes as a logic string representation for PRISM,
-     * including essential nodes.
-     * @return redundant node string
+     * Returns the conjunction of the redundant nodes being in the given state.
+     * @param nodeStatus state of the redundant nodes
+     * @return redundant node expression, e.g. "n2=0 & n3=0"
      */
-    std::string
-    getRedundantNodesAsString(std::string nodeStatus="0");
-    
+    Expression::Ptr
+    getRedundantNodesExpression(int nodeStatus = 0);
+
     /**
-     * Returns the redundant nodes as a logic string representation for PRISM.
-     * @return redundant node string
+     * Returns the disjunction of the redundant nodes being in the given state, each including
+     * its collected essential nodes.
+     * @param nodeStatus state of the redundant nodes
+     * @return redundant node expression, e.g. "n2=0 & (n4=0) | n3=0"
      */
-    std::string
-    getRedundantAndEssentialNodesAsString(std::string nodeStatus="0");
+    Expression::Ptr
+    getRedundantAndEssentialNodesExpression(int nodeStatus = 0);
     
+    /**
+     * Makes this node a member of a k-out-of-n group, i.e. the group works as long as at least
+     * k of its n members work (e.g. a 2oo3 voter).
+     * @param required number of members that have to work (k)
+     * @param members all members of the group, including this node
+     */
+    void
+    setVotingGroup(unsigned int required, const std::vector<Node*>& members);
+
+    /**
+     * Indicates whether this node is a member of a k-out-of-n group.
+     * @return true if setVotingGroup() was called, false otherwise
+     */
+    bool
+    isInVotingGroup() const;
+
+    /**
+     * Returns the members of the node's k-out-of-n group, in the order of the definition.
+     */
+    const std::vector<Node*>&
+    getVotingGroup() const;
+
+    /**
+     * Returns the counting expression of the group working, i.e. at least k members are ok.
+     * @param withEssentialNodes include the collected essential nodes of each member
+     * @return e.g. "(n2=0?1:0)+(n3=0?1:0)+(n4=0?1:0)>=2"
+     */
+    Expression::Ptr
+    getVotingGroupExpression(bool withEssentialNodes);
+
+    /**
+     * Returns the counting expression of the group being corrupted, i.e. more than n-k members
+     * are corrupted and the remaining members cannot outvote them.
+     * @return e.g. "(n2=2?1:0)+(n3=2?1:0)+(n4=2?1:0)>=2"
+     */
+    Expression::Ptr
+    getVotingGroupCorruptedExpression() const;
+
     /**
      * Returns redundant nodes of this node in corrupted mode (=2) and without 
      * essential nodes.
@@ -327,23 +399,30 @@ public:
     getReundantCorrNodes();
 
     /**
-     * Iterates over the node's essential node definition (user input) and identifies single
-     * node elems, in order to recursively call this function on them. The goal is to receive
-     * a hierarchically built string that contains the firstly called nodes essential nodes,
-     * extended by their essential nodes, extended by their essential nodes and so on.
-     * @return, the extended essential node string
+     * Replaces every node comparison of the node's essential nodes by the comparison and the
+     * collected essential nodes of the referenced node. The result contains the essential
+     * nodes of this node, extended by their essential nodes, extended by their essential nodes
+     * and so on. Loops are broken at the first node that is visited twice.
+     * @return the extended essential node expression, nullptr if no essential nodes are defined
      */
-    std::string
-    collectEssentialNodes(unsigned int startNode);
+    Expression::Ptr
+    collectEssentialNodes();
 
     /**
-     * Parses the reach connection from the given node to the environment node and identifies
-     * whether a non-corrupted path to it exists.
-     * @return
+     * Returns the formula stating that all nodes of at least one minimal reach path from the
+     * environment to this node are ok. Requires setMinimalPaths() to be called.
+     * @return "true" if directly connected to the environment, empty string if no path exists
      */
     std::string
     getRestrictedRecoveryFormula();
 
+    /**
+     * Sets the minimal path sets shared by all nodes of a transformation.
+     * @param minimalPaths
+     */
+    void
+    setMinimalPaths(std::shared_ptr<MinimalPaths> minimalPaths);
+
     /**
      * Returns the corruption recovery strategy that was retrieved by user input.
      * @return
@@ -370,17 +449,16 @@ private:
     findFunctionalNode(unsigned int number, Node*& searchedNode);
 
     /**
-     * Helper function for recursive call to identify whether a path to the environment node exists,
-     * that is
-     * @return
+     * Parses mEssentialNodes into mEssentialExpression.
      */
     void
-    findPathToEnv(unsigned int origin,
-                  std::set<std::set<unsigned int>>* pathes,
-                  std::set<unsigned int>* path);
+    parseEssentialNodes();
 
-    bool
-    findReachable(std::list<unsigned int> visited);
+    /**
+     * See collectEssentialNodes(), visiting holds the nodes on the current path.
+     */
+    Expression::Ptr
+    collectEssentialNodes(std::set<unsigned int>* visiting);
 
     /** List of nodes that are reaching to this node */
     std::list<Node*> mReachingNodes;
@@ -398,6 +476,12 @@ private:
 
     std::string mRedundantAndEssentialNodes;
 
+    /** Number of members of the k-out-of-n group that have to work (k), 0 if not in a group */
+    unsigned int mVotingThreshold;
+
+    /** Members of the k-out-of-n group (this node included) */
+    std::vector<Node*> mVotingGroup;
+
     
     /** Flag indicating the criticality of the node */
     bool mCritical;
@@ -418,9 +502,21 @@ private:
     /** Number/ID of the node */
     unsigned int mNumber;
 
+    /** Name of the node in the generated model, see getStringRepresentation() */
+    std::string mName;
+
     /** Flag indicating whether this node is reachable from the environment node*/
     bool mReachableFromEnv;
 
+    /** Flag indicating whether this node is reachable via other nodes from the environment */
+    bool mReachable;
+
+    /** Flag indicating whether mReachable was computed by Reachability::compute() */
+    bool mReachabilityComputed;
+
+    /** Minimal path sets of the current transformation */
+    std::shared_ptr<MinimalPaths> mMinimalPaths;
+
     /** The probability that the node runs into a security failure*/
     std::string mIntrusionIndicator;
 
@@ -439,6 +535,9 @@ private:
     /** String containing the node dependencies of this node */
     std::string mEssentialNodes;
 
+    /** Parsed node dependencies, nullptr if none are given */
+    Expression::Ptr mEssentialExpression;
+
     /** String containing the corruption custom recovery strategy */
     std::string mCustomCorrRecoveryFormula;
 
@@ -253,7 +253,7 @@ NodeItem::isCritical()
 void
 NodeItem::recoverableFromDefect(bool recoverable)
 {
-    mRecoverableDefect = recoverable;
+    updateAttribute(&mRecoverableDefect, recoverable);
 }
 
 bool
@@ -265,7 +265,7 @@ NodeItem::isRecoverableFromDefect()
 void
 NodeItem::recoverableFromCorruption(bool recoverable)
 {
-    mRecoverableCorruption = recoverable;
+    updateAttribute(&mRecoverableCorruption, recoverable);
 }
 
 bool
@@ -327,10 +327,16 @@ NodeItem::getId()
     return mId;
 }
 
+uint64_t
+NodeItem::getRevision() const
+{
+    return mRevision;
+}
+
 void
 NodeItem::setId(unsigned int id)
 {
-    mId = id;
+    updateAttribute(&mId, id);
     mNodeText->setPlainText("n" + QString::number(mId));
     updateTextItemPosition();
 }
@@ -399,7 +405,7 @@ NodeItem::getEssentialNodes()
 void
 NodeItem::setEssentialNodes(QString essentialNodes)
 {
-    mEssentialNodes = essentialNodes;
+    updateAttribute(&mEssentialNodes, essentialNodes);
 }
 
 QString
@@ -424,13 +430,13 @@ NodeItem::getIntrusionIndicatorPtr()
 void
 NodeItem::setIntrusionIndicator(QString value)
 {
-    mIntrusionIndicator = value;
+    updateAttribute(&mIntrusionIndicator, value);
 }
 
 void
 NodeItem::setIntrusionIndicators(std::map<qreal, QString>* indicators)
 {
-    mIntrusionIndicators = indicators;
+    updateAttribute(&mIntrusionIndicators, indicators);
 }
 
 QString
@@ -455,13 +461,13 @@ NodeItem::getFailureIndicatorPtr()
 void
 NodeItem::setFailureIndicator(QString value)
 {
-    mFailureIndicator = value;
+    updateAttribute(&mFailureIndicator, value);
 }
 
 void
 NodeItem::setFailureIndicators(std::map<qreal, QString>* indicators)
 {
-    mFailureIndicators = indicators;
+    updateAttribute(&mFailureIndicators, indicators);
 }
 
 QString
@@ -473,7 +479,7 @@ NodeItem::getSecurityIndicator()
 void
 NodeItem::setSecurityIndicator(QString value)
 {
-    mSecurityIndicator = value;
+    updateAttribute(&mSecurityIndicator, value);
 }
 
 QString
@@ -485,7 +491,7 @@ NodeItem::getDefectRecoveryIndicator()
 void
 NodeItem::setDefectRecoveryIndicator(QString value)
 {
-    mDefectRecoveryIndicator = value;
+    updateAttribute(&mDefectRecoveryIndicator, value);
 }
 
 QString
@@ -497,13 +503,13 @@ NodeItem::getCorruptionRecoveryIndicator()
 void
 NodeItem::setCorruptionRecoveryIndicator(QString value)
 {
-    mCorruptionRecoveryIndicator = value;
+    updateAttribute(&mCorruptionRecoveryIndicator, value);
 }
 
 void
 NodeItem::setCorruptionRecoveryStrategy(Recovery::Strategy strategy)
 {
-    mCorruptionRecoveryStrategy = strategy;
+    updateAttribute(&mCorruptionRecoveryStrategy, strategy);
 }
 
 Recovery::Strategy
@@ -515,7 +521,7 @@ NodeItem::getCorruptionRecoveryStrategy()
 void
 NodeItem::setDefectRecoveryStrategy(Recovery::Strategy strategy)
 {
-    mDefectRecoveryStrategy = strategy;
+    updateAttribute(&mDefectRecoveryStrategy, strategy);
 }
 
 Recovery::Strategy
@@ -540,7 +546,7 @@ NodeItem::providesFunctionality(unsigned int id)
 void
 NodeItem::setCustomCorruptionRecoveryFormula(QString formula)
 {
-    mCorruptionRecoveryFormula = std::move(formula);
+    updateAttribute(&mCorruptionRecoveryFormula, std::move(formula));
 }
 
 QString
@@ -552,7 +558,7 @@ NodeItem::getCustomCorruptionRecoveryFormula()
 void
 NodeItem::setCustomDefectRecoveryFormula(QString formula)
 {
-    mDefectRecoveryFormula = formula;
+    updateAttribute(&mDefectRecoveryFormula, formula);
 }
 
 QString
@@ -38,8 +38,10 @@ class QMenu;
 class QAction;
 QT_END_NAMESPACE
 
+#include <cstdint>
 #include <regex>
 #include <set>
+#include <utility>
 
 namespace widgets
 {
@@ -274,6 +276,14 @@ public:
     unsigned int
     getId();
 
+    /**
+     * Returns the revision of the node's attributes, which is increased by every setter that
+     * changes a value. The Transformer uses it to detect which nodes have to be regenerated.
+     * @return current revision
+     */
+    uint64_t
+    getRevision() const;
+
     /**
      * Swap current id with other id
      * */
@@ -681,6 +691,21 @@ private:
     GraphicScene* mScene = nullptr;
     
     bool mSceneIsInvalid = false;
+
+    /** Attribute revision, see getRevision() */
+    uint64_t mRevision = 0;
+
+    /** Assigns the attribute and increases the revision if the value differs */
+    template <typename T>
+    void
+    updateAttribute(T* attribute, T value)
+    {
+        if (*attribute != value)
+        {
+            *attribute = std::move(value);
+            ++mRevision;
+        }
+    }
 };
 
 }  // namespace graph
@@ -0,0 +1,149 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "reachability.h"
+
+#include "node.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace graphInternal
+{
+void
+Reachability::compute(const std::vector<Node*>& envNodes, const std::vector<Node*>& nodes)
+{
+    std::vector<Node*> all(envNodes);
+    all.insert(all.end(), nodes.begin(), nodes.end());
+    const unsigned int count = static_cast<unsigned int>(all.size());
+    std::unordered_map<Node*, unsigned int> index;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        index[all[i]] = i;
+    }
+
+    // CSR adjacency: v -> nodes reaching v
+    std::vector<unsigned int> rowStarts(count + 1, 0);
+    std::vector<unsigned int> columns;
+    for (unsigned int v = 0; v < count; ++v)
+    {
+        for (Node* reaching : all[v]->getReachingNodes())
+        {
+            auto iter = index.find(reaching);
+            if (iter != index.end())
+            {
+                columns.push_back(iter->second);
+            }
+        }
+        rowStarts[v + 1] = static_cast<unsigned int>(columns.size());
+    }
+
+    // Iterative Tarjan, components are completed in reverse topological order of the adjacency,
+    // i.e. every component after all components reaching it.
+    const unsigned int unvisited = ~0U;
+    std::vector<unsigned int> order(count, unvisited);
+    std::vector<unsigned int> lowLink(count, 0);
+    std::vector<unsigned int> component(count, unvisited);
+    std::vector<bool> onStack(count, false);
+    std::vector<unsigned int> stack;
+    std::vector<std::pair<unsigned int, unsigned int>> callStack;  // (node, next edge)
+    std::vector<bool> reachable;
+    unsigned int counter = 0;
+
+    for (unsigned int root = 0; root < count; ++root)
+    {
+        if (order[root] != unvisited)
+        {
+            continue;
+        }
+        callStack.emplace_back(root, rowStarts[root]);
+        order[root] = lowLink[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = true;
+
+        while (!callStack.empty())
+        {
+            const unsigned int v = callStack.back().first;
+            unsigned int& edge = callStack.back().second;
+            if (edge < rowStarts[v + 1])
+            {
+                const unsigned int w = columns[edge++];
+                if (order[w] == unvisited)
+                {
+                    order[w] = lowLink[w] = counter++;
+                    stack.push_back(w);
+                    onStack[w] = true;
+                    callStack.emplace_back(w, rowStarts[w]);
+                }
+                else if (onStack[w])
+                {
+                    lowLink[v] = std::min(lowLink[v], order[w]);
+                }
+                continue;
+            }
+
+            callStack.pop_back();
+            if (!callStack.empty())
+            {
+                const unsigned int parent = callStack.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[v]);
+            }
+            if (lowLink[v] != order[v])
+            {
+                continue;
+            }
+
+            // v is the root of a component, pop its members
+            const unsigned int id = static_cast<unsigned int>(reachable.size());
+            bool componentReachable = false;
+            std::vector<unsigned int> members;
+            unsigned int member;
+            do
+            {
+                member = stack.back();
+                stack.pop_back();
+                onStack[member] = false;
+                component[member] = id;
+                members.push_back(member);
+                componentReachable = componentReachable || all[member]->isReachableFromEnv();
+            } while (member != v);
+
+            for (unsigned int u : members)
+            {
+                for (unsigned int e = rowStarts[u]; e < rowStarts[u + 1]; ++e)
+                {
+                    const unsigned int other = component[columns[e]];
+                    if (other != id)
+                    {
+                        componentReachable = componentReachable || reachable[other];
+                    }
+                }
+            }
+            reachable.push_back(componentReachable);
+        }
+    }
+
+    for (unsigned int v = 0; v < count; ++v)
+    {
+        all[v]->setReachability(reachable[component[v]]);
+    }
+}
+
+}  // namespace graphInternal
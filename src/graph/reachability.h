@@ -0,0 +1,54 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_GRAPH_INTERNAL_REACHABILITY_H
+#define ERIS_GRAPH_INTERNAL_REACHABILITY_H
+
+#include <vector>
+
+namespace graphInternal
+{
+class Node;
+
+/**
+ * Computes the reachability information of all nodes once per transformation, so that
+ * Node::isReachable() can be answered in constant time.
+ *
+ * The reach edges are stored in a CSR adjacency (target -> reaching nodes) and decomposed into
+ * strongly connected components by Tarjan's algorithm. Tarjan emits a component only after every
+ * component it depends on, hence the reachability of a component can be propagated in a single
+ * pass over the condensation.
+ */
+class Reachability
+{
+public:
+    /**
+     * Computes and stores the reachability information in the given nodes. Has to be called
+     * after all edges have been added.
+     * @param envNodes environment nodes
+     * @param nodes all other nodes
+     */
+    static void
+    compute(const std::vector<Node*>& envNodes, const std::vector<Node*>& nodes);
+};
+
+}  // namespace graphInternal
+
+#endif /* ERIS_GRAPH_INTERNAL_REACHABILITY_H */
@@ -24,13 +24,21 @@
 #include "node.h"
 #include "edge.h"
 #include "error_handler.h"
+#include "logger.h"
+#include "markov_chain.h"
 #include "operational.h"
+#include "variable_order.h"
 
 #include <QStyleOption>
 
 #include <cmath> /* pow */
 
+#include <algorithm>
+#include <array>
 #include <bitset>
+#include <cctype>
+#include <initializer_list>
+#include <string_view>
 #include <utility>
 
 using namespace graph;
@@ -39,6 +47,30 @@ namespace graphInternal
 using widgets::ErrorHandler;
 using widgets::Errors;
 
+namespace
+{
+/**
+ * Concatenates the pieces with a single allocation, a chain of operator+ creates a temporary
+ * string for each of them.
+ */
+std::string
+concat(std::initializer_list<std::string_view> pieces)
+{
+    size_t size = 0;
+    for (std::string_view piece : pieces)
+    {
+        size += piece.size();
+    }
+    std::string result;
+    result.reserve(size);
+    for (std::string_view piece : pieces)
+    {
+        result.append(piece);
+    }
+    return result;
+}
+}  // namespace
+
 Transcriber::Transcriber(const std::vector<Node*>& envNodes,
                          const std::vector<Node*>& otherNodes,
                          std::string redundancy,
@@ -90,53 +122,87 @@ Transcriber::generatePermutations(unsigned int nodeCount, std::list<std::string>
 }
 
 void
-Transcriber::assembleSafetyTransition(const std::string& start, const std::string& end, Node* node)
+Transcriber::assembleSafetyTransition(int start, Node* node)
 {
-    std::string restProb = "";
-    std::string currTransition = "[] (" + node->getStringRepresentation() + "=" + start
-                                 + ") & (operational) -> " + mVarUsg
-                                 + node->getStringRepresentation() + "SAFE : ("
-                                 + node->getStringRepresentation() + "'=" + end + ")";
+    const std::string& name = node->getStringRepresentation();
+    Command transition(node->getNumber(), start, 1, concat({mVarUsg, name, "SAFE"}));
+    transition.otherwise = start;
 
-    if (node->hasEssentialNodes() && start == "0")
+    if (node->hasEssentialNodes() && start == 0)
     {
         // set internalfailure flag to identify the cause of the defect
         // (only needed to recover nodes that have essentialnodes)
         // optimization: may be left out for critical nodes that are not redundant
         if (node->isRecoverableFromDefect())
         {
-            currTransition += " & (" + node->getStringRepresentation() + "internalfailure'=true)";
+            transition.updates.push_back(concat({name, "internalfailure'=true"}));
         }
 
         // if node has essential nodes, it turns defective if essential nodes fail
-        std::string essentialConst = "formula " + node->getStringRepresentation()
-                                     + "essentials = " + node->getEssentialNodes() + ";";
-        std::string essentialTransition = "[] (" + node->getStringRepresentation() + "=0) & (!"
-                                          + node->getStringRepresentation() + "essentials"
-                                          + ") & (operational)-> ("
-                                          + node->getStringRepresentation() + "'=1);";
-        mTransitions.push_back(essentialTransition);
-        mConstants.push_back(essentialConst);
+        Formula essentials;
+        essentials.name = concat({name, "essentials"});
+        essentials.expression = node->getEssentialExpression();
+        essentials.body = essentials.expression->toString();
+        Command essential(node->getNumber(), 0, 1, "");
+        essential.conditions.push_back("!" + essentials.name);
+        essential.formulas.push_back(essentials.expression);
+        mFragment->commands.push_back(std::move(essential));
+        mFragment->formulas.push_back(std::move(essentials));
     }
+    mFragment->commands.push_back(std::move(transition));
+}
 
-    if (Model::getInstance().getType() == Model::MDP)
+void
+Transcriber::assembleCompactSecurityTransition(Command transition, Node* node)
+{
+    const std::string& name = node->getStringRepresentation();
+    // the rate is minimal if all securing nodes are ok
+    double minimalIndicator = std::stod(node->getIntrusionIndicator());
+    for (Node* securingNode : node->getSecuringNodes())
     {
-        restProb = " + 1-" + mVarUsg + node->getStringRepresentation() + "SAFE" + " : ("
-                   + node->getStringRepresentation() + "'=" + start + ")";
+        const std::string& currSecNode = securingNode->getStringRepresentation();
+        transition.rate += concat({"-(", currSecNode, "=0 ? ", mVarUsg, currSecNode, "GUAR : 0)"});
+        transition.reads.push_back(securingNode->getNumber());
+        minimalIndicator -= std::stod(securingNode->getSecurityIndicator());
     }
-    currTransition += restProb + ";";
-    mTransitions.push_back(currTransition);
+    if (minimalIndicator <= 0.0)
+    {  // the guard below removes these transitions
+        setError(Errors::invalidTransitionsRemoved(name, "SEC"));
+    }
+    transition.conditions.push_back(transition.rate + ">0");
+    mFragment->commands.push_back(std::move(transition));
 }
 
 void
-Transcriber::assembleSecurityTransition(const std::string& init, Node* node)
+Transcriber::assembleSecurityTransition(Node* attacker, Node* node)
 {
-    if (node->hasSecuringNodes())
+    const std::string& name = node->getStringRepresentation();
+    Command transition(node->getNumber(), 0, 2, concat({mVarUsg, name, "SEC"}));
+    transition.otherwise = 2;
+    if (attacker != nullptr)
+    {  // the attack starts from a corrupted node
+        transition.conditions.push_back(concat({attacker->getStringRepresentation(), "=2"}));
+        transition.reads.push_back(attacker->getNumber());
+    }
+
+    // The expanded encoding drops transitions by the current values, which is not possible if
+    // the rates are parameters
+    if (node->hasSecuringNodes()
+        && (Model::getInstance().getSecurityEncoding() == Model::SecurityEncoding::compact
+            || isParametric(node)))
+    {
+        assembleCompactSecurityTransition(std::move(transition), node);
+    }
+    else if (node->hasSecuringNodes())
     {
         std::list<std::string> permutations;
         generatePermutations(node->getSecuringNodes().size(), &permutations);
+        for (Node* securingNode : node->getSecuringNodes())
+        {
+            transition.reads.push_back(securingNode->getNumber());
+        }
 
-        for (std::string permutation : permutations)
+        for (const std::string& permutation : permutations)
         {
             // check whether a permutation evaluates to zero or below and skip it if so!
             double indicator = std::stod(node->getIntrusionIndicator());
@@ -149,78 +215,62 @@ Transcriber::assembleSecurityTransition(const std::string& init, Node* node)
             }
             if (indicator <= 0.0)
             {  // TODO: do we need to differentiate between 0 and below 0 ?
-                ErrorHandler::getInstance().setError(
-                        Errors::invalidTransitionsRemoved(node->getStringRepresentation(), "SEC"));
+                setError(Errors::invalidTransitionsRemoved(name, "SEC"));
                 continue;
             }
-            std::string currTransition = "[] " + init;
-            std::string guard = "(";
-            std::string consequence;
-            std::string rest;
+            std::string guard;
+            Command currTransition = transition;
             for (unsigned int i = 0; i < permutation.size(); ++i)
             {
-                std::string currSecNode = node->getSecuringNodes()[i]->getStringRepresentation();
+                const std::string& currSecNode =
+                        node->getSecuringNodes()[i]->getStringRepresentation();
                 if (permutation[i] == '0')
                 {  // node is ok
-                    guard += currSecNode + "=0 & ";
-                    consequence += "-" + mVarUsg + currSecNode + "GUAR";
+                    guard += concat({currSecNode, "=0 & "});
+                    currTransition.rate += concat({"-", mVarUsg, currSecNode, "GUAR"});
                 }
                 else
                 {
-                    guard += currSecNode + "!=0 & ";
+                    guard += concat({currSecNode, "!=0 & "});
                 }
             }
-            guard = guard.substr(0, guard.size() - 3);
-            guard += ")";
-            currTransition += " & " + guard + " & (operational) -> " + mVarUsg
-                              + node->getStringRepresentation() + "SEC" + consequence + " : ("
-                              + node->getStringRepresentation() + "'=2)";
-            if (Model::getInstance().getType() == Model::MDP)
-            {
-                rest = "+ 1-(" + mVarUsg + node->getStringRepresentation() + "SEC" + consequence
-                       + ") : (" + node->getStringRepresentation() + "'=2)";
-            }
-            currTransition += rest + ";";
-            mTransitions.push_back(currTransition);
+            guard.resize(guard.size() - 3);
+            currTransition.conditions.push_back(std::move(guard));
+            mFragment->commands.push_back(std::move(currTransition));
         }
     }
     else
     {
-        std::string currTransition = "[] " + init + " & (operational) -> " + mVarUsg
-                                     + node->getStringRepresentation() + "SEC" + " : ("
-                                     + node->getStringRepresentation() + "'=2)";
-        std::string rest;
-        if (Model::getInstance().getType() == Model::MDP)
-        {
-            rest = "+ 1-" + mVarUsg + node->getStringRepresentation() + "SEC" + " : ("
-                   + node->getStringRepresentation() + "'=2)";
-        }
-        currTransition += rest + ";";
-
-        mTransitions.push_back(currTransition);
+        mFragment->commands.push_back(std::move(transition));
     }
 }
 
+void
+Transcriber::addRecoveryFormula(const std::string& name,
+                                const std::string& body,
+                                Command* transition)
+{
+    Formula formula;
+    formula.name = name;
+    formula.body = body;
+    formula.expression = Expression::parse(body);
+    transition->conditions.push_back(name);
+    transition->formulas.push_back(formula.expression);
+    mFragment->formulas.push_back(std::move(formula));
+}
+
 void
 Transcriber::assembleCorRecoveryTransition(Node* node)
 {
-    std::string transition;
-    std::string formula = "pathes" + node->getStringRepresentation() + "CORREC";
+    const std::string& name = node->getStringRepresentation();
+    const std::string formula = concat({"pathes", name, "CORREC"});
+    // the guard of the general strategy, the others restrict it by the formula
+    Command transition(node->getNumber(), 2, 0, concat({mVarUsg, name, "CORREC"}));
+    transition.otherwise = 2;
     switch (node->getCorruptionRecoveryStrategy())
     {
         case Recovery::Strategy::general:
         {  // Node can always recover
-            transition = "[] (" + node->getStringRepresentation() + "=2) & (operational) -> "
-                         + mVarUsg + node->getStringRepresentation() + "CORREC : ("
-                         + node->getStringRepresentation() + "'=0)";
-            if (Model::getInstance().getType() == Model::MDP)
-            {
-                std::string rest = "1-" + mVarUsg + node->getStringRepresentation() + "CORREC"
-                                   + " : (" + node->getStringRepresentation() + "'=2)";
-                transition += " + " + rest;
-            }
-            transition += ";";
-            mTransitions.push_back(transition);
             break;
         }
         case Recovery::Strategy::restricted:
@@ -229,7 +279,7 @@ Transcriber::assembleCorRecoveryTransition(Node* node)
             /* TODO
             if (node->isReachableFromEnv())
             {
-                ErrorHandler::getInstance().setError(
+                setError(
                     Errors::restrictedRecoveryReachableFromEnv(node->getStringRepresentation()));
                 node->setCorrStrategy
                 assembleCorRecoveryTransition(node);
@@ -237,58 +287,37 @@ Transcriber::assembleCorRecoveryTransition(Node* node)
             std::string restrictedFormula = node->getRestrictedRecoveryFormula();
             if (restrictedFormula.empty())
             {
-                ErrorHandler::getInstance().setError(
-                        Errors::restrictedRecoveryTransitionEmpty(node->getStringRepresentation()));
+                setError(Errors::restrictedRecoveryTransitionEmpty(name));
+                return;
             }
-            else
-            {
-                mConstants.push_back("formula " + formula + " = "+ restrictedFormula + ";");
-                transition = "[] (" + node->getStringRepresentation() + "=2) & (operational) & ("
-                             + formula + ") -> " + mVarUsg + node->getStringRepresentation()
-                             + "CORREC : (" + node->getStringRepresentation() + "'=0)";
-                if (Model::getInstance().getType() == Model::MDP)
-                {
-                    std::string rest = "1-" + mVarUsg + node->getStringRepresentation() + "CORREC"
-                                       + " : (" + node->getStringRepresentation() + "'=2)";
-                    transition += " + " + rest;
-                }
-                transition += ";";
-                mTransitions.push_back(transition);
-            }
-
+            addRecoveryFormula(formula, restrictedFormula, &transition);
             break;
         }
         case Recovery::Strategy::custom:
         {  // Node can recover by given user definition
-            mConstants.push_back("formula "+ formula + " = "
-                                 + node->getCustomCorrRecoveryFormula() + ";");
-            transition = "[] (" + node->getStringRepresentation() + "=2) & (operational) & ("
-                         + formula + ") -> " + mVarUsg + node->getStringRepresentation()
-                         + "CORREC : (" + node->getStringRepresentation() + "'=0)";
-            if (Model::getInstance().getType() == Model::MDP)
-            {
-                std::string rest = "1-" + mVarUsg + node->getStringRepresentation() + "CORREC"
-                                   + " : (" + node->getStringRepresentation() + "'=2)";
-                transition += " + " + rest;
-            }
-            transition += ";";
-            mTransitions.push_back(transition);
+            addRecoveryFormula(formula, node->getCustomCorrRecoveryFormula(), &transition);
             break;
         }
         default:
         {
-            break;
+            return;
         }
     }
+    mFragment->commands.push_back(std::move(transition));
 }
 
 void
-Transcriber::assembleDefRecoveryTransition(Node* node,
-                                           const std::string& init,
-                                           const std::string& end)
+Transcriber::assembleDefRecoveryTransition(Node* node)
 {
-    std::string transition = init;
-    std::string formula = "pathes" + node->getStringRepresentation() + "DEFREC";
+    const std::string& name = node->getStringRepresentation();
+    const std::string formula = concat({"pathes", name, "DEFREC"});
+    Command transition(node->getNumber(), 1, 0, concat({mVarUsg, name, "DEFREC"}));
+    transition.otherwise = 1;
+    if (node->hasEssentialNodes())
+    {  // only defects of the node itself are recovered, see assembleSafetyTransition()
+        transition.conditions.push_back(concat({name, "internalfailure"}));
+        transition.updates.push_back(concat({name, "internalfailure'=false"}));
+    }
 
     switch (node->getDefectRecoveryStrategy())
     {
@@ -297,16 +326,6 @@ Transcriber::assembleDefRecoveryTransition(Node* node,
 
         case Recovery::Strategy::general:
         {  // Node can always recover
-            transition += "-> " + mVarUsg + node->getStringRepresentation() + "DEFREC : ("
-                          + node->getStringRepresentation() + "'=0)" + end;
-            if (Model::getInstance().getType() == Model::MDP)
-            {
-                std::string rest = "1-" + mVarUsg + node->getStringRepresentation() + "DEFREC"
-                                   + " : (" + node->getStringRepresentation() + "'=1)";
-                transition += " + " + rest;
-            }
-            transition += ";";
-            mTransitions.push_back(transition);
             break;
         }
         case Recovery::Strategy::restricted:
@@ -315,304 +334,1023 @@ Transcriber::assembleDefRecoveryTransition(Node* node,
             std::string restrictedFormula = node->getRestrictedRecoveryFormula();
             if (restrictedFormula.empty())
             {
-                ErrorHandler::getInstance().setError(
-                        Errors::restrictedRecoveryTransitionEmpty(node->getStringRepresentation()));
-                break;
-            }
-            else
-            {
-                mConstants.push_back("formula "+ formula + " = " + restrictedFormula + ";");
-                transition += " & (" + formula + ") -> " + mVarUsg + node->getStringRepresentation()
-                              + "DEFREC : (" + node->getStringRepresentation() + "'=0)" + end;
-                if (Model::getInstance().getType() == Model::MDP)
-                {
-                    std::string rest = "1-" + mVarUsg + node->getStringRepresentation() + "DEFREC"
-                                       + " : (" + node->getStringRepresentation() + "'=1)";
-                    transition += " + " + rest;
-                }
-                transition += ";";
-                mTransitions.push_back(transition);
-                break;
+                setError(Errors::restrictedRecoveryTransitionEmpty(name));
+                return;
             }
+            addRecoveryFormula(formula, restrictedFormula, &transition);
+            break;
         }
         case Recovery::Strategy::custom:
         {  // Node can recover by given user definition
             // TODO show warning if mode is custom but no nodes are provided
-            mConstants.push_back("formula " + formula + " = "
-                                 + node->getCustomDefRecoveryFormula() + ";");
-            transition += " & (" + formula + ") -> " + mVarUsg + node->getStringRepresentation()
-                          + "DEFREC : (" + node->getStringRepresentation() + "'=0)" + end;
-            if (Model::getInstance().getType() == Model::MDP)
-            {
-                std::string rest = "1-" + mVarUsg + node->getStringRepresentation() + "DEFREC"
-                                   + " : (" + node->getStringRepresentation() + "'=1)";
-                transition += " + " + rest;
-            }
-            transition += ";";
-            mTransitions.push_back(transition);
+            addRecoveryFormula(formula, node->getCustomDefRecoveryFormula(), &transition);
             break;
         }
         default:
         {
-            break;
+            return;
         }
     }
+    mFragment->commands.push_back(std::move(transition));
 }
 
 void
 Transcriber::buildAutomaton()
 {
-    std::string currNode;
-    std::string operational;      // correct functionality; system is working!
-    std::string normalDefective;  // In case no critical nodes are given
-    std::string normalCorrupted;  // In case no critical nodes are given
-    std::string corrupted = "";
-    std::string systemfailure = "label \"systemfailure\" = !operational;";
-    std::string defective = "";
+    std::vector<Expression::Ptr> operational;      // correct functionality; system is working!
+    std::vector<Expression::Ptr> normalDefective;  // In case no critical nodes are given
+    std::vector<Expression::Ptr> normalCorrupted;  // In case no critical nodes are given
+    std::vector<Expression::Ptr> corrupted;
     bool crit = false;
     for (Node* node : mNodes)
     {
-        currNode = node->getStringRepresentation();
-        // Add variable for node
-        mVariables.push_back(std::string(currNode + ": [0..2] init 0;"));
-
-        if (node->hasValidFailureIndicator())
-        {
-            // ----- n=0 -> n=1 -----
-            // Safety transition
-            assembleSafetyTransition("0", "1", node);
-            // ----- n=1 -> n=0 -----
-            // Recovery Transition from defective state to ok stat
-            if (node->isRecoverableFromDefect() && node->hasValidDefectRecoveryIndicator())
-            {
-                std::string init =
-                        "[] (" + node->getStringRepresentation() + "=1) & (operational) ";
-                std::string end = "";
-                if (node->hasEssentialNodes())
-                {
-                    std::string defState = node->getStringRepresentation() + "internalfailure";
-                    init += "& (" + defState + ")";
-                    end += " & (" + node->getStringRepresentation() + "internalfailure'=false)";
-                    defState += ": bool init false;";
-                    mVariables.push_back(defState);
-                }
-                assembleDefRecoveryTransition(node, init, end);
-            }
-        }
-
-        if (node->isReachable()) 
-        {  // Node is reachable when continuous reach edges from the env node to it exist
-            // ----- n=0 -> n=2 -----
-            // Security transition
-            if (node->isReachableFromEnv() && node->hasValidIntrusionIndicator())
-            {  // Node is directly attached to Env!
-                std::string init = "(" + currNode + "=0)";
-                assembleSecurityTransition(init, node);
-            }
-
-            // ----- n=2 -> n=1 -----
-            if (node->hasValidFailureIndicator())
-            {
-                assembleSafetyTransition("2", "1", node);
-            }
-
-            // Corruption of node can be used to attack other nodes
-            // ----- n=2 -> n'=2 -----
-            if (node->hasReachableNodes())
+        // ----- critical essential nodes add up to the mode of operation -----
+        if (node->isCritical() && node->isInVotingGroup())
+        {  // k-out-of-n groups are counted once, by their first member
+            if (node == node->getVotingGroup().front())
             {
-                for (Node* reachNode : node->getReachableNodes())
-                {
-                    std::string init = "(" + currNode + "=2 & "
-                                       + reachNode->getStringRepresentation() + "=0)";
-                    assembleSecurityTransition(init, reachNode);
-                }
-            }
-            // ----- n=2 -> n=0 -----
-            // Recovery Transition from corrupted state to ok state, if applicable
-            if (node->isRecoverableFromCorruption() && node->hasValidCorruptionRecoveryIndicator())
-            {
-                assembleCorRecoveryTransition(node);
+                operational.push_back(node->getVotingGroupExpression(
+                        Operational::getInstance().getMode() == Operational::Mode::optimized));
+                corrupted.push_back(node->getVotingGroupCorruptedExpression());
             }
+            crit = true;
         }
-
-        // ----- critical essential nodes add up to the mode of operation -----
-        if (node->isCritical())
+        else if (node->isCritical())
         {
+            Expression::Ptr ok = Expression::makeComparison(node->getNumber(), 0);
             if (Operational::getInstance().getMode() == Operational::Mode::optimized)
             {
-                operational += "(" + currNode + "=0";
                 if (node->hasEssentialNodes())
                 {
-                    operational +=
-                            " & (" + node->collectEssentialNodes(node->getNumber()) + ")";
+                    ok = Expression::makeConjunction({ok, node->collectEssentialNodes()});
                 }
                 if (node->hasRedundantNodes())
                 {
-                    operational += " | " + node->getRedundantAndEssentialNodesAsString(); 
+                    ok = Expression::makeDisjunction(
+                            {ok, node->getRedundantAndEssentialNodesExpression()});
                 }
             }
-            else
+            else if (node->hasRedundantNodes())
             {
-                operational += "(" + currNode + "=0";
-                if (node->hasRedundantNodes())
-                {
-                    operational += " | " + node->getRedundantNodesAsString(); 
-                }
+                ok = Expression::makeDisjunction({ok, node->getRedundantNodesExpression()});
             }
-            operational += ") & ";
+            operational.push_back(ok);
 
+            Expression::Ptr broken = Expression::makeComparison(node->getNumber(), 2);
             if (node->hasRedundantNodes())
             {
-                corrupted += "(" + currNode + "=2 & " + node->getRedundantNodesAsString("2") + ") | "; // returns "nx=2" or "nx=2 & nz=2 ..."
-            }
-            else
-            {
-                corrupted += currNode + "=2 | ";
+                broken = Expression::makeConjunction({broken, node->getRedundantNodesExpression(2)});
             }
+            corrupted.push_back(broken);
             crit = true;
         }
         // ----- n=2 + normal essential nodes -----
         else
         {  // Safety transition: a corrupted node may turn defective (critical nodes can't break
             // more)
-            normalDefective += currNode + "=0";
-            normalCorrupted += "(" + currNode + "=2) & ";// required to always print corrupted label
+            normalDefective.push_back(Expression::makeComparison(node->getNumber(), 0));
+            // required to always print corrupted label
+            normalCorrupted.push_back(Expression::makeComparison(node->getNumber(), 2));
             // If the node is corrupted the attacker may use it to corrupt further nodes:
             if (node->hasEssentialNodes())
             {
-                normalDefective += " | " + node->getEssentialNodes();
+                normalDefective.push_back(node->getEssentialExpression());
             }
-            normalDefective += " | ";
         }
     }
 
+    Expression::Ptr corruptedFormula;
     if (crit)  // at least one critical node given
-    {          // otherwise corrupted label has not been set and should not be printed
-        if (!corrupted.empty())
-        {
-            corrupted.insert(0, "label \"corrupted\" = ");
-            corrupted.replace(corrupted.size() - 2, 2, ";");
-        }
-        // remove last logic operator and space; cannot be empty as critical nodes exist
-        operational = operational.substr(0, operational.size() - 2);
+    {
+        mOperationalFormula = Expression::makeConjunction(std::move(operational));
+        corruptedFormula = Expression::makeDisjunction(std::move(corrupted));
     }
     else
     {  // no critical nodes given, default mode of operation has to be set!
-        // remove last & and space
-        normalDefective = normalDefective.substr(0, normalDefective.size() - 2);
-        normalCorrupted = normalCorrupted.substr(0, normalCorrupted.size() - 2);
-        operational += normalDefective;
+        mOperationalFormula = Expression::makeDisjunction(std::move(normalDefective));
 
         // default mode even though reach links may not exist, nodes are included
         // This is a workaround, as the corrupted label might be required for an experiment
-        corrupted.insert(0, "label \"corrupted\" = ");
-        corrupted += normalCorrupted + ";";
+        corruptedFormula = Expression::makeConjunction(std::move(normalCorrupted));
+    }
+    // the system is defective if it is not operational with defects instead of corruptions
+    Expression::Ptr defectiveFormula = mOperationalFormula->dual();
+
+    // keep the formulas, they are needed for the native analysis
+    mLabelFormulas.clear();
+    mLabelFormulas.emplace_back("systemfailure", Expression::makeNegation(mOperationalFormula));
+    mLabelFormulas.emplace_back("defective", defectiveFormula);
+    mLabelFormulas.emplace_back("corrupted", corruptedFormula);
+}
+
+std::string
+Transcriber::constantName(unsigned int number, const std::string& suffix)
+{
+    return (Model::getInstance().getType() == Model::CTMC ? "rn" : "pn") + std::to_string(number)
+           + suffix;
+}
+
+void
+Transcriber::setObservedLabels(std::set<std::string> labels)
+{
+    mObservedLabels = std::move(labels);
+}
+
+void
+Transcriber::setConeOfInfluence(bool enabled)
+{
+    mConeOfInfluence = enabled;
+}
+
+void
+Transcriber::setSymmetryAbstraction(bool enabled)
+{
+    mSymmetryAbstraction = enabled;
+}
+
+void
+Transcriber::setTimeReward(bool enabled)
+{
+    mTimeReward = enabled;
+}
+
+void
+Transcriber::setParameters(std::set<std::string> parameters)
+{
+    mParameters = std::move(parameters);
+    mFragments.clear();
+}
+
+std::string
+Transcriber::declareConstant(Node* node, const std::string& suffix, const std::string& value)
+{
+    const std::string number = std::to_string(node->getNumber());
+    if (!mParameters.empty() && mParameters.count(constantName(node->getNumber(), suffix)) != 0)
+    {  // left undefined, the value is given by -const
+        return concat({mVarDecl, number, suffix, ";"});
     }
-    operational += ";";
+    return concat({mVarDecl, number, suffix, " = ", value, ";"});
+}
 
-    defective = operational;
-    char prev = ' ';
-    for (char& c : defective)
+bool
+Transcriber::isParametric(Node* node) const
+{
+    if (mParameters.empty())
+    {
+        return false;
+    }
+    if (mParameters.count(constantName(node->getNumber(), "SEC")) != 0)
+    {
+        return true;
+    }
+    for (Node* securingNode : node->getSecuringNodes())
     {
-        if (c == ' ')
+        if (mParameters.count(constantName(securingNode->getNumber(), "GUAR")) != 0)
         {
-            continue;
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+Transcriber::buildFragment(Node* node)
+{
+    // Collect Variables (Component Probabilities)
+    mFragment->rates.push_back(declareConstant(node, "SEC", node->getIntrusionIndicator()));
+    mFragment->rates.push_back(declareConstant(node, "SAFE", node->getFailureIndicator()));
+    mFragment->rates.push_back(declareConstant(node, "GUAR", node->getSecurityIndicator()));
+    if (node->isRecoverableFromDefect())
+    {
+        mFragment->rates.push_back(
+                declareConstant(node, "DEFREC", node->getDefectRecoveryIndicator()));
+    }
+    if (node->isRecoverableFromCorruption())
+    {
+        mFragment->rates.push_back(
+                declareConstant(node, "CORREC", node->getCorruptionRecoveryIndicator()));
+    }
+
+    if (node->hasValidFailureIndicator())
+    {
+        // ----- n=0 -> n=1 -----
+        // Safety transition
+        assembleSafetyTransition(0, node);
+        // ----- n=1 -> n=0 -----
+        // Recovery Transition from defective state to ok stat
+        if (node->isRecoverableFromDefect() && node->hasValidDefectRecoveryIndicator())
+        {
+            mFragment->internalFailure = node->hasEssentialNodes();
+            assembleDefRecoveryTransition(node);
+        }
+    }
+
+    if (node->isReachable()) 
+    {  // Node is reachable when continuous reach edges from the env node to it exist
+        // ----- n=0 -> n=2 -----
+        // Security transition
+        if (node->isReachableFromEnv() && node->hasValidIntrusionIndicator())
+        {  // Node is directly attached to Env!
+            assembleSecurityTransition(nullptr, node);
+        }
+
+        // ----- n=2 -> n=1 -----
+        if (node->hasValidFailureIndicator())
+        {
+            assembleSafetyTransition(2, node);
         }
-        else if (c == '0' && prev == '=')
+
+        // Corruption of node can be used to attack other nodes
+        // ----- n=2 -> n'=2 -----
+        if (node->hasReachableNodes())
         {
-            c = '1';
+            for (Node* reachNode : node->getReachableNodes())
+            {
+                assembleSecurityTransition(node, reachNode);
+            }
         }
-        else if (c == '&')
+        // ----- n=2 -> n=0 -----
+        // Recovery Transition from corrupted state to ok state, if applicable
+        if (node->isRecoverableFromCorruption() && node->hasValidCorruptionRecoveryIndicator())
         {
-            c = '|';
+            assembleCorRecoveryTransition(node);
         }
-        else if (c == '|')
+    }
+}
+
+bool
+Transcriber::dependsOn(Node* node, const std::set<unsigned int>& changed)
+{
+    auto contains = [&changed](Node* other) { return changed.count(other->getNumber()) != 0; };
+    if (contains(node))
+    {
+        return true;
+    }
+    // the security transitions of a node and of the nodes it reaches use their guarantees
+    std::vector<Node*> targets(node->getReachableNodes().begin(), node->getReachableNodes().end());
+    targets.push_back(node);
+    for (Node* target : targets)
+    {
+        const std::vector<Node*>& securingNodes = target->getSecuringNodes();
+        if (contains(target) || std::any_of(securingNodes.begin(), securingNodes.end(), contains))
         {
-            c = '&';
+            return true;
         }
-        prev = c;
     }
-    operational.insert(0, "formula operational = ");
-    defective.insert(0, "label \"defective\" = ");
+    return false;
+}
 
-    mConstants.push_back(operational);
-    mConstants.emplace_back("");  // newline
-    mVariables.emplace_back("");
-    mLabels.push_back(systemfailure);
-    mLabels.push_back(defective);
-    mLabels.push_back(corrupted);
+void
+Transcriber::setError(const std::pair<Errors::Type, QString>& error)
+{
+    mFragment->warnings.push_back(error);
+    ErrorHandler::getInstance().setError(error);
 }
 
 void
-Transcriber::buildModel()
+Transcriber::buildModel(const std::set<unsigned int>* changed)
 {
+    size_t rebuilt = 0;
     for (Node* node : mNodes)
-    {  // Collect Variables (Component Probabilities)
-        mConstants.push_back(std::string(mVarDecl + std::to_string(node->getNumber())
-                                         + "SEC = " + node->getIntrusionIndicator() + ";"));
-        mConstants.push_back(std::string(mVarDecl + std::to_string(node->getNumber())
-                                         + "SAFE = " + node->getFailureIndicator() + ";"));
-        mConstants.push_back(std::string(mVarDecl + std::to_string(node->getNumber())
-                                         + "GUAR = " + node->getSecurityIndicator() + ";"));
-        if (node->isRecoverableFromDefect())
+    {
+        auto iter = mFragments.find(node->getNumber());
+        if (changed == nullptr || iter == mFragments.end() || dependsOn(node, *changed))
         {
-            mConstants.push_back(std::string(mVarDecl + std::to_string(node->getNumber())
-                                             + "DEFREC = " + node->getDefectRecoveryIndicator()
-                                             + ";"));
+            Fragment& fragment = mFragments[node->getNumber()];
+            fragment = Fragment();
+            mFragment = &fragment;
+            buildFragment(node);
+            mFragment = nullptr;
+            ++rebuilt;
+        }
+        else
+        {  // reused, the warnings apply nonetheless
+            for (const auto& warning : iter->second.warnings)
+            {
+                ErrorHandler::getInstance().setError(warning);
+            }
         }
-        if (node->isRecoverableFromCorruption())
+    }
+    if (mFragments.size() > mNodes.size())
+    {  // drop the fragments of removed nodes
+        std::set<unsigned int> numbers;
+        for (Node* node : mNodes)
+        {
+            numbers.insert(node->getNumber());
+        }
+        for (auto iter = mFragments.begin(); iter != mFragments.end();)
         {
-            mConstants.push_back(std::string(mVarDecl + std::to_string(node->getNumber())
-                                             + "CORREC = " + node->getCorruptionRecoveryIndicator()
-                                             + ";"));
+            iter = numbers.count(iter->first) == 0 ? mFragments.erase(iter) : std::next(iter);
         }
     }
-    mConstants.emplace_back("");  // newline
+    PRINT_INFO("Generated %zu of %zu nodes", rebuilt, mNodes.size());
 
     buildAutomaton();
+    if ((mConeOfInfluence || mSymmetryAbstraction) && Model::getInstance().getType() == Model::CTMC
+        && mParameters.empty())
+    {  // the commands of an MDP are choices of the scheduler, swept rates may be zero
+        MarkovChain chain(mNodes, mOperationalFormula, mLabelFormulas);
+        if (chain.isValid())
+        {
+            reduceConeOfInfluence(chain);
+            if (mSymmetryAbstraction)
+            {
+                abstractSymmetries(chain);
+            }
+        }
+    }
     generateFile();
 }
 
+namespace
+{
+/** Counts of ok, defective and corrupted members of a group */
+using Counts = std::array<unsigned int, 3>;
+
+std::string
+counterName(unsigned int first, int value)
+{
+    static const char* suffixes[] = {"ok", "def", "cor"};
+    return "g" + std::to_string(first) + suffixes[value];
+}
+
+std::vector<Counts>
+allCounts(unsigned int members)
+{
+    std::vector<Counts> counts;
+    for (unsigned int ok = members + 1; ok-- > 0;)
+    {
+        for (unsigned int defective = members - ok + 1; defective-- > 0;)
+        {
+            counts.push_back({ok, defective, members - ok - defective});
+        }
+    }
+    return counts;
+}
+
+/**
+ * Prints a condition over the counters of the group that holds for exactly the given counts,
+ * a single comparison if possible. Empty if it holds for all counts.
+ */
+std::string
+countCondition(unsigned int first, unsigned int members, const std::vector<Counts>& counts)
+{
+    const std::vector<Counts> all = allCounts(members);
+    const std::set<Counts> wanted(counts.begin(), counts.end());
+    if (wanted.size() == all.size())
+    {
+        return "";
+    }
+    static const char* comparisons[] = {"=", ">=", "<="};
+    for (int value = 0; value < 3; ++value)
+    {
+        for (unsigned int bound = 0; bound <= members; ++bound)
+        {
+            for (int comparison = 0; comparison < 3; ++comparison)
+            {
+                std::set<Counts> matching;
+                for (const Counts& count : all)
+                {
+                    const unsigned int n = count[value];
+                    if ((comparison == 0 && n == bound) || (comparison == 1 && n >= bound)
+                        || (comparison == 2 && n <= bound))
+                    {
+                        matching.insert(count);
+                    }
+                }
+                if (matching == wanted)
+                {
+                    return counterName(first, value) + comparisons[comparison]
+                           + std::to_string(bound);
+                }
+            }
+        }
+    }
+    std::string condition;
+    for (const Counts& count : counts)
+    {
+        condition += std::string(condition.empty() ? "" : " | ") + "(" + counterName(first, 0)
+                     + "=" + std::to_string(count[0]) + " & " + counterName(first, 1) + "="
+                     + std::to_string(count[1]) + ")";
+    }
+    return condition;
+}
+
+/**
+ * Checks whether the expression refers to one of the given nodes, unknown expressions (nullptr)
+ * may refer to all nodes.
+ */
+bool
+refersTo(const Expression::Ptr& expression, const std::set<unsigned int>& nodes)
+{
+    if (expression == nullptr)
+    {
+        return true;
+    }
+    std::vector<unsigned int> referenced;
+    expression->collectNodes(&referenced);
+    return std::any_of(referenced.begin(), referenced.end(),
+                       [&nodes](unsigned int number) { return nodes.count(number) != 0; });
+}
+
+/**
+ * Checks whether a command reads one of the given nodes by its conditions, rate or formulas.
+ */
+template <typename Command>
+bool
+reads(const Command& command, const std::set<unsigned int>& nodes)
+{
+    return std::any_of(command.reads.begin(), command.reads.end(),
+                       [&nodes](unsigned int number) { return nodes.count(number) != 0; })
+           || std::any_of(command.formulas.begin(), command.formulas.end(),
+                          [&nodes](const Expression::Ptr& formula) {
+                              return refersTo(formula, nodes);
+                          });
+}
+
+/**
+ * Checks whether the rate is a number or a constant, i.e. needs no parentheses as an operand.
+ */
+bool
+isPlain(const std::string& rate)
+{
+    return std::all_of(rate.begin(), rate.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' || c == '.';
+    });
+}
+
+std::string
+listNodes(const std::set<unsigned int>& nodes)
+{
+    std::string list;
+    for (unsigned int number : nodes)
+    {
+        list += " n" + std::to_string(number);
+    }
+    return list;
+}
+}  // namespace
+
+std::string
+Transcriber::countFormula(const Expression::Ptr& formula,
+                          const std::vector<std::vector<unsigned int>>& groups) const
+{
+    std::vector<unsigned int> referenced;
+    formula->collectNodes(&referenced);
+    auto group = std::find_if(groups.begin(), groups.end(), [&](const auto& members) {
+        return std::any_of(referenced.begin(), referenced.end(), [&](unsigned int number) {
+            return std::find(members.begin(), members.end(), number) != members.end();
+        });
+    });
+    if (group == groups.end())
+    {
+        return formula->toString();
+    }
+
+    // The formula is symmetric in the group, i.e., it only depends on the counts. Each count is
+    // represented by assigning the values in the order of the members, the remaining formulas
+    // are hash-consed, so counts with the same remainder are collected by pointer.
+    const unsigned int size = static_cast<unsigned int>(group->size());
+    std::vector<std::pair<Expression::Ptr, std::vector<Counts>>> remainders;
+    for (const Counts& counts : allCounts(size))
+    {
+        Expression::Ptr remainder = formula->replaceAtoms([&](const Expression::Ptr& atom) {
+            auto member = std::find(group->begin(), group->end(), atom->getNode());
+            if (member == group->end() || atom->getKind() == Expression::Kind::flag)
+            {
+                return atom;
+            }
+            const unsigned int index = static_cast<unsigned int>(member - group->begin());
+            const int value = index < counts[0] ? 0 : index < counts[0] + counts[1] ? 1 : 2;
+            return Expression::makeConstant((value == atom->getValue())
+                                            == (atom->getKind() == Expression::Kind::equals));
+        });
+        auto known = std::find_if(remainders.begin(), remainders.end(),
+                                  [&](const auto& entry) { return entry.first == remainder; });
+        if (known != remainders.end())
+        {
+            known->second.push_back(counts);
+        }
+        else
+        {
+            remainders.emplace_back(remainder, std::vector<Counts>{counts});
+        }
+    }
+
+    std::vector<std::string> terms;
+    for (const auto& remainder : remainders)
+    {
+        const Expression::Ptr& rest = remainder.first;
+        if (rest->getKind() == Expression::Kind::constant && rest->getValue() == 0)
+        {
+            continue;
+        }
+        const std::string condition = countCondition(group->front(), size, remainder.second);
+        const std::string other = rest->getKind() == Expression::Kind::constant
+                                          ? ""
+                                          : countFormula(rest, groups);
+        if (condition.empty() || other.empty())
+        {
+            terms.push_back(condition.empty() ? (other.empty() ? "true" : other) : condition);
+        }
+        else
+        {
+            terms.push_back("(" + condition + ") & (" + other + ")");
+        }
+    }
+    if (terms.empty())
+    {
+        return "false";
+    }
+    if (terms.size() == 1)
+    {
+        return terms.front();
+    }
+    std::string ret;
+    for (const std::string& term : terms)
+    {
+        ret += (ret.empty() ? "(" : " | (") + term + ")";
+    }
+    return ret;
+}
+
+
+bool
+Transcriber::isWritten(unsigned int number) const
+{
+    auto group = mGroupOf.find(number);
+    return mRemovedNodes.count(number) == 0 && mFrozenNodes.count(number) == 0
+           && (group == mGroupOf.end() || mGroups[group->second].front() == number);
+}
+
+unsigned int
+Transcriber::getOwner(unsigned int number) const
+{
+    auto group = mGroupOf.find(number);
+    return group == mGroupOf.end() ? number : mGroups[group->second].front();
+}
+
 void
-Transcriber::generateFile()
+Transcriber::abstractSymmetries(const MarkovChain& chain)
 {
-    // open file
-    std::ofstream outfile;
-    outfile.open(mOutfileName, std::ios::out | std::ios::trunc);
-    if (outfile.is_open())
+    std::set<unsigned int> counted;
+    for (auto& members : chain.getSymmetryGroups())
     {
-        outfile << mModelAsString << "\n" << std::endl;
+        bool flagged = false;
+        for (unsigned int number : members)
+        {  // the flags are per node, removed or frozen members are not declared
+            const Fragment& fragment = mFragments[number];
+            flagged |= fragment.internalFailure || mRemovedNodes.count(number) != 0
+                       || mFrozenNodes.count(number) != 0
+                       || std::any_of(fragment.commands.begin(), fragment.commands.end(),
+                                      [](const Command& command) {
+                                          return !command.updates.empty();
+                                      });
+        }
+        if (!flagged)
+        {
+            for (unsigned int number : members)
+            {
+                mGroupOf[number] = mGroups.size();
+            }
+            counted.insert(members.begin(), members.end());
+            mGroups.push_back(std::move(members));
+        }
+    }
+    if (mGroups.empty())
+    {
+        return;
+    }
 
-        // write constant variables
-        for (auto it = mConstants.begin(); it != mConstants.end(); ++it)
+    // The counters tell how many members are in a state but not which, hence the written code
+    // may only refer to members by formulas that are symmetric in each group
+    auto isSymmetric = [&](const Expression::Ptr& formula) {
+        if (!refersTo(formula, counted))
         {
-            outfile << *it << std::endl;
+            return true;
         }
+        const std::string canonical = formula->toCanonicalString();
+        for (const auto& members : mGroups)
+        {
+            for (size_t i = 1; i < members.size(); ++i)
+            {
+                if (formula->swapNodes(members.front(), members[i])->toCanonicalString()
+                    != canonical)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    bool symmetric = isSymmetric(mOperationalFormula);
+    for (const auto& label : mLabelFormulas)
+    {
+        symmetric &= mUnobservedLabels.count(label.first) != 0 || isSymmetric(label.second);
+    }
+    std::string reading;
+    for (Node* node : mNodes)
+    {
+        const Fragment& fragment = mFragments[node->getNumber()];
+        for (const Formula& formula : fragment.formulas)
+        {
+            symmetric &= !isWritten(node->getNumber()) || isSymmetric(formula.expression);
+        }
+        for (const Command& command : fragment.commands)
+        {
+            if (isWritten(command.node)
+                && std::any_of(command.reads.begin(), command.reads.end(),
+                               [&counted](unsigned int read) { return counted.count(read) != 0; }))
+            {
+                reading = "n" + std::to_string(command.node);
+            }
+        }
+    }
+    if (!symmetric || !reading.empty())
+    {
+        if (reading.empty())
+        {
+            PRINT_INFO("Interchangeable nodes are referenced by asymmetric formulas");
+        }
+        else
+        {
+            PRINT_INFO("Interchangeable nodes are read by the commands of %s", reading.c_str());
+        }
+        mGroups.clear();
+        mGroupOf.clear();
+        return;
+    }
+    PRINT_INFO("Counted %zu groups of interchangeable nodes", mGroups.size());
+}
 
-        // begin module
-        outfile << "module generatedScenario\n" << std::endl;
+void
+Transcriber::reduceConeOfInfluence(const MarkovChain& chain)
+{
+    if (!mConeOfInfluence)
+    {
+        return;
+    }
+    std::vector<unsigned int> observed;
+    std::set<std::string> unobserved;
+    for (const auto& label : mLabelFormulas)
+    {
+        if (mObservedLabels.empty() || mObservedLabels.count(label.first) != 0)
+        {
+            label.second->collectNodes(&observed);
+        }
+        else
+        {
+            unobserved.insert(label.first);
+        }
+    }
+    std::vector<unsigned int> frozenNodes;
+    const std::vector<unsigned int> cone = chain.getConeOfInfluence(observed, &frozenNodes);
+    std::set<unsigned int> removed;
+    for (Node* node : mNodes)
+    {
+        if (!std::binary_search(cone.begin(), cone.end(), node->getNumber()))
+        {
+            removed.insert(node->getNumber());
+        }
+    }
+    std::set<unsigned int> frozen(frozenNodes.begin(), frozenNodes.end());
+    if (removed.empty() && frozen.empty() && unobserved.empty())
+    {
+        return;
+    }
 
-        // write variable and state declarations
-        for (auto it = mVariables.begin(); it != mVariables.end(); ++it)
+    // the cone is derived from the rules of the chain, the kept code must agree with them
+    std::string dependent;
+    if (refersTo(mOperationalFormula, removed))
+    {
+        dependent = "operational";
+    }
+    for (const auto& label : mLabelFormulas)
+    {
+        if (unobserved.count(label.first) == 0 && refersTo(label.second, removed))
+        {
+            dependent = label.first;
+        }
+    }
+    for (Node* node : mNodes)
+    {
+        for (const Command& command : mFragments[node->getNumber()].commands)
         {
-            outfile << *it << std::endl;
+            if (removed.count(command.node) == 0 && frozen.count(command.node) == 0
+                && reads(command, removed))
+            {
+                dependent = "n" + std::to_string(command.node);
+            }
         }
-        // outfile << "s : [0.." << mTransitions.size() << "] init 0\n" << std::endl;
+    }
+    if (!dependent.empty())
+    {
+        PRINT_WARNING("Cone of influence not applied, %s depends on removed nodes",
+                      dependent.c_str());
+        return;
+    }
 
-        // write state transitions
-        for (auto it = mTransitions.begin(); it != mTransitions.end(); ++it)
+    PRINT_INFO("Cone of influence: removed %zu nodes%s, froze %zu nodes%s, dropped %zu labels",
+               removed.size(), listNodes(removed).c_str(), frozen.size(),
+               listNodes(frozen).c_str(), unobserved.size());
+    mRemovedNodes.swap(removed);
+    mFrozenNodes.swap(frozen);
+    mUnobservedLabels.swap(unobserved);
+}
+
+Expression::Ptr
+Transcriber::getOperationalFormula() const
+{
+    return mOperationalFormula;
+}
+
+const std::vector<std::pair<std::string, Expression::Ptr>>&
+Transcriber::getLabelFormulas() const
+{
+    return mLabelFormulas;
+}
+
+const std::string&
+Transcriber::getModelCode() const
+{
+    return mModelCode;
+}
+
+void
+Transcriber::appendLines(const std::vector<std::string>& lines)
+{
+    for (const std::string& line : lines)
+    {
+        mModelCode.append(line).push_back('\n');
+    }
+}
+
+std::string
+Transcriber::printCommand(const Command& command) const
+{
+    const std::string variable = "n" + std::to_string(command.node);
+    std::string source;
+    std::string rate = command.rate;
+    std::vector<std::string> updates;
+    auto group = mGroupOf.find(command.node);
+    if (group == mGroupOf.end())
+    {
+        source = concat({variable, "=", std::to_string(command.source)});
+        updates.push_back(concat({variable, "'=", std::to_string(command.target)}));
+    }
+    else
+    {  // one member in the source state is taken, the rates of all of them add up
+        const unsigned int first = mGroups[group->second].front();
+        const std::string from = counterName(first, command.source);
+        const std::string to = counterName(first, command.target);
+        source = concat({from, ">0"});
+        rate = rate.empty() ? from : concat({from, "*", isPlain(rate) ? rate : "(" + rate + ")"});
+        updates.push_back(concat({from, "'=", from, "-1"}));
+        updates.push_back(concat({to, "'=", to, "+1"}));
+    }
+    updates.insert(updates.end(), command.updates.begin(), command.updates.end());
+
+    std::string line = concat({"[] (", source, ")"});
+    for (const std::string& condition : command.conditions)
+    {
+        line.append(" & (").append(condition).append(")");
+    }
+    line.append(" & (operational) -> ");
+    if (!rate.empty())
+    {
+        line.append(rate).append(" : ");
+    }
+    for (size_t i = 0; i < updates.size(); ++i)
+    {
+        line.append(i == 0 ? "(" : " & (").append(updates[i]).append(")");
+    }
+    if (command.otherwise >= 0 && Model::getInstance().getType() == Model::MDP)
+    {  // the transition fails with the remaining probability
+        line.append(concat({" + 1-", isPlain(rate) ? rate : "(" + rate + ")", " : (", variable,
+                            "'=", std::to_string(command.otherwise), ")"}));
+    }
+    line.push_back(';');
+    return line;
+}
+
+void
+Transcriber::appendModules()
+{
+    std::vector<Node*> order = mNodes;
+    if (Model::getInstance().getVariableOrder() == Model::dependencyOrder)
+    {
+        order = VariableOrder::reverseCuthillMcKee(mNodes);
+        PRINT_INFO("Variables ordered by dependencies, bandwidth %u instead of %u",
+                   VariableOrder::bandwidth(order), VariableOrder::bandwidth(mNodes));
+    }
+
+    // The declarations and commands belong to the node, respectively the group of
+    // interchangeable nodes, whose variables they declare and update. PRISM only allows a
+    // module to update its own variables, the guards may read all of them.
+    std::map<unsigned int, size_t> rank;
+    std::vector<unsigned int> owners;
+    for (Node* node : order)
+    {
+        auto group = mGroupOf.find(node->getNumber());
+        const unsigned int owner =
+                group == mGroupOf.end() ? node->getNumber() : mGroups[group->second].front();
+        if (rank.emplace(owner, owners.size()).second)
+        {
+            owners.push_back(owner);
+        }
+    }
+    auto byOwner = [&rank](const std::pair<unsigned int, std::string>& first,
+                           const std::pair<unsigned int, std::string>& second) {
+        return rank.at(first.first) < rank.at(second.first);
+    };
+    std::stable_sort(mVariables.begin(), mVariables.end(), byOwner);
+    std::stable_sort(mCommands.begin(), mCommands.end(), byOwner);
+
+    if (Model::getInstance().getModuleLayout() == Model::singleModule)
+    {
+        mModelCode.append("module generatedScenario\n\n");
+        appendLines(mComments);
+        for (const auto& variable : mVariables)
+        {
+            mModelCode.append(variable.second).push_back('\n');
+        }
+        mModelCode.push_back('\n');
+        for (const auto& command : mCommands)
+        {
+            mModelCode.append(command.second).push_back('\n');
+        }
+        mModelCode.append("\n\nendmodule\n");
+        return;
+    }
+
+    appendLines(mComments);
+    auto variable = mVariables.begin();
+    auto command = mCommands.begin();
+    size_t modules = 0;
+    for (unsigned int owner : owners)
+    {
+        if (variable == mVariables.end() || variable->first != owner)
+        {  // removed from the model
+            continue;
+        }
+        mModelCode.append(mGroupOf.count(owner) != 0 ? "module group" : "module node")
+                .append(std::to_string(owner))
+                .append("\n");
+        for (; variable != mVariables.end() && variable->first == owner; ++variable)
+        {
+            mModelCode.append(variable->second).push_back('\n');
+        }
+        for (; command != mCommands.end() && command->first == owner; ++command)
+        {
+            mModelCode.append(command->second).push_back('\n');
+        }
+        mModelCode.append("endmodule\n\n");
+        ++modules;
+    }
+    PRINT_INFO("Generated %zu modules", modules);
+}
+
+void
+Transcriber::generateFile()
+{
+    // elapsed time, for mean time properties such as R{"time"}=? [ F "systemfailure" ]
+    static const std::string timeReward = "\nrewards \"time\"\n    true : 1;\nendrewards\n";
+    const bool rewards = mTimeReward && Model::getInstance().getType() == Model::CTMC;
+
+    std::set<unsigned int> counted;
+    for (const auto& member : mGroupOf)
+    {
+        counted.insert(member.first);
+    }
+    auto print = [&](const Expression::Ptr& formula, const std::string& body) {
+        return refersTo(formula, counted) ? countFormula(formula, mGroups) : body;
+    };
+
+    for (unsigned int number : mFrozenNodes)
+    {
+        mConstants.push_back(concat({"const int n", std::to_string(number), " = 0;"}));
+    }
+    std::vector<std::string> formulas;
+    for (Node* node : mNodes)
+    {
+        const unsigned int number = node->getNumber();
+        const Fragment& fragment = mFragments[number];
+        if (mRemovedNodes.count(number) == 0)
+        {  // frozen nodes and other members of counted groups may secure written nodes
+            mConstants.insert(mConstants.end(), fragment.rates.begin(), fragment.rates.end());
+        }
+        // the commands of attacks are generated by the attacker but belong to their target
+        for (const Command& command : fragment.commands)
         {
-            outfile << *it << std::endl;
+            if (isWritten(command.node))
+            {
+                mCommands.emplace_back(getOwner(command.node), printCommand(command));
+            }
         }
-        // end module
-        outfile << "\n" << std::endl;
-        outfile << "endmodule" << std::endl;
+        if (!isWritten(number))
+        {
+            continue;
+        }
+        for (const Formula& formula : fragment.formulas)
+        {
+            formulas.push_back(concat({"formula ", formula.name, " = ",
+                                       print(formula.expression, formula.body), ";"}));
+        }
+        const std::string& name = node->getStringRepresentation();
+        auto group = mGroupOf.find(number);
+        if (group != mGroupOf.end())
+        {
+            const std::vector<unsigned int>& members = mGroups[group->second];
+            const std::string size = std::to_string(members.size());
+            mVariables.emplace_back(number,
+                                    "// interchangeable nodes"
+                                            + listNodes({members.begin(), members.end()}));
+            mVariables.emplace_back(number,
+                                    concat({counterName(number, 0), ": [0..", size, "] init ",
+                                            size, ";"}));
+            mVariables.emplace_back(number, concat({counterName(number, 1), ": [0..", size,
+                                                    "] init 0;"}));
+            mVariables.emplace_back(number, concat({counterName(number, 2), ": [0..", size,
+                                                    "] init 0;"}));
+        }
+        else
+        {
+            mVariables.emplace_back(number, concat({name, ": [0..2] init 0;"}));
+            if (fragment.internalFailure)
+            {
+                mVariables.emplace_back(number,
+                                        concat({name, "internalfailure: bool init false;"}));
+            }
+        }
+    }
+    mConstants.emplace_back("");  // newline
+    mConstants.insert(mConstants.end(), formulas.begin(), formulas.end());
+    mConstants.push_back(concat({"formula operational = ",
+                                 print(mOperationalFormula, mOperationalFormula->toString()),
+                                 ";"}));
+    mConstants.emplace_back("");
 
-        for (auto it = mLabels.begin(); it != mLabels.end(); ++it)
+    if (!mRemovedNodes.empty())
+    {
+        mComments.push_back("// outside the cone of influence:" + listNodes(mRemovedNodes));
+    }
+    if (!mFrozenNodes.empty())
+    {
+        mComments.push_back("// never leave ok:" + listNodes(mFrozenNodes));
+    }
+
+    for (const auto& label : mLabelFormulas)
+    {
+        if (mUnobservedLabels.count(label.first) != 0)
+        {
+            continue;
+        }
+        mLabels.push_back(concat({"label \"", label.first, "\" = ",
+                                  label.first == "systemfailure"
+                                          ? "!operational"
+                                          : print(label.second, label.second->toString()),
+                                  ";"}));
+    }
+
+    // the code is assembled in a single buffer and written at once, the buffer is kept
+    // between calls, it only grows if the model does
+    size_t size = mModelAsString.size() + (rewards ? timeReward.size() : 0)
+                  + mNodes.size() * 32;  // module per node
+    for (const auto* lines : {&mConstants, &mComments, &mLabels})
+    {
+        for (const std::string& line : *lines)
+        {
+            size += line.size() + 1;
+        }
+    }
+    for (const auto* lines : {&mVariables, &mCommands})
+    {
+        for (const auto& line : *lines)
         {
-            outfile << *it << std::endl;
+            size += line.second.size() + 1;
         }
     }
+    mModelCode.clear();
+    mModelCode.reserve(size);
+
+    mModelCode.append(mModelAsString).append("\n\n");
+    appendLines(mConstants);
+    appendModules();
+    appendLines(mLabels);
+    if (rewards)
+    {
+        mModelCode.append(timeReward);
+    }
+
+    std::ofstream outfile(mOutfileName, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (outfile.is_open())
+    {
+        outfile.write(mModelCode.data(), static_cast<std::streamsize>(mModelCode.size()));
+    }
+    else
+    {
+        PRINT_ERROR("Cannot write the model to %s", mOutfileName.c_str());
+    }
     outfile.close();
     clear();
 }
@@ -621,9 +1359,15 @@ void
 Transcriber::clear()
 {
     mConstants.clear();
+    mComments.clear();
     mVariables.clear();
-    mTransitions.clear();
+    mCommands.clear();
     mLabels.clear();
+    mRemovedNodes.clear();
+    mFrozenNodes.clear();
+    mUnobservedLabels.clear();
+    mGroups.clear();
+    mGroupOf.clear();
 }
 
-}  // namespace graph
\ No newline at end of file
+}  // namespace graph
@@ -21,15 +21,24 @@
 #ifndef ERIS_GRAPH_INTERNAL_TRANSCRIBER_H
 #define ERIS_GRAPH_INTERNAL_TRANSCRIBER_H
 
+#include "errors.h"
+#include "expression.h"
+
+#include <QString>
+
 #include <fstream>
 #include <list>
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace graphInternal
 {
 class Node;
 class Edge;
+class MarkovChain;
 
 class Transcriber
 {
@@ -50,10 +59,69 @@ public:
     ~Transcriber();
 
     /**
-     * Starts the transformation to the given model.
+     * Starts the transformation to the given model. The constants, variables and commands of
+     * each node are kept between calls, only those of the changed nodes and of the nodes
+     * depending on them are regenerated.
+     * @param changed numbers of the nodes that changed since the last call, nullptr to
+     * regenerate all nodes
+     */
+    void
+    buildModel(const std::set<unsigned int>* changed = nullptr);
+
+    /**
+     * Sets the constants that are left undefined in the generated model, e.g. rn3SAFE, so that
+     * their values can be given to prism by -const. Used for parameter sweeps, all nodes are
+     * regenerated by the next buildModel().
+     * @param parameters names of the constants, see constantName()
+     */
+    void
+    setParameters(std::set<std::string> parameters);
+
+    /**
+     * Returns the name of the constant the given rate of a node is declared as, e.g. rn3SAFE in
+     * a CTMC or pn3SAFE in an MDP.
+     * @param number of the node
+     * @param suffix SEC, SAFE, GUAR, DEFREC or CORREC
+     * @return name of the constant
+     */
+    static std::string
+    constantName(unsigned int number, const std::string& suffix);
+
+    /**
+     * Sets the labels the experiment refers to, whose cone of influence the generated CTMC is
+     * restricted to if enabled, see setConeOfInfluence(). Takes effect with the next buildModel().
+     * @param labels names of the labels the experiment refers to, empty for all labels
+     */
+    void
+    setObservedLabels(std::set<std::string> labels);
+
+    /**
+     * Enables the reduction of a generated CTMC to the cone of influence of the observed labels
+     * (default off), see reduceConeOfInfluence(). Experiments that refer to node variables
+     * instead of labels need the complete model. Takes effect with the next buildModel().
+     * @param enabled true to drop the nodes and labels the observed labels do not depend on
+     */
+    void
+    setConeOfInfluence(bool enabled);
+
+    /**
+     * Enables the counter abstraction of interchangeable nodes in a generated CTMC (default off),
+     * see abstractSymmetries(). The counters tell how many members of a group are in a state but
+     * not which, hence experiments that refer to node variables need it off. Takes effect with
+     * the next buildModel().
+     * @param enabled true to count the members of groups of interchangeable nodes
      */
     void
-    buildModel();
+    setSymmetryAbstraction(bool enabled);
+
+    /**
+     * Adds the reward structure "time" to a generated CTMC (default off), which mean time
+     * properties such as R{"time"}=? [ F "systemfailure" ] refer to. Takes effect with the next
+     * buildModel().
+     * @param enabled true to write the reward structure
+     */
+    void
+    setTimeReward(bool enabled);
 
     /**
      * Sets the name of the outpit (.pm) file.
@@ -62,30 +130,213 @@ public:
     void
     setOutfileName(std::string name);
 
+    /**
+     * Returns the operational formula of the last built model.
+     * @return formula expression
+     */
+    Expression::Ptr
+    getOperationalFormula() const;
+
+    /**
+     * Returns the labels (name, formula) of the last built model.
+     * @return list of labels
+     */
+    const std::vector<std::pair<std::string, Expression::Ptr>>&
+    getLabelFormulas() const;
+
+    /**
+     * Returns the PRISM code of the last built model, i.e. the content of the output file, for
+     * consumers that would otherwise read the file back.
+     * @return model code
+     */
+    const std::string&
+    getModelCode() const;
+
 private:
     /**
-     * Creates a file for the PRISM Code and writes the generated variables, transitions etc in it.
+     * A command of a node, printed as
+     * [] (nX=source) & (conditions) & (operational) -> rate : (nX'=target) & (updates);
+     */
+    struct Command
+    {
+        Command(unsigned int node, int source, int target, std::string rate) :
+            node(node), source(source), target(target), rate(std::move(rate))
+        {
+        }
+
+        /** Number of the node whose variable is updated */
+        unsigned int node;
+        int source;
+        int target;
+
+        /** Rate expression, empty for PRISM's default rate 1 */
+        std::string rate;
+
+        /** Further conjuncts of the guard */
+        std::vector<std::string> conditions;
+
+        /** Further updates, i.e. of the internalfailure flag */
+        std::vector<std::string> updates;
+
+        /** Value of the node after the alternative 1-rate of an MDP, none if negative */
+        int otherwise = -1;
+
+        /** Numbers of the other nodes the conditions or the rate read (attacker, securing nodes) */
+        std::vector<unsigned int> reads;
+
+        /** Formulas the conditions refer to, nullptr if a formula cannot be parsed */
+        std::vector<Expression::Ptr> formulas;
+    };
+
+    /** A formula of a node, printed as formula name = body; */
+    struct Formula
+    {
+        std::string name;
+        std::string body;
+
+        /** Parsed body, nullptr if it cannot be parsed */
+        Expression::Ptr expression;
+    };
+
+    /** Generated PRISM code of a single node */
+    struct Fragment
+    {
+        std::vector<std::string> rates;
+        std::vector<Formula> formulas;
+        std::vector<Command> commands;
+
+        /** Whether the node has the variable nXinternalfailure */
+        bool internalFailure = false;
+
+        /** Warnings raised during generation, repeated whenever the fragment is reused */
+        std::vector<std::pair<widgets::Errors::Type, QString>> warnings;
+    };
+
+    /**
+     * Assembles the constants, formulas, variables, commands and labels of the fragments, taking
+     * the reductions into account, in mModelCode and writes it to the output file with a single
+     * write.
      */
     void
     generateFile();
 
     /**
-     * Parses the dependency graph and generates the automaton. Thereby the
-     * global Mode is checked to determine whether a CTMC or an MDP has to
-     * be build.
+     * Appends the lines to mModelCode, one per line.
+     */
+    void
+    appendLines(const std::vector<std::string>& lines);
+
+    /**
+     * Appends the variables and commands to mModelCode as set by Model::getModuleLayout() and
+     * Model::getVariableOrder(): the declarations (and commands) of each node, respectively of
+     * each group of interchangeable nodes, are appended in the order of their first node,
+     * either into a single module or into one module each.
+     */
+    void
+    appendModules();
+
+    /**
+     * Checks whether the variable of the node is written, i.e., the node is neither removed nor
+     * frozen nor counted by the first member of its group.
+     */
+    bool
+    isWritten(unsigned int number) const;
+
+    /**
+     * Returns the number of the node, respectively first group member, whose module declares
+     * the variable of the node.
+     */
+    unsigned int
+    getOwner(unsigned int number) const;
+
+    /**
+     * Prints the command, over the counters if its node is a member of a counted group.
+     */
+    std::string
+    printCommand(const Command& command) const;
+
+    /**
+     * Builds the operational formula and the labels from all nodes.
      */
     void
     buildAutomaton();
 
     /**
-     * Assembles the safety transition from the ok state to the defective state
-     * (n=0 -> n=1).
+     * Removes the nodes that cannot influence the observed labels (see
+     * MarkovChain::getConeOfInfluence()) from the model: their fragments are not written, nor
+     * are the labels that are not observed. Nodes of the cone that never leave ok are frozen,
+     * i.e. declared as constants without commands. The model is left unchanged if a kept
+     * command, formula or label refers to a removed node.
+     * @param chain compiled rules of the nodes
+     */
+    void
+    reduceConeOfInfluence(const MarkovChain& chain);
+
+    /**
+     * Replaces groups of interchangeable nodes (see MarkovChain::getSymmetryGroups()) by
+     * counters of their ok, defective and corrupted members, i.e., only the commands of the
+     * first member are written with rates multiplied by the number of members in the source
+     * state. The model is left unchanged if a member is read by a command (e.g. as attacker or
+     * securing node) or by an asymmetric formula. Groups with internalfailure flags or reduced
+     * members are not counted.
+     * @param chain compiled rules of the nodes
+     */
+    void
+    abstractSymmetries(const MarkovChain& chain);
+
+    /**
+     * Rewrites a formula that is symmetric in each of the groups over their counters.
+     * @param formula the formula over node variables
+     * @param groups node numbers of the interchangeable groups
+     * @return PRISM representation of the formula
+     */
+    std::string
+    countFormula(const Expression::Ptr& formula,
+                 const std::vector<std::vector<unsigned int>>& groups) const;
+
+    /**
+     * Generates the constants, formulas and commands of the given node into mFragment.
+     * Thereby the global Mode is checked to determine whether a CTMC or an MDP has to be build.
+     */
+    void
+    buildFragment(Node* node);
+
+    /**
+     * Returns the declaration of the given rate constant of the node, without a value if the
+     * constant is a parameter.
+     */
+    std::string
+    declareConstant(Node* node, const std::string& suffix, const std::string& value);
+
+    /**
+     * Checks whether the intrusion rate of the node or the guarantee of one of its securing
+     * nodes is a parameter.
+     */
+    bool
+    isParametric(Node* node) const;
+
+    /**
+     * Checks whether the fragment of the given node uses one of the changed nodes, i.e., the
+     * node itself, the nodes it reaches or their securing nodes changed.
+     */
+    bool
+    dependsOn(Node* node, const std::set<unsigned int>& changed);
+
+    /**
+     * Records the warning in the current fragment and forwards it to the error handler.
+     */
+    void
+    setError(const std::pair<widgets::Errors::Type, QString>& error);
+
+    /**
+     * Assembles the safety transition of the node from start to the defective state
+     * (n=0 -> n=1 or n=2 -> n=1).
      *
-     * @param init contains the initial guard setup
+     * @param start value of the node before the transition
      * @param node is a pointer to the current node
      */
     void
-    assembleSafetyTransition(const std::string& start, const std::string& end, Node* node);
+    assembleSafetyTransition(int start, Node* node);
 
     /**
      * Assembles the security transition and collects the security guarantees
@@ -93,11 +344,23 @@ private:
      * provided security guarantees, from the ok state to the corrupted state
      * of the node (n=0 -> n=2) are written.
      *
-     * @param init contains the initial guard setup
+     * @param attacker corrupted node the attack starts from, nullptr for the environment
      * @param node is a pointer to the current node
      */
     void
-    assembleSecurityTransition(const std::string& init, Node* node);
+    assembleSecurityTransition(Node* attacker, Node* node);
+
+    /**
+     * Assembles a single security transition (n=0 -> n=2) for a node with securing nodes. The
+     * guarantee of each securing node is deducted in the rate expression as long as the securing
+     * node is ok, i.e. rnSEC-(nj=0 ? rnjGUAR : 0)-..., instead of writing one transition per
+     * permutation of the securing nodes.
+     *
+     * @param transition command with the guard of the attack
+     * @param node is a pointer to the current node
+     */
+    void
+    assembleCompactSecurityTransition(Command transition, Node* node);
 
     /**
      * Assembles the recovery transition from a corruptive state of the current node and adds the
@@ -111,7 +374,14 @@ private:
      * transition and required constants to the global lists.
      */
     void
-    assembleDefRecoveryTransition(Node* node, const std::string& init, const std::string& end);
+    assembleDefRecoveryTransition(Node* node);
+
+    /**
+     * Adds the formula of a restricted or custom recovery strategy to mFragment and refers to it
+     * in the guard of the transition.
+     */
+    void
+    addRecoveryFormula(const std::string& name, const std::string& body, Command* transition);
 
     /**
      * Generates all permutations (0,1) by the given number of nodes (nodeCount)
@@ -150,10 +420,52 @@ private:
     std::string mOutfileName;
 
     std::vector<std::string> mConstants;
-    std::vector<std::string> mVariables;
-    std::vector<std::string> mTransitions;
+    std::vector<std::string> mComments;
     std::vector<std::string> mLabels;
 
+    /** Declarations and commands with the number of the node (or first group member) owning them */
+    std::vector<std::pair<unsigned int, std::string>> mVariables;
+    std::vector<std::pair<unsigned int, std::string>> mCommands;
+
+    /** PRISM code of the last built model, see getModelCode() */
+    std::string mModelCode;
+
+    /** Constants left undefined, see setParameters() */
+    std::set<std::string> mParameters;
+
+    /** Labels of the experiment, see setObservedLabels() */
+    std::set<std::string> mObservedLabels;
+
+    /** See setConeOfInfluence() */
+    bool mConeOfInfluence = false;
+
+    /** See setSymmetryAbstraction() */
+    bool mSymmetryAbstraction = false;
+
+    /** See setTimeReward() */
+    bool mTimeReward = false;
+
+    /** Nodes removed respectively frozen by reduceConeOfInfluence() in the last built model */
+    std::set<unsigned int> mRemovedNodes;
+    std::set<unsigned int> mFrozenNodes;
+
+    /** Labels dropped by reduceConeOfInfluence() in the last built model */
+    std::set<std::string> mUnobservedLabels;
+
+    /** Groups counted by abstractSymmetries() in the last built model, by member */
+    std::vector<std::vector<unsigned int>> mGroups;
+    std::map<unsigned int, size_t> mGroupOf;
+
+    /** Fragments of the last built model by node number */
+    std::map<unsigned int, Fragment> mFragments;
+
+    /** Fragment currently generated by buildFragment() */
+    Fragment* mFragment = nullptr;
+
+    /** Bare formulas of the last built model, see getOperationalFormula()/getLabelFormulas() */
+    Expression::Ptr mOperationalFormula;
+    std::vector<std::pair<std::string, Expression::Ptr>> mLabelFormulas;
+
     /** List of environment nodes */
     const std::vector<Node*>& mEnvNodes;
 
@@ -30,18 +30,29 @@
 #include "edge_item.h"
 #include "node_item.h"
 #include "transcriber.h"
+#include "markov_chain.h"
+#include "minimal_paths.h"
+#include "native_engine.h"
+#include "reachability.h"
+#include "model.h"
+#include "operational.h"
 #include "utils.h"
 #include "scene_status.h"
 #include "main_window.h"
 #include "xprism.h"
 #include "checks.h"
 
+#include <algorithm>
+#include <regex>
+#include <sstream>
 #include <utility>
 #include <QProcess>
+#include <QRegularExpression>
 #include <QLabel>
 
 namespace graphInternal
 {
+using eval::NativeEngine;
 using eval::XPrism;
 using widgets::ErrorHandler;
 using widgets::Errors;
@@ -55,11 +66,14 @@ Transformer::Transformer(GraphicScene* graphicScene) : mScene(graphicScene), mPr
 Transformer::~Transformer() = default;
 
 bool
-Transformer::start(const std::string& redundancyDefinition, const std::string& outFileName)
+Transformer::start(const std::string& redundancyDefinition,
+                   const std::string& outFileName,
+                   const QString& experimentDoc)
 {
     ERIS_CHECK(!outFileName.empty());
     mRedundancy = redundancyDefinition;
     mOutFileName = outFileName;
+    mExperimentDoc = experimentDoc;
     mRunning = true;
 
     mProcess.reset(new (std::nothrow) QProcess());
@@ -84,26 +98,65 @@ Transformer::stop()
 bool
 Transformer::transform(std::string& outfile)
 {
-    std::vector<Node*> envNodes;
-    std::vector<Node*> nodes;
-    if (generateLogicRepresentation(envNodes, nodes))
+    std::set<unsigned int> changed;
+    bool rebuilt = false;
+    if (!updateLogicRepresentation(&changed, &rebuilt))
+    {  // something went wrong
+        return false;
+    }
+
+    if (rebuilt)
     {
+        mTranscriber.reset();
+    }
+    prepareTranscriber(mEnvNodes, mNodes, mRedundancy, outfile, mExperimentDoc, &mTranscriber);
+    mTranscriber->setOutfileName(outfile);
+    mTranscriber->buildModel(rebuilt ? nullptr : &changed);
 
-        std::sort(nodes.begin(), nodes.end(),[] (Node* const& n1, Node* const& n2) 
-        {return n1->getNumber() < n2->getNumber(); });
+    if (Model::getInstance().getType() == Model::CTMC)
+    {
+        if (rebuilt || !changed.empty() || mMarkovChain == nullptr)
+        {
+            mMarkovChain = std::make_shared<MarkovChain>(mNodes,
+                                                         mTranscriber->getOperationalFormula(),
+                                                         mTranscriber->getLabelFormulas());
+        }
+        if (!mMarkovChain->isValid())
+        {
+            PRINT_INFO("Native evaluation not available : %s", mMarkovChain->getError().c_str());
+        }
+    }
+    else
+    {
+        mMarkovChain.reset();
+    }
 
+    mScene->setStateChanged(false);
+    // DeprecatedSceneStatus::getInstance().setChanged(false);
+    return true;
+}
 
-        Transcriber transcriber(envNodes, nodes, mRedundancy, outfile);
-        transcriber.buildModel();
+std::shared_ptr<MarkovChain>
+Transformer::getMarkovChain() const
+{
+    return mMarkovChain;
+}
 
-        mScene->setStateChanged(false);
-        // DeprecatedSceneStatus::getInstance().setChanged(false);
-        return true;
-    }
-    else
-    {  // something went wrong
+bool
+Transformer::writeParametricModel(const std::set<std::string>& parameters,
+                                  const std::string& outFileName)
+{
+    if (mNodes.empty())
+    {
         return false;
     }
+    // A separate transcriber, the kept fragments of mTranscriber stay valid
+    std::unique_ptr<Transcriber> transcriber(
+            new Transcriber(mEnvNodes, mNodes, mRedundancy, outFileName));
+    prepareTranscriber(mEnvNodes, mNodes, mRedundancy, outFileName, mExperimentDoc, &transcriber);
+    transcriber->setParameters(parameters);
+    transcriber->buildModel();
+    return true;
 }
 
 bool
@@ -121,6 +174,48 @@ Transformer::getNodeById(const std::vector<Node*>& nodes, unsigned int id, Node*
     return false;
 }
 
+void
+Transformer::prepareTranscriber(const std::vector<Node*>& envNodes,
+                                const std::vector<Node*>& nodes,
+                                const std::string& redundancy,
+                                const std::string& outFileName,
+                                const QString& experimentDoc,
+                                std::unique_ptr<Transcriber>* transcriber)
+{
+    if (*transcriber == nullptr)
+    {
+        Reachability::compute(envNodes, nodes);
+        auto minimalPaths = std::make_shared<MinimalPaths>(nodes);
+        for (Node* node : nodes)
+        {
+            node->setMinimalPaths(minimalPaths);
+        }
+        transcriber->reset(new Transcriber(envNodes, nodes, redundancy, outFileName));
+    }
+    // the native engine parses experiments that refer to labels only, others may refer to node
+    // variables as well and need the complete model without counters
+    std::vector<NativeEngine::Property> properties;
+    if (NativeEngine::supportedProperties(experimentDoc, &properties))
+    {
+        std::set<std::string> observedLabels;
+        for (const NativeEngine::Property& property : properties)
+        {
+            observedLabels.insert(property.label);
+        }
+        (*transcriber)->setObservedLabels(std::move(observedLabels));
+        (*transcriber)->setConeOfInfluence(true);
+        (*transcriber)->setSymmetryAbstraction(true);
+    }
+    else
+    {
+        (*transcriber)->setObservedLabels({});
+        (*transcriber)->setConeOfInfluence(false);
+        (*transcriber)->setSymmetryAbstraction(false);
+    }
+    static const QRegularExpression timeReward(R"(R\s*\{\s*"time"\s*\})");
+    (*transcriber)->setTimeReward(experimentDoc.contains(timeReward));
+}
+
 bool
 Transformer::startSimulationProcess(NodeItem* nodeItem)
 {
@@ -194,11 +289,8 @@ Transformer::startSimulationProcess(NodeItem* nodeItem)
 }
 
 bool
-Transformer::generateLogicRepresentation(std::vector<Node*>& envNodes,
-                                         std::vector<Node*>& otherNodes)
+Transformer::updateLogicRepresentation(std::set<unsigned int>* changed, bool* rebuilt)
 {
-    Node* node;
-    Edge* edge;
     std::vector<NodeItem*> envNodeItems;
     std::vector<NodeItem*> nodeItems;
     std::vector<EdgeItem*> edgeItems;
@@ -209,11 +301,42 @@ Transformer::generateLogicRepresentation(std::vector<Node*>& envNodes,
         ErrorHandler::getInstance().setError(Errors::missingNodes());
         return false;
     }
-    for (NodeItem* envNodeItem : envNodeItems)
+
+    // Everything the edges, reachability, minimal paths and the transcriber setup depend on
+    std::string structure = std::to_string(Model::getInstance().getType()) + ","
+                            + std::to_string(Model::getInstance().getSecurityEncoding()) + ","
+                            + std::to_string(Operational::getInstance().getMode()) + ","
+                            + std::to_string(Model::getInstance().getModuleLayout()) + ","
+                            + std::to_string(Model::getInstance().getVariableOrder()) + ","
+                            + mRedundancy + ";";
+    for (NodeItem* nodeItem : envNodeItems)
+    {
+        structure += "e" + std::to_string(nodeItem->getId()) + ";";
+    }
+    for (NodeItem* nodeItem : nodeItems)
+    {
+        structure += "n" + std::to_string(nodeItem->getId()) + ","
+                     + std::to_string(static_cast<int>(nodeItem->getComponentType())) + ";";
+    }
+    for (EdgeItem* edgeItem : edgeItems)
     {
-        node = new Node(envNodeItem->getComponentType(), envNodeItem->getId());
-        envNodes.push_back(node);
+        structure += std::to_string(edgeItem->startItem()->getId()) + "-"
+                     + std::to_string(edgeItem->endItem()->getId()) + ","
+                     + std::to_string(static_cast<int>(edgeItem->getComponentType())) + ";";
     }
+
+    *rebuilt = structure != mStructure;
+    if (*rebuilt)
+    {
+        mStructure.clear();
+        if (!generateLogicRepresentation(envNodeItems, nodeItems, edgeItems))
+        {
+            return false;
+        }
+        mStructure = structure;
+        return true;
+    }
+
     for (NodeItem* nodeItem : nodeItems)
     {
         if (!mRunning)
@@ -222,28 +345,81 @@ Transformer::generateLogicRepresentation(std::vector<Node*>& envNodes,
             ErrorHandler::getInstance().setError(Errors::transformationStopped());
             return false;
         }
+        auto& generatedFrom = mItemRevisions[nodeItem->getId()];
+        if (generatedFrom.first == nodeItem && generatedFrom.second == nodeItem->getRevision())
+        {
+            continue;
+        }
+        Node* node;
+        if (!getNodeById(mNodes, nodeItem->getId(), node))
+        {  // Should not happen as the structure did not change
+            mStructure.clear();
+            return false;
+        }
+        node->setAttributes(nodeItem->isRecoverableFromDefect(),
+                            nodeItem->isRecoverableFromCorruption(),
+                            nodeItem->getIntrusionIndicator().toStdString(),
+                            nodeItem->getFailureIndicator().toStdString(),
+                            nodeItem->getSecurityIndicator().toStdString(),
+                            nodeItem->getDefectRecoveryIndicator().toStdString(),
+                            nodeItem->getCorruptionRecoveryIndicator().toStdString(),
+                            nodeItem->getEssentialNodes().toStdString(),
+                            nodeItem->getCustomCorruptionRecoveryFormula().toStdString(),
+                            nodeItem->getCorruptionRecoveryStrategy(),
+                            nodeItem->getCustomDefectRecoveryFormula().toStdString(),
+                            nodeItem->getDefectRecoveryStrategy());
+        generatedFrom = std::make_pair(nodeItem, nodeItem->getRevision());
+        changed->insert(nodeItem->getId());
+    }
+    return true;
+}
 
-        node = new Node(nodeItem->getComponentType(),
-                        nodeItem->getId(),
-                        nodeItem->isRecoverableFromDefect(),
-                        nodeItem->isRecoverableFromCorruption(),
-                        nodeItem->getIntrusionIndicator().toStdString(),
-                        nodeItem->getFailureIndicator().toStdString(),
-                        nodeItem->getSecurityIndicator().toStdString(),
-                        nodeItem->getDefectRecoveryIndicator().toStdString(),
-                        nodeItem->getCorruptionRecoveryIndicator().toStdString(),
-                        nodeItem->getEssentialNodes().toStdString(),
-                        nodeItem->getCustomCorruptionRecoveryFormula().toStdString(),
-                        nodeItem->getCorruptionRecoveryStrategy(),
-                        nodeItem->getCustomDefectRecoveryFormula().toStdString(),
-                        nodeItem->getDefectRecoveryStrategy());
+bool
+Transformer::generateLogicRepresentation(const std::vector<NodeItem*>& envNodeItems,
+                                         const std::vector<NodeItem*>& nodeItems,
+                                         const std::vector<EdgeItem*>& edgeItems)
+{
+    mEnvNodes.clear();
+    mNodes.clear();
+    mEdges.clear();
+    mNodeStore.clear();
+    mItemRevisions.clear();
+    mTranscriber.reset();
 
-    
-        otherNodes.push_back(node);
+    for (NodeItem* envNodeItem : envNodeItems)
+    {
+        mNodeStore.emplace_back(new Node(envNodeItem->getComponentType(), envNodeItem->getId()));
+        mEnvNodes.push_back(mNodeStore.back().get());
+    }
+    for (NodeItem* nodeItem : nodeItems)
+    {
+        if (!mRunning)
+        {  // Stop was requested
+            ErrorHandler::getInstance().clearCollection();
+            ErrorHandler::getInstance().setError(Errors::transformationStopped());
+            return false;
+        }
+
+        mNodeStore.emplace_back(new Node(nodeItem->getComponentType(),
+                                         nodeItem->getId(),
+                                         nodeItem->isRecoverableFromDefect(),
+                                         nodeItem->isRecoverableFromCorruption(),
+                                         nodeItem->getIntrusionIndicator().toStdString(),
+                                         nodeItem->getFailureIndicator().toStdString(),
+                                         nodeItem->getSecurityIndicator().toStdString(),
+                                         nodeItem->getDefectRecoveryIndicator().toStdString(),
+                                         nodeItem->getCorruptionRecoveryIndicator().toStdString(),
+                                         nodeItem->getEssentialNodes().toStdString(),
+                                         nodeItem->getCustomCorruptionRecoveryFormula().toStdString(),
+                                         nodeItem->getCorruptionRecoveryStrategy(),
+                                         nodeItem->getCustomDefectRecoveryFormula().toStdString(),
+                                         nodeItem->getDefectRecoveryStrategy()));
+        mNodes.push_back(mNodeStore.back().get());
+        mItemRevisions[nodeItem->getId()] = std::make_pair(nodeItem, nodeItem->getRevision());
     }
 
-    std::vector<Node*> totalNodes = envNodes;
-    totalNodes.insert(totalNodes.end(), otherNodes.begin(), otherNodes.end());
+    std::vector<Node*> totalNodes = mEnvNodes;
+    totalNodes.insert(totalNodes.end(), mNodes.begin(), mNodes.end());
 
     for (EdgeItem* edgeItem : edgeItems)
     {
@@ -255,37 +431,136 @@ Transformer::generateLogicRepresentation(std::vector<Node*>& envNodes,
             // unsuccessfully!
             return false;
         }
-        edge = new Edge(start, end, edgeItem->getComponentType());
-        start->addEdge(edge);
-        end->addEdge(edge);
+        mEdges.emplace_back(new Edge(start, end, edgeItem->getComponentType()));
+        start->addEdge(mEdges.back().get());
+        end->addEdge(mEdges.back().get());
+    }
+    processRedundancy(mRedundancy, mNodes);
+
+    std::sort(mNodes.begin(), mNodes.end(), [](Node* const& n1, Node* const& n2) {
+        return n1->getNumber() < n2->getNumber();
+    });
+    return true;
+}
+
+bool
+Transformer::parseRedundancy(const std::string& redundancy,
+                             std::vector<std::pair<unsigned int, unsigned int>>* pairs,
+                             std::vector<VotingGroup>* groups)
+{
+    static const std::regex pairTerm(R"(^\s*[nN](\d+)\s*=\s*[nN](\d+)\s*$)");
+    static const std::regex groupTerm(R"(^\s*(\d+)\s*oo\s*(\d+)\s*\(([^()]*)\)\s*$)");
+    static const std::regex member(R"(^\s*[nN](\d+)\s*$)");
+
+    // Separate the terms by the commas outside of the groups
+    std::vector<std::string> terms(1);
+    int depth = 0;
+    for (char c : redundancy)
+    {
+        depth += c == '(' ? 1 : c == ')' ? -1 : 0;
+        if (c == ',' && depth == 0)
+        {
+            terms.emplace_back();
+        }
+        else
+        {
+            terms.back() += c;
+        }
+    }
+
+    std::vector<std::pair<unsigned int, unsigned int>> parsedPairs;
+    std::vector<VotingGroup> parsedGroups;
+    std::set<unsigned int> grouped;
+    std::set<unsigned int> paired;
+    for (const std::string& term : terms)
+    {
+        std::smatch match;
+        if (std::regex_match(term, match, pairTerm))
+        {
+            const unsigned int first = std::stoul(match[1].str());
+            const unsigned int second = std::stoul(match[2].str());
+            parsedPairs.emplace_back(first, second);
+            paired.insert(first);
+            paired.insert(second);
+            continue;
+        }
+        if (!std::regex_match(term, match, groupTerm))
+        {
+            return false;
+        }
+        VotingGroup group{static_cast<unsigned int>(std::stoul(match[1].str())), {}};
+        const unsigned long size = std::stoul(match[2].str());
+        std::stringstream ss(match[3].str());
+        std::string token;
+        while (getline(ss, token, ','))
+        {
+            std::smatch number;
+            if (!std::regex_match(token, number, member))
+            {
+                return false;
+            }
+            group.members.push_back(std::stoul(number[1].str()));
+            if (!grouped.insert(group.members.back()).second)
+            {  // duplicate member or member of another group
+                return false;
+            }
+        }
+        if (group.members.size() != size || size < 2 || group.required < 1
+            || group.required > size)
+        {
+            return false;
+        }
+        parsedGroups.push_back(std::move(group));
+    }
+    for (unsigned int number : paired)
+    {
+        if (grouped.count(number) != 0)
+        {
+            return false;
+        }
+    }
+
+    if (pairs != nullptr)
+    {
+        pairs->swap(parsedPairs);
+    }
+    if (groups != nullptr)
+    {
+        groups->swap(parsedGroups);
     }
-    processRedundancy(otherNodes);
     return true;
 }
 
 void
-Transformer::processRedundancy(const std::vector<Node*>& nodes)
+Transformer::processRedundancy(const std::string& redundancy, const std::vector<Node*>& nodes)
 {
-    std::regex nodeElem("(n[0-9][0-9]*)");
-    // Iterate over redundancy string. Seperate by "," delimiter
-    std::string token;
-    std::stringstream ss(mRedundancy);
+    std::vector<std::pair<unsigned int, unsigned int>> pairs;
+    std::vector<VotingGroup> groups;
+    parseRedundancy(redundancy, &pairs, &groups);
     Node* nodeA;
     Node* nodeB;
-    std::string redundantStr;
-    while (getline(ss, token, ','))
+    for (const auto& pair : pairs)
     {  // node redundancies are separated, collect nodes and add the logic!
-        std::regex elem("(n[0-9][0-9]*)");
-        std::sregex_iterator iter(token.begin(), token.end(), elem);
-        unsigned int idA = std::stoi(std::string((*iter)[1]).substr(1));
-        iter++;
-        unsigned int idB = std::stoi(std::string((*iter)[1]).substr(1));
-
-        getNodeById(nodes, idA, nodeA);
-        getNodeById(nodes, idB, nodeB);
-        
-        nodeA->addRedundantNode(nodeB);
-        nodeB->addRedundantNode(nodeA);
+        if (getNodeById(nodes, pair.first, nodeA) && getNodeById(nodes, pair.second, nodeB))
+        {
+            nodeA->addRedundantNode(nodeB);
+            nodeB->addRedundantNode(nodeA);
+        }
+    }
+    for (const VotingGroup& group : groups)
+    {
+        std::vector<Node*> members;
+        for (unsigned int number : group.members)
+        {
+            if (getNodeById(nodes, number, nodeA))
+            {
+                members.push_back(nodeA);
+            }
+        }
+        for (Node* node : members)
+        {
+            node->setVotingGroup(group.required, members);
+        }
     }
 
     ErrorHandler::getInstance().clear();
@@ -26,7 +26,13 @@
 
 #include <QObject>
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 class QProcess;
@@ -35,6 +41,7 @@ QT_END_NAMESPACE
 namespace graph
 {
 class NodeItem;
+class EdgeItem;
 class GraphicScene;
 }
 
@@ -42,6 +49,8 @@ namespace graphInternal
 {
 class Node;
 class Edge;
+class MarkovChain;
+class Transcriber;
 
 class ERIS_EXPORT Transformer : public QObject
 {
@@ -52,8 +61,17 @@ public:
     ~Transformer() override;
 
     // TODO Move to another thread
+    /**
+     * Transforms the scene and writes the generated model to the given file.
+     * @param redundancyDefinition redundancy definition, e.g. "n1=n5, 2oo3(n2,n3,n4)"
+     * @param outFileName path of the .pm file
+     * @param experimentDoc experiment the model is generated for, see prepareTranscriber()
+     * @return true if successful, false otherwise
+     */
     bool
-    start(const std::string& redundancyDefinition, const std::string& outFileName);
+    start(const std::string& redundancyDefinition,
+          const std::string& outFileName,
+          const QString& experimentDoc);
 
     /**
      * Attempts a graceful shutdown of the transformation process by killing the Simulation Process
@@ -70,6 +88,88 @@ public:
     void
     DeprecatedTransformationFinished(bool success);
 
+    /**
+     * Returns the markov chain compiled during the last transformation, which can be evaluated
+     * natively instead of running PRISM. Only available for CTMC models.
+     * @return the chain, nullptr if not available
+     */
+    std::shared_ptr<MarkovChain>
+    getMarkovChain() const;
+
+    /**
+     * Writes the logic graph of the last transformation as a parametric model, i.e. the given
+     * rate constants are left undefined, see Transcriber::setParameters().
+     * @param parameters names of the constants, e.g. rn3SAFE
+     * @param outFileName path of the .pm file
+     * @return true if written, false if no transformation was done yet
+     */
+    bool
+    writeParametricModel(const std::set<std::string>& parameters, const std::string& outFileName);
+
+    /** k-out-of-n group of a redundancy definition, e.g. "2oo3(n2,n3,n4)" */
+    struct VotingGroup
+    {
+        unsigned int required;
+        std::vector<unsigned int> members;
+    };
+
+    /**
+     * Splits a redundancy definition into its pairs of redundant nodes ("n1=n2") and its
+     * k-out-of-n groups ("2oo3(n2,n3,n4)"), separated by commas. A group requires 1 to n of its
+     * n distinct members, a node may only be a member of one group and not of a pair.
+     * @param redundancy redundancy definition, e.g. "n1=n5, 2oo3(n2,n3,n4)"
+     * @param pairs vector the node numbers of the pairs are stored in (may be null)
+     * @param groups vector the groups are stored in (may be null)
+     * @return true if the definition is valid, false otherwise
+     */
+    static bool
+    parseRedundancy(const std::string& redundancy,
+                    std::vector<std::pair<unsigned int, unsigned int>>* pairs,
+                    std::vector<VotingGroup>* groups);
+
+    /**
+     * Sets the redundant nodes of the parsed nodes given by the redundancy definition.
+     * Thereby a pointer to the twin node object is added in the viewed node, the members of
+     * k-out-of-n groups share the group.
+     * @param redundancy redundancy definition, e.g. "n1=n5, 2oo3(n2,n3,n4)"
+     * @param nodes
+     */
+    static void
+    processRedundancy(const std::string& redundancy, const std::vector<Node*>& nodes);
+
+    /**
+     * Iterates overall nodes and searches for the node with the provided ID. If found, the node is
+     * stored in the provided reference and true is returned.
+     * @param nodes list of nodes
+     * @param id of searched node
+     * @param node reference to store the found node in
+     * @return true if found, false otherwise
+     */
+    static bool
+    getNodeById(const std::vector<Node*>& nodes, unsigned int id, Node*& node);
+
+    /**
+     * Prepares the transcription of a logic graph, shared by the GUI and the batch mode. If no
+     * transcriber is given, the reachability and the minimal path sets of the nodes are computed
+     * and a new transcriber is created. The transcriber is then configured for the experiment:
+     * the generated CTMC is only reduced to the labels of the experiment and its interchangeable
+     * nodes are only counted if the experiment refers to labels and to nothing else, the time
+     * reward is only added if the experiment uses it.
+     * @param envNodes environment nodes
+     * @param nodes all other nodes
+     * @param redundancy redundancy definition
+     * @param outFileName path of the .pm file
+     * @param experimentDoc experiment the model is generated for, empty if unknown
+     * @param transcriber transcriber to configure, created if null
+     */
+    static void
+    prepareTranscriber(const std::vector<Node*>& envNodes,
+                       const std::vector<Node*>& nodes,
+                       const std::string& redundancy,
+                       const std::string& outFileName,
+                       const QString& experimentDoc,
+                       std::unique_ptr<Transcriber>* transcriber);
+
 signals:
 
     void
@@ -87,35 +187,30 @@ private:
     transform(std::string& outfile);
 
     /**
-     * Parses all scene items and converts them to analysis nodes and edges. Sets redundancy
-     * definition and essential nodes etc.
-     * Fills the given vectors with the nodes and edge and sets the error handler if necessary.
-     * @param envNodes vector to push the env nodes to
-     * @param otherNodes vector to push other nodes to
-     * @return true if generation was successful, false otherwise
+     * Brings the persistent logic graph up to date with the scene. If the structure (nodes,
+     * edges, redundancy, model type) changed, the graph is rebuilt, otherwise only the nodes
+     * whose NodeItem revision changed are updated in place.
+     * @param changed set the numbers of the updated nodes are inserted to
+     * @param rebuilt set to true if the whole graph was rebuilt
+     * @return true if successful, false otherwise (error handler is set)
      */
     bool
-    generateLogicRepresentation(std::vector<Node*>& envNodes, std::vector<Node*>& otherNodes);
+    updateLogicRepresentation(std::set<unsigned int>* changed, bool* rebuilt);
 
     /**
-     * Sets the redundant nodes of the parsed nodes given by the globally set 
-     * redundancy definition. Thereby a pointer to the twin node object is added
-     * in the viewed node.
-     * @param nodes
-     */
-    void
-    processRedundancy(const std::vector<Node*>& nodes);
-
-    /**
-     * Iterates overall nodes and searches for the node with the provided ID. If found, the node is
-     * stored in the provided reference and true is returned.
-     * @param nodes list of nodes
-     * @param id of searched node
-     * @param node reference to store the found node in
-     * @return true if found, false otherwise
+     * Parses all scene items and converts them to analysis nodes and edges. Sets redundancy
+     * definition and essential nodes etc.
+     * Replaces the logic graph and sets the error handler if necessary.
+     * @param envNodeItems environment node items of the scene
+     * @param nodeItems other node items of the scene
+     * @param edgeItems edge items of the scene
+     * @return true if generation was successful, false otherwise
      */
     bool
-    getNodeById(const std::vector<Node*>& nodes, unsigned int id, Node*& node);
+    generateLogicRepresentation(const std::vector<graph::NodeItem*>& envNodeItems,
+                                const std::vector<graph::NodeItem*>& nodeItems,
+                                const std::vector<graph::EdgeItem*>& edgeItems);
+
 
     /**
      * Starts the simulation of the subsystem using octave. The returned results
@@ -135,8 +230,35 @@ private:
 
     std::string mOutFileName;
 
+    /** Experiment of the current transformation, see start() */
+    QString mExperimentDoc;
+
     std::unique_ptr<QProcess> mProcess;
 
+    /** Owner of the nodes of the logic graph */
+    std::vector<std::unique_ptr<Node>> mNodeStore;
+
+    /** Owner of the edges of the logic graph */
+    std::vector<std::unique_ptr<Edge>> mEdges;
+
+    /** Environment nodes of the logic graph */
+    std::vector<Node*> mEnvNodes;
+
+    /** All other nodes of the logic graph, sorted by number */
+    std::vector<Node*> mNodes;
+
+    /** NodeItem and its revision each node was last generated from, by node number */
+    std::map<unsigned int, std::pair<graph::NodeItem*, uint64_t>> mItemRevisions;
+
+    /** Structure the logic graph was built from, empty if it has to be rebuilt */
+    std::string mStructure;
+
+    /** Transcriber of the logic graph, keeps the generated code of unchanged nodes */
+    std::unique_ptr<Transcriber> mTranscriber;
+
+    /** Chain of the last transformation (CTMC only) */
+    std::shared_ptr<MarkovChain> mMarkovChain;
+
     bool mRunning = false;
 };
 
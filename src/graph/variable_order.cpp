@@ -0,0 +1,164 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "variable_order.h"
+
+#include "expression.h"
+#include "node.h"
+
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+
+namespace graphInternal
+{
+std::vector<std::vector<unsigned int>>
+VariableOrder::dependencies(const std::vector<Node*>& nodes)
+{
+    std::unordered_map<unsigned int, unsigned int> index;
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+    {
+        index[nodes[i]->getNumber()] = i;
+    }
+    std::vector<std::vector<unsigned int>> adjacency(nodes.size());
+    auto connect = [&](unsigned int from, unsigned int number) {
+        auto iter = index.find(number);
+        if (iter != index.end() && iter->second != from)
+        {  // environment nodes are not declared
+            adjacency[from].push_back(iter->second);
+            adjacency[iter->second].push_back(from);
+        }
+    };
+
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+    {
+        Node* node = nodes[i];
+        for (Node* reachable : node->getReachableNodes())
+        {
+            connect(i, reachable->getNumber());
+        }
+        for (Node* securing : node->getSecuringNodes())
+        {
+            connect(i, securing->getNumber());
+        }
+        for (Node* redundant : node->getRedundantNodes())
+        {
+            connect(i, redundant->getNumber());
+        }
+        for (Node* member : node->getVotingGroup())
+        {
+            connect(i, member->getNumber());
+        }
+        if (node->getEssentialExpression() != nullptr)
+        {
+            std::vector<unsigned int> essentials;
+            node->getEssentialExpression()->collectNodes(&essentials);
+            for (unsigned int number : essentials)
+            {
+                connect(i, number);
+            }
+        }
+    }
+    for (std::vector<unsigned int>& neighbours : adjacency)
+    {
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+    return adjacency;
+}
+
+std::vector<Node*>
+VariableOrder::reverseCuthillMcKee(const std::vector<Node*>& nodes)
+{
+    const std::vector<std::vector<unsigned int>> adjacency = dependencies(nodes);
+    auto before = [&](unsigned int a, unsigned int b) {
+        if (adjacency[a].size() != adjacency[b].size())
+        {
+            return adjacency[a].size() < adjacency[b].size();
+        }
+        return nodes[a]->getNumber() < nodes[b]->getNumber();
+    };
+
+    std::vector<unsigned int> starts(nodes.size());
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+    {
+        starts[i] = i;
+    }
+    std::sort(starts.begin(), starts.end(), before);
+
+    std::vector<bool> visited(nodes.size(), false);
+    std::vector<unsigned int> order;
+    order.reserve(nodes.size());
+    std::deque<unsigned int> queue;
+    for (unsigned int start : starts)
+    {
+        if (visited[start])
+        {
+            continue;
+        }
+        visited[start] = true;
+        queue.push_back(start);
+        while (!queue.empty())
+        {
+            const unsigned int current = queue.front();
+            queue.pop_front();
+            order.push_back(current);
+            std::vector<unsigned int> next;
+            for (unsigned int neighbour : adjacency[current])
+            {
+                if (!visited[neighbour])
+                {
+                    visited[neighbour] = true;
+                    next.push_back(neighbour);
+                }
+            }
+            std::sort(next.begin(), next.end(), before);
+            queue.insert(queue.end(), next.begin(), next.end());
+        }
+    }
+
+    std::vector<Node*> result;
+    result.reserve(order.size());
+    for (auto iter = order.rbegin(); iter != order.rend(); ++iter)
+    {
+        result.push_back(nodes[*iter]);
+    }
+    return result;
+}
+
+unsigned int
+VariableOrder::bandwidth(const std::vector<Node*>& order)
+{
+    const std::vector<std::vector<unsigned int>> adjacency = dependencies(order);
+    unsigned int bandwidth = 0;
+    for (unsigned int i = 0; i < adjacency.size(); ++i)
+    {
+        for (unsigned int neighbour : adjacency[i])
+        {  // the adjacency is symmetric, the larger index suffices
+            if (neighbour > i)
+            {
+                bandwidth = std::max(bandwidth, neighbour - i);
+            }
+        }
+    }
+    return bandwidth;
+}
+
+}  // namespace graphInternal
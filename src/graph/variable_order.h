@@ -0,0 +1,73 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_GRAPH_INTERNAL_VARIABLE_ORDER_H
+#define ERIS_GRAPH_INTERNAL_VARIABLE_ORDER_H
+
+#include <vector>
+
+namespace graphInternal
+{
+class Node;
+
+/**
+ * Orders the nodes for the variable declarations of the generated model. PRISM's symbolic
+ * engines order the MTBDD variables as declared, and an MTBDD stays small if variables that
+ * interact are close to each other.
+ *
+ * The dependency graph connects each node with the nodes it reaches, its securing, essential and
+ * redundant nodes and the members of its voting group, regardless of the direction. It is
+ * ordered by reverse Cuthill-McKee: a breadth first search per component, starting at a node of
+ * minimal degree and visiting the neighbours by increasing degree, in reverse. This keeps the
+ * bandwidth of the dependency graph small, i.e. every node is declared close to the nodes it
+ * depends on.
+ */
+class VariableOrder
+{
+public:
+    /**
+     * Computes the reverse Cuthill-McKee order of the given nodes. Ties are broken by the node
+     * number, hence the order is deterministic.
+     * @param nodes all nodes excluding the environment nodes
+     * @return the nodes in declaration order
+     */
+    static std::vector<Node*>
+    reverseCuthillMcKee(const std::vector<Node*>& nodes);
+
+    /**
+     * Computes the bandwidth of the dependency graph in the given order, i.e. the maximal
+     * distance of two connected nodes. Used to report the quality of an order.
+     * @param order nodes in declaration order
+     * @return bandwidth, 0 if no nodes are connected
+     */
+    static unsigned int
+    bandwidth(const std::vector<Node*>& order);
+
+private:
+    /**
+     * Builds the undirected dependency graph over the indices of the given nodes.
+     */
+    static std::vector<std::vector<unsigned int>>
+    dependencies(const std::vector<Node*>& nodes);
+};
+
+}  // namespace graphInternal
+
+#endif /* ERIS_GRAPH_INTERNAL_VARIABLE_ORDER_H */
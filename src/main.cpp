@@ -24,6 +24,8 @@
 #include "main_window_manager.h"
 #include "prism.h"
 #include "error_handler.h"
+#include "batch_evaluator.h"
+#include "logger.h"
 
 #include <QApplication>
 #include <QDesktopWidget>
@@ -31,7 +33,12 @@
 #include <QFile>
 
 #include <QCommandLineParser>
+#include <QCoreApplication>
 #include <QFileInfo>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cstring>
 
 #if IS_LINUX
 
@@ -65,12 +72,152 @@ handler(int sig)
 
 using widgets::MainWindow;
 
+/**
+ * Evaluates the model files given on the command line without any window (eris --batch).
+ * @return exit code
+ */
+static int
+runBatch(QCoreApplication& app)
+{
+    using eval::BatchEvaluator;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Evaluates ERIS models without a window and writes the "
+                                     "results to stdout.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("models", "Paths to eris models i.e. </home/model.xml> .",
+                                 "<model.xml>...");
+    QCommandLineOption batch_opt("batch", "Headless batch mode.");
+    QCommandLineOption model_path_opt(QStringList() << "m"
+                                                    << "eris-model",
+                                      "Path to an eris model i.e. </home/model.xml> .",
+                                      "path");
+    QCommandLineOption properties_opt(QStringList() << "p"
+                                                    << "properties",
+                                      "Experiment (.pctl) to evaluate, defaults to systemfailure, "
+                                      "defective and corrupted.",
+                                      "path");
+    QCommandLineOption interval_opt(QStringList() << "i"
+                                                  << "interval",
+                                    "Experiment interval T=from:steps:to (default 0:1:10).",
+                                    "from:steps:to",
+                                    "0:1:10");
+    QCommandLineOption format_opt(QStringList() << "f"
+                                                << "format",
+                                  "Output format, csv or json (default csv).",
+                                  "format",
+                                  "csv");
+    QCommandLineOption jobs_opt(QStringList() << "j"
+                                              << "jobs",
+                                "Number of models evaluated concurrently (default 1).",
+                                "N",
+                                "1");
+    QCommandLineOption prism_opt("prism", "Always use the prism command line tool.");
+    QCommandLineOption rare_event_opt(
+            "rare-event",
+            "Estimate CTMC experiments by importance sampling (for very small probabilities).");
+    QCommandLineOption bounded_opt(
+            "bounded",
+            "Explore only states with few failed nodes, up to the given truncation error.",
+            "tolerance");
+    QCommandLineOption no_header_opt("no-header", "Omit the CSV header.");
+    no_header_opt.setFlags(QCommandLineOption::HiddenFromHelp);
+    parser.addOptions({batch_opt, model_path_opt, properties_opt, interval_opt, format_opt,
+                       jobs_opt, prism_opt, rare_event_opt, bounded_opt,
+                       no_header_opt});
+    parser.process(app);
+
+    QStringList models = parser.positionalArguments();
+    if (parser.isSet(model_path_opt))
+    {
+        models.prepend(parser.value(model_path_opt));
+    }
+    if (models.isEmpty())
+    {
+        PRINT_ERROR("No model given");
+        return 1;
+    }
+
+    BatchEvaluator::Options options;
+    if (parser.isSet(properties_opt))
+    {
+        QFile properties(parser.value(properties_opt));
+        if (!properties.open(QFile::ReadOnly | QFile::Text))
+        {
+            PRINT_ERROR("Cannot read %s", parser.value(properties_opt).toStdString().c_str());
+            return 1;
+        }
+        options.experimentDoc = QString::fromUtf8(properties.readAll());
+        options.experimentPath = QFileInfo(properties).absoluteFilePath();
+    }
+
+    QString interval = parser.value(interval_opt);
+    if (interval.startsWith("T="))
+    {
+        interval.remove(0, 2);
+    }
+    const QStringList bounds = interval.split(":");
+    bool ok = bounds.size() == 3;
+    if (ok)
+    {
+        bool fromOk = false;
+        bool stepsOk = false;
+        bool toOk = false;
+        options.interval = eval::ExperimentInterval(
+                bounds[0].toInt(&fromOk), bounds[2].toInt(&toOk), bounds[1].toInt(&stepsOk));
+        ok = fromOk && stepsOk && toOk && options.interval.from >= 0
+             && options.interval.to >= options.interval.from;
+    }
+    if (!ok)
+    {
+        PRINT_ERROR("Invalid interval %s", parser.value(interval_opt).toStdString().c_str());
+        return 1;
+    }
+
+    if (parser.value(format_opt) == "json")
+    {
+        options.format = BatchEvaluator::Format::json;
+    }
+    else if (parser.value(format_opt) != "csv")
+    {
+        PRINT_ERROR("Unknown format %s", parser.value(format_opt).toStdString().c_str());
+        return 1;
+    }
+    options.jobs = std::max(1, parser.value(jobs_opt).toInt());
+    options.forcePrism = parser.isSet(prism_opt);
+    options.rareEvent = parser.isSet(rare_event_opt);
+    if (parser.isSet(bounded_opt))
+    {
+        bool toleranceOk = false;
+        options.truncationTolerance = parser.value(bounded_opt).toDouble(&toleranceOk);
+        if (!toleranceOk || options.truncationTolerance <= 0.0)
+        {
+            PRINT_ERROR("Invalid tolerance %s", parser.value(bounded_opt).toStdString().c_str());
+            return 1;
+        }
+    }
+    options.header = !parser.isSet(no_header_opt);
+
+    QTextStream out(stdout);
+    return BatchEvaluator(options).run(models, &out);
+}
+
 int
 main(int argc, char* argv[])
 {
 #if IS_LINUX
     signal(SIGSEGV, handler);
 #endif
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--batch") == 0)
+        {  // No window, hence no display is required. stdout only carries the results.
+            utils::Logger::getInstance().setInfoStream(stderr);
+            QCoreApplication app(argc, argv);
+            return runBatch(app);
+        }
+    }
+
     QApplication app(argc, argv);
     
     // This is needed to ensure that qt signals are connected
@@ -90,6 +237,11 @@ main(int argc, char* argv[])
             QCoreApplication::translate("main", "Path to an eris model i.e. </home/model.xml> ."),
             QCoreApplication::translate("main", "path"));
     parser.addOption(model_path_opt);
+    QCommandLineOption batch_opt(
+            "batch",
+            QCoreApplication::translate("main",
+                                        "Evaluate models without a window, see --batch --help."));
+    parser.addOption(batch_opt);
     parser.process(app);
 
     const QStringList args = parser.positionalArguments();
@@ -75,5 +75,29 @@ Command::isRunning()
 {
     return state() == QProcess::Running;
 }
+bool
+Command::waitUntilFinished(const std::atomic_bool* cancelled)
+{
+    if (cancelled == nullptr)
+    {
+        waitForFinished(-1);
+        return true;
+    }
+    while (!waitForFinished(100))
+    {
+        if (state() == QProcess::NotRunning)
+        {
+            return true;
+        }
+        if (cancelled->load(std::memory_order_acquire))
+        {
+            PRINT_INFO("Cancelled : %s ", program().toStdString().c_str());
+            kill();
+            waitForFinished(-1);
+            return false;
+        }
+    }
+    return true;
+}
 
 }  // namespace base
\ No newline at end of file
@@ -23,6 +23,8 @@
 #define ERIS_COMMAND_H
 
 #include <QProcess>
+
+#include <atomic>
 namespace utils
 {
 //
@@ -45,6 +47,11 @@ public:
 
     virtual bool
     isRunning() final;
+
+    /// Blocks until the process finished, kills it once |cancelled| is set.
+    /// Returns false if the process was killed.
+    bool
+    waitUntilFinished(const std::atomic_bool* cancelled);
 };
 
 }  // namespace base
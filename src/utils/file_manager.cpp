@@ -31,6 +31,9 @@
 #include "node_settings_validator.h"
 #include "string_utils.h"
 #include "file_manager_fields.h"
+#include "node.h"
+#include "edge.h"
+#include "transformer.h"
 
 #include <QColor>
 #include <QFile>
@@ -42,10 +45,18 @@
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
+#include <algorithm>
+
 namespace utils
 {
 using widgets::ErrorHandler;
 using widgets::Errors;
+using graphInternal::Edge;
+using graphInternal::Node;
+
+LogicModel::LogicModel() = default;
+
+LogicModel::~LogicModel() = default;
 
 FileManager::FileManager(GraphicScene* scene) : mScene(scene)
 {
@@ -721,6 +732,223 @@ FileManager::read(QString fileName, bool passive)
     return true;
 }
 
+bool
+FileManager::readLogicNode(QXmlStreamReader* xmlReader, LogicModel* model)
+{
+    const QXmlStreamAttributes attributes = xmlReader->attributes();
+    QString curr = attributes.value(kId).toString();
+    bool ok = false;
+    const unsigned int id = curr.toUInt(&ok);
+    if (!ok)
+    {
+        ErrorHandler::getInstance().setError(Errors::iDInvalid(curr));
+        return false;
+    }
+    for (const auto& node : model->nodeStore)
+    {
+        if (node->getNumber() == id)
+        {
+            ErrorHandler::getInstance().setError(Errors::nodeAlreadyExists(id));
+            return false;
+        }
+    }
+
+    curr = attributes.value(kComponentType).toString();
+    if (curr.isEmpty() || !utils::isValidComponentType(curr.toStdString(), id))
+    {
+        ErrorHandler::getInstance().setError(Errors::componentTypeUndefined(id));
+        return false;
+    }
+    const ComponentType type = ComponentType(curr.toUInt());
+    if (type == ComponentType::environmentNode)
+    {
+        model->nodeStore.emplace_back(new Node(type, id));
+        model->envNodes.push_back(model->nodeStore.back().get());
+        return true;
+    }
+    if (type != ComponentType::normalNode && type != ComponentType::criticalNode)
+    {
+        ErrorHandler::getInstance().setError(Errors::componentTypeOutOfBounds(id));
+        return false;
+    }
+    if (attributes.value(kSubmodule).toString() == kTrue
+        || attributes.value(kSimulated).toString() == kTrue)
+    {
+        PRINT_WARNING("Node %u is a module, its stored rates are used", id);
+    }
+
+    // Rates as read by readNodes()
+    std::string indicators[5];
+    const char* const fields[5] = {kIntrusion, kFailure, kSecurity, kDefRecIndicator,
+                                   kCorrRecIndicator};
+    const char* const names[5] = {"Intrusion", "Failure", "Security", "Defect Recovery",
+                                  "Corruption Recovery"};
+    for (int i = 0; i < 5; ++i)
+    {
+        curr = attributes.value(fields[i]).toString();
+        indicators[i] = curr.isEmpty() ? kDefaultZero : curr.toStdString();
+        if (!utils::isValidInputValue(indicators[i], names[i], Model::getInstance().getType()))
+        {
+            return false;
+        }
+    }
+
+    Recovery::Strategy strategies[2] = {Recovery::Strategy::general, Recovery::Strategy::general};
+    const char* const strategyFields[2] = {kDefRecStrategy, kCorrRecStrategy};
+    for (int i = 0; i < 2; ++i)
+    {
+        curr = attributes.value(strategyFields[i]).toString();
+        if (curr.isEmpty())
+        {  // older format
+            continue;
+        }
+        if (!utils::isValidRecoveryStrategy(curr, id))
+        {
+            return false;
+        }
+        strategies[i] = Recovery::fromString(curr);
+    }
+
+    model->nodeStore.emplace_back(
+            new Node(type,
+                     id,
+                     attributes.value(kRecoverableDef).toString() == kTrue,
+                     attributes.value(kRecoverableCorr).toString() == kTrue,
+                     indicators[0],
+                     indicators[1],
+                     indicators[2],
+                     indicators[3],
+                     indicators[4],
+                     attributes.value(kEssentialNodes).toString().toStdString(),
+                     attributes.value(kCustomCorrRecFormula).toString().toStdString(),
+                     strategies[1],
+                     attributes.value(kCustomDefRecFormula).toString().toStdString(),
+                     strategies[0]));
+    model->nodes.push_back(model->nodeStore.back().get());
+    return true;
+}
+
+bool
+FileManager::readLogic(const QString& fileName, LogicModel* model)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        ErrorHandler::getInstance().setError(Errors::openFileError(fileName));
+        return false;
+    }
+
+    QXmlStreamReader xmlReader(&file);
+    std::vector<std::pair<std::pair<unsigned int, unsigned int>, ComponentType>> edges;
+    while (!xmlReader.atEnd() && !xmlReader.hasError())
+    {
+        xmlReader.readNext();
+        if (!xmlReader.isStartElement())
+        {
+            continue;
+        }
+        if (xmlReader.name() == kProperties)
+        {
+            const QString modelType = xmlReader.attributes().value("Model").toString();
+            Model::getInstance().setType(
+                    modelType == Model::getInstance().getTypeAsString(Model::Type::MDP)
+                            ? Model::MDP
+                            : Model::CTMC);
+        }
+        else if (xmlReader.name() == kNode)
+        {
+            if (!readLogicNode(&xmlReader, model))
+            {
+                return false;
+            }
+        }
+        else if (xmlReader.name() == kEdge)
+        {
+            edges.emplace_back(
+                    std::make_pair(xmlReader.attributes().value(kEdgeStart).toUInt(),
+                                   xmlReader.attributes().value(kEdgeEnd).toUInt()),
+                    ComponentType(xmlReader.attributes().value(kComponentType).toUInt()));
+        }
+        else if (xmlReader.name() == kDefinition)
+        {
+            model->redundancy = xmlReader.attributes().value(kRedundancy).toString().toStdString();
+        }
+    }
+    if (xmlReader.hasError())
+    {
+        ErrorHandler::getInstance().setError(Errors::openFileError(fileName));
+        return false;
+    }
+    if (model->nodes.empty())
+    {
+        ErrorHandler::getInstance().setError(Errors::missingNodes());
+        return false;
+    }
+
+    std::vector<Node*> totalNodes = model->envNodes;
+    totalNodes.insert(totalNodes.end(), model->nodes.begin(), model->nodes.end());
+    for (const auto& edge : edges)
+    {
+        Node* start;
+        Node* end;
+        if (!graphInternal::Transformer::getNodeById(totalNodes, edge.first.first, start)
+            || !graphInternal::Transformer::getNodeById(totalNodes, edge.first.second, end))
+        {  // dangling edge
+            return false;
+        }
+        if (start == end)
+        {
+            ErrorHandler::getInstance().setError(Errors::selfEdges());
+            return false;
+        }
+        model->edges.emplace_back(new Edge(start, end, edge.second));
+        start->addEdge(model->edges.back().get());
+        end->addEdge(model->edges.back().get());
+    }
+
+    // Same checks as isValidRedundancyDefinition(), but against the logic nodes
+    if (!model->redundancy.empty())
+    {
+        std::vector<std::pair<unsigned int, unsigned int>> pairs;
+        std::vector<graphInternal::Transformer::VotingGroup> groups;
+        if (!graphInternal::Transformer::parseRedundancy(model->redundancy, &pairs, &groups))
+        {
+            ErrorHandler::getInstance().setError(Errors::redundancySyntacticallyIncorrect());
+            return false;
+        }
+        std::vector<unsigned int> ids;
+        for (const auto& pair : pairs)
+        {
+            ids.push_back(pair.first);
+            ids.push_back(pair.second);
+        }
+        for (const auto& group : groups)
+        {
+            ids.insert(ids.end(), group.members.begin(), group.members.end());
+        }
+        for (unsigned int id : ids)
+        {
+            Node* node;
+            if (!graphInternal::Transformer::getNodeById(model->nodes, id, node))
+            {
+                ErrorHandler::getInstance().setError(Errors::noNodeWithId(id));
+                return false;
+            }
+            if (!node->isCritical())
+            {
+                ErrorHandler::getInstance().setError(Errors::nonCriticalNodeRedundant());
+                return false;
+            }
+        }
+        graphInternal::Transformer::processRedundancy(model->redundancy, model->nodes);
+    }
+
+    std::sort(model->nodes.begin(), model->nodes.end(), [](Node* const& n1, Node* const& n2) {
+        return n1->getNumber() < n2->getNumber();
+    });
+    return true;
+}
+
 std::string
 FileManager::getRedundancyDefinition()
 {
@@ -25,6 +25,10 @@
 
 #include <QString>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 class QColor;
 class QFile;
@@ -36,6 +40,12 @@ class QXmlStreamReader;
 class QXmlStreamWriter;
 QT_END_NAMESPACE
 
+namespace graphInternal
+{
+class Edge;
+class Node;
+}
+
 using namespace graph;
 
 namespace utils
@@ -43,6 +53,26 @@ namespace utils
 class Model;
 class GraphicScene;
 
+/**
+ * Logic representation of a model file, i.e. the nodes and edges the Transformer generates from
+ * a scene. It allows to evaluate a model without a scene (and without a display).
+ */
+struct LogicModel
+{
+    LogicModel();
+    ~LogicModel();
+
+    std::vector<std::unique_ptr<graphInternal::Node>> nodeStore;
+    std::vector<std::unique_ptr<graphInternal::Edge>> edges;
+
+    std::vector<graphInternal::Node*> envNodes;
+
+    /** All other nodes, sorted by number */
+    std::vector<graphInternal::Node*> nodes;
+
+    std::string redundancy;
+};
+
 /**
  * Manager that handles read and write actions on files to store and load scenes from/to XML.
  * @param scene
@@ -71,6 +101,18 @@ public:
     bool
     read(QString fileName, bool passive);
 
+    /**
+     * Reads the file given by filename into its logic representation without building a graphic
+     * scene. Submodules are not opened, the rates stored in module nodes are used as they are.
+     * The model type of the file is set globally.
+     * @param fileName input file
+     * @param model logic representation to fill
+     * @return false if the file could not be read or is invalid (error handler is set),
+     * true otherwise
+     */
+    static bool
+    readLogic(const QString& fileName, LogicModel* model);
+
     /**
      * Writes the current scene into a file provided by filename.
      * @param fileName input file
@@ -148,6 +190,15 @@ private:
               std::map<NodeItem*, std::pair<std::string, std::string>>* customs,
               bool passive);
 
+    /**
+     * Helper function of readLogic() that converts a node element into a logic node.
+     * @param xmlReader reader positioned at the node element
+     * @param model logic representation the node is added to
+     * @return false if the node is invalid (error handler is set), true otherwise
+     */
+    static bool
+    readLogicNode(QXmlStreamReader* xmlReader, LogicModel* model);
+
     /**
      * Helper function that reads all edge items from the file and adds them to the scene.
      * @param xmlWriter
@@ -0,0 +1,109 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "job.h"
+
+#include "command.h"
+#include "logger.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QProcessEnvironment>
+
+namespace utils
+{
+namespace
+{
+bool
+isWritableDirectory(const QString& path)
+{
+    const QFileInfo info(path);
+    return !path.isEmpty() && info.isDir() && info.isWritable();
+}
+}  // namespace
+
+Job::Job(const QString& name) : mDirectory(root() + "/eris_" + name + "_XXXXXX")
+{
+    if (!mDirectory.isValid())
+    {
+        PRINT_ERROR("Failed to create a scratch directory in %s : %s",
+                    root().toStdString().c_str(),
+                    mDirectory.errorString().toStdString().c_str());
+    }
+}
+
+Job::~Job() = default;
+
+bool
+Job::isValid() const
+{
+    return mDirectory.isValid();
+}
+
+QString
+Job::errorString() const
+{
+    return mDirectory.errorString();
+}
+
+QString
+Job::path() const
+{
+    return mDirectory.path();
+}
+
+QString
+Job::filePath(const QString& fileName) const
+{
+    return mDirectory.filePath(fileName);
+}
+
+void
+Job::attach(Command* command) const
+{
+    command->setWorkingDirectory(path());
+    QProcessEnvironment environment = command->processEnvironment();
+    if (environment.isEmpty())
+    {
+        environment = QProcessEnvironment::systemEnvironment();
+    }
+    environment.insert("TMPDIR", path());
+    command->setProcessEnvironment(environment);
+}
+
+QString
+Job::root()
+{
+    static const QString root = [] {
+        const QString runtime = qEnvironmentVariable("XDG_RUNTIME_DIR");
+        if (isWritableDirectory(runtime))
+        {
+            return QDir(runtime).absolutePath();
+        }
+        if (isWritableDirectory("/dev/shm"))
+        {
+            return QString("/dev/shm");
+        }
+        return QDir::tempPath();
+    }();
+    return root;
+}
+
+}  // namespace utils
@@ -0,0 +1,103 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_UTILS_JOB_H
+#define ERIS_UTILS_JOB_H
+
+#include "eris_config.h"
+
+#include <QString>
+#include <QTemporaryDir>
+
+namespace utils
+{
+class Command;
+
+/**
+ * Scratch directory of a single evaluation job, e.g. one run of PRISM or Octave. Every job owns
+ * a unique directory for its temporaries (experiment, results, ...), hence evaluations from
+ * several tabs or several ERIS processes in the same directory do not overwrite each other's
+ * files. The directory is created on a tmpfs if available (see root()) and removed with all its
+ * content when the job is destroyed.
+ *
+ * Usage scenario:
+ * Job job("experiment");
+ * if (!job.isValid()) ... error, see job.errorString()
+ * job.attach(command);  // runs within job.path()
+ * command->setArguments(QStringList() << model << job.filePath("experiment.pctl") ...);
+ */
+class ERIS_EXPORT Job
+{
+public:
+    ERIS_DISALLOW_COPY_AND_ASSIGN(Job);
+
+    /**
+     * Creates the scratch directory.
+     * @param name part of the directory name, identifies the kind of job in the file system
+     */
+    explicit Job(const QString& name);
+    ~Job();
+
+    /**
+     * @return true if the scratch directory was created
+     */
+    bool
+    isValid() const;
+
+    /**
+     * @return reason why the scratch directory could not be created
+     */
+    QString
+    errorString() const;
+
+    /**
+     * @return absolute path of the scratch directory
+     */
+    QString
+    path() const;
+
+    /**
+     * @return absolute path of the given file within the scratch directory
+     */
+    QString
+    filePath(const QString& fileName) const;
+
+    /**
+     * Runs the command within the scratch directory, its temporaries (TMPDIR) included. Relative
+     * paths among the arguments of the command must be resolved before.
+     */
+    void
+    attach(Command* command) const;
+
+    /**
+     * Returns the directory the scratch directories are created in: $XDG_RUNTIME_DIR or
+     * /dev/shm, both are usually memory backed, and the temporary directory of the system
+     * otherwise.
+     */
+    static QString
+    root();
+
+private:
+    QTemporaryDir mDirectory;
+};
+
+}  // namespace utils
+
+#endif  // ERIS_UTILS_JOB_H
@@ -52,10 +52,17 @@ Logger::levelName(Level level)
     }
 }
 
-Logger::Logger() : lock_()
+Logger::Logger() : lock_(), infoStream_(stdout)
 {
 }
 
+void
+Logger::setInfoStream(FILE* stream)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    infoStream_ = stream;
+}
+
 void
 Logger::log(Level level,
             const char* file,
@@ -66,7 +73,7 @@ Logger::log(Level level,
 {
     std::lock_guard<std::mutex> guard(lock_);
 
-    FILE* stream = stdout;
+    FILE* stream = infoStream_;
 
     switch (level)
     {
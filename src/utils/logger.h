@@ -127,6 +127,13 @@ public:
         const char* format,
         va_list args);
 
+    //
+    // Sets the stream of the info and debug messages (stdout by default), errors and warnings
+    // are always written to stderr.
+    //
+    void
+    setInfoStream(FILE* stream);
+
     ERIS_DISALLOW_COPY_AND_ASSIGN(Logger);
 
 private:
@@ -136,6 +143,7 @@ private:
 
 private:
     std::mutex lock_;
+    FILE* infoStream_;
 };
 
 void
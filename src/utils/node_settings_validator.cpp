@@ -26,8 +26,10 @@
 #include "graphic_scene.h"
 #include "error_handler.h"
 #include "errors.h"
+#include "expression.h"
 #include "node_item.h"
 #include "string_utils.h"
+#include "transformer.h"
 #include <QGraphicsScene>
 #include <QFileInfo>
 #include <algorithm>
@@ -35,6 +37,8 @@
 #include <string>
 
 using namespace widgets;
+using graphInternal::Expression;
+using graphInternal::Transformer;
 
 namespace utils
 {
@@ -148,27 +152,21 @@ isValidEssentialNodes(std::string essentialNodes, NodeItem* nodeItem)
     ErrorHandler& errorHandler = ErrorHandler::getInstance();
     if (!essentialNodes.empty())
     {
-        std::regex reg("^((\\(?n|N)[0-9][0-9]*[ ]*=[ ]*[0-2])[ ]*\\)?[ ]*([|&][ ]*"
-                       "(\\(?n|N)[0-9][0-9]*[ ]*=[ ]*[0-2]\\)?[ ]*)*");
-        if (!std::regex_match(essentialNodes, reg))
+        Expression::Ptr expression = Expression::parse(essentialNodes);
+        if (expression == nullptr || !expression->isStateFormula())
         {  // input is syntactically incorrect
             errorHandler.setError(Errors::essentialNodeSyntacticallyIncorrect(nodeItem->getId()));
             return false;
         }
-        // at this point the string is syntactically correct so we can only view the number
-        std::regex elem("(n[0-9][0-9]*)");
-        std::sregex_iterator iter(essentialNodes.begin(), essentialNodes.end(), elem);
-        std::sregex_iterator end;
-        std::string id;
-        while (iter != end)
+        std::vector<unsigned int> ids;
+        expression->collectNodes(&ids);
+        for (unsigned int id : ids)
         {
-            id = std::string((*iter)[1]).substr(1);
-            if (!nodeItem->providesFunctionality(std::stoi(id)))
+            if (!nodeItem->providesFunctionality(id))
             {  // if no functional edge from the node exists, the expression is invalid/useless
                 errorHandler.setError(Errors::essentialNodeDoesNotProvideFunctionality());
                 return false;
             }
-            ++iter;
         }
     }
     return true;
@@ -180,22 +178,17 @@ isValidRecoveryFormula(std::string recoveryFormula, QGraphicsScene* scene)
     ErrorHandler& errorHandler = ErrorHandler::getInstance();
     if (!recoveryFormula.empty())
     {
-        std::regex reg("^((\\(?n|N)[0-9][0-9]*[ ]*=[ ]*[0-2])[ ]*\\)?[ ]*([|&][ ]*"
-                       "(\\(?n|N)[0-9][0-9]*[ ]*=[ ]*[0-2]\\)?[ ]*)*");
-        if (!std::regex_match(recoveryFormula, reg))
+        Expression::Ptr expression = Expression::parse(recoveryFormula);
+        if (expression == nullptr || !expression->isStateFormula())
         {  // input is syntactically incorrect
             errorHandler.setError(Errors::recoveryFormulaSyntacticallyIncorrect());
             return false;
         }
-        // at this point the string is syntactically correct so we can only view the number
-        std::regex elem("(n[0-9][0-9]*)");
-        std::sregex_iterator iter(recoveryFormula.begin(), recoveryFormula.end(), elem);
-        std::sregex_iterator end;
-        unsigned int id;
-        bool exists = false;
-        while (iter != end)
+        std::vector<unsigned int> ids;
+        expression->collectNodes(&ids);
+        for (unsigned int id : ids)
         {
-            id = stoi(std::string((*iter)[1]).substr(1));
+            bool exists = false;
             for (QGraphicsItem* item : scene->items())
             {
                 if (item->type() == NodeItem::Type)
@@ -212,8 +205,6 @@ isValidRecoveryFormula(std::string recoveryFormula, QGraphicsScene* scene)
                 errorHandler.setError(Errors::customRecoveryNodeDoesNotExist(id));
                 return false;
             }
-            exists = false;
-            ++iter;
         }
     }
     return true;
@@ -222,27 +213,28 @@ isValidRecoveryFormula(std::string recoveryFormula, QGraphicsScene* scene)
 bool
 isValidRedundancyDefinition(std::string redundancy, GraphicScene* scene)
 {
-    // regex that allows multiple nodes at once: "^([ ]*(n|N)[0-9][0-9]*[ ]*=[ ]*(n|N)[0-9][0-9]*[
-    // ]*)([=[ ]*(n|N)[0-9][0-9]*[ ]*|,[ ])*" Allows: n1=n2, n3= n4 .... disallows n3=n2=n1
-    std::regex reg("^([ ]*(n|N)[0-9][0-9]*[ ]*=[ ]*(n|N)[0-9][0-9]*[ ]*)(,[ ]*(n|N)[0-9][0-9]*"
-                   "[ ]*=[ ]*(n|N)[0-9][0-9]*[ ]*)*");
-    if (std::regex_match(redundancy, reg))
+    // Allows: n1=n2, n3= n4, 2oo3(n5, n6, n7) .... disallows n3=n2=n1 and 4oo3(n5, n6, n7)
+    std::vector<std::pair<unsigned int, unsigned int>> pairs;
+    std::vector<Transformer::VotingGroup> groups;
+    if (Transformer::parseRedundancy(redundancy, &pairs, &groups))
     {
-        std::regex elem("(n[0-9][0-9]*)");  // match nodes
-        std::sregex_iterator iter(redundancy.begin(), redundancy.end(), elem);
-        std::sregex_iterator end;
-        while (iter != end)
+        std::vector<unsigned int> ids;
+        for (const auto& pair : pairs)
+        {
+            ids.push_back(pair.first);
+            ids.push_back(pair.second);
+        }
+        for (const auto& group : groups)
+        {
+            ids.insert(ids.end(), group.members.begin(), group.members.end());
+        }
+        for (unsigned int id : ids)
         {
-            unsigned int id = std::stoi(std::string((*iter)[1]).substr(1));
             if (scene->nodeExists(id))
             {
                 NodeItem* nodeItem;
                 scene->getNodeItemById(id, &nodeItem, true);
-                if (nodeItem->isCritical())
-                {
-                    ++iter;
-                }
-                else
+                if (!nodeItem->isCritical())
                 {
                     ErrorHandler::getInstance().clear();
                     ErrorHandler::getInstance().setError(Errors::nonCriticalNodeRedundant());
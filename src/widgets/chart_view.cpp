@@ -99,6 +99,11 @@ ChartView::clear()
     mPlot.clear();
 }
 void
+ChartView::addResults(const QMap<QString, QList<QPointF>>& results)
+{
+    mPlot.addLineSeries(results);
+}
+void
 ChartView::customMenuRequested(QPoint pos)
 {
     mContextMenu->popup(mChartView->viewport()->mapToGlobal(pos));
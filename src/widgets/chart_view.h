@@ -50,6 +50,13 @@ public:
     void
     clear();
 
+    /**
+     * Adds the curves to the plot without going through the results parser, e.g. for the
+     * results of a parameter sweep. Must be called from the GUI thread.
+     */
+    void
+    addResults(const QMap<QString, QList<QPointF>>& results);
+
 protected:
     
     void
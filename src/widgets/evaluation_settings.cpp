@@ -30,12 +30,16 @@
 #include <QToolTip>
 #include <QFormLayout>
 #include <QCheckBox>
+#include <QComboBox>
+#include <QDoubleSpinBox>
 #include <QLabel>
 #include <QSpinBox>
 
 #define SYSTEMFAILURE "P=? [ F[T,T] \"systemfailure\" ]"
 #define DEFECTIVE "P=? [ F[T,T] \"defective\" ]"
 #define CORRUPTED "P=? [ F[T,T] \"corrupted\" ]"
+#define STEADY_STATE(label) "S=? [ \"" label "\" ]"
+#define MEAN_TIME(label) "R{\"time\"}=? [ F \"" label "\" ]"
 
 static widgets::EvaluationSettingsDialog* instance = nullptr;
 
@@ -98,21 +102,53 @@ EvaluationSettingsDialog::EvaluationSettingsDialog(QWidget* parent) : QDialog(pa
     intervalSteps->setMaximum(1000);
     intervalStepsLabel = new QLabel("Steps [-1]");
 
+    engineSelection = new QComboBox();
+    engineSelection->addItem("Native (CTMC only)");
+    engineSelection->addItem("PRISM");
+    engineSelection->addItem("Simulation (CTMC only)");
+    engineSelection->addItem("Rare Event Simulation (CTMC only)");
+
+    simulationPrecision = new QDoubleSpinBox();
+    simulationPrecision->setDecimals(4);
+    simulationPrecision->setRange(0.0001, 0.1);
+    simulationPrecision->setSingleStep(0.001);
+    simulationPrecision->setValue(0.01);
+    simulationPrecision->setToolTip("Half width of the 95% confidence intervals");
+    simulationPrecision->setEnabled(false);
+
+    truncationSelection = new QComboBox();
+    truncationSelection->addItem("Off", 0.0);
+    truncationSelection->addItem("Error < 1e-3", 1e-3);
+    truncationSelection->addItem("Error < 1e-6", 1e-6);
+    truncationSelection->addItem("Error < 1e-9", 1e-9);
+    truncationSelection->setToolTip(
+            "Explores only states with few failed or corrupted nodes, the truncation error is "
+            "plotted as an upper bound of each result");
+
+    propertySelection = new QComboBox();
+    propertySelection->addItem("Transient");
+    propertySelection->addItem("Steady State");
+    propertySelection->addItem("Mean Time To Failure");
+    propertySelection->setToolTip(
+            "Probabilities at the time points of the interval, long-run probabilities (e.g. the "
+            "steady-state unavailability of recoverable models) or mean times until the labels "
+            "hold (e.g. the MTTF)");
+
     auto hboxLayout = new QHBoxLayout();
     hboxLayout->addWidget(systemFailureButton);
     hboxLayout->addWidget(defectiveButton);
     hboxLayout->addWidget(corruptedButton);
 
     formLayout->addRow("Experiment Properties  ", hboxLayout);
+    formLayout->addRow("Property Kind", propertySelection);
     formLayout->addWidget(editor);
     formLayout->addRow(intervalLabel, intervalSlider);
     formLayout->addRow(intervalStepsLabel, intervalSteps);
+    formLayout->addRow("Engine", engineSelection);
+    formLayout->addRow("Simulation Precision", simulationPrecision);
+    formLayout->addRow("Bounded Exploration", truncationSelection);
 
-    QString defaultContent;
-    defaultContent = "const double T;\n" SYSTEMFAILURE "\n" DEFECTIVE "\n"
-                     "\n" CORRUPTED "\n";
-
-    editor->setPlainText(defaultContent);
+    updateProperties(0);
 
     QFont font = editor->font();
     font.setPointSize(14);
@@ -130,12 +166,21 @@ EvaluationSettingsDialog::EvaluationSettingsDialog(QWidget* parent) : QDialog(pa
             &QCheckBox::stateChanged,
             this,
             &EvaluationSettingsDialog::updateEditor);
+    connect(propertySelection,
+            QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this,
+            &EvaluationSettingsDialog::updateProperties);
     connect(this, &QDialog::finished, this, &EvaluationSettingsDialog::dialogClosed);
     connect(intervalSlider,
             &QSlider::valueChanged,
             this,
             &EvaluationSettingsDialog::updateInterval);
     connect(intervalSteps, SIGNAL(valueChanged(int)), this, SLOT(updateIntervalSteps(int)));
+    connect(engineSelection, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            [this](int index) {
+                simulationPrecision->setEnabled(index == 2);
+                truncationSelection->setEnabled(index == 0);
+            });
 
     setLayout(formLayout);
     intervalSlider->setValue(2);
@@ -152,6 +197,29 @@ EvaluationSettingsDialog::updateEditor(int)
     editor->markAsUnchecked("corrupted", !corruptedButton->isChecked());
 }
 
+void
+EvaluationSettingsDialog::updateProperties(int kind)
+{
+    QString content;
+    switch (kind)
+    {
+        case 1:
+            content = STEADY_STATE("systemfailure") "\n" STEADY_STATE("defective") "\n"
+                      "\n" STEADY_STATE("corrupted") "\n";
+            break;
+        case 2:
+            content = MEAN_TIME("systemfailure") "\n" MEAN_TIME("defective") "\n"
+                      "\n" MEAN_TIME("corrupted") "\n";
+            break;
+        default:
+            content = "const double T;\n" SYSTEMFAILURE "\n" DEFECTIVE "\n"
+                      "\n" CORRUPTED "\n";
+            break;
+    }
+    editor->setPlainText(content);
+    updateEditor(0);
+}
+
 void
 EvaluationSettingsDialog::experimentDocument(QString& output,
                                              eval::ExperimentInterval* interval)
@@ -185,6 +253,33 @@ EvaluationSettingsDialog::experimentDocument(QString& output,
     interval->steps = intervalSteps->value();
 }
 
+bool
+EvaluationSettingsDialog::nativeEngineSelected() const
+{
+    return engineSelection->currentIndex() == 0;
+}
+
+bool
+EvaluationSettingsDialog::simulationSelected() const
+{
+    return engineSelection->currentIndex() == 2 || engineSelection->currentIndex() == 3;
+}
+
+eval::TransientSimulator::Options
+EvaluationSettingsDialog::simulationOptions() const
+{
+    eval::TransientSimulator::Options options;
+    options.halfWidth = simulationPrecision->value();
+    options.importanceSampling = engineSelection->currentIndex() == 3;
+    return options;
+}
+
+double
+EvaluationSettingsDialog::truncationTolerance() const
+{
+    return nativeEngineSelected() ? truncationSelection->currentData().toDouble() : 0.0;
+}
+
 void
 EvaluationSettingsDialog::dialogClosed(int)
 {
@@ -22,6 +22,7 @@
 #define ERIS_WIDGETS_EVALUATION_SETTINGS_H
 
 #include "experiment.h"
+#include "transient_simulator.h"
 
 #include <QDialog>
 #include <QSlider>
@@ -29,6 +30,8 @@
 QT_BEGIN_NAMESPACE
 class QFormLayout;
 class QCheckBox;
+class QComboBox;
+class QDoubleSpinBox;
 class QLabel;
 class QSpinBox;
 QT_END_NAMESPACE
@@ -71,6 +74,26 @@ public:
     void
     experimentDocument(QString& output, eval::ExperimentInterval* interval);
 
+    // Whether CTMC experiments should be evaluated in-process instead of
+    // running PRISM. PRISM is still used when the native engine does not
+    // support the model or the properties.
+    bool
+    nativeEngineSelected() const;
+
+    // Whether CTMC experiments should be estimated by simulation, e.g. for
+    // models whose state space is too large for the native engine, or by
+    // importance sampling for very small probabilities.
+    bool
+    simulationSelected() const;
+
+    eval::TransientSimulator::Options
+    simulationOptions() const;
+
+    // Accepted truncation error of the failure depth bounded exploration of
+    // the native engine, 0 to explore the full state space.
+    double
+    truncationTolerance() const;
+
 private slots:
     
     void
@@ -78,6 +101,11 @@ private slots:
     
     void
     updateEditor(int);
+
+    // Replaces the properties of the editor by the templates of the
+    // selected kind (transient, steady state, mean time to failure).
+    void
+    updateProperties(int kind);
     
     void
     updateInterval(int);
@@ -97,8 +125,12 @@ private:
     QCheckBox* corruptedButton;
     FancySlider* intervalSlider;
     QLabel* intervalLabel;
+    QComboBox* propertySelection;
     QSpinBox* intervalSteps;
     QLabel* intervalStepsLabel;
+    QComboBox* engineSelection;
+    QDoubleSpinBox* simulationPrecision;
+    QComboBox* truncationSelection;
 };
 
 }  // namespace widgets
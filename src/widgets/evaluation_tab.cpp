@@ -23,6 +23,7 @@
 #include <QSplitter>
 #include <QHBoxLayout>
 #include "chart_view.h"
+#include "importance_table.h"
 #include "properties_table.h"
 
 using namespace QtCharts;
@@ -35,10 +36,17 @@ EvaluationTab::EvaluationTab(QWidget* parent) : QWidget(parent), properties_tabl
     q_hbox_layout_ = new QHBoxLayout();
     // propertiesTable = new PropertiesTable();
     chart_view_ = new ChartView();
+    // hidden until an importance analysis finished
+    importance_table_ = new ImportanceTable();
     auto* splitter = new QSplitter(Qt::Horizontal);
+    auto* chartSplitter = new QSplitter(Qt::Vertical);
+
+    chartSplitter->addWidget(chart_view_);
+    chartSplitter->addWidget(importance_table_);
+    chartSplitter->setSizes({700, 300});
 
     // splitter->addWidget(propertiesTable);
-    splitter->addWidget(chart_view_);
+    splitter->addWidget(chartSplitter);
     splitter->setSizes({5, 1000});
 
     q_hbox_layout_->addWidget(splitter);
@@ -32,6 +32,7 @@ namespace widgets
 {
     
 class ChartView;
+class ImportanceTable;
 class PropertiesTable;
 // This is the tab called evaluation
 // TODO view all proprietress in a table instead of putting them
@@ -50,6 +51,12 @@ public:
         return chart_view_;
     };
 
+    ImportanceTable*
+    importanceTable()
+    {
+        return importance_table_;
+    };
+
 private:
     explicit EvaluationTab(QWidget* parent);
 
@@ -57,6 +64,7 @@ private:
     PropertiesTable* properties_table_;
     QHBoxLayout* q_hbox_layout_;
     ChartView* chart_view_;
+    ImportanceTable* importance_table_;
 };
 
 }  // namespace widgets
@@ -0,0 +1,121 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "importance_table.h"
+
+#include <QHeaderView>
+
+#include <algorithm>
+#include <cmath>
+
+#define COLUMN_COUNT 7
+
+namespace
+{
+QTableWidgetItem*
+numberItem(double value)
+{
+    auto item = new QTableWidgetItem();
+    if (std::isfinite(value))
+    {  // sorted numerically
+        item->setData(Qt::DisplayRole, value);
+    }
+    else
+    {
+        item->setText("n/a");
+    }
+    item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+    return item;
+}
+}  // namespace
+
+namespace widgets
+{
+ImportanceTable::ImportanceTable(QWidget* parent) : QTableWidget(parent)
+{
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setSelectionBehavior(QAbstractItemView::SelectRows);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+
+    setColumnCount(COLUMN_COUNT);
+    setRowCount(0);
+    setHorizontalHeaderLabels(
+            {"Node", "Property", "P", "Birnbaum", "Fussell-Vesely", "RAW", "RRW"});
+    horizontalHeaderItem(3)->setToolTip(tr("P(failed) - P(perfect)"));
+    horizontalHeaderItem(4)->setToolTip(tr("(P - P(perfect)) / P"));
+    horizontalHeaderItem(5)->setToolTip(tr("Risk Achievement Worth, P(failed) / P"));
+    horizontalHeaderItem(6)->setToolTip(tr("Risk Reduction Worth, P / P(perfect)"));
+    resizeColumnsToContents();
+
+    connect(eval::ImportanceAnalysis::getInstance(), &eval::ImportanceAnalysis::analysisFinished,
+            this, &ImportanceTable::analysisFinished);
+    hide();
+}
+
+void
+ImportanceTable::analysisFinished(bool success)
+{
+    if (success)
+    {
+        loadMeasures(eval::ImportanceAnalysis::getInstance()->getMeasures());
+    }
+}
+
+void
+ImportanceTable::loadMeasures(const std::vector<eval::ImportanceAnalysis::Measures>& measures)
+{
+    setSortingEnabled(false);
+    clearContents();
+    setRowCount(0);
+
+    double end = 0.0;
+    for (const auto& measure : measures)
+    {
+        end = std::max(end, measure.time);
+    }
+    for (const auto& measure : measures)
+    {
+        if (measure.time != end)
+        {
+            continue;
+        }
+        const int row = rowCount();
+        insertRow(row);
+        auto node = new QTableWidgetItem(QString("n%1").arg(measure.node));
+        node->setFlags(node->flags() & ~Qt::ItemIsEditable);
+        auto label = new QTableWidgetItem(QString::fromStdString(measure.label));
+        label->setFlags(label->flags() & ~Qt::ItemIsEditable);
+        setItem(row, 0, node);
+        setItem(row, 1, label);
+        setItem(row, 2, numberItem(measure.probability));
+        setItem(row, 3, numberItem(measure.birnbaum));
+        setItem(row, 4, numberItem(measure.fussellVesely));
+        setItem(row, 5, numberItem(measure.achievementWorth));
+        setItem(row, 6, numberItem(measure.reductionWorth));
+    }
+
+    // ranked by the Birnbaum importance
+    setSortingEnabled(true);
+    sortItems(3, Qt::DescendingOrder);
+    resizeColumnsToContents();
+    setVisible(rowCount() > 0);
+}
+}  // namespace widgets
@@ -0,0 +1,51 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_WIDGETS_IMPORTANCE_TABLE_H
+#define ERIS_WIDGETS_IMPORTANCE_TABLE_H
+
+#include <QTableWidget>
+#include "eris_config.h"
+#include "importance_analysis.h"
+
+#include <vector>
+
+namespace widgets
+{
+// Ranked table of the node importance measures at the end of the
+// experiment interval, see eval::ImportanceAnalysis.
+class ERIS_EXPORT ImportanceTable : public QTableWidget
+{
+    Q_OBJECT
+public:
+    explicit ImportanceTable(QWidget* parent = nullptr);
+
+public slots:
+    void
+    loadMeasures(const std::vector<eval::ImportanceAnalysis::Measures>& measures);
+
+private slots:
+    void
+    analysisFinished(bool success);
+};
+
+}  // namespace widgets
+
+#endif  // ERIS_WIDGETS_IMPORTANCE_TABLE_H
@@ -31,6 +31,7 @@
 #include "scene_status.h"
 #include "prism.h"
 #include "evaluation_settings.h"
+#include "parameter_sweep_dialog.h"
 #include "error_handler.h"
 #include "graphic_scene.h"
 #include "transcriber.h"
@@ -89,6 +90,7 @@ MainWindow::init()
     GraphicScene::Factory::getInstance();
     ModulesTabWidget::getInstance();
     EvaluationSettingsDialog::Create(this);
+    ParameterSweepDialog::Create(this);
     MainWindowManager::getInstance();
 
     MainWindowButtonsGroupManager::getInstance()->registerObserver(this);
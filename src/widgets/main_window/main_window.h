@@ -126,11 +126,51 @@ protected:
      */
     void optionSimpleModeActTriggered();
 
+    /**
+     * Writes one security transition per attack (default).
+     */
+    void optionCompactSecurityActTriggered();
+
+    /**
+     * Writes one security transition per permutation of the securing nodes.
+     */
+    void optionExpandedSecurityActTriggered();
+
+    /**
+     * Writes all variables into a single module (default).
+     */
+    void optionSingleModuleActTriggered();
+
+    /**
+     * Writes one module per node.
+     */
+    void optionModulePerNodeActTriggered();
+
+    /**
+     * Declares the variables by node number (default).
+     */
+    void optionNumberOrderActTriggered();
+
+    /**
+     * Declares the variables in the order of the dependencies between nodes.
+     */
+    void optionDependencyOrderActTriggered();
+
     /**
      * Show evaluation settings dialog
      */
     void evaluationSettingsActTriggered();
 
+    /**
+     * Show parameter sweep dialog
+     */
+    void parameterSweepActTriggered();
+
+    /**
+     * Ask for the failed state and start the importance analysis
+     */
+    void importanceAnalysisActTriggered();
+
     void
     ButtonsGroupButtonClicked(int /*id*/) override;
     
@@ -28,8 +28,10 @@
 #include "file_manager.h"
 #include "scene_status.h"
 #include "prism.h"
+#include "job_scheduler.h"
 #include "transformer.h"
 #include "evaluation_settings.h"
+#include "parameter_sweep_dialog.h"
 #include "error_handler.h"
 #include "graphic_scene.h"
 #include "command.h"
@@ -39,6 +41,7 @@
 #include "transcriber.h"
 #include "graphics_view.h"
 #include "main_window_manager.h"
+#include "model.h"
 
 #include <QToolButton>
 #include <QToolBar>
@@ -49,6 +52,7 @@
 #include <QMenuBar>
 #include <QAction>
 #include <QInputDialog>
+#include <QMessageBox>
 #include <QFileDialog>
 #include <QApplication>
 #include <QCloseEvent>
@@ -103,6 +107,42 @@ MainWindow::optionSimpleModeActTriggered()
     graphInternal::Operational::getInstance().setMode(graphInternal::Operational::Mode::simple);
 }
 
+void
+MainWindow::optionCompactSecurityActTriggered()
+{
+    graph::Model::getInstance().setSecurityEncoding(graph::Model::SecurityEncoding::compact);
+}
+
+void
+MainWindow::optionExpandedSecurityActTriggered()
+{
+    graph::Model::getInstance().setSecurityEncoding(graph::Model::SecurityEncoding::expanded);
+}
+
+void
+MainWindow::optionSingleModuleActTriggered()
+{
+    graph::Model::getInstance().setModuleLayout(graph::Model::ModuleLayout::singleModule);
+}
+
+void
+MainWindow::optionModulePerNodeActTriggered()
+{
+    graph::Model::getInstance().setModuleLayout(graph::Model::ModuleLayout::modulePerNode);
+}
+
+void
+MainWindow::optionNumberOrderActTriggered()
+{
+    graph::Model::getInstance().setVariableOrder(graph::Model::VariableOrder::numberOrder);
+}
+
+void
+MainWindow::optionDependencyOrderActTriggered()
+{
+    graph::Model::getInstance().setVariableOrder(graph::Model::VariableOrder::dependencyOrder);
+}
+
 void
 MainWindow::newFileActTriggered()
 {
@@ -112,13 +152,14 @@ MainWindow::newFileActTriggered()
 void
 MainWindow::closeEvent(QCloseEvent* event)
 {
-    if (eval::Prism::getInstance()->isRunning())
+    if (eval::Prism::getInstance()->isRunning() || eval::JobScheduler::getInstance()->isRunning())
     {
         if (!eval::Prism::getInstance()->askForAbort())
         {
             event->ignore();
             return;
         }
+        eval::JobScheduler::getInstance()->waitForDone();
     }
 
     event->accept();
@@ -130,6 +171,32 @@ MainWindow::evaluationSettingsActTriggered()
     EvaluationSettingsDialog::Get()->show();
 }
 
+void
+MainWindow::parameterSweepActTriggered()
+{
+    ParameterSweepDialog::Get()->show();
+}
+
+void
+MainWindow::importanceAnalysisActTriggered()
+{
+    bool ok = false;
+    const QStringList states = {"Defective", "Corrupted"};
+    const QString state = QInputDialog::getItem(this, tr("Importance Analysis"),
+                                                tr("State of a failed node:"), states, 0, false,
+                                                &ok);
+    if (!ok)
+    {
+        return;
+    }
+    if (!GRAPHIC_SCENE_FACTORY()->current()->evaluateImportance(states.indexOf(state) + 1))
+    {
+        QMessageBox::warning(this, tr("Importance Analysis"),
+                             tr("The importance analysis could not be started, it requires a "
+                                "CTMC and F[T,T] label properties."));
+    }
+}
+
 void
 MainWindow::startVerificationActTriggered()
 {
@@ -95,6 +95,14 @@ MainWindowActionsManager::MainWindowActionsManager(QObject* parent) : QObject(pa
     mEvaluationSettings = new QAction("&Evaluation Settings");
     this->initMenuAction(mEvaluationSettings, SLOT(optionEvaluationSettingsItemClicked()), Qt::Key_unknown, 
         "Show evaluation settings dialog", false, false);
+
+    mParameterSweep = new QAction("Parameter &Sweep");
+    this->initMenuAction(mParameterSweep, SLOT(optionParameterSweepItemClicked()), Qt::Key_unknown, 
+        "Evaluate the module for ranges of node rates", false, false);
+
+    mImportanceAnalysis = new QAction("&Importance Analysis");
+    this->initMenuAction(mImportanceAnalysis, SLOT(optionImportanceAnalysisItemClicked()), Qt::Key_unknown, 
+        "Rank the nodes by their importance for the experiment", false, false);
     
     mOptionOptimizedMode = new QAction("&Optimized");
     this->initMenuAction(mOptionOptimizedMode, SLOT(optionOptimizedModeItemClicked()), Qt::Key_unknown, 
@@ -104,6 +112,30 @@ MainWindowActionsManager::MainWindowActionsManager(QObject* parent) : QObject(pa
     this->initMenuAction(mOptionSimpleMode, SLOT(optionSimpleModeItemClicked()), Qt::Key_unknown, 
         "Enable strict mode of operation", true, false);
     
+    mOptionCompactSecurity = new QAction("&Compact");
+    this->initMenuAction(mOptionCompactSecurity, SLOT(optionCompactSecurityItemClicked()), Qt::Key_unknown, 
+        "One security transition per attack, guarantees are deducted in the rate (default)", true, true);
+    
+    mOptionExpandedSecurity = new QAction("&Expanded");
+    this->initMenuAction(mOptionExpandedSecurity, SLOT(optionExpandedSecurityItemClicked()), Qt::Key_unknown, 
+        "One security transition per permutation of the securing nodes (compatibility)", true, false);
+    
+    mOptionSingleModule = new QAction("&Single Module");
+    this->initMenuAction(mOptionSingleModule, SLOT(optionSingleModuleItemClicked()), Qt::Key_unknown, 
+        "All variables and commands in one PRISM module (default)", true, true);
+    
+    mOptionModulePerNode = new QAction("Module per &Node");
+    this->initMenuAction(mOptionModulePerNode, SLOT(optionModulePerNodeItemClicked()), Qt::Key_unknown, 
+        "One PRISM module per node, respectively per group of interchangeable nodes", true, false);
+    
+    mOptionNumberOrder = new QAction("By &Number");
+    this->initMenuAction(mOptionNumberOrder, SLOT(optionNumberOrderItemClicked()), Qt::Key_unknown, 
+        "Declare the variables by node number (default)", true, true);
+    
+    mOptionDependencyOrder = new QAction("By &Dependencies");
+    this->initMenuAction(mOptionDependencyOrder, SLOT(optionDependencyOrderItemClicked()), Qt::Key_unknown, 
+        "Declare dependent nodes next to each other, keeps the MTBDDs of PRISM small", true, false);
+    
     mHelpAct = new QAction("Help");
     this->initMenuAction(mHelpAct, SLOT(helpMenuItemClicked()), Qt::Key_F1, "Open the Help Menu", 
         false, false);
@@ -154,8 +186,19 @@ MainWindowActionsManager::MainWindowActionsManager(QObject* parent) : QObject(pa
     mModeOfOperationSubMenu = mOptionsMenu->addMenu(tr("Mode of &Operation"));
     mModeOfOperationSubMenu->addAction(mOptionOptimizedMode);
     mModeOfOperationSubMenu->addAction(mOptionSimpleMode);
+    mSecurityEncodingSubMenu = mOptionsMenu->addMenu(tr("Security &Guarantees"));
+    mSecurityEncodingSubMenu->addAction(mOptionCompactSecurity);
+    mSecurityEncodingSubMenu->addAction(mOptionExpandedSecurity);
+    mModuleLayoutSubMenu = mOptionsMenu->addMenu(tr("Module &Layout"));
+    mModuleLayoutSubMenu->addAction(mOptionSingleModule);
+    mModuleLayoutSubMenu->addAction(mOptionModulePerNode);
+    mVariableOrderSubMenu = mOptionsMenu->addMenu(tr("&Variable Order"));
+    mVariableOrderSubMenu->addAction(mOptionNumberOrder);
+    mVariableOrderSubMenu->addAction(mOptionDependencyOrder);
     mOptionsMenu->addAction(mAddRedundancyDefinition);
     mOptionsMenu->addAction(mEvaluationSettings);
+    mOptionsMenu->addAction(mParameterSweep);
+    mOptionsMenu->addAction(mImportanceAnalysis);
     
 }
 
@@ -360,6 +403,54 @@ MainWindowActionsManager::optionSimpleModeItemClicked()
     MainWindow::getInstance()->optionSimpleModeActTriggered();
 }
 
+void
+MainWindowActionsManager::optionCompactSecurityItemClicked()
+{
+    mOptionCompactSecurity->setChecked(true);
+    mOptionExpandedSecurity->setChecked(false);
+    MainWindow::getInstance()->optionCompactSecurityActTriggered();
+}
+
+void
+MainWindowActionsManager::optionExpandedSecurityItemClicked()
+{
+    mOptionCompactSecurity->setChecked(false);
+    mOptionExpandedSecurity->setChecked(true);
+    MainWindow::getInstance()->optionExpandedSecurityActTriggered();
+}
+
+void
+MainWindowActionsManager::optionSingleModuleItemClicked()
+{
+    mOptionSingleModule->setChecked(true);
+    mOptionModulePerNode->setChecked(false);
+    MainWindow::getInstance()->optionSingleModuleActTriggered();
+}
+
+void
+MainWindowActionsManager::optionModulePerNodeItemClicked()
+{
+    mOptionSingleModule->setChecked(false);
+    mOptionModulePerNode->setChecked(true);
+    MainWindow::getInstance()->optionModulePerNodeActTriggered();
+}
+
+void
+MainWindowActionsManager::optionNumberOrderItemClicked()
+{
+    mOptionNumberOrder->setChecked(true);
+    mOptionDependencyOrder->setChecked(false);
+    MainWindow::getInstance()->optionNumberOrderActTriggered();
+}
+
+void
+MainWindowActionsManager::optionDependencyOrderItemClicked()
+{
+    mOptionNumberOrder->setChecked(false);
+    mOptionDependencyOrder->setChecked(true);
+    MainWindow::getInstance()->optionDependencyOrderActTriggered();
+}
+
 void
 MainWindowActionsManager::optionAddRedundancyItemClicked()
 {
@@ -372,5 +463,17 @@ MainWindowActionsManager::optionEvaluationSettingsItemClicked()
     MainWindow::getInstance()->evaluationSettingsActTriggered();
 }
 
+void
+MainWindowActionsManager::optionParameterSweepItemClicked()
+{
+    MainWindow::getInstance()->parameterSweepActTriggered();
+}
+
+void
+MainWindowActionsManager::optionImportanceAnalysisItemClicked()
+{
+    MainWindow::getInstance()->importanceAnalysisActTriggered();
+}
+
 
 }  // namespace widgets
\ No newline at end of file
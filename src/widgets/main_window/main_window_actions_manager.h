@@ -101,10 +101,26 @@ private slots:
     void optionOptimizedModeItemClicked();
     
     void optionSimpleModeItemClicked();
+
+    void optionCompactSecurityItemClicked();
+
+    void optionExpandedSecurityItemClicked();
+
+    void optionSingleModuleItemClicked();
+
+    void optionModulePerNodeItemClicked();
+
+    void optionNumberOrderItemClicked();
+
+    void optionDependencyOrderItemClicked();
     
     void optionAddRedundancyItemClicked();
     
     void optionEvaluationSettingsItemClicked();
+
+    void optionParameterSweepItemClicked();
+
+    void optionImportanceAnalysisItemClicked();
         
 
 private:
@@ -130,8 +146,16 @@ private:
     QAction* mModelOptionMDP;
     QAction* mAddRedundancyDefinition;
     QAction* mEvaluationSettings;
+    QAction* mParameterSweep;
+    QAction* mImportanceAnalysis;
     QAction* mOptionOptimizedMode;
     QAction* mOptionSimpleMode;
+    QAction* mOptionCompactSecurity;
+    QAction* mOptionExpandedSecurity;
+    QAction* mOptionSingleModule;
+    QAction* mOptionModulePerNode;
+    QAction* mOptionNumberOrder;
+    QAction* mOptionDependencyOrder;
     QAction* mOptionHourlyRates;
     QAction* mOptionMonthlyRates;
     QAction* mOptionYearlyRates;
@@ -147,6 +171,9 @@ private:
     QMenu* mExportFileSubMenu;
     QMenu* mMarkovModelSubMenu;
     QMenu* mModeOfOperationSubMenu;
+    QMenu* mSecurityEncodingSubMenu;
+    QMenu* mModuleLayoutSubMenu;
+    QMenu* mVariableOrderSubMenu;
     QMenu* mRateInterpretationSubMenu;
 
 };
@@ -0,0 +1,504 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "parameter_sweep_dialog.h"
+
+#include "chart_view.h"
+#include "evaluation_tab.h"
+#include "graphic_scene.h"
+#include "logger.h"
+#include "node_item.h"
+#include "transcriber.h"
+
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+
+#include <set>
+
+static widgets::ParameterSweepDialog* instance = nullptr;
+
+namespace
+{
+enum Column
+{
+    nodeColumn = 0,
+    rateColumn,
+    fromColumn,
+    toColumn,
+    stepsColumn,
+    columnCount
+};
+
+/** Rates of a node that can be swept and the suffix of their constant */
+const std::vector<std::pair<QString, QString>> kRates = {
+        {"Failure", "SAFE"},
+        {"Intrusion", "SEC"},
+        {"Security", "GUAR"},
+        {"Defect Recovery", "DEFREC"},
+        {"Corruption Recovery", "CORREC"},
+};
+
+graph::NodeItem*
+findNodeItem(unsigned int id)
+{
+    std::vector<graph::NodeItem*> nodes;
+    std::vector<graph::NodeItem*> envNodes;
+    std::vector<graph::EdgeItem*> edges;
+    GRAPHIC_SCENE_FACTORY()->current()->getSortedSceneItems(nodes, envNodes, edges);
+    for (graph::NodeItem* node : nodes)
+    {
+        if (node->getId() == id)
+        {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Returns the current value of a rate, false if the module does not use it, i.e. no transition
+ * with this rate is generated.
+ */
+bool
+currentRate(graph::NodeItem* node, const QString& suffix, double* value)
+{
+    if (suffix == "SAFE")
+    {
+        *value = node->getFailureIndicator().toDouble();
+    }
+    else if (suffix == "SEC")
+    {
+        *value = node->getIntrusionIndicator().toDouble();
+    }
+    else if (suffix == "GUAR")
+    {  // deducted from the intrusion rates, zero is fine
+        *value = node->getSecurityIndicator().toDouble();
+        return true;
+    }
+    else if (suffix == "DEFREC")
+    {
+        *value = node->getDefectRecoveryIndicator().toDouble();
+        if (!node->isRecoverableFromDefect())
+        {
+            return false;
+        }
+    }
+    else
+    {
+        *value = node->getCorruptionRecoveryIndicator().toDouble();
+        if (!node->isRecoverableFromCorruption())
+        {
+            return false;
+        }
+    }
+    return *value > 0.0;
+}
+
+QDoubleSpinBox*
+createRateBox(double value)
+{
+    auto box = new QDoubleSpinBox();
+    box->setDecimals(10);
+    box->setRange(0.0, 1e9);
+    box->setValue(value);
+    return box;
+}
+}  // namespace
+
+namespace widgets
+{
+ParameterSweepDialog::ParameterSweepDialog(QWidget* parent) : QDialog(parent)
+{
+    setWindowTitle("Parameter Sweep");
+    setWindowFlags(Qt::Window | Qt::WindowMinimizeButtonHint | Qt::WindowMaximizeButtonHint
+                   | Qt::WindowCloseButtonHint);
+
+    parametersTable = new QTableWidget(0, columnCount);
+    parametersTable->setHorizontalHeaderLabels({"Node", "Rate", "From", "To", "Steps"});
+    parametersTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    parametersTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    addButton = new QPushButton("Add Rate");
+    removeButton = new QPushButton("Remove Rate");
+
+    samplingSelection = new QComboBox();
+    samplingSelection->addItem("Grid");
+    samplingSelection->addItem("Latin Hypercube");
+    samples = new QSpinBox();
+    samples->setRange(1, static_cast<int>(eval::ParameterSweep::kMaxPoints));
+    samples->setValue(100);
+    samples->setEnabled(false);
+    pointsLabel = new QLabel("0 points");
+
+    startButton = new QPushButton("Start");
+    cancelButton = new QPushButton("Cancel");
+    cancelButton->setEnabled(false);
+    progressLabel = new QLabel();
+
+    resultsTable = new QTableWidget();
+    resultsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    resultsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    resultsTable->setMinimumSize(600, 300);
+
+    auto parameterButtons = new QHBoxLayout();
+    parameterButtons->addWidget(addButton);
+    parameterButtons->addWidget(removeButton);
+    auto samplingLayout = new QHBoxLayout();
+    samplingLayout->addWidget(samplingSelection);
+    samplingLayout->addWidget(new QLabel("Samples"));
+    samplingLayout->addWidget(samples);
+    samplingLayout->addWidget(pointsLabel);
+    auto runButtons = new QHBoxLayout();
+    runButtons->addWidget(startButton);
+    runButtons->addWidget(cancelButton);
+    runButtons->addWidget(progressLabel);
+
+    auto formLayout = new QFormLayout();
+    formLayout->addRow("Swept Rates", parametersTable);
+    formLayout->addRow("", parameterButtons);
+    formLayout->addRow("Sampling", samplingLayout);
+    formLayout->addRow("", runButtons);
+    formLayout->addRow("Results", resultsTable);
+    setLayout(formLayout);
+
+    connect(addButton, &QPushButton::clicked, this, &ParameterSweepDialog::addParameter);
+    connect(removeButton, &QPushButton::clicked, this, &ParameterSweepDialog::removeParameter);
+    connect(samplingSelection, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            [this](int index) {
+                samples->setEnabled(index == 1);
+                updatePointCount();
+            });
+    connect(samples, QOverload<int>::of(&QSpinBox::valueChanged), this,
+            &ParameterSweepDialog::updatePointCount);
+    connect(startButton, &QPushButton::clicked, this, &ParameterSweepDialog::startSweep);
+    connect(cancelButton, &QPushButton::clicked, this, &ParameterSweepDialog::cancelSweep);
+
+    // emitted from the worker threads, hence queued
+    eval::ParameterSweep* sweep = eval::ParameterSweep::getInstance();
+    connect(sweep, &eval::ParameterSweep::pointFinished, this,
+            &ParameterSweepDialog::pointFinished, Qt::QueuedConnection);
+    connect(sweep, &eval::ParameterSweep::pointFailed, this,
+            &ParameterSweepDialog::pointFailed, Qt::QueuedConnection);
+    connect(sweep, &eval::ParameterSweep::sweepFinished, this,
+            &ParameterSweepDialog::sweepFinished, Qt::QueuedConnection);
+}
+
+ParameterSweepDialog::~ParameterSweepDialog() = default;
+
+void
+ParameterSweepDialog::showEvent(QShowEvent* event)
+{
+    // the nodes of the module may have changed since the dialog was shown last
+    std::vector<graph::NodeItem*> nodes;
+    std::vector<graph::NodeItem*> envNodes;
+    std::vector<graph::EdgeItem*> edges;
+    GRAPHIC_SCENE_FACTORY()->current()->getSortedSceneItems(nodes, envNodes, edges);
+    mNodeIds.clear();
+    for (graph::NodeItem* node : nodes)
+    {
+        mNodeIds << QString::number(node->getId());
+    }
+    for (int row = 0; row < parametersTable->rowCount(); ++row)
+    {
+        auto nodeBox = qobject_cast<QComboBox*>(parametersTable->cellWidget(row, nodeColumn));
+        const QString current = nodeBox->currentText();
+        nodeBox->clear();
+        nodeBox->addItems(mNodeIds);
+        nodeBox->setCurrentText(current);
+    }
+    QDialog::showEvent(event);
+}
+
+void
+ParameterSweepDialog::addParameter()
+{
+    const int row = parametersTable->rowCount();
+    parametersTable->insertRow(row);
+
+    auto nodeBox = new QComboBox();
+    nodeBox->addItems(mNodeIds);
+    auto rateBox = new QComboBox();
+    for (const auto& rate : kRates)
+    {
+        rateBox->addItem(rate.first, rate.second);
+    }
+    auto fromBox = createRateBox(0.0);
+    auto toBox = createRateBox(0.0);
+    auto stepsBox = new QSpinBox();
+    stepsBox->setRange(1, 1000);
+    stepsBox->setValue(5);
+
+    // by default the range spans the current rate of the node
+    auto fillRange = [nodeBox, rateBox, fromBox, toBox] {
+        graph::NodeItem* node = findNodeItem(nodeBox->currentText().toUInt());
+        double value = 0.0;
+        if (node != nullptr && currentRate(node, rateBox->currentData().toString(), &value))
+        {
+            fromBox->setValue(value / 2);
+            toBox->setValue(value * 2);
+        }
+    };
+    fillRange();
+    connect(nodeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, fillRange);
+    connect(rateBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, fillRange);
+    connect(stepsBox, QOverload<int>::of(&QSpinBox::valueChanged), this,
+            &ParameterSweepDialog::updatePointCount);
+
+    parametersTable->setCellWidget(row, nodeColumn, nodeBox);
+    parametersTable->setCellWidget(row, rateColumn, rateBox);
+    parametersTable->setCellWidget(row, fromColumn, fromBox);
+    parametersTable->setCellWidget(row, toColumn, toBox);
+    parametersTable->setCellWidget(row, stepsColumn, stepsBox);
+    updatePointCount();
+}
+
+void
+ParameterSweepDialog::removeParameter()
+{
+    const int row = parametersTable->currentRow();
+    parametersTable->removeRow(row >= 0 ? row : parametersTable->rowCount() - 1);
+    updatePointCount();
+}
+
+void
+ParameterSweepDialog::updatePointCount()
+{
+    if (samplingSelection->currentIndex() == 1)
+    {
+        pointsLabel->setText(tr("%1 points").arg(parametersTable->rowCount() > 0
+                                                         ? samples->value()
+                                                         : 0));
+        return;
+    }
+    qint64 count = parametersTable->rowCount() > 0 ? 1 : 0;
+    for (int row = 0; row < parametersTable->rowCount(); ++row)
+    {
+        count *= qobject_cast<QSpinBox*>(parametersTable->cellWidget(row, stepsColumn))->value();
+        count = std::min<qint64>(count, eval::ParameterSweep::kMaxPoints + 1);
+    }
+    pointsLabel->setText(tr("%1 points").arg(count));
+}
+
+bool
+ParameterSweepDialog::collectParameters(std::vector<eval::ParameterSweep::Parameter>* parameters)
+{
+    parameters->clear();
+    std::set<std::string> constants;
+    for (int row = 0; row < parametersTable->rowCount(); ++row)
+    {
+        auto nodeBox = qobject_cast<QComboBox*>(parametersTable->cellWidget(row, nodeColumn));
+        auto rateBox = qobject_cast<QComboBox*>(parametersTable->cellWidget(row, rateColumn));
+        const unsigned int id = nodeBox->currentText().toUInt();
+        const QString suffix = rateBox->currentData().toString();
+        graph::NodeItem* node = findNodeItem(id);
+        double value = 0.0;
+        if (node == nullptr || !currentRate(node, suffix, &value))
+        {
+            QMessageBox::warning(this, windowTitle(),
+                                 tr("The %1 rate of node %2 is not used by the module, set a "
+                                    "rate (and recovery) in the node settings to sweep it.")
+                                         .arg(rateBox->currentText())
+                                         .arg(id));
+            return false;
+        }
+
+        eval::ParameterSweep::Parameter parameter;
+        parameter.constant = graphInternal::Transcriber::constantName(id, suffix.toStdString());
+        parameter.from =
+                qobject_cast<QDoubleSpinBox*>(parametersTable->cellWidget(row, fromColumn))->value();
+        parameter.to =
+                qobject_cast<QDoubleSpinBox*>(parametersTable->cellWidget(row, toColumn))->value();
+        parameter.steps =
+                qobject_cast<QSpinBox*>(parametersTable->cellWidget(row, stepsColumn))->value();
+        if (!constants.insert(parameter.constant).second)
+        {
+            QMessageBox::warning(this, windowTitle(),
+                                 tr("The %1 rate of node %2 is swept twice.")
+                                         .arg(rateBox->currentText())
+                                         .arg(id));
+            return false;
+        }
+        parameters->push_back(parameter);
+    }
+    if (parameters->empty())
+    {
+        QMessageBox::warning(this, windowTitle(), tr("Add at least one rate to sweep."));
+        return false;
+    }
+    return true;
+}
+
+bool
+ParameterSweepDialog::samplePoints(const std::vector<eval::ParameterSweep::Parameter>& parameters,
+                                   std::vector<eval::ParameterSweep::Point>* points) const
+{
+    const auto sampling = samplingSelection->currentIndex() == 1
+                                  ? eval::ParameterSweep::Sampling::latinHypercube
+                                  : eval::ParameterSweep::Sampling::grid;
+    return eval::ParameterSweep::samplePoints(
+            parameters, sampling, static_cast<size_t>(samples->value()), points);
+}
+
+void
+ParameterSweepDialog::startSweep()
+{
+    std::vector<eval::ParameterSweep::Parameter> parameters;
+    std::vector<eval::ParameterSweep::Point> points;
+    if (!collectParameters(&parameters))
+    {
+        return;
+    }
+    if (!samplePoints(parameters, &points))
+    {
+        QMessageBox::warning(this, windowTitle(),
+                             tr("At most %1 points are supported.")
+                                     .arg(eval::ParameterSweep::kMaxPoints));
+        return;
+    }
+
+    mParameters = parameters;
+    mPoints = points;
+    mFinished = 0;
+    mFailed = 0;
+    resultsTable->setSortingEnabled(false);
+    resultsTable->clear();
+    resultsTable->setRowCount(0);
+    resultsTable->setColumnCount(static_cast<int>(mParameters.size()));
+    QStringList headers;
+    for (const auto& parameter : mParameters)
+    {
+        headers << QString::fromStdString(parameter.constant);
+    }
+    resultsTable->setHorizontalHeaderLabels(headers);
+    EvaluationTab::Get()->view()->clear();
+
+    if (!GRAPHIC_SCENE_FACTORY()->current()->evaluateParameterSweep(mParameters, mPoints))
+    {
+        QMessageBox::warning(this, windowTitle(), tr("The parameter sweep could not be started."));
+        return;
+    }
+    startButton->setEnabled(false);
+    cancelButton->setEnabled(true);
+    updateProgress();
+}
+
+void
+ParameterSweepDialog::cancelSweep()
+{
+    eval::ParameterSweep::getInstance()->cancel();
+    cancelButton->setEnabled(false);
+}
+
+void
+ParameterSweepDialog::pointFinished(int index, const QMap<QString, QList<QPointF>>& results)
+{
+    if (index < 0 || static_cast<size_t>(index) >= mPoints.size())
+    {
+        return;
+    }
+    ++mFinished;
+    const int row = resultsTable->rowCount();
+    resultsTable->insertRow(row);
+    const eval::ParameterSweep::Point& point = mPoints[static_cast<size_t>(index)];
+    for (size_t j = 0; j < point.size(); ++j)
+    {
+        auto item = new QTableWidgetItem();
+        item->setData(Qt::DisplayRole, point[j]);
+        resultsTable->setItem(row, static_cast<int>(j), item);
+    }
+
+    // one column per property with the probability at the end of the interval
+    QMap<QString, QList<QPointF>> curves;
+    const QString constants = eval::ParameterSweep::describe(mParameters, point);
+    for (auto it = results.begin(); it != results.end(); ++it)
+    {
+        int column = static_cast<int>(mParameters.size());
+        while (column < resultsTable->columnCount()
+               && resultsTable->horizontalHeaderItem(column)->text() != it.key())
+        {
+            ++column;
+        }
+        if (column == resultsTable->columnCount())
+        {
+            resultsTable->insertColumn(column);
+            resultsTable->setHorizontalHeaderItem(column, new QTableWidgetItem(it.key()));
+        }
+        if (!it.value().isEmpty())
+        {
+            auto item = new QTableWidgetItem();
+            item->setData(Qt::DisplayRole, it.value().last().y());
+            resultsTable->setItem(row, column, item);
+        }
+        curves[it.key() + " (" + constants + ")"] = it.value();
+    }
+    EvaluationTab::Get()->view()->addResults(curves);
+    updateProgress();
+}
+
+void
+ParameterSweepDialog::pointFailed(int)
+{
+    ++mFailed;
+    updateProgress();
+}
+
+void
+ParameterSweepDialog::sweepFinished()
+{
+    startButton->setEnabled(true);
+    cancelButton->setEnabled(false);
+    resultsTable->setSortingEnabled(true);
+    resultsTable->resizeColumnsToContents();
+    PRINT_INFO("Parameter sweep done, %d points evaluated, %d failed", mFinished, mFailed);
+}
+
+void
+ParameterSweepDialog::updateProgress()
+{
+    QString text = tr("%1 of %2 points").arg(mFinished).arg(mPoints.size());
+    if (mFailed > 0)
+    {
+        text += tr(", %1 failed").arg(mFailed);
+    }
+    progressLabel->setText(text);
+}
+
+ParameterSweepDialog*
+ParameterSweepDialog::Create(QWidget* parent)
+{
+    delete instance;
+    instance = new ParameterSweepDialog(parent);
+    return Get();
+}
+
+ParameterSweepDialog*
+ParameterSweepDialog::Get()
+{
+    return instance;
+}
+
+}  // namespace widgets
@@ -0,0 +1,137 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This file is part of the ERIS tool (https://github.com/telina/eris).
+ * Copyright (c) 2023 Rhea Rinaldo (Rhea@Odlanir.de).
+ *
+ * Authors:
+ *      - 2023 Rhea Rinaldo (Rhea@Odlanir.de)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ERIS_WIDGETS_PARAMETER_SWEEP_DIALOG_H
+#define ERIS_WIDGETS_PARAMETER_SWEEP_DIALOG_H
+
+#include "parameter_sweep.h"
+
+#include <QDialog>
+#include <QList>
+#include <QMap>
+#include <QPointF>
+#include <QString>
+
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+class QComboBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+QT_END_NAMESPACE
+
+namespace widgets
+{
+/**
+ * Dialog to set up a parameter sweep over node rates of the current module. The rates are
+ * chosen per row (node, rate, range), the points are sampled as a grid or a latin hypercube.
+ * The results are streamed into the table of the dialog, one row per point with the
+ * probabilities at the end of the experiment interval, and into the evaluation plot.
+ */
+class ParameterSweepDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    static ParameterSweepDialog*
+    Create(QWidget* parent);
+
+    static ParameterSweepDialog*
+    Get();
+
+    ParameterSweepDialog() = delete;
+    ~ParameterSweepDialog() override;
+
+protected:
+    void
+    showEvent(QShowEvent* event) override;
+
+private slots:
+    void
+    addParameter();
+
+    void
+    removeParameter();
+
+    void
+    updatePointCount();
+
+    void
+    startSweep();
+
+    void
+    cancelSweep();
+
+    void
+    pointFinished(int index, const QMap<QString, QList<QPointF>>& results);
+
+    void
+    pointFailed(int index);
+
+    void
+    sweepFinished();
+
+private:
+    explicit ParameterSweepDialog(QWidget* parent);
+
+    /**
+     * Collects the parameters from the table and checks that the swept rates are used by the
+     * current module.
+     * @param parameters vector the parameters are stored in
+     * @return true if valid, false otherwise (error message is shown)
+     */
+    bool
+    collectParameters(std::vector<eval::ParameterSweep::Parameter>* parameters);
+
+    /**
+     * Samples the points of the current setup.
+     */
+    bool
+    samplePoints(const std::vector<eval::ParameterSweep::Parameter>& parameters,
+                 std::vector<eval::ParameterSweep::Point>* points) const;
+
+    void
+    updateProgress();
+
+    QTableWidget* parametersTable;
+    QPushButton* addButton;
+    QPushButton* removeButton;
+    QComboBox* samplingSelection;
+    QSpinBox* samples;
+    QLabel* pointsLabel;
+    QPushButton* startButton;
+    QPushButton* cancelButton;
+    QLabel* progressLabel;
+    QTableWidget* resultsTable;
+
+    /** Node ids of the current module, offered in the node column */
+    QStringList mNodeIds;
+
+    /** Setup of the running sweep */
+    std::vector<eval::ParameterSweep::Parameter> mParameters;
+    std::vector<eval::ParameterSweep::Point> mPoints;
+    int mFinished = 0;
+    int mFailed = 0;
+};
+
+}  // namespace widgets
+
+#endif  // ERIS_WIDGETS_PARAMETER_SWEEP_DIALOG_H
@@ -37,11 +37,21 @@ WorkingDialog::WorkingDialog(QWidget* parent) : QDialog(parent)
     button_box_ = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Abort);
     output_widget_ = new OutputWidget();
     output_widget_->setMinimumSize(860, 600);
+    jobs_widget_ = new QTreeWidget();
+    jobs_widget_->setHeaderLabels({tr("Job"), tr("State"), tr("Progress")});
+    jobs_widget_->setRootIsDecorated(false);
+    jobs_widget_->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    jobs_widget_->setMaximumHeight(160);
+    jobs_widget_->hide();
+    cancel_job_button_ = button_box_->addButton(tr("Cancel Job"), QDialogButtonBox::ActionRole);
+    cancel_job_button_->hide();
     setCursor(Qt::WaitCursor);
     button_box_->setCursor(Qt::PointingHandCursor);
     connect(button_box_, &QDialogButtonBox::rejected, this, &WorkingDialog::AskForAbort);
     connect(button_box_, &QDialogButtonBox::accepted, this, &WorkingDialog::accept);
+    connect(cancel_job_button_, &QPushButton::clicked, this, &WorkingDialog::CancelSelectedJobs);
 
+    grid_layout_->addWidget(jobs_widget_);
     grid_layout_->addWidget(output_widget_);
     grid_layout_->addWidget(progress_bar_);
     grid_layout_->addWidget(button_box_);
@@ -75,11 +85,88 @@ WorkingDialog::AskForAbort()
         return false;
     }
 
+    if (scheduler_ != nullptr)
+    {
+        scheduler_->cancelAll();
+    }
     emit WasAborted();
     close();
     return true;
 }
 void
+WorkingDialog::WatchJobs(eval::JobScheduler* scheduler)
+{
+    scheduler_ = scheduler;
+    // the scheduler signals from its worker threads
+    connect(scheduler_,
+            &eval::JobScheduler::jobChanged,
+            this,
+            &WorkingDialog::UpdateJob,
+            Qt::QueuedConnection);
+}
+void
+WorkingDialog::UpdateJob(const eval::JobScheduler::Info& info)
+{
+    auto it = job_items_.find(info.id);
+    const bool done = eval::JobScheduler::isDone(info.state);
+    // the updates of a job are signalled by different threads and may arrive out of order
+    if (it != job_items_.end()
+        && it->second->data(1, Qt::UserRole).value<quint64>() >= info.sequence)
+    {
+        return;
+    }
+    if (it == job_items_.end() && !done && scheduler_ != nullptr
+        && eval::JobScheduler::isDone(scheduler_->state(info.id)))
+    {  // e.g. queued arriving after finished, its row would never be removed
+        return;
+    }
+    if (done)
+    {
+        if (info.state != eval::JobScheduler::State::finished)
+        {
+            output_widget_->writeOutput(tr("Job %1 %2\n")
+                                                .arg(info.name)
+                                                .arg(eval::JobScheduler::toString(info.state)),
+                                        Qt::red);
+        }
+        if (it != job_items_.end())
+        {
+            delete it->second;
+            job_items_.erase(it);
+        }
+    }
+    else
+    {
+        if (it == job_items_.end())
+        {
+            it = job_items_.emplace(info.id, new QTreeWidgetItem(jobs_widget_)).first;
+            it->second->setText(0, info.name);
+            it->second->setData(0, Qt::UserRole, QVariant::fromValue(info.id));
+        }
+        it->second->setText(1, eval::JobScheduler::toString(info.state));
+        it->second->setData(1, Qt::UserRole, QVariant::fromValue(info.sequence));
+        it->second->setText(2, info.progress < 0 ? QString() : QString("%1 %").arg(info.progress));
+        if (!isVisible())
+        {
+            ShowIt();
+        }
+    }
+    jobs_widget_->setVisible(!job_items_.empty());
+    cancel_job_button_->setVisible(!job_items_.empty());
+}
+void
+WorkingDialog::CancelSelectedJobs()
+{
+    if (scheduler_ == nullptr)
+    {
+        return;
+    }
+    for (QTreeWidgetItem* item : jobs_widget_->selectedItems())
+    {
+        scheduler_->cancel(item->data(0, Qt::UserRole).value<eval::JobScheduler::Id>());
+    }
+}
+void
 WorkingDialog::DoneWorking()
 {
     reset();
@@ -22,11 +22,16 @@
 #define ERIS_WIDGETS_WORKING_DIALOG_H
 
 #include "output_widget.h"
+#include "job_scheduler.h"
 
 #include <QDialog>
 #include <QDialogButtonBox>
 #include <QGridLayout>
 #include <QProgressBar>
+#include <QPushButton>
+#include <QTreeWidget>
+
+#include <map>
 
 namespace widgets
 {
@@ -43,6 +48,11 @@ namespace widgets
 // dialog->ShowIt(); // GUI thread
 // dialog->DoneWorking(); // background thread via queued qt signal.
 //
+// Jobs of an |eval::JobScheduler| are listed above the output once it is
+// watched, the selected ones can be cancelled:
+//
+// dialog->WatchJobs(eval::JobScheduler::getInstance());
+//
 class WorkingDialog : public QDialog
 {
     Q_OBJECT
@@ -56,6 +66,10 @@ public:
     void
     Clear();
 
+    // List the queued and running jobs of the scheduler, abort cancels all of them.
+    void
+    WatchJobs(eval::JobScheduler* scheduler);
+
     // Make the progress bar active or passive.
     void
     SetProgressBarActive(bool active)
@@ -96,6 +110,16 @@ public slots:
     void
     SetDoneState();
 
+    // Add, update or remove (once done) the job in the list and show the dialog.
+    // Outdated updates, i.e. of a lower sequence or of a job that is done, are ignored.
+    void
+    UpdateJob(const eval::JobScheduler::Info& info);
+
+private slots:
+    // Cancel the selected jobs.
+    void
+    CancelSelectedJobs();
+
 private:
     void
     reset();
@@ -105,6 +129,10 @@ private:
     QDialogButtonBox* button_box_ = nullptr;
     QProgressBar* progress_bar_ = nullptr;
     OutputWidget* output_widget_ = nullptr;
+    QTreeWidget* jobs_widget_ = nullptr;
+    QPushButton* cancel_job_button_ = nullptr;
+    eval::JobScheduler* scheduler_ = nullptr;
+    std::map<eval::JobScheduler::Id, QTreeWidgetItem*> job_items_;
     bool active_ = false;
 };
 
@@ -1,32 +1,26 @@
 #include <gtest/gtest.h>
 #include "counter.h"
 
+using graph::Counter;
+
 class CounterTest : public ::testing::Test {
 
   protected:
 
-    CounterTest() {
+    CounterTest() : mCounter(Counter::Create()) {
     }
 
     virtual ~CounterTest() {
     }
 
-    virtual void SetUp() 
-    {
-      
-    }
-
-    virtual void TearDown() 
-    {
-        Counter::getInstance().clear();
-    }
+    std::unique_ptr<Counter> mCounter;
 
   };
 
 
 TEST_F(CounterTest, GetNextTest)
 {
-    Counter& counter = Counter::getInstance();
+    Counter& counter = *mCounter;
     EXPECT_EQ(counter.getNext(), 0);
     EXPECT_EQ(counter.getNext(), 1);
     EXPECT_EQ(counter.getNext(), 2);
@@ -49,7 +43,7 @@ TEST_F(CounterTest, GetNextTest)
 
 TEST_F(CounterTest, Clear)
 {
-    Counter& counter = Counter::getInstance();
+    Counter& counter = *mCounter;
     for (unsigned int i=0; i< 15; ++i)
     {
         EXPECT_TRUE(counter.setId(i));
@@ -59,7 +53,7 @@ TEST_F(CounterTest, Clear)
 
 TEST_F(CounterTest, SetId)
 {
-    Counter& counter = Counter::getInstance();
+    Counter& counter = *mCounter;
     EXPECT_TRUE(counter.setId(0));
     EXPECT_TRUE(counter.setId(25));
     EXPECT_TRUE(counter.setId(1));
@@ -72,7 +66,7 @@ TEST_F(CounterTest, SetId)
 
 TEST_F(CounterTest, UpdateId)
 {
-    Counter& counter = Counter::getInstance();
+    Counter& counter = *mCounter;
     for (unsigned int i=0; i<7; ++i)
     {
         EXPECT_TRUE(counter.setId(i));
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "engine_planner.h"
+
+#include <algorithm>
+
+using eval::EnginePlanner;
+using eval::ExperimentInterval;
+
+TEST(EnginePlanner, CombinationsOfSingleNodes)
+{
+    // each node is ok, defective or corrupted
+    EXPECT_DOUBLE_EQ(EnginePlanner::combinations({}, 4, 4), 81.0);
+    EXPECT_DOUBLE_EQ(EnginePlanner::combinations({}, 4, ~0U), 81.0);
+    // all ok, one of 4 nodes in one of 2 failed values
+    EXPECT_DOUBLE_EQ(EnginePlanner::combinations({}, 4, 1), 9.0);
+    EXPECT_DOUBLE_EQ(EnginePlanner::combinations({}, 4, 0), 1.0);
+}
+
+TEST(EnginePlanner, CombinationsOfGroups)
+{
+    // a group of m interchangeable nodes is counted by its defective and corrupted members
+    EXPECT_DOUBLE_EQ(EnginePlanner::combinations({3}, 0, ~0U), 10.0);
+    EXPECT_DOUBLE_EQ(EnginePlanner::combinations({3}, 0, 1), 3.0);
+    EXPECT_DOUBLE_EQ(EnginePlanner::combinations({3, 2}, 1, ~0U), 10.0 * 6.0 * 3.0);
+}
+
+TEST(EnginePlanner, ChoosesEngineBySize)
+{
+    const ExperimentInterval interval(0, 10, 1);
+
+    EnginePlanner::Plan small = EnginePlanner::choose(1e3, 5e3, 1.0, interval);
+    EXPECT_TRUE(small.planned);
+    EXPECT_EQ(small.engine, EnginePlanner::Engine::explicitEngine);
+    EXPECT_GT(small.epsilon, 0.0);
+
+    EnginePlanner::Plan medium = EnginePlanner::choose(1e6, 1e7, 1.0, interval);
+    EXPECT_EQ(medium.engine, EnginePlanner::Engine::sparse);
+
+    EnginePlanner::Plan large = EnginePlanner::choose(1e8, 1e9, 1.0, interval);
+    EXPECT_EQ(large.engine, EnginePlanner::Engine::hybrid);
+    EXPECT_DOUBLE_EQ(large.epsilon, 0.0);
+    EXPECT_GT(large.seconds, medium.seconds);
+
+    EnginePlanner::Plan huge = EnginePlanner::choose(1e12, 1e13, 1.0, interval);
+    EXPECT_EQ(huge.engine, EnginePlanner::Engine::mtbdd);
+}
+
+TEST(EnginePlanner, Arguments)
+{
+    EnginePlanner::Plan plan;
+    EXPECT_EQ(plan.arguments(),
+              std::vector<std::string>({"-javamaxmem", "4g", "-cuddmaxmem", "4g"}));
+
+    plan = EnginePlanner::choose(100.0, 300.0, 1.0, ExperimentInterval(0, 1, 1));
+    const std::vector<std::string> arguments = plan.arguments();
+    ASSERT_FALSE(arguments.empty());
+    EXPECT_EQ(arguments.front(), "-explicit");
+    EXPECT_NE(std::find(arguments.begin(), arguments.end(), "-epsilon"), arguments.end());
+    EXPECT_NE(std::find(arguments.begin(), arguments.end(), "-javamaxmem"), arguments.end());
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "expression.h"
+
+#include <map>
+#include <string>
+
+using graphInternal::Expression;
+
+TEST(ExpressionTest, PrintsParsedFormula)
+{
+    for (const std::string formula : {"n1=0 & n2=0", "n1=0 & (n2=0 | n3=2)", "!n1=0 | n2!=1",
+                                      "n3internalfailure & n1=2",
+                                      "(n2=0?1:0)+(n3=0?1:0)+(n4=0?1:0)>=2", "true"})
+    {
+        Expression::Ptr expression = Expression::parse(formula);
+        ASSERT_NE(expression, nullptr) << formula;
+        EXPECT_EQ(expression->toString(), formula);
+        // hash-consed, printing and parsing again yields the same object
+        EXPECT_EQ(Expression::parse(expression->toString()), expression);
+    }
+}
+
+TEST(ExpressionTest, SharesEqualFormulas)
+{
+    Expression::Ptr expression = Expression::parse("n1=0 & n2=0");
+    EXPECT_EQ(Expression::parse("(n1=0)&(n2=0)"), expression);
+    EXPECT_EQ(Expression::makeConjunction({Expression::makeComparison(1, 0),
+                                           Expression::makeComparison(2, 0)}),
+              expression);
+
+    Expression::Ptr swapped = Expression::parse("n2=0 & n1=0");
+    EXPECT_NE(swapped, expression);
+    EXPECT_EQ(swapped->toCanonicalString(), expression->toCanonicalString());
+}
+
+TEST(ExpressionTest, Simplifies)
+{
+    EXPECT_EQ(Expression::parse("n1=0 & n1=0")->toString(), "n1=0");
+    EXPECT_EQ(Expression::parse("n1=0 & (n1=0 | n2=0)")->toString(), "n1=0");
+    EXPECT_EQ(Expression::parse("n1=0 & true")->toString(), "n1=0");
+    EXPECT_EQ(Expression::parse("n1=0 & false")->toString(), "false");
+    EXPECT_EQ(Expression::makeAtLeast(1, {Expression::makeComparison(1, 0),
+                                          Expression::makeComparison(2, 0)}),
+              Expression::parse("n1=0 | n2=0"));
+    EXPECT_EQ(Expression::makeConjunction({}), Expression::makeConstant(true));
+}
+
+TEST(ExpressionTest, Dual)
+{
+    EXPECT_EQ(Expression::parse("n1=0 & n2=0")->dual()->toString(), "n1=1 | n2=1");
+    EXPECT_EQ(Expression::parse("n1=0 & (n2=0 | n3=2)")->dual()->toString(),
+              "n1=1 | n2=1 & n3=2");
+    EXPECT_EQ(Expression::parse("n3internalfailure & n1=2")->dual()->toString(),
+              "n3internalfailure | n1=2");
+    EXPECT_EQ(Expression::parse("(n2=0?1:0)+(n3=0?1:0)+(n4=0?1:0)>=2")->dual()->toString(),
+              "(n2=1?1:0)+(n3=1?1:0)+(n4=1?1:0)>=2");
+    EXPECT_EQ(Expression::parse("true")->dual(), Expression::makeConstant(false));
+}
+
+TEST(ExpressionTest, SwapsNodes)
+{
+    Expression::Ptr expression = Expression::parse("n1=0 & (n2=0 | n3=2) & n1internalfailure");
+    Expression::Ptr swapped = expression->swapNodes(1, 2);
+    EXPECT_EQ(swapped->toString(), "n2=0 & (n1=0 | n3=2) & n2internalfailure");
+    EXPECT_EQ(swapped->swapNodes(1, 2), expression);
+    EXPECT_EQ(expression->swapNodes(4, 5), expression);
+}
+
+TEST(ExpressionTest, ResolvesNamedFormulas)
+{
+    std::map<std::string, Expression::Ptr> formulas;
+    formulas["operational"] = Expression::parse("n1=0 & n2!=2");
+    Expression::Ptr failure = Expression::parse("!operational", &formulas);
+    ASSERT_NE(failure, nullptr);
+
+    int values[3] = {0, 0, 0};
+    auto lookup = [&values](unsigned int node, bool flag) { return flag ? 0 : values[node]; };
+    EXPECT_FALSE(failure->evaluate(lookup));
+    values[2] = 2;
+    EXPECT_TRUE(failure->evaluate(lookup));
+    values[2] = 1;
+    EXPECT_FALSE(failure->evaluate(lookup));
+
+    std::vector<unsigned int> nodes;
+    failure->collectNodes(&nodes);
+    EXPECT_EQ(nodes, std::vector<unsigned int>({1, 2}));
+}
+
+TEST(ExpressionTest, ReportsSyntaxErrors)
+{
+    std::string error;
+    EXPECT_EQ(Expression::parse("(n1=0 &", nullptr, &error), nullptr);
+    EXPECT_FALSE(error.empty());
+    error.clear();
+    EXPECT_EQ(Expression::parse("foo & n1=0", nullptr, &error), nullptr);
+    EXPECT_NE(error.find("foo"), std::string::npos);
+}
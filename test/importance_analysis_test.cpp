@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "edge.h"
+#include "experiment.h"
+#include "importance_analysis.h"
+#include "markov_chain.h"
+#include "minimal_paths.h"
+#include "node.h"
+#include "reachability.h"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+using eval::ExperimentInterval;
+using eval::ImportanceAnalysis;
+using graph::ComponentType;
+using graphInternal::Edge;
+using graphInternal::Expression;
+using graphInternal::MarkovChain;
+using graphInternal::MinimalPaths;
+using graphInternal::Node;
+using graphInternal::Reachability;
+
+class ImportanceAnalysisTest : public ::testing::Test
+{
+protected:
+    ImportanceAnalysisTest()
+    {
+        mEnv.push_back(new Node(ComponentType::environmentNode, 0));
+    }
+
+    ~ImportanceAnalysisTest() override
+    {
+        for (Edge* edge : mEdges)
+        {
+            delete edge;
+        }
+        for (Node* node : mNodes)
+        {
+            delete node;
+        }
+        delete mEnv.front();
+    }
+
+    /** Adds a node reachable from the environment, repairable if recovery is not "0" */
+    void
+    addNode(unsigned int number, const std::string& failure, const std::string& recovery)
+    {
+        mNodes.push_back(new Node(ComponentType::normalNode, number, recovery != "0", false, "0",
+                                  failure, "0", recovery, "0"));
+        Edge* edge = new Edge(mEnv.front(), mNodes.back(), ComponentType::reachEdge);
+        mEnv.front()->addEdge(edge);
+        mNodes.back()->addEdge(edge);
+        mEdges.push_back(edge);
+    }
+
+    /** Compiles the chain of the nodes with the given operational formula and label */
+    std::shared_ptr<const MarkovChain>
+    createChain(const std::string& operational, const std::string& label)
+    {
+        Reachability::compute(mEnv, mNodes);
+        auto minimalPaths = std::make_shared<MinimalPaths>(mNodes);
+        for (Node* node : mNodes)
+        {
+            node->setMinimalPaths(minimalPaths);
+        }
+        auto chain = std::make_shared<MarkovChain>(
+                mNodes, Expression::parse(operational),
+                std::vector<std::pair<std::string, Expression::Ptr>>(
+                        {{"systemfailure", Expression::parse(label)}}));
+        EXPECT_TRUE(chain->isValid()) << chain->getError();
+        return chain;
+    }
+
+    /** Runs the analysis and waits for it to finish */
+    std::vector<ImportanceAnalysis::Measures>
+    analyze(std::shared_ptr<const MarkovChain> chain, const ExperimentInterval& interval)
+    {
+        EXPECT_TRUE(ImportanceAnalysis::getInstance()->execute(chain, {"systemfailure"},
+                                                               interval, 1));
+        while (ImportanceAnalysis::getInstance()->isRunning())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return ImportanceAnalysis::getInstance()->getMeasures();
+    }
+
+    std::vector<Node*> mEnv;
+    std::vector<Node*> mNodes;
+    std::vector<Edge*> mEdges;
+};
+
+TEST(ImportanceAnalysisMeasuresTest, ComputesMeasures)
+{
+    ImportanceAnalysis::Measures measures;
+    ImportanceAnalysis::computeMeasures(0.2, 0.5, 0.1, &measures);
+    EXPECT_DOUBLE_EQ(measures.probability, 0.2);
+    EXPECT_DOUBLE_EQ(measures.birnbaum, 0.4);
+    EXPECT_DOUBLE_EQ(measures.fussellVesely, 0.5);
+    EXPECT_DOUBLE_EQ(measures.achievementWorth, 2.5);
+    EXPECT_DOUBLE_EQ(measures.reductionWorth, 2.0);
+
+    ImportanceAnalysis::computeMeasures(0.0, 0.5, 0.0, &measures);
+    EXPECT_DOUBLE_EQ(measures.birnbaum, 0.5);
+    EXPECT_TRUE(std::isnan(measures.fussellVesely));
+    EXPECT_TRUE(std::isnan(measures.achievementWorth));
+    EXPECT_TRUE(std::isnan(measures.reductionWorth));
+}
+
+TEST_F(ImportanceAnalysisTest, SeriesSystem)
+{
+    // the system fails as soon as one of the two nodes fails
+    const double lambda1 = 0.1;
+    const double lambda2 = 0.3;
+    addNode(1, "0.1", "0");
+    addNode(2, "0.3", "0");
+    const std::vector<ImportanceAnalysis::Measures> measures =
+            analyze(createChain("n1=0 & n2=0", "n1=1 | n2=1"), ExperimentInterval(1, 5, 2));
+    ASSERT_EQ(measures.size(), 6u);
+
+    for (const ImportanceAnalysis::Measures& measure : measures)
+    {
+        const double ok1 = std::exp(-lambda1 * measure.time);
+        const double ok2 = std::exp(-lambda2 * measure.time);
+        // Q+ = 1, Q- is the failure probability of the other node
+        const double probability = 1.0 - ok1 * ok2;
+        const double perfect = measure.node == 1 ? 1.0 - ok2 : 1.0 - ok1;
+        EXPECT_EQ(measure.label, "systemfailure");
+        EXPECT_NEAR(measure.probability, probability, 1e-9) << measure.node;
+        EXPECT_NEAR(measure.birnbaum, 1.0 - perfect, 1e-9) << measure.node;
+        EXPECT_NEAR(measure.fussellVesely, (probability - perfect) / probability, 1e-9);
+        EXPECT_NEAR(measure.achievementWorth, 1.0 / probability, 1e-9);
+        EXPECT_NEAR(measure.reductionWorth, probability / perfect, 1e-9);
+    }
+    // the node failing faster matters more
+    EXPECT_GT(measures[3].birnbaum, measures[0].birnbaum);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "job_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using eval::JobScheduler;
+
+namespace
+{
+/** Records the order in which the jobs ran */
+class Recorder
+{
+public:
+    JobScheduler::Work
+    job(const std::string& name, bool success = true)
+    {
+        return [this, name, success](JobScheduler::Context&) {
+            std::lock_guard<std::mutex> guard(mLock);
+            mOrder.push_back(name);
+            return success;
+        };
+    }
+
+    std::vector<std::string>
+    order()
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        return mOrder;
+    }
+
+private:
+    std::mutex mLock;
+    std::vector<std::string> mOrder;
+};
+
+/** Occupies the only worker until released */
+JobScheduler::Id
+block(JobScheduler* scheduler, std::atomic_bool* release)
+{
+    const JobScheduler::Id id = scheduler->submit("blocker", [release](JobScheduler::Context&) {
+        while (!release->load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    });
+    while (scheduler->state(id) != JobScheduler::State::running)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return id;
+}
+}  // namespace
+
+TEST(JobSchedulerTest, RunsByPriorityAndDependencies)
+{
+    JobScheduler* scheduler = JobScheduler::getInstance();
+    scheduler->setMaxThreadCount(1);
+    Recorder recorder;
+    std::atomic_bool release(false);
+    block(scheduler, &release);
+
+    const JobScheduler::Id low = scheduler->submit("low", recorder.job("low"), 0);
+    const JobScheduler::Id high = scheduler->submit("high", recorder.job("high"), 5);
+    scheduler->submit("parent", recorder.job("parent"), 9, {low, high});
+    EXPECT_EQ(scheduler->pendingJobs().size(), 4u);
+
+    release = true;
+    ASSERT_TRUE(scheduler->waitForDone(10000));
+    EXPECT_EQ(recorder.order(), std::vector<std::string>({"high", "low", "parent"}));
+    EXPECT_FALSE(scheduler->isRunning());
+}
+
+TEST(JobSchedulerTest, FailureCancelsDependents)
+{
+    JobScheduler* scheduler = JobScheduler::getInstance();
+    scheduler->setMaxThreadCount(2);
+    Recorder recorder;
+
+    const JobScheduler::Id failing = scheduler->submit("failing", recorder.job("failing", false));
+    const JobScheduler::Id step = scheduler->submit("step", recorder.job("step"), 0, {failing});
+    const JobScheduler::Id next = scheduler->submit("next", recorder.job("next"), 0, {step});
+    ASSERT_TRUE(scheduler->waitForDone(10000));
+
+    EXPECT_EQ(scheduler->state(failing), JobScheduler::State::failed);
+    EXPECT_EQ(scheduler->state(step), JobScheduler::State::cancelled);
+    EXPECT_EQ(scheduler->state(next), JobScheduler::State::cancelled);
+    EXPECT_EQ(recorder.order(), std::vector<std::string>({"failing"}));
+
+    // submitted after its dependency failed
+    const JobScheduler::Id late = scheduler->submit("late", recorder.job("late"), 0, {failing});
+    EXPECT_EQ(scheduler->state(late), JobScheduler::State::cancelled);
+}
+
+TEST(JobSchedulerTest, CancelsQueuedAndRunningJobs)
+{
+    JobScheduler* scheduler = JobScheduler::getInstance();
+    scheduler->setMaxThreadCount(1);
+    Recorder recorder;
+    std::atomic_bool release(false);
+    const JobScheduler::Id blocker = block(scheduler, &release);
+    const JobScheduler::Id queued = scheduler->submit("queued", recorder.job("queued"));
+    scheduler->cancel(queued);
+    EXPECT_EQ(scheduler->state(queued), JobScheduler::State::cancelled);
+    release = true;
+    ASSERT_TRUE(scheduler->waitForDone(10000));
+
+    std::atomic_bool started(false);
+    const JobScheduler::Id running =
+            scheduler->submit("running", [&started](JobScheduler::Context& context) {
+                started = true;
+                while (!context.isCancelled())
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                return true;
+            });
+    const JobScheduler::Id dependent =
+            scheduler->submit("dependent", recorder.job("dependent"), 0, {running});
+    while (!started)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    scheduler->cancelAll();
+    ASSERT_TRUE(scheduler->waitForDone(10000));
+
+    EXPECT_EQ(scheduler->state(blocker), JobScheduler::State::finished);
+    EXPECT_EQ(scheduler->state(running), JobScheduler::State::cancelled);
+    EXPECT_EQ(scheduler->state(dependent), JobScheduler::State::cancelled);
+    EXPECT_TRUE(recorder.order().empty());
+}
+
+TEST(JobSchedulerTest, OrdersChangesAndForgetsOldJobs)
+{
+    JobScheduler* scheduler = JobScheduler::getInstance();
+    scheduler->setMaxThreadCount(2);
+    Recorder recorder;
+    std::mutex lock;
+    std::map<JobScheduler::Id, quint64> sequences;
+    QMetaObject::Connection connection = QObject::connect(
+            scheduler, &JobScheduler::jobChanged, [&](const JobScheduler::Info& info) {
+                // the snapshots may arrive out of order, the latest has the highest sequence
+                std::lock_guard<std::mutex> guard(lock);
+                sequences[info.id] = std::max(sequences[info.id], info.sequence);
+            });
+
+    std::vector<JobScheduler::Id> ids;
+    for (size_t i = 0; i < JobScheduler::kKeptJobs + 10; ++i)
+    {
+        ids.push_back(scheduler->submit("job", recorder.job("job")));
+    }
+    ASSERT_TRUE(scheduler->wait(ids, 10000));
+    ASSERT_TRUE(scheduler->waitForDone(10000));
+    QObject::disconnect(connection);
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        // queued, running and finished
+        EXPECT_EQ(sequences[ids.front()], 3u);
+        EXPECT_EQ(sequences[ids.back()], 3u);
+    }
+    EXPECT_EQ(scheduler->state(ids.back()), JobScheduler::State::finished);
+    // forgotten, its dependents cannot rely on its result
+    EXPECT_EQ(scheduler->state(ids.front()), JobScheduler::State::cancelled);
+    const JobScheduler::Id late = scheduler->submit("late", recorder.job("late"), 0, {ids.front()});
+    EXPECT_EQ(scheduler->state(late), JobScheduler::State::cancelled);
+}
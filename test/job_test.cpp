@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include "command.h"
+#include "job.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+using utils::Command;
+using utils::Job;
+
+TEST(JobTest, OwnsUniqueScratchDirectory)
+{
+    QString path;
+    {
+        Job first("experiment");
+        Job second("experiment");
+        ASSERT_TRUE(first.isValid());
+        ASSERT_TRUE(second.isValid());
+        EXPECT_NE(first.path(), second.path());
+        EXPECT_TRUE(first.path().startsWith(Job::root()));
+
+        QFile results(first.filePath("results.txt"));
+        ASSERT_TRUE(results.open(QFile::WriteOnly));
+        results.write("T\tP\n");
+        results.close();
+        EXPECT_FALSE(QFile::exists(second.filePath("results.txt")));
+        path = first.path();
+    }
+    // removed together with its content
+    EXPECT_FALSE(QFileInfo(path).exists());
+}
+
+TEST(JobTest, AttachesCommand)
+{
+    Job job("octave");
+    ASSERT_TRUE(job.isValid());
+    Command command(nullptr, "prism");
+    job.attach(&command);
+    EXPECT_EQ(command.workingDirectory(), job.path());
+    EXPECT_EQ(command.processEnvironment().value("TMPDIR"), job.path());
+}
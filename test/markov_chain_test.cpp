@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "edge.h"
+#include "markov_chain.h"
+#include "minimal_paths.h"
+#include "node.h"
+#include "reachability.h"
+#include "transcriber.h"
+
+#include <cstdio>
+#include <memory>
+
+using graph::ComponentType;
+using graphInternal::Edge;
+using graphInternal::MarkovChain;
+using graphInternal::MinimalPaths;
+using graphInternal::Node;
+using graphInternal::Reachability;
+using graphInternal::Transcriber;
+
+class MarkovChainTest : public ::testing::Test
+{
+protected:
+    MarkovChainTest()
+    {
+        mEnv.push_back(new Node(ComponentType::environmentNode, 0));
+    }
+
+    ~MarkovChainTest() override
+    {
+        for (Edge* edge : mEdges)
+        {
+            delete edge;
+        }
+        for (Node* node : mNodes)
+        {
+            delete node;
+        }
+        delete mEnv.front();
+    }
+
+    void
+    connect(Node* start, Node* end, ComponentType type)
+    {
+        Edge* edge = new Edge(start, end, type);
+        start->addEdge(edge);
+        end->addEdge(edge);
+        mEdges.push_back(edge);
+    }
+
+    /**
+     * Three sensors n2-n4 reachable from the environment, critical node n1 needs one of them.
+     * Node n5 fails independently of the others.
+     */
+    void
+    createSensors()
+    {
+        mNodes.push_back(new Node(ComponentType::criticalNode, 1, false, false, "0", "0.01", "0",
+                                  "0", "0", "n2=0 | n3=0 | n4=0"));
+        for (unsigned int number = 2; number <= 4; ++number)
+        {
+            mNodes.push_back(new Node(ComponentType::normalNode, number, true, false, "0", "0.1",
+                                      "0", "1", "0"));
+            connect(mEnv.front(), mNodes.back(), ComponentType::reachEdge);
+            connect(mNodes.back(), mNodes.front(), ComponentType::functionalEdge);
+        }
+        mNodes.push_back(new Node(ComponentType::normalNode, 5, false, false, "0", "0.2"));
+        connect(mEnv.front(), mNodes.back(), ComponentType::reachEdge);
+    }
+
+    /** Compiles the chain from the formulas generated by the transcriber */
+    std::unique_ptr<MarkovChain>
+    createChain()
+    {
+        Reachability::compute(mEnv, mNodes);
+        auto minimalPaths = std::make_shared<MinimalPaths>(mNodes);
+        for (Node* node : mNodes)
+        {
+            node->setMinimalPaths(minimalPaths);
+        }
+        const std::string outFileName = testing::TempDir() + "markov_chain_test.pm";
+        Transcriber transcriber(mEnv, mNodes, "", outFileName);
+        transcriber.buildModel();
+        std::remove(outFileName.c_str());
+        return std::make_unique<MarkovChain>(mNodes, transcriber.getOperationalFormula(),
+                                             transcriber.getLabelFormulas());
+    }
+
+    std::vector<Node*> mEnv;
+    std::vector<Node*> mNodes;
+    std::vector<Edge*> mEdges;
+};
+
+TEST_F(MarkovChainTest, BuildsRateMatrix)
+{
+    mNodes.push_back(new Node(ComponentType::criticalNode, 1, true, false, "0.3", "0.1", "0",
+                              "0.5", "0"));
+    connect(mEnv.front(), mNodes.back(), ComponentType::reachEdge);
+    std::unique_ptr<MarkovChain> chain = createChain();
+    ASSERT_TRUE(chain->isValid()) << chain->getError();
+    ASSERT_TRUE(chain->build());
+
+    // the critical node fails or is corrupted, every command requires the system to be operational
+    ASSERT_EQ(chain->getStateCount(), 3u);
+    EXPECT_EQ(chain->getTransitionCount(), 2u);
+    EXPECT_EQ(chain->getRowStarts(), std::vector<uint64_t>({0, 2, 2, 2}));
+    EXPECT_EQ(chain->getColumns(), std::vector<uint32_t>({1, 2}));
+    EXPECT_EQ(chain->getRates(), std::vector<double>({0.1, 0.3}));
+    EXPECT_EQ(chain->getNodeValue(0, 1), 0);
+    EXPECT_EQ(chain->getNodeValue(1, 1), 1);
+    EXPECT_EQ(chain->getNodeValue(2, 1), 2);
+    EXPECT_EQ(chain->getLabelStates("systemfailure"), std::vector<bool>({false, true, true}));
+    EXPECT_EQ(chain->getLabelStates("corrupted"), std::vector<bool>({false, false, true}));
+}
+
+TEST_F(MarkovChainTest, ConeOfInfluence)
+{
+    createSensors();
+    std::unique_ptr<MarkovChain> chain = createChain();
+    ASSERT_TRUE(chain->isValid()) << chain->getError();
+
+    std::vector<unsigned int> frozen;
+    EXPECT_EQ(chain->getConeOfInfluence({1}, &frozen), std::vector<unsigned int>({1, 2, 3, 4}));
+    EXPECT_TRUE(frozen.empty());
+    EXPECT_EQ(chain->getConeOfInfluence({5}, &frozen),
+              std::vector<unsigned int>({1, 2, 3, 4, 5}));
+}
+
+TEST_F(MarkovChainTest, LumpsInterchangeableNodes)
+{
+    createSensors();
+    std::unique_ptr<MarkovChain> chain = createChain();
+    ASSERT_TRUE(chain->isValid()) << chain->getError();
+    EXPECT_EQ(chain->getSymmetryGroups(), std::vector<std::vector<unsigned int>>({{2, 3, 4}}));
+
+    chain->setSymmetryReduction(false);
+    ASSERT_TRUE(chain->build());
+    EXPECT_EQ(chain->getStateCount(), 30u);
+    EXPECT_TRUE(chain->getLumpedGroupSizes().empty());
+    const std::vector<uint64_t> rowStarts = chain->getRowStarts();
+    const std::vector<double> rates = chain->getRates();
+
+    chain->setSymmetryReduction(true);
+    ASSERT_TRUE(chain->build());
+    EXPECT_EQ(chain->getStateCount(), 14u);
+    EXPECT_EQ(chain->getLumpedGroupSizes(), std::vector<size_t>({3}));
+    // the failures of the three sensors lead to the same lumped state
+    EXPECT_EQ(chain->getRowStarts()[1] - chain->getRowStarts()[0], 3u);
+    EXPECT_EQ(rowStarts[1] - rowStarts[0], 5u);
+    double exitRate = 0;
+    double lumpedExitRate = 0;
+    for (uint64_t i = 0; i < rowStarts[1]; ++i)
+    {
+        exitRate += rates[i];
+    }
+    for (uint64_t i = 0; i < chain->getRowStarts()[1]; ++i)
+    {
+        lumpedExitRate += chain->getRates()[i];
+    }
+    EXPECT_DOUBLE_EQ(lumpedExitRate, exitRate);
+    EXPECT_DOUBLE_EQ(chain->getRates()[1], 0.3);
+}
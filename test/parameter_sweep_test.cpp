@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "edge.h"
+#include "experiment.h"
+#include "markov_chain.h"
+#include "minimal_paths.h"
+#include "node.h"
+#include "parameter_sweep.h"
+#include "reachability.h"
+#include "transcriber.h"
+
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using eval::ExperimentInterval;
+using eval::ParameterSweep;
+using graph::ComponentType;
+using graphInternal::Edge;
+using graphInternal::Expression;
+using graphInternal::MarkovChain;
+using graphInternal::MinimalPaths;
+using graphInternal::Node;
+using graphInternal::Reachability;
+using graphInternal::Transcriber;
+
+class ParameterSweepChainTest : public ::testing::Test
+{
+protected:
+    ParameterSweepChainTest()
+    {
+        mEnv.push_back(new Node(ComponentType::environmentNode, 0));
+        mNodes.push_back(new Node(ComponentType::normalNode, 1, false, false, "0", "0.1", "0",
+                                  "0", "0"));
+        mEdge = new Edge(mEnv.front(), mNodes.front(), ComponentType::reachEdge);
+        mEnv.front()->addEdge(mEdge);
+        mNodes.front()->addEdge(mEdge);
+    }
+
+    ~ParameterSweepChainTest() override
+    {
+        QObject::disconnect(mConnection);
+        delete mEdge;
+        delete mNodes.front();
+        delete mEnv.front();
+    }
+
+    /** Compiles the chain of a single node, the system fails with the node */
+    std::shared_ptr<const MarkovChain>
+    createChain()
+    {
+        Reachability::compute(mEnv, mNodes);
+        mNodes.front()->setMinimalPaths(std::make_shared<MinimalPaths>(mNodes));
+        auto chain = std::make_shared<MarkovChain>(
+                mNodes, Expression::parse("n1=0"),
+                std::vector<std::pair<std::string, Expression::Ptr>>(
+                        {{"systemfailure", Expression::parse("n1=1")}}));
+        EXPECT_TRUE(chain->isValid()) << chain->getError();
+        return chain;
+    }
+
+    std::vector<Node*> mEnv;
+    std::vector<Node*> mNodes;
+    Edge* mEdge;
+    QMetaObject::Connection mConnection;
+};
+
+TEST(ParameterSweepTest, GridContainsEveryCombination)
+{
+    const std::vector<ParameterSweep::Parameter> parameters = {{"rn1SAFE", 0.1, 0.3, 3},
+                                                               {"rn2SAFE", 1.0, 2.0, 2}};
+    std::vector<ParameterSweep::Point> points;
+    ASSERT_TRUE(ParameterSweep::samplePoints(parameters, ParameterSweep::Sampling::grid, 0,
+                                             &points));
+    ASSERT_EQ(points.size(), 6u);
+    // the last parameter changes fastest
+    const std::vector<ParameterSweep::Point> expected = {{0.1, 1.0}, {0.1, 2.0}, {0.2, 1.0},
+                                                         {0.2, 2.0}, {0.3, 1.0}, {0.3, 2.0}};
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        ASSERT_EQ(points[i].size(), 2u);
+        EXPECT_NEAR(points[i][0], expected[i][0], 1e-12) << i;
+        EXPECT_NEAR(points[i][1], expected[i][1], 1e-12) << i;
+    }
+}
+
+TEST(ParameterSweepTest, RejectsInvalidGrids)
+{
+    std::vector<ParameterSweep::Point> points;
+    EXPECT_FALSE(ParameterSweep::samplePoints({}, ParameterSweep::Sampling::grid, 0, &points));
+    EXPECT_FALSE(ParameterSweep::samplePoints({{"rn1SAFE", 0.1, 0.2, 0}},
+                                              ParameterSweep::Sampling::grid, 0, &points));
+    EXPECT_FALSE(ParameterSweep::samplePoints({{"rn1SAFE", 0.1, 0.2, 1000},
+                                               {"rn2SAFE", 0.1, 0.2, 1000}},
+                                              ParameterSweep::Sampling::grid, 0, &points));
+    EXPECT_TRUE(points.empty());
+}
+
+TEST(ParameterSweepTest, LatinHypercubeHitsEveryStratumOnce)
+{
+    const size_t samples = 20;
+    const std::vector<ParameterSweep::Parameter> parameters = {{"rn1SAFE", 0.0, 1.0, 2},
+                                                               {"rn2SEC", 2.0, 4.0, 2}};
+    std::vector<ParameterSweep::Point> points;
+    ASSERT_TRUE(ParameterSweep::samplePoints(
+            parameters, ParameterSweep::Sampling::latinHypercube, samples, &points, 42));
+    ASSERT_EQ(points.size(), samples);
+    for (size_t j = 0; j < parameters.size(); ++j)
+    {
+        const double width = (parameters[j].to - parameters[j].from) / samples;
+        std::set<size_t> strata;
+        for (const ParameterSweep::Point& point : points)
+        {
+            ASSERT_GE(point[j], parameters[j].from);
+            ASSERT_LT(point[j], parameters[j].to);
+            strata.insert(static_cast<size_t>((point[j] - parameters[j].from) / width));
+        }
+        EXPECT_EQ(strata.size(), samples) << parameters[j].constant;
+    }
+
+    // the same seed yields the same points
+    std::vector<ParameterSweep::Point> again;
+    ASSERT_TRUE(ParameterSweep::samplePoints(
+            parameters, ParameterSweep::Sampling::latinHypercube, samples, &again, 42));
+    EXPECT_EQ(points, again);
+}
+
+TEST(ParameterSweepTest, DescribesConstants)
+{
+    EXPECT_EQ(ParameterSweep::describe({{"rn1SAFE", 0.1, 0.3, 3}, {"rn2SEC", 1.0, 2.0, 2}},
+                                       {0.25, 2.0})
+                      .toStdString(),
+              "rn1SAFE=0.25,rn2SEC=2");
+}
+
+TEST_F(ParameterSweepChainTest, NativeSweepMatchesClosedForm)
+{
+    std::shared_ptr<const MarkovChain> chain = createChain();
+    const std::vector<ParameterSweep::Parameter> parameters = {
+            {Transcriber::constantName(1, "SAFE"), 0.1, 0.5, 5}};
+    std::vector<ParameterSweep::Point> points;
+    ASSERT_TRUE(ParameterSweep::samplePoints(parameters, ParameterSweep::Sampling::grid, 0,
+                                             &points));
+    std::mutex lock;
+    std::map<int, ParameterSweep::Results> results;
+    mConnection = QObject::connect(
+            ParameterSweep::getInstance(), &ParameterSweep::pointFinished,
+            [&lock, &results](int index, const ParameterSweep::Results& point) {
+                std::lock_guard<std::mutex> guard(lock);
+                results[index] = point;
+            });
+    ASSERT_TRUE(ParameterSweep::getInstance()->execute(chain, {"systemfailure"},
+                                                       ExperimentInterval(2, 2, 1), parameters,
+                                                       points));
+    while (ParameterSweep::getInstance()->isRunning())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ASSERT_EQ(results.size(), points.size());
+    for (const auto& result : results)
+    {
+        const QList<QPointF> curve = result.second.value("systemfailure");
+        ASSERT_EQ(curve.size(), 1);
+        const double lambda = points[result.first][0];
+        EXPECT_NEAR(curve.front().y(), 1.0 - std::exp(-lambda * 2.0), 1e-10) << lambda;
+    }
+}
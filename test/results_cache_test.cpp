@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "experiment.h"
+#include "results_cache.h"
+
+#include <QDir>
+#include <QFile>
+
+using eval::ExperimentInterval;
+using eval::ResultsCache;
+
+namespace
+{
+ResultsCache::Results
+createResults(double probability)
+{
+    ResultsCache::Results results;
+    results.insert("P=? [ F<=T \"systemfailure\" ]",
+                   {QPointF(0.0, 0.0), QPointF(5.0, probability)});
+    return results;
+}
+}  // namespace
+
+class ResultsCacheTest : public ::testing::Test
+{
+protected:
+    ResultsCacheTest() :
+        mDirectory(QString::fromStdString(testing::TempDir()) + "results_cache_test"),
+        mPreviousDirectory(ResultsCache::Get()->getDirectory())
+    {
+        QDir(mDirectory).removeRecursively();
+    }
+
+    ~ResultsCacheTest() override
+    {
+        QDir(mDirectory).removeRecursively();
+        ResultsCache::Get()->setDirectory(mPreviousDirectory);
+    }
+
+    QString mDirectory;
+    QString mPreviousDirectory;
+};
+
+TEST_F(ResultsCacheTest, KeyChangesWithEachInput)
+{
+    const QByteArray model = "ctmc\nmodule n1\nendmodule\n";
+    const QString experiment = "P=? [ F<=T \"systemfailure\" ]";
+    const ExperimentInterval interval(0, 10, 1);
+    const QStringList options = {"-sparse", "-epsilon", "1e-6"};
+    const QString key = ResultsCache::key(model, experiment, interval, options);
+
+    EXPECT_EQ(key, ResultsCache::key(model, experiment, interval, options));
+    EXPECT_NE(key, ResultsCache::key(model + " ", experiment, interval, options));
+    EXPECT_NE(key, ResultsCache::key(model, "S=? [ \"systemfailure\" ]", interval, options));
+    EXPECT_NE(key, ResultsCache::key(model, experiment, ExperimentInterval(0, 10, 2), options));
+    EXPECT_NE(key, ResultsCache::key(model, experiment, interval, {"-hybrid", "-epsilon", "1e-6"}));
+    EXPECT_NE(key, ResultsCache::key(model, experiment, interval, {"-sparse", "-epsilon", "1e-9"}));
+    EXPECT_NE(key, ResultsCache::key(model, experiment, interval, {}));
+}
+
+TEST_F(ResultsCacheTest, MemoryHit)
+{
+    ResultsCache::Get()->setDirectory("");
+    const QString key = ResultsCache::key("memory", "", ExperimentInterval(0, 5, 5), {});
+    ResultsCache::Get()->store(key, createResults(0.25));
+    ResultsCache::Results results;
+    ASSERT_TRUE(ResultsCache::Get()->lookup(key, &results));
+    EXPECT_EQ(results, createResults(0.25));
+    EXPECT_FALSE(QDir(mDirectory).exists());
+}
+
+TEST_F(ResultsCacheTest, DiskRoundTrip)
+{
+    ResultsCache::Get()->setDirectory(mDirectory);
+    const QString key = ResultsCache::key("disk", "", ExperimentInterval(0, 5, 5), {});
+    ResultsCache::Get()->store(key, createResults(0.5));
+    ASSERT_TRUE(QFile::exists(mDirectory + "/" + key + ".results"));
+
+    // push the entry out of memory, the lookup has to read it back from disk
+    for (int i = 0; i < 64; ++i)
+    {
+        ResultsCache::Get()->store(
+                ResultsCache::key("filler", QString::number(i), ExperimentInterval(0, 5, 5), {}),
+                createResults(0.75));
+    }
+    ResultsCache::Get()->setDirectory("");
+    ResultsCache::Results results;
+    EXPECT_FALSE(ResultsCache::Get()->lookup(key, &results));
+
+    ResultsCache::Get()->setDirectory(mDirectory);
+    ASSERT_TRUE(ResultsCache::Get()->lookup(key, &results));
+    EXPECT_EQ(results, createResults(0.5));
+}
+
+TEST_F(ResultsCacheTest, IgnoresEmptyResults)
+{
+    ResultsCache::Get()->setDirectory(mDirectory);
+    const QString key = ResultsCache::key("empty", "", ExperimentInterval(0, 5, 5), {});
+    ResultsCache::Get()->store(key, ResultsCache::Results());
+    ResultsCache::Results results;
+    EXPECT_FALSE(ResultsCache::Get()->lookup(key, &results));
+    EXPECT_FALSE(QFile::exists(mDirectory + "/" + key + ".results"));
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "edge.h"
+#include "markov_chain.h"
+#include "minimal_paths.h"
+#include "node.h"
+#include "reachability.h"
+#include "steady_state_solver.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+
+using eval::SteadyStateSolver;
+using graph::ComponentType;
+using graphInternal::Edge;
+using graphInternal::Expression;
+using graphInternal::MarkovChain;
+using graphInternal::MinimalPaths;
+using graphInternal::Node;
+using graphInternal::Reachability;
+
+class SteadyStateSolverTest : public ::testing::Test
+{
+protected:
+    SteadyStateSolverTest()
+    {
+        mEnv.push_back(new Node(ComponentType::environmentNode, 0));
+    }
+
+    ~SteadyStateSolverTest() override
+    {
+        for (Edge* edge : mEdges)
+        {
+            delete edge;
+        }
+        for (Node* node : mNodes)
+        {
+            delete node;
+        }
+        delete mEnv.front();
+    }
+
+    /** Adds a node reachable from the environment, repairable if recovery is not "0" */
+    void
+    addNode(unsigned int number, const std::string& failure, const std::string& recovery)
+    {
+        mNodes.push_back(new Node(ComponentType::normalNode, number, recovery != "0", false, "0",
+                                  failure, "0", recovery, "0"));
+        Edge* edge = new Edge(mEnv.front(), mNodes.back(), ComponentType::reachEdge);
+        mEnv.front()->addEdge(edge);
+        mNodes.back()->addEdge(edge);
+        mEdges.push_back(edge);
+    }
+
+    /** Builds the chain of the nodes with the given operational formula and labels */
+    std::unique_ptr<MarkovChain>
+    createChain(const std::string& operational,
+                const std::vector<std::pair<std::string, std::string>>& labels)
+    {
+        Reachability::compute(mEnv, mNodes);
+        auto minimalPaths = std::make_shared<MinimalPaths>(mNodes);
+        for (Node* node : mNodes)
+        {
+            node->setMinimalPaths(minimalPaths);
+        }
+        std::vector<std::pair<std::string, Expression::Ptr>> formulas;
+        for (const auto& label : labels)
+        {
+            formulas.emplace_back(label.first, Expression::parse(label.second));
+        }
+        auto chain = std::make_unique<MarkovChain>(mNodes, Expression::parse(operational),
+                                                   formulas);
+        EXPECT_TRUE(chain->isValid()) << chain->getError();
+        EXPECT_TRUE(chain->build());
+        return chain;
+    }
+
+    std::vector<Node*> mEnv;
+    std::vector<Node*> mNodes;
+    std::vector<Edge*> mEdges;
+};
+
+TEST_F(SteadyStateSolverTest, RepairableAvailability)
+{
+    const double lambda = 0.1;
+    const double mu = 0.9;
+    addNode(1, "0.1", "0.9");
+    std::unique_ptr<MarkovChain> chain = createChain("true", {{"up", "n1=0"}, {"down", "n1=1"}});
+    ASSERT_EQ(chain->getStateCount(), 2u);
+
+    std::map<std::string, double> results;
+    ASSERT_TRUE(SteadyStateSolver(*chain).steadyState({"up", "down"}, &results));
+    EXPECT_NEAR(results["up"], mu / (lambda + mu), 1e-8);
+    EXPECT_NEAR(results["down"], lambda / (lambda + mu), 1e-8);
+}
+
+TEST_F(SteadyStateSolverTest, MeanTimeToFailure)
+{
+    addNode(1, "0.25", "0");
+    std::unique_ptr<MarkovChain> chain = createChain("n1=0", {{"systemfailure", "n1=1"}});
+
+    std::map<std::string, double> results;
+    ASSERT_TRUE(SteadyStateSolver(*chain).meanTime({"systemfailure"}, &results));
+    EXPECT_NEAR(results["systemfailure"], 1.0 / 0.25, 1e-8);
+}
+
+TEST_F(SteadyStateSolverTest, TransientStatesFeedTwoBottomComponents)
+{
+    // n2 fails and is repaired until n1 fails, which freezes n2 in one of two absorbing states
+    const double lambda1 = 0.2;
+    const double lambda2 = 0.5;
+    const double mu2 = 1.5;
+    addNode(1, "0.2", "0");
+    addNode(2, "0.5", "1.5");
+    std::unique_ptr<MarkovChain> chain =
+            createChain("n1=0", {{"both", "n1=1 & n2=1"}, {"first", "n1=1 & n2=0"}});
+    ASSERT_EQ(chain->getStateCount(), 4u);
+
+    // p0 and p1: probabilities to end in "both" when n2 is ok respectively defective
+    const double p1 = lambda1 / (lambda1 + mu2)
+                      / (1.0 - mu2 / (lambda1 + mu2) * lambda2 / (lambda1 + lambda2));
+    const double p0 = lambda2 / (lambda1 + lambda2) * p1;
+    SteadyStateSolver solver(*chain);
+    solver.setRelaxation(1.2);
+    std::map<std::string, double> results;
+    ASSERT_TRUE(solver.steadyState({"both", "first"}, &results));
+    EXPECT_NEAR(results["both"], p0, 1e-8);
+    EXPECT_NEAR(results["first"], 1.0 - p0, 1e-8);
+
+    // both labels are only reached with a probability below 1
+    ASSERT_TRUE(solver.meanTime({"both", "first"}, &results));
+    EXPECT_EQ(results["both"], INFINITY);
+    EXPECT_EQ(results["first"], INFINITY);
+}
+
+TEST_F(SteadyStateSolverTest, UnreachableGoal)
+{
+    addNode(1, "0.1", "0.9");
+    std::unique_ptr<MarkovChain> chain = createChain("true", {{"corrupted", "n1=2"}});
+
+    std::map<std::string, double> results;
+    SteadyStateSolver solver(*chain);
+    ASSERT_TRUE(solver.meanTime({"corrupted"}, &results));
+    EXPECT_EQ(results["corrupted"], INFINITY);
+    ASSERT_TRUE(solver.steadyState({"corrupted"}, &results));
+    EXPECT_EQ(results["corrupted"], 0.0);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "edge.h"
+#include "minimal_paths.h"
+#include "node.h"
+#include "reachability.h"
+#include "transcriber.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+using graph::ComponentType;
+using graph::Recovery;
+using graphInternal::Edge;
+using graphInternal::MinimalPaths;
+using graphInternal::Node;
+using graphInternal::Reachability;
+using graphInternal::Transcriber;
+
+namespace
+{
+/**
+ * Synthetic graph of chains of ten nodes attached to the environment, with securing nodes,
+ * essential nodes and all recovery strategies. The rates differ so that no nodes are lumped.
+ */
+class SyntheticGraph
+{
+public:
+    explicit SyntheticGraph(unsigned int size)
+    {
+        mEnv.push_back(new Node(ComponentType::environmentNode, 0));
+        for (unsigned int i = 1; i <= size; ++i)
+        {
+            const std::string previous = "n" + std::to_string(i > 1 ? i - 1 : 2);
+            Recovery::Strategy corrStrategy = i % 3 == 0   ? Recovery::Strategy::general
+                                              : i % 3 == 1 ? Recovery::Strategy::restricted
+                                                           : Recovery::Strategy::custom;
+            mNodes.push_back(new Node(
+                    i % 10 == 0 ? ComponentType::criticalNode : ComponentType::normalNode, i,
+                    i % 2 == 0, true, std::to_string(0.5 + i * 1e-3), "0.01", "0.1", "0.3", "0.2",
+                    i % 4 == 0 ? previous + "=0" : "", previous + "=0", corrStrategy,
+                    previous + "!=2",
+                    i % 5 == 0 ? Recovery::Strategy::custom : Recovery::Strategy::general));
+        }
+        for (unsigned int i = 1; i <= size; ++i)
+        {
+            if (i % 10 == 1)
+            {
+                connect(mEnv.front(), node(i), ComponentType::reachEdge);
+            }
+            if (i < size && i % 10 != 0)
+            {
+                connect(node(i), node(i + 1), ComponentType::reachEdge);
+            }
+            if (i % 5 == 0)
+            {
+                connect(node(i - 3), node(i), ComponentType::securityEdge);
+            }
+            if (i % 4 == 0)
+            {
+                connect(node(i - 1), node(i), ComponentType::functionalEdge);
+            }
+        }
+        Reachability::compute(mEnv, mNodes);
+        auto minimalPaths = std::make_shared<MinimalPaths>(mNodes);
+        for (Node* node : mNodes)
+        {
+            node->setMinimalPaths(minimalPaths);
+        }
+    }
+
+    ~SyntheticGraph()
+    {
+        for (Edge* edge : mEdges)
+        {
+            delete edge;
+        }
+        for (Node* node : mNodes)
+        {
+            delete node;
+        }
+        delete mEnv.front();
+    }
+
+    std::vector<Node*> mEnv;
+    std::vector<Node*> mNodes;
+
+private:
+    Node*
+    node(unsigned int number)
+    {
+        return mNodes[number - 1];
+    }
+
+    void
+    connect(Node* start, Node* end, ComponentType type)
+    {
+        Edge* edge = new Edge(start, end, type);
+        start->addEdge(edge);
+        end->addEdge(edge);
+        mEdges.push_back(edge);
+    }
+
+    std::vector<Edge*> mEdges;
+};
+}  // namespace
+
+TEST(TranscriberBenchmark, WritesModelCode)
+{
+    SyntheticGraph graph(50);
+    const std::string outFileName = testing::TempDir() + "transcriber_benchmark.pm";
+    Transcriber transcriber(graph.mEnv, graph.mNodes, "", outFileName);
+    transcriber.buildModel();
+
+    std::ifstream file(outFileName, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_EQ(content.str(), transcriber.getModelCode());
+    EXPECT_EQ(transcriber.getModelCode().rfind("ctmc\n\n", 0), 0u);
+    EXPECT_NE(transcriber.getModelCode().find("n50: [0..2] init 0;\n"), std::string::npos);
+    std::remove(outFileName.c_str());
+}
+
+TEST(TranscriberBenchmark, BytesPerSecond)
+{
+    SyntheticGraph graph(500);
+    const std::string outFileName = testing::TempDir() + "transcriber_benchmark.pm";
+    Transcriber transcriber(graph.mEnv, graph.mNodes, "", outFileName);
+    const int repetitions = 10;
+    size_t bytes = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; ++i)
+    {
+        transcriber.buildModel();
+        bytes += transcriber.getModelCode().size();
+    }
+    const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::remove(outFileName.c_str());
+
+    EXPECT_GT(bytes, 0u);
+    std::printf("500 nodes: %zu bytes per model, %.3f ms per model, %.1f MB/s\n",
+                bytes / repetitions, seconds * 1e3 / repetitions, bytes / seconds / 1e6);
+}
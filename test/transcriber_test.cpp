@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include "edge.h"
+#include "minimal_paths.h"
+#include "model.h"
+#include "node.h"
+#include "reachability.h"
+#include "transcriber.h"
+
+#include <cstdio>
+#include <memory>
+
+using graph::ComponentType;
+using graphInternal::Edge;
+using graphInternal::MinimalPaths;
+using graphInternal::Node;
+using graphInternal::Reachability;
+using graphInternal::Transcriber;
+
+class TranscriberTest : public ::testing::Test
+{
+protected:
+    /**
+     * Three interchangeable sensors n2-n4 reachable from the environment, critical node n1 needs
+     * one of them. Node n5 fails independently of the others.
+     */
+    TranscriberTest() : mOutFileName(testing::TempDir() + "transcriber_test.pm")
+    {
+        mEnv.push_back(new Node(ComponentType::environmentNode, 0));
+        mNodes.push_back(new Node(ComponentType::criticalNode, 1, false, false, "0", "0.01", "0",
+                                  "0", "0", "n2=0 | n3=0 | n4=0"));
+        for (unsigned int number = 2; number <= 4; ++number)
+        {
+            mNodes.push_back(new Node(ComponentType::normalNode, number, true, false, "0", "0.1",
+                                      "0", "1", "0"));
+            connect(mEnv.front(), mNodes.back(), ComponentType::reachEdge);
+            connect(mNodes.back(), mNodes.front(), ComponentType::functionalEdge);
+        }
+        mNodes.push_back(new Node(ComponentType::normalNode, 5, false, false, "0", "0.2"));
+        connect(mEnv.front(), mNodes.back(), ComponentType::reachEdge);
+
+        Reachability::compute(mEnv, mNodes);
+        auto minimalPaths = std::make_shared<MinimalPaths>(mNodes);
+        for (Node* node : mNodes)
+        {
+            node->setMinimalPaths(minimalPaths);
+        }
+    }
+
+    ~TranscriberTest() override
+    {
+        graph::Model::getInstance().setModuleLayout(graph::Model::singleModule);
+        std::remove(mOutFileName.c_str());
+        for (Edge* edge : mEdges)
+        {
+            delete edge;
+        }
+        for (Node* node : mNodes)
+        {
+            delete node;
+        }
+        delete mEnv.front();
+    }
+
+    void
+    connect(Node* start, Node* end, ComponentType type)
+    {
+        Edge* edge = new Edge(start, end, type);
+        start->addEdge(edge);
+        end->addEdge(edge);
+        mEdges.push_back(edge);
+    }
+
+    bool
+    contains(const Transcriber& transcriber, const std::string& code) const
+    {
+        return transcriber.getModelCode().find(code) != std::string::npos;
+    }
+
+    const std::string mOutFileName;
+    std::vector<Node*> mEnv;
+    std::vector<Node*> mNodes;
+    std::vector<Edge*> mEdges;
+};
+
+TEST_F(TranscriberTest, CountsInterchangeableNodes)
+{
+    Transcriber transcriber(mEnv, mNodes, "", mOutFileName);
+    transcriber.buildModel();
+    // experiments may refer to the variables of the members unless counting is enabled
+    EXPECT_FALSE(contains(transcriber, "g2ok"));
+    EXPECT_TRUE(contains(transcriber, "n3: [0..2] init 0;\n"));
+
+    transcriber.setSymmetryAbstraction(true);
+    transcriber.buildModel();
+
+    EXPECT_TRUE(contains(transcriber, "// interchangeable nodes n2 n3 n4\n"));
+    EXPECT_TRUE(contains(transcriber, "g2ok: [0..3] init 3;\n"));
+    EXPECT_TRUE(contains(transcriber, "[] (g2ok>0) & (operational) -> g2ok*rn2SAFE : "
+                                      "(g2ok'=g2ok-1) & (g2def'=g2def+1);\n"));
+    EXPECT_TRUE(contains(transcriber, "formula n1essentials = g2ok>=1;\n"));
+    EXPECT_FALSE(contains(transcriber, "n3: [0..2]"));
+    EXPECT_FALSE(contains(transcriber, "(n3=0)"));
+    // the rates of the other members are still declared
+    EXPECT_TRUE(contains(transcriber, "const double rn3SAFE = 0.1;\n"));
+}
+
+TEST_F(TranscriberTest, CountsInterchangeableNodesOnly)
+{
+    // n2 secures n5 against intrusions, it is no longer interchangeable with n3 and n4
+    mNodes[1]->setAttributes(true, false, "0", "0.1", "0.05", "1", "0", "", "",
+                             graph::Recovery::Strategy::restricted, "",
+                             graph::Recovery::Strategy::general);
+    mNodes[4]->setAttributes(false, false, "0.3", "0.2", "0", "0", "0", "", "",
+                             graph::Recovery::Strategy::restricted, "",
+                             graph::Recovery::Strategy::general);
+    connect(mNodes[1], mNodes[4], ComponentType::securityEdge);
+    Transcriber transcriber(mEnv, mNodes, "", mOutFileName);
+    transcriber.setSymmetryAbstraction(true);
+    transcriber.buildModel();
+
+    EXPECT_FALSE(contains(transcriber, "g2ok"));
+    EXPECT_TRUE(contains(transcriber, "n2: [0..2] init 0;\n"));
+    EXPECT_TRUE(contains(transcriber, "// interchangeable nodes n3 n4\n"));
+    EXPECT_TRUE(contains(transcriber, "g3ok: [0..2] init 2;\n"));
+}
+
+TEST_F(TranscriberTest, RemovesNodesOutsideTheConeOfInfluence)
+{
+    Transcriber transcriber(mEnv, mNodes, "", mOutFileName);
+    transcriber.setObservedLabels({"systemfailure"});
+    transcriber.buildModel();
+    // experiments may refer to any node unless the reduction is enabled
+    EXPECT_TRUE(contains(transcriber, "n5: [0..2] init 0;\n"));
+
+    transcriber.setConeOfInfluence(true);
+    transcriber.buildModel();
+    EXPECT_TRUE(contains(transcriber, "// outside the cone of influence: n5\n"));
+    EXPECT_FALSE(contains(transcriber, "n5: [0..2]"));
+    EXPECT_FALSE(contains(transcriber, "rn5SAFE"));
+    EXPECT_TRUE(contains(transcriber, "label \"systemfailure\" = !operational;\n"));
+    EXPECT_FALSE(contains(transcriber, "label \"defective\""));
+
+    transcriber.setConeOfInfluence(false);
+    transcriber.buildModel();
+    EXPECT_TRUE(contains(transcriber, "n5: [0..2] init 0;\n"));
+    EXPECT_TRUE(contains(transcriber, "label \"defective\""));
+}
+
+TEST_F(TranscriberTest, WritesModulePerNode)
+{
+    graph::Model::getInstance().setModuleLayout(graph::Model::modulePerNode);
+    Transcriber transcriber(mEnv, mNodes, "", mOutFileName);
+    transcriber.setSymmetryAbstraction(true);
+    transcriber.buildModel();
+
+    EXPECT_TRUE(contains(transcriber, "module node1\nn1: [0..2] init 0;\n"));
+    EXPECT_TRUE(contains(transcriber, "module group2\n"));
+    EXPECT_TRUE(contains(transcriber, "module node5\nn5: [0..2] init 0;\n"
+                                      "[] (n5=0) & (operational) -> rn5SAFE : (n5'=1);\n"));
+    EXPECT_FALSE(contains(transcriber, "module generatedScenario"));
+}
+
+TEST_F(TranscriberTest, WritesTimeRewardOnRequest)
+{
+    Transcriber transcriber(mEnv, mNodes, "", mOutFileName);
+    transcriber.buildModel();
+    EXPECT_FALSE(contains(transcriber, "rewards"));
+
+    transcriber.setTimeReward(true);
+    transcriber.buildModel();
+    EXPECT_TRUE(contains(transcriber, "\nrewards \"time\"\n    true : 1;\nendrewards\n"));
+}
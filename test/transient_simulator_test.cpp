@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "edge.h"
+#include "experiment.h"
+#include "markov_chain.h"
+#include "minimal_paths.h"
+#include "node.h"
+#include "reachability.h"
+#include "transient_simulator.h"
+#include "transient_solver.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+
+using eval::ExperimentInterval;
+using eval::TransientSimulator;
+using eval::TransientSolver;
+using graph::ComponentType;
+using graphInternal::Edge;
+using graphInternal::Expression;
+using graphInternal::MarkovChain;
+using graphInternal::MinimalPaths;
+using graphInternal::Node;
+using graphInternal::Reachability;
+
+class TransientSimulatorTest : public ::testing::Test
+{
+protected:
+    TransientSimulatorTest()
+    {
+        mEnv.push_back(new Node(ComponentType::environmentNode, 0));
+    }
+
+    ~TransientSimulatorTest() override
+    {
+        for (Edge* edge : mEdges)
+        {
+            delete edge;
+        }
+        for (Node* node : mNodes)
+        {
+            delete node;
+        }
+        delete mEnv.front();
+    }
+
+    /** Adds a node reachable from the environment, repairable if recovery is not "0" */
+    void
+    addNode(unsigned int number, const std::string& failure, const std::string& recovery)
+    {
+        mNodes.push_back(new Node(ComponentType::normalNode, number, recovery != "0", false, "0",
+                                  failure, "0", recovery, "0"));
+        Edge* edge = new Edge(mEnv.front(), mNodes.back(), ComponentType::reachEdge);
+        mEnv.front()->addEdge(edge);
+        mNodes.back()->addEdge(edge);
+        mEdges.push_back(edge);
+    }
+
+    /** Compiles the chain of the nodes with the given operational formula and label */
+    std::unique_ptr<MarkovChain>
+    createChain(const std::string& operational, const std::string& label)
+    {
+        Reachability::compute(mEnv, mNodes);
+        auto minimalPaths = std::make_shared<MinimalPaths>(mNodes);
+        for (Node* node : mNodes)
+        {
+            node->setMinimalPaths(minimalPaths);
+        }
+        auto chain = std::make_unique<MarkovChain>(
+                mNodes, Expression::parse(operational),
+                std::vector<std::pair<std::string, Expression::Ptr>>(
+                        {{"systemfailure", Expression::parse(label)}}));
+        EXPECT_TRUE(chain->isValid()) << chain->getError();
+        return chain;
+    }
+
+    std::vector<Node*> mEnv;
+    std::vector<Node*> mNodes;
+    std::vector<Edge*> mEdges;
+};
+
+TEST_F(TransientSimulatorTest, EstimatesContainAnalyticResult)
+{
+    const double lambda = 0.2;
+    addNode(1, "0.2", "0");
+    std::unique_ptr<MarkovChain> chain = createChain("n1=0", "n1=1");
+
+    for (bool importanceSampling : {false, true})
+    {
+        TransientSimulator::Options options;
+        options.seed = 7;
+        options.threads = 2;
+        options.importanceSampling = importanceSampling;
+        options.relativeError = 0.02;
+        std::map<std::string, TransientSimulator::Estimates> results;
+        ASSERT_TRUE(TransientSimulator(*chain, options)
+                            .simulate(ExperimentInterval(1, 5, 2), {"systemfailure"}, &results));
+        const TransientSimulator::Estimates& estimates = results["systemfailure"];
+        ASSERT_EQ(estimates.size(), 3u);
+        for (const TransientSimulator::Estimate& estimate : estimates)
+        {
+            const double expected = 1.0 - std::exp(-lambda * estimate.time);
+            EXPECT_LE(estimate.lower, expected) << importanceSampling << " " << estimate.time;
+            EXPECT_GE(estimate.upper, expected) << importanceSampling << " " << estimate.time;
+        }
+    }
+}
+
+TEST_F(TransientSimulatorTest, FailureBiasingIsUnbiased)
+{
+    // both nodes of a quickly repaired pair are defective with a probability of about 1e-7
+    addNode(1, "0.0005", "1");
+    addNode(2, "0.0003", "1");
+    std::unique_ptr<MarkovChain> chain = createChain("true", "n1=1 & n2=1");
+    const ExperimentInterval interval(10, 10, 1);
+    ASSERT_TRUE(chain->build());
+    std::map<std::string, TransientSolver::Curve> exact;
+    ASSERT_TRUE(TransientSolver(*chain).solve(interval, {"systemfailure"}, &exact));
+    const double expected = exact["systemfailure"].front().second;
+    ASSERT_GT(expected, 0.0);
+    ASSERT_LT(expected, 1e-6);
+
+    TransientSimulator::Options options;
+    options.seed = 11;
+    options.threads = 2;
+    options.importanceSampling = true;
+    TransientSimulator simulator(*chain, options);
+    std::map<std::string, TransientSimulator::Estimates> results;
+    ASSERT_TRUE(simulator.simulate(interval, {"systemfailure"}, &results));
+    const TransientSimulator::Estimate& estimate = results["systemfailure"].front();
+    EXPECT_GT(simulator.getFailureBias(), 0.0);
+    EXPECT_LE(estimate.lower, expected);
+    EXPECT_GE(estimate.upper, expected);
+    EXPECT_NEAR(estimate.probability, expected, 0.1 * expected);
+}
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include "edge.h"
+#include "experiment.h"
+#include "markov_chain.h"
+#include "minimal_paths.h"
+#include "node.h"
+#include "reachability.h"
+#include "transcriber.h"
+#include "transient_solver.h"
+
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <numeric>
+
+using eval::ExperimentInterval;
+using eval::TransientSolver;
+using graph::ComponentType;
+using graphInternal::Edge;
+using graphInternal::Expression;
+using graphInternal::MarkovChain;
+using graphInternal::MinimalPaths;
+using graphInternal::Node;
+using graphInternal::Reachability;
+using graphInternal::Transcriber;
+
+class TransientSolverChainTest : public ::testing::Test
+{
+protected:
+    TransientSolverChainTest()
+    {
+        mEnv.push_back(new Node(ComponentType::environmentNode, 0));
+    }
+
+    ~TransientSolverChainTest() override
+    {
+        for (Edge* edge : mEdges)
+        {
+            delete edge;
+        }
+        for (Node* node : mNodes)
+        {
+            delete node;
+        }
+        delete mEnv.front();
+    }
+
+    /** Adds a node reachable from the environment, repairable if recovery is not "0" */
+    void
+    addNode(ComponentType type,
+            unsigned int number,
+            const std::string& failure,
+            const std::string& recovery)
+    {
+        mNodes.push_back(new Node(type, number, recovery != "0", false, "0", failure, "0",
+                                  recovery, "0"));
+        Edge* edge = new Edge(mEnv.front(), mNodes.back(), ComponentType::reachEdge);
+        mEnv.front()->addEdge(edge);
+        mNodes.back()->addEdge(edge);
+        mEdges.push_back(edge);
+    }
+
+    void
+    computePaths()
+    {
+        Reachability::compute(mEnv, mNodes);
+        auto minimalPaths = std::make_shared<MinimalPaths>(mNodes);
+        for (Node* node : mNodes)
+        {
+            node->setMinimalPaths(minimalPaths);
+        }
+    }
+
+    /** Compiles the chain of the nodes with the given operational formula and labels */
+    std::unique_ptr<MarkovChain>
+    createChain(const std::string& operational,
+                const std::vector<std::pair<std::string, std::string>>& labels)
+    {
+        computePaths();
+        std::vector<std::pair<std::string, Expression::Ptr>> formulas;
+        for (const auto& label : labels)
+        {
+            formulas.emplace_back(label.first, Expression::parse(label.second));
+        }
+        auto chain = std::make_unique<MarkovChain>(mNodes, Expression::parse(operational),
+                                                   formulas);
+        EXPECT_TRUE(chain->isValid()) << chain->getError();
+        return chain;
+    }
+
+    /** Compiles the chain from the formulas generated by the transcriber */
+    std::unique_ptr<MarkovChain>
+    createTranscribedChain()
+    {
+        computePaths();
+        const std::string outFileName = testing::TempDir() + "transient_solver_test.pm";
+        Transcriber transcriber(mEnv, mNodes, "", outFileName);
+        transcriber.buildModel();
+        std::remove(outFileName.c_str());
+        auto chain = std::make_unique<MarkovChain>(mNodes, transcriber.getOperationalFormula(),
+                                                   transcriber.getLabelFormulas());
+        EXPECT_TRUE(chain->isValid()) << chain->getError();
+        return chain;
+    }
+
+    std::vector<Node*> mEnv;
+    std::vector<Node*> mNodes;
+    std::vector<Edge*> mEdges;
+};
+
+TEST(TransientSolverTest, PoissonWeightsSumToOne)
+{
+    for (double lambda : {0.5, 10.0, 250.0, 5000.0})
+    {
+        size_t left = 0;
+        std::vector<double> weights;
+        TransientSolver::poissonWeights(lambda, 1e-12, &left, &weights);
+        EXPECT_NEAR(std::accumulate(weights.begin(), weights.end(), 0.0), 1.0, 1e-12);
+        EXPECT_LE(left, static_cast<size_t>(lambda));
+        EXPECT_GT(left + weights.size(), static_cast<size_t>(lambda));
+    }
+}
+
+TEST(TransientSolverTest, PoissonWeightsMatchDistribution)
+{
+    const double lambda = 3.0;
+    size_t left = 0;
+    std::vector<double> weights;
+    TransientSolver::poissonWeights(lambda, 1e-12, &left, &weights);
+    EXPECT_EQ(left, 0u);
+    double expected = std::exp(-lambda);
+    for (size_t k = 0; k < 10; ++k)
+    {
+        EXPECT_NEAR(weights[k], expected, 1e-12);
+        expected *= lambda / static_cast<double>(k + 1);
+    }
+}
+
+TEST(TransientSolverTest, PoissonWeightsZero)
+{
+    size_t left = 5;
+    std::vector<double> weights;
+    TransientSolver::poissonWeights(0.0, 1e-12, &left, &weights);
+    EXPECT_EQ(left, 0u);
+    ASSERT_EQ(weights.size(), 1u);
+    EXPECT_EQ(weights[0], 1.0);
+}
+
+TEST_F(TransientSolverChainTest, SingleNodeFailure)
+{
+    const double lambda = 0.3;
+    addNode(ComponentType::criticalNode, 1, "0.3", "0");
+    std::unique_ptr<MarkovChain> chain = createTranscribedChain();
+    ASSERT_TRUE(chain->build());
+
+    std::map<std::string, TransientSolver::Curve> results;
+    ASSERT_TRUE(TransientSolver(*chain).solve(ExperimentInterval(0, 10, 1), {"systemfailure"},
+                                              &results));
+    const TransientSolver::Curve& curve = results["systemfailure"];
+    ASSERT_EQ(curve.size(), 11u);
+    for (const auto& point : curve)
+    {
+        EXPECT_NEAR(point.second, 1.0 - std::exp(-lambda * point.first), 1e-10) << point.first;
+    }
+}
+
+TEST_F(TransientSolverChainTest, RepairableNode)
+{
+    const double lambda = 0.4;
+    const double mu = 1.1;
+    addNode(ComponentType::normalNode, 1, "0.4", "1.1");
+    std::unique_ptr<MarkovChain> chain = createChain("true", {{"down", "n1=1"}});
+    ASSERT_TRUE(chain->build());
+
+    std::map<std::string, TransientSolver::Curve> results;
+    ASSERT_TRUE(TransientSolver(*chain).solve(ExperimentInterval(0, 20, 2), {"down"}, &results));
+    const TransientSolver::Curve& curve = results["down"];
+    ASSERT_EQ(curve.size(), 11u);
+    for (const auto& point : curve)
+    {
+        const double expected =
+                lambda / (lambda + mu) * (1.0 - std::exp(-(lambda + mu) * point.first));
+        EXPECT_NEAR(point.second, expected, 1e-10) << point.first;
+    }
+}
+
+TEST_F(TransientSolverChainTest, TruncationErrorBracketsResult)
+{
+    addNode(ComponentType::normalNode, 1, "0.3", "1");
+    addNode(ComponentType::normalNode, 2, "0.4", "1");
+    addNode(ComponentType::normalNode, 3, "0.5", "1");
+    addNode(ComponentType::normalNode, 4, "0.6", "1");
+    std::unique_ptr<MarkovChain> chain =
+            createChain("true", {{"both", "n1=1 & n4=1"}, {"any", "n1=1 | n2=1 | n3=1"}});
+    const ExperimentInterval interval(0, 8, 2);
+    const std::vector<std::string> labels = {"both", "any"};
+    ASSERT_TRUE(chain->build());
+    std::map<std::string, TransientSolver::Curve> exact;
+    ASSERT_TRUE(TransientSolver(*chain).solve(interval, labels, &exact));
+
+    for (unsigned int depth = 1; depth <= 4; ++depth)
+    {
+        chain->setFailureDepth(depth);
+        ASSERT_TRUE(chain->build());
+        TransientSolver solver(*chain);
+        std::map<std::string, TransientSolver::Curve> results;
+        ASSERT_TRUE(solver.solve(interval, labels, &results));
+        const TransientSolver::Curve& errors = solver.getTruncationErrors();
+        for (const std::string& label : labels)
+        {
+            for (size_t i = 0; i < errors.size(); ++i)
+            {
+                EXPECT_LE(results[label][i].second, exact[label][i].second + 1e-10);
+                EXPECT_GE(results[label][i].second + errors[i].second,
+                          exact[label][i].second - 1e-10);
+            }
+        }
+        EXPECT_EQ(errors.back().second > 1e-10, depth < 4) << depth;
+    }
+    chain->setFailureDepth(MarkovChain::kUnbounded);
+
+    std::map<std::string, TransientSolver::Curve> results;
+    TransientSolver::Curve errors;
+    ASSERT_TRUE(TransientSolver::solveBounded(*chain, interval, labels, 1e-3, &results, &errors));
+    for (const std::string& label : labels)
+    {
+        for (size_t i = 0; i < errors.size(); ++i)
+        {
+            EXPECT_LE(errors[i].second, 1e-3);
+            EXPECT_LE(results[label][i].second, exact[label][i].second + 1e-10);
+            EXPECT_GE(results[label][i].second + errors[i].second,
+                      exact[label][i].second - 1e-10);
+        }
+    }
+}
+
+TEST_F(TransientSolverChainTest, VotingGroupFailsLikeBinomial)
+{
+    const double lambda = 0.05;
+    for (unsigned int number = 1; number <= 3; ++number)
+    {
+        addNode(ComponentType::criticalNode, number, "0.05", "0");
+    }
+    for (Node* node : mNodes)
+    {
+        node->setVotingGroup(2, mNodes);
+    }
+    std::unique_ptr<MarkovChain> chain = createTranscribedChain();
+    ASSERT_TRUE(chain->build());
+
+    std::map<std::string, TransientSolver::Curve> results;
+    ASSERT_TRUE(TransientSolver(*chain).solve(ExperimentInterval(0, 30, 5), {"systemfailure"},
+                                              &results));
+    for (const auto& point : results["systemfailure"])
+    {  // fewer than 2 of the 3 members work
+        const double ok = std::exp(-lambda * point.first);
+        const double working = ok * ok * ok + 3.0 * ok * ok * (1.0 - ok);
+        EXPECT_NEAR(point.second, 1.0 - working, 1e-10) << point.first;
+    }
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "edge.h"
+#include "node.h"
+#include "variable_order.h"
+
+#include <algorithm>
+
+using graph::ComponentType;
+using graphInternal::Edge;
+using graphInternal::Node;
+using graphInternal::VariableOrder;
+
+class VariableOrderTest : public ::testing::Test
+{
+protected:
+    ~VariableOrderTest() override
+    {
+        for (Edge* edge : mEdges)
+        {
+            delete edge;
+        }
+        for (Node* node : mNodes)
+        {
+            delete node;
+        }
+    }
+
+    /** Chain of reach edges visiting the nodes in the order of the given numbers */
+    void
+    createChain(const std::vector<unsigned int>& numbers)
+    {
+        for (unsigned int number : numbers)
+        {
+            mNodes.push_back(new Node(ComponentType::normalNode, number));
+        }
+        std::sort(mNodes.begin(), mNodes.end(),
+                  [](Node* a, Node* b) { return a->getNumber() < b->getNumber(); });
+        for (size_t i = 0; i + 1 < numbers.size(); ++i)
+        {
+            Node* start = find(numbers[i]);
+            Node* end = find(numbers[i + 1]);
+            Edge* edge = new Edge(start, end, ComponentType::reachEdge);
+            start->addEdge(edge);
+            end->addEdge(edge);
+            mEdges.push_back(edge);
+        }
+    }
+
+    Node*
+    find(unsigned int number)
+    {
+        for (Node* node : mNodes)
+        {
+            if (node->getNumber() == number)
+            {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<Node*> mNodes;
+    std::vector<Edge*> mEdges;
+};
+
+TEST_F(VariableOrderTest, ChainHasBandwidthOne)
+{
+    createChain({5, 1, 8, 3, 7, 2, 6, 4});
+    EXPECT_EQ(VariableOrder::bandwidth(mNodes), 7u);
+
+    const std::vector<Node*> order = VariableOrder::reverseCuthillMcKee(mNodes);
+    ASSERT_EQ(order.size(), mNodes.size());
+    EXPECT_EQ(VariableOrder::bandwidth(order), 1u);
+    // starts at an end of the chain, the one with the smaller number
+    EXPECT_EQ(order.back()->getNumber(), 4u);
+    EXPECT_EQ(order.front()->getNumber(), 5u);
+}
+
+TEST_F(VariableOrderTest, KeepsUnconnectedNodes)
+{
+    createChain({3, 1});
+    mNodes.push_back(new Node(ComponentType::normalNode, 2));
+
+    const std::vector<Node*> order = VariableOrder::reverseCuthillMcKee(mNodes);
+    ASSERT_EQ(order.size(), 3u);
+    // the isolated node has the minimal degree and is visited first
+    EXPECT_EQ(order.back()->getNumber(), 2u);
+    EXPECT_EQ(VariableOrder::bandwidth(order), 1u);
+}